@@ -10,10 +10,25 @@
 #include "cclient/api/extended/get_new_address.h"
 #include "cclient/api/extended/logger.h"
 
-static retcode_t is_unused_address(iota_client_service_t const* const serv, flex_trit_t const* const addr,
-                                   bool* const is_unused) {
+// Number of candidate addresses generated and looked up at once while searching for an unused address
+#ifndef GET_NEW_ADDRESS_BATCH_SIZE
+#define GET_NEW_ADDRESS_BATCH_SIZE 8
+#endif
+
+/**
+ * Checks that no transaction references a set of addresses with a single
+ * iota_client_find_transactions() call, only the hashes being fetched
+ *
+ * @param serv client service
+ * @param addrs The addresses
+ * @param count The number of addresses
+ * @param are_unused Whether none of the addresses is referenced
+ *
+ * @return error code
+ */
+static retcode_t are_unused_addresses(iota_client_service_t const* const serv, flex_trit_t const* const addrs,
+                                      size_t const count, bool* const are_unused) {
   retcode_t ret_code = RC_OK;
-  size_t ret_num = 0;
   find_transactions_req_t* find_tran_req = NULL;
   find_transactions_res_t* find_tran_res = NULL;
 
@@ -27,15 +42,17 @@ static retcode_t is_unused_address(iota_client_service_t const* const serv, flex
     goto done;
   }
 
-  ret_code = hash243_queue_push(&find_tran_req->addresses, addr);
-  if (ret_code) {
-    log_error(client_extended_logger_id, "%s: hahs queue push failed: %s\n", __func__, error_2_string(ret_code));
-    goto done;
+  for (size_t i = 0; i < count; i++) {
+    ret_code = hash243_queue_push(&find_tran_req->addresses, addrs + i * FLEX_TRIT_SIZE_243);
+    if (ret_code) {
+      log_error(client_extended_logger_id, "%s: hash queue push failed: %s\n", __func__, error_2_string(ret_code));
+      goto done;
+    }
   }
+
   ret_code = iota_client_find_transactions(serv, find_tran_req, find_tran_res);
   if (ret_code == RC_OK) {
-    ret_num = hash243_queue_count(find_tran_res->hashes);
-    *is_unused = ret_num ? false : true;
+    *are_unused = hash243_queue_count(find_tran_res->hashes) == 0;
   }
 done:
   find_transactions_req_free(&find_tran_req);
@@ -43,12 +60,44 @@ done:
   return ret_code;
 }
 
+/**
+ * Finds the first unused address of a batch, probing the addresses one by one
+ * only when some of them are referenced
+ *
+ * @param serv client service
+ * @param addrs The addresses
+ * @param count The number of addresses
+ * @param first_unused The index of the first unused address, count if they are all used
+ *
+ * @return error code
+ */
+static retcode_t first_unused_address(iota_client_service_t const* const serv, flex_trit_t const* const addrs,
+                                      size_t const count, size_t* const first_unused) {
+  retcode_t ret_code = RC_OK;
+  bool are_unused = false;
+
+  *first_unused = 0;
+  if ((ret_code = are_unused_addresses(serv, addrs, count, &are_unused)) != RC_OK || are_unused) {
+    return ret_code;
+  }
+
+  for (*first_unused = 0; *first_unused < count; (*first_unused)++) {
+    ret_code = are_unused_addresses(serv, addrs + *first_unused * FLEX_TRIT_SIZE_243, 1, &are_unused);
+    if (ret_code != RC_OK || are_unused) {
+      break;
+    }
+  }
+
+  return ret_code;
+}
+
 retcode_t iota_client_get_new_address(iota_client_service_t const* const serv, flex_trit_t const* const seed,
                                       address_opt_t const addr_opt, hash243_queue_t* out_addresses) {
   retcode_t ret = RC_OK;
-  flex_trit_t* tmp = NULL;
+  flex_trit_t* addrs = NULL;
   size_t addr_index = 0;
-  bool is_unused = true;
+  size_t count = 0;
+  size_t first_unused = 0;
 
   log_info(client_extended_logger_id, "[%s:%d]\n", __func__, __LINE__);
   // security validation
@@ -59,49 +108,58 @@ retcode_t iota_client_get_new_address(iota_client_service_t const* const serv, f
   }
 
   if (addr_opt.total != 0) {  // return addresses in a list
-    for (addr_index = addr_opt.start; addr_index < addr_opt.total; addr_index++) {
-      tmp = iota_sign_address_gen_flex_trits(seed, addr_index, addr_opt.security);
-      if (tmp) {
-        ret = hash243_queue_push(out_addresses, tmp);
-        if (ret) {
-          log_error(client_extended_logger_id, "%s:%d hash queue push failed: %s\n", __func__, __LINE__,
-                    error_2_string(ret));
-          goto done;
-        }
-        free(tmp);
-        tmp = NULL;
-      } else {
-        // gen address failed.
-        ret = RC_CCLIENT_OOM;
-        log_error(client_extended_logger_id, "%s address generation failed: %s\n", __func__, error_2_string(ret));
+    count = addr_opt.total > addr_opt.start ? addr_opt.total - addr_opt.start : 0;
+  } else {  // return addresses include the latest unused address.
+    count = GET_NEW_ADDRESS_BATCH_SIZE;
+  }
+  if (count == 0) {
+    return RC_OK;
+  }
+
+  if ((addrs = (flex_trit_t*)calloc(count, FLEX_TRIT_SIZE_243)) == NULL) {
+    ret = RC_CCLIENT_OOM;
+    log_error(client_extended_logger_id, "%s address generation failed: %s\n", __func__, error_2_string(ret));
+    return ret;
+  }
+
+  if (addr_opt.total != 0) {
+    ret = iota_sign_addresses_gen_flex_trits(seed, addr_opt.start, count, addr_opt.security, addrs);
+    if (ret) {
+      log_error(client_extended_logger_id, "%s address generation failed: %s\n", __func__, error_2_string(ret));
+      goto done;
+    }
+    for (size_t i = 0; i < count; i++) {
+      ret = hash243_queue_push(out_addresses, addrs + i * FLEX_TRIT_SIZE_243);
+      if (ret) {
+        log_error(client_extended_logger_id, "%s:%d hash queue push failed: %s\n", __func__, __LINE__,
+                  error_2_string(ret));
         goto done;
       }
     }
-  } else {  // return addresses include the latest unused address.
-    for (addr_index = 0;; addr_index++) {
-      tmp = iota_sign_address_gen_flex_trits(seed, addr_index, addr_opt.security);
-      if (tmp) {
-        ret = hash243_queue_push(out_addresses, tmp);
+  } else {
+    for (addr_index = 0;; addr_index += count) {
+      ret = iota_sign_addresses_gen_flex_trits(seed, addr_index, count, addr_opt.security, addrs);
+      if (ret) {
+        log_error(client_extended_logger_id, "%s address generation failed: %s\n", __func__, error_2_string(ret));
+        goto done;
+      }
+      if ((ret = first_unused_address(serv, addrs, count, &first_unused)) != RC_OK) {
+        goto done;
+      }
+      for (size_t i = 0; i < count && i <= first_unused; i++) {
+        ret = hash243_queue_push(out_addresses, addrs + i * FLEX_TRIT_SIZE_243);
         if (ret) {
           log_error(client_extended_logger_id, "%s:%d hash queue push failed: %s\n", __func__, __LINE__,
                     error_2_string(ret));
           goto done;
         }
-        ret = is_unused_address(serv, tmp, &is_unused);
-        if (ret == RC_OK && is_unused) {
-          goto done;
-        }
-        free(tmp);
-        tmp = NULL;
-      } else {
-        // gen address failed.
-        ret = RC_CCLIENT_OOM;
-        log_error(client_extended_logger_id, "%s address generation failed: %s\n", __func__, error_2_string(ret));
+      }
+      if (first_unused < count) {
         goto done;
       }
     }
   }
 done:
-  free(tmp);
+  free(addrs);
   return ret;
 }
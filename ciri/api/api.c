@@ -5,9 +5,11 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <inttypes.h>
 #include <string.h>
 
 #include "ciri/api/api.h"
+#include "common/crypto/curl-p/pearl_diver.h"
 #include "common/helpers/pow.h"
 #include "utils/logger_helper.h"
 #include "utils/time.h"
@@ -275,6 +277,8 @@ retcode_t iota_api_attach_to_tangle(iota_api_t const *const api, attach_to_tangl
   flex_trit_t *trytes_iter = NULL;
   iota_transaction_t tx;
   flex_trit_t tx_trytes[FLEX_TRIT_SIZE_8019];
+  iota_pow_timing_t timing;
+  size_t slowest = 0;
 
   if (api == NULL || req == NULL || res == NULL || error == NULL) {
     return RC_NULL_PARAM;
@@ -287,9 +291,20 @@ retcode_t iota_api_attach_to_tangle(iota_api_t const *const api, attach_to_tangl
     bundle_transactions_add(bundle, &tx);
   }
 
-  if ((ret = iota_pow_bundle(bundle, req->trunk, req->branch, req->mwm)) != RC_OK) {
+  if ((ret = iota_pow_bundle_timed(bundle, req->trunk, req->branch, req->mwm, &timing)) != RC_OK) {
     goto done;
   }
+  for (size_t i = 1; i < timing.transactions_count; i++) {
+    if (timing.transactions_us[i] > timing.transactions_us[slowest]) {
+      slowest = i;
+    }
+  }
+  log_debug(logger_id,
+            "Attached %zu transactions in %" PRIu64 " us, %" PRIu64 " us absorbing midstates, slowest %zu in %" PRIu64
+            " us\n",
+            timing.transactions_count, timing.total_us, timing.midstates_us, slowest,
+            timing.transactions_count > 0 ? timing.transactions_us[slowest] : 0);
+  iota_pow_timing_free(&timing);
 
   BUNDLE_FOREACH(bundle, tx_iter) {
     transaction_serialize_on_flex_trits(tx_iter, tx_trytes);
@@ -299,7 +314,7 @@ retcode_t iota_api_attach_to_tangle(iota_api_t const *const api, attach_to_tangl
 done:
   bundle_transactions_free(&bundle);
 
-  return RC_OK;
+  return ret;
 }
 
 retcode_t iota_api_interrupt_attaching_to_tangle(iota_api_t const *const api, error_res_t **const error) {
@@ -307,6 +322,9 @@ retcode_t iota_api_interrupt_attaching_to_tangle(iota_api_t const *const api, er
     return RC_NULL_PARAM;
   }
 
+  // Pending 'attachToTangle' calls fail with RC_HELPERS_POW_FAILED
+  pearl_diver_cancel_all(pearl_diver_default());
+
   return RC_OK;
 }
 
@@ -395,7 +413,6 @@ retcode_t iota_api_check_consistency(iota_api_t const *const api, tangle_t *cons
                                      error_res_t **const error) {
   retcode_t ret = RC_OK;
   hash243_queue_entry_t *iter = NULL;
-  bundle_transactions_t *bundle = NULL;
   bundle_status_t bundle_status = BUNDLE_NOT_INITIALIZED;
   exit_prob_transaction_validator_t walker_validator;
   DECLARE_PACK_SINGLE_TX(tx, txp, pack);
@@ -411,7 +428,6 @@ retcode_t iota_api_check_consistency(iota_api_t const *const api, tangle_t *cons
   }
 
   CDL_FOREACH(req->tails, iter) {
-    bundle_transactions_new(&bundle);
     hash_pack_reset(&pack);
     if ((ret = iota_tangle_transaction_load_partial(tangle, iter->hash, &pack, PARTIAL_TX_MODEL_ESSENCE_METADATA)) !=
         RC_OK) {
@@ -429,14 +445,13 @@ retcode_t iota_api_check_consistency(iota_api_t const *const api, tangle_t *cons
       check_consistency_res_info_set(res, API_TAILS_NOT_SOLID);
       goto done;
     }
-    if ((ret = iota_consensus_bundle_validator_validate(tangle, iter->hash, bundle, &bundle_status)) != RC_OK) {
+    if ((ret = iota_consensus_bundle_validator_validate_delta(tangle, iter->hash, NULL, &bundle_status)) != RC_OK) {
       goto done;
     }
-    if (bundle_status != BUNDLE_VALID || bundle_transactions_size(bundle) == 0) {
+    if (bundle_status != BUNDLE_VALID) {
       check_consistency_res_info_set(res, API_TAILS_BUNDLE_INVALID);
       goto done;
     }
-    bundle_transactions_free(&bundle);
   }
 
   rw_lock_handle_rdlock(&api->core->consensus.milestone_tracker.latest_snapshot->rw_lock);
@@ -461,8 +476,6 @@ retcode_t iota_api_check_consistency(iota_api_t const *const api, tangle_t *cons
   rw_lock_handle_unlock(&api->core->consensus.milestone_tracker.latest_snapshot->rw_lock);
 
 done:
-  bundle_transactions_free(&bundle);
-
   return ret;
 }
 
@@ -474,6 +487,10 @@ retcode_t iota_api_init(iota_api_t *const api, core_t *const core) {
   logger_id = logger_helper_enable(API_LOGGER_ID, LOGGER_DEBUG, true);
   api->core = core;
 
+  if (pearl_diver_set_max_jobs(pearl_diver_default(), api->conf.max_pow_jobs) != RC_OK) {
+    log_warning(logger_id, "Setting the maximum number of proof of work jobs failed\n");
+  }
+
   return RC_OK;
 }
 
@@ -482,6 +499,7 @@ retcode_t iota_api_destroy(iota_api_t *const api) {
     return RC_NULL_PARAM;
   }
 
+  pearl_diver_default_destroy();
   logger_helper_release(logger_id);
 
   return RC_OK;
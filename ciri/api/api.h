@@ -46,6 +46,7 @@ retcode_t iota_api_init(iota_api_t *const api, core_t *const core);
 
 /**
  * Destroys an API
+ * Destroys the proof of work pool, the HTTP API must be stopped first
  *
  * @param api The API
  *
@@ -15,6 +15,7 @@ retcode_t iota_api_conf_init(iota_api_conf_t* const conf) {
   conf->http_port = DEFAULT_API_HTTP_PORT;
   conf->max_find_transactions = DEFAULT_MAX_FIND_TRANSACTIONS;
   conf->max_get_trytes = DEFAULT_MAX_GET_TRYTES;
+  conf->max_pow_jobs = DEFAULT_MAX_POW_JOBS;
 
   return RC_OK;
 }
@@ -15,6 +15,7 @@
 #define DEFAULT_API_HTTP_PORT 14265
 #define DEFAULT_MAX_FIND_TRANSACTIONS 100000;
 #define DEFAULT_MAX_GET_TRYTES 10000;
+#define DEFAULT_MAX_POW_JOBS 4
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,6 +33,9 @@ typedef struct iota_api_conf_s {
   // Maximum number of transactions that will be returned by the 'getTrytes' API
   // call
   size_t max_get_trytes;
+  // Maximum number of 'attachToTangle' proofs of work run concurrently, the
+  // others wait for one of them to end
+  size_t max_pow_jobs;
   // Path of the DB file
   char db_path[128];
 } iota_api_conf_t;
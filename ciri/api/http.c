@@ -600,6 +600,7 @@ retcode_t iota_api_http_start(iota_api_http_t *const api) {
 retcode_t iota_api_http_stop(iota_api_http_t *const api) {
   retcode_t ret = RC_OK;
   tangle_t *tangle;
+  error_res_t *error = NULL;
 
   if (api == NULL) {
     return RC_NULL_PARAM;
@@ -607,6 +608,8 @@ retcode_t iota_api_http_stop(iota_api_http_t *const api) {
     return RC_OK;
   }
 
+  // Stopping the daemon waits for the request being handled, which an 'attachToTangle' would hold until its end
+  iota_api_interrupt_attaching_to_tangle(api->api, &error);
   MHD_stop_daemon(api->state);
 
   for (tangle = (tangle_t *)utarray_back(api->db_connections); tangle != NULL;
@@ -132,6 +132,12 @@ static retcode_t set_conf_value(iota_ciri_conf_t* const ciri_conf, iota_consensu
     case CONF_P_SEND_MILESTONE:  // --p-send-milestone
       gossip_conf->p_send_milestone = atof(value);
       break;
+    case CONF_PROCESSOR_WORKERS:  // --processor-workers
+      gossip_conf->processor_workers = atoi(value);
+      break;
+    case CONF_RECENT_HASHES_SIZE:  // --recent-hashes-size
+      gossip_conf->recent_hashes_size = atoi(value);
+      break;
     case CONF_REQUESTER_QUEUE_SIZE:  // --requester-queue-size
       gossip_conf->requester_queue_size = atoi(value);
       break;
@@ -155,6 +161,9 @@ static retcode_t set_conf_value(iota_ciri_conf_t* const ciri_conf, iota_consensu
     case CONF_MAX_GET_TRYTES:  // --max-get-trytes
       api_conf->max_get_trytes = atoi(value);
       break;
+    case CONF_MAX_POW_JOBS:  // --max-pow-jobs
+      api_conf->max_pow_jobs = atoi(value);
+      break;
     case 'p':  // --http_port
       api_conf->http_port = atoi(value);
       break;
@@ -223,6 +232,12 @@ static retcode_t set_conf_value(iota_ciri_conf_t* const ciri_conf, iota_consensu
     case CONF_SNAPSHOT_TIMESTAMP:  // --snapshot-timestamp
       consensus_conf->snapshot_timestamp_sec = atoi(value);
       break;
+    case CONF_TIP_SELECTION_BATCH_WINDOW:  // --tip-selection-batch-window
+      consensus_conf->tip_selection_batch_window_ms = atoi(value);
+      break;
+    case CONF_TIP_SELECTION_CW_INCREMENTAL:  // --tip-selection-cw-incremental
+      ret = get_true_false(value, &consensus_conf->tip_selection_cw_incremental);
+      break;
 
     default:
       iota_usage();
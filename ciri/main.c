@@ -5,6 +5,7 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <inttypes.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -116,6 +117,9 @@ int main(int argc, char* argv[]) {
   }
 
   size_t count = 0;
+  processor_worker_stats_t processor_stats;
+  transaction_cache_stats_t cache_stats;
+  neighbor_t *neighbor = NULL;
   while (ciri_core.running) {
     if (iota_tangle_transaction_count(&tangle, &count) != RC_OK) {
       ret = EXIT_FAILURE;
@@ -126,6 +130,36 @@ int main(int argc, char* argv[]) {
              "to reply %d, count %d\n",
              processor_size(&ciri_core.node.processor), broadcaster_size(&ciri_core.node.broadcaster),
              requester_size(&ciri_core.node.transaction_requester), responder_size(&ciri_core.node.responder), count);
+    for (size_t i = 0; i < ciri_core.node.processor.workers_count; i++) {
+      if (processor_worker_stats(&ciri_core.node.processor, i, &processor_stats) == RC_OK) {
+        log_debug(logger_id,
+                  "Processor worker %zu: to process %zu, peak %zu, processed %" PRIu64 ", dropped %" PRIu64
+                  ", forward dropped %" PRIu64 ", store dropped %" PRIu64 ", rejected weight %" PRIu64
+                  ", timestamp %" PRIu64 ", value %" PRIu64 ", address %" PRIu64 "\n",
+                  i, processor_stats.queue_size, processor_stats.peak_queue_size, processor_stats.processed,
+                  processor_stats.dropped, processor_stats.forward_dropped, processor_stats.store_dropped,
+                  processor_stats.rejected[TRANSACTION_INVALID_WEIGHT],
+                  processor_stats.rejected[TRANSACTION_INVALID_TIMESTAMP],
+                  processor_stats.rejected[TRANSACTION_INVALID_VALUE],
+                  processor_stats.rejected[TRANSACTION_INVALID_ADDRESS]);
+      }
+    }
+    if (iota_tangle_cache_stats(&tangle, &cache_stats) == RC_OK) {
+      log_debug(logger_id,
+                "Transaction cache: size %zu/%zu, hits %" PRIu64 ", misses %" PRIu64 ", evictions %" PRIu64
+                ", invalidations %" PRIu64 "\n",
+                cache_stats.size, cache_stats.capacity, cache_stats.hits, cache_stats.misses, cache_stats.evictions,
+                cache_stats.invalidations);
+    }
+    rw_lock_handle_rdlock(&ciri_core.node.neighbors_lock);
+    LL_FOREACH(ciri_core.node.neighbors, neighbor) {
+      log_debug(logger_id, "Neighbor %s:%d: all %u, new %u, invalid %u, seen %u (%.2f%%), sent %u\n",
+                neighbor->endpoint.host, neighbor->endpoint.port, NEIGHBOR_COUNTER_LOAD(neighbor->nbr_all_tx),
+                NEIGHBOR_COUNTER_LOAD(neighbor->nbr_new_tx), NEIGHBOR_COUNTER_LOAD(neighbor->nbr_invalid_tx),
+                NEIGHBOR_COUNTER_LOAD(neighbor->nbr_seen_tx), 100.0 * neighbor_seen_tx_ratio(neighbor),
+                NEIGHBOR_COUNTER_LOAD(neighbor->nbr_sent_tx));
+    }
+    rw_lock_handle_unlock(&ciri_core.node.neighbors_lock);
     sleep(STATS_LOG_INTERVAL_S);
   }
 
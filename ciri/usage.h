@@ -21,6 +21,8 @@ typedef enum cli_arg_value_e {
   CONF_P_REPLY_RANDOM_TIP,
   CONF_P_SELECT_MILESTONE,
   CONF_P_SEND_MILESTONE,
+  CONF_PROCESSOR_WORKERS,
+  CONF_RECENT_HASHES_SIZE,
   CONF_REQUESTER_QUEUE_SIZE,
   CONF_TIPS_CACHE_SIZE,
   CONF_TIPS_SOLIDIFIER_ENABLED,
@@ -29,6 +31,7 @@ typedef enum cli_arg_value_e {
 
   CONF_MAX_FIND_TRANSACTIONS,
   CONF_MAX_GET_TRYTES,
+  CONF_MAX_POW_JOBS,
 
   // Consensus configuration
 
@@ -47,6 +50,8 @@ typedef enum cli_arg_value_e {
   CONF_SNAPSHOT_SIGNATURE_PUBKEY,
   CONF_SNAPSHOT_SIGNATURE_SKIP_VALIDATION,
   CONF_SNAPSHOT_TIMESTAMP,
+  CONF_TIP_SELECTION_BATCH_WINDOW,
+  CONF_TIP_SELECTION_CW_INCREMENTAL,
 
 } cli_arg_value_t;
 
@@ -98,6 +103,14 @@ static struct cli_argument_s {
      "Probability of sending a milestone transaction when the node looks for a "
      "random transaction to send to a neighbor. Value must be in [0,1].",
      REQUIRED_ARG},
+    {"processor-workers", CONF_PROCESSOR_WORKERS,
+     "Number of threads processing received packets, 0 for one per available "
+     "core up to 4.",
+     REQUIRED_ARG},
+    {"recent-hashes-size", CONF_RECENT_HASHES_SIZE,
+     "Number of recently seen transaction hashes remembered to discard duplicate "
+     "transactions before deserializing them.",
+     REQUIRED_ARG},
     {"requester-queue-size", CONF_REQUESTER_QUEUE_SIZE, "Size of the transaction requester queue.", REQUIRED_ARG},
     {"tcp-receiver-port", 't', "TCP listen port.", REQUIRED_ARG},
     {"tips-cache-size", CONF_TIPS_CACHE_SIZE,
@@ -119,6 +132,10 @@ static struct cli_argument_s {
      "Maximum number of transactions that will be returned by the 'getTrytes' "
      "API call.",
      REQUIRED_ARG},
+    {"max-pow-jobs", CONF_MAX_POW_JOBS,
+     "Maximum number of 'attachToTangle' proofs of work run concurrently, the "
+     "others wait for one of them to end.",
+     REQUIRED_ARG},
     {"http_port", 'p', "HTTP API listen port.", REQUIRED_ARG},
 
     // Consensus configuration
@@ -160,6 +177,14 @@ static struct cli_argument_s {
     {"snapshot-signature-skip-validation", CONF_SNAPSHOT_SIGNATURE_SKIP_VALIDATION,
      "Skip validation of snapshot signature. Must be \"true\" or \"false\".", REQUIRED_ARG},
     {"snapshot-timestamp", CONF_SNAPSHOT_TIMESTAMP, "Epoch time of the last snapshot.", REQUIRED_ARG},
+    {"tip-selection-batch-window", CONF_TIP_SELECTION_BATCH_WINDOW,
+     "Time in milliseconds during which concurrent tip selections of the same depth are coalesced to compute the "
+     "cumulative weights once and run their walks in parallel, 0 to disable.",
+     REQUIRED_ARG},
+    {"tip-selection-cw-incremental", CONF_TIP_SELECTION_CW_INCREMENTAL,
+     "Keep the cumulative weights across tip selections instead of computing them for each selection. An entry point "
+     "outside of the kept subtangle forces a full rebuild. Must be \"true\" or \"false\".",
+     REQUIRED_ARG},
     {NULL, 0, NULL, NO_ARG}};
 
 static char* short_options = "hl:d:n:t:u:p:";
@@ -5,158 +5,469 @@
  * Refer to the LICENSE file for licensing information
  */
 
-#include <stdio.h>
+#include <stdatomic.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 
-#include "common/crypto/curl-p/ptrit.h"
+#include "utlist.h"
+
+#include "common/crypto/curl-p/pearl_diver.h"
 #include "common/crypto/curl-p/search.h"
 #include "common/trinary/ptrit_incr.h"
 #include "common/trinary/trit_ptrit.h"
-#include "utils/handles/rw_lock.h"
+#include "utils/handles/cond.h"
+#include "utils/handles/lock.h"
 #include "utils/handles/thread.h"
 #include "utils/system.h"
 
-typedef enum { SEARCH_RUNNING, SEARCH_INTERRUPT, SEARCH_FINISHED } SearchStatus;
+typedef struct pearl_diver_task_s {
+  pearl_diver_job_t *job;
+  PCurl curl;
+  struct pearl_diver_task_s *prev;
+  struct pearl_diver_task_s *next;
+} pearl_diver_task_t;
 
-typedef struct {
-  unsigned short index;
+struct pearl_diver_job_s {
+  Curl *ctx;
   unsigned short offset;
   unsigned short end;
-  PCurl curl;
-  short (*test)(PCurl *, unsigned short);
+  pearl_diver_test_t test;
   unsigned short param;
-  SearchStatus *status;
-  rw_lock_handle_t *statusLock;
-} SearchInstance;
+  // Initial state shared by the tasks
+  PCurl curl;
+  // A PearlDiverStatus, only changed from PEARL_DIVER_RUNNING
+  atomic_int status;
+  // Guarded by the lock of the pearl diver
+  bool active;
+  bool done;
+  size_t tasks_count;
+  struct pearl_diver_job_s *prev;
+  struct pearl_diver_job_s *next;
+};
 
-void init_inst(SearchInstance *const inst, SearchStatus *const status, rw_lock_handle_t *const statusLock,
-               unsigned short const index, PCurl *const curl, unsigned short const offset, unsigned short const end,
-               unsigned short const param, short (*test)(PCurl *const, unsigned short const));
-void pt_start(thread_handle_t *const tid, SearchInstance *const inst, unsigned short const index);
-void *run_search_thread(void *const data);
-short do_pd_search(short (*test)(PCurl *const, unsigned short const), SearchInstance *const inst, PCurl *const copy);
+struct pearl_diver_s {
+  bool running;
+  size_t workers_count;
+  thread_handle_t *workers;
+  size_t max_jobs;
+  size_t active_jobs;
+  atomic_uint_fast64_t hashes;
+  pearl_diver_job_t *jobs;
+  // Tasks of the active jobs, run in turn
+  pearl_diver_task_t *tasks;
+  // Jobs waiting for an active job to end
+  pearl_diver_job_t *pending_jobs;
+  // Threads in pearl_diver_wait, the pearl diver is not freed before they leave it
+  size_t waiters;
+  lock_handle_t lock;
+  cond_handle_t tasks_cond;
+  cond_handle_t done_cond;
+};
 
-PearlDiverStatus pd_search(Curl *const ctx, unsigned short const offset, unsigned short const end,
-                           short (*test)(PCurl *const, unsigned short const), unsigned short const param) {
-  unsigned short found_thread = 0, n_procs = system_cpu_available();
+static _Atomic(pearl_diver_t *) default_pd = NULL;
 
-  intptr_t found_index = -1;
-  SearchStatus status = SEARCH_RUNNING;
-  rw_lock_handle_t statusLock;
+/*
+ * Private functions
+ */
 
-  if (rw_lock_handle_init(&statusLock)) {
-    return PEARL_DIVER_ERROR;
+// Ends a running job, returns false if it had already ended
+static bool pearl_diver_job_set_status(pearl_diver_job_t *const job, PearlDiverStatus const status) {
+  int expected = PEARL_DIVER_RUNNING;
+
+  return atomic_compare_exchange_strong(&job->status, &expected, status);
+}
+
+static void pearl_diver_activate(pearl_diver_t *const pd, pearl_diver_job_t *const job);
+
+// Called with the lock held
+static void pearl_diver_complete(pearl_diver_t *const pd, pearl_diver_job_t *const job) {
+  pearl_diver_job_t *next = NULL;
+
+  job->done = true;
+  if (job->active) {
+    DL_DELETE(pd->jobs, job);
+    pd->active_jobs--;
+  }
+  while (pd->running && pd->pending_jobs && pd->active_jobs < pd->max_jobs) {
+    next = pd->pending_jobs;
+    DL_DELETE(pd->pending_jobs, next);
+    pearl_diver_activate(pd, next);
   }
+  cond_handle_broadcast(&pd->done_cond);
+}
+
+// Called with the lock held
+static void pearl_diver_activate(pearl_diver_t *const pd, pearl_diver_job_t *const job) {
+  pearl_diver_task_t *task = NULL;
 
-  SearchInstance *inst = (SearchInstance *)calloc(n_procs, sizeof(SearchInstance));
-  thread_handle_t *tid = (thread_handle_t *)calloc(n_procs, sizeof(thread_handle_t));
+  job->active = true;
+  DL_APPEND(pd->jobs, job);
+  pd->active_jobs++;
 
-  {
-    PCurl curl;
-    ptrit_curl_init(&curl, CURL_P_81);
-    trits_to_ptrits_fill(ctx->state, curl.state, STATE_LENGTH);
-    ptrit_offset(&curl.state[offset], 4);
-    curl.type = ctx->type;
-    init_inst(inst, &status, &statusLock, n_procs, &curl, offset + 4, end, param, test);
+  for (size_t i = 0; i < pd->workers_count; i++) {
+    if ((task = (pearl_diver_task_t *)malloc(sizeof(pearl_diver_task_t))) == NULL) {
+      break;
+    }
+    task->job = job;
+    memcpy(&task->curl, &job->curl, sizeof(PCurl));
+    // Gives each task its own value of the partition trits, never touched by the search itself
+    for (size_t j = 0; j < i; j++) {
+      ptrit_increment(task->curl.state, job->offset + 4, job->offset + 4 + PEARL_DIVER_PARTITION_TRITS);
+    }
+    DL_APPEND(pd->tasks, task);
+    job->tasks_count++;
   }
 
-  pt_start(tid, inst, n_procs - 1);
+  if (job->tasks_count == 0) {
+    pearl_diver_job_set_status(job, PEARL_DIVER_ERROR);
+    pearl_diver_complete(pd, job);
+  } else {
+    cond_handle_broadcast(&pd->tasks_cond);
+  }
+}
 
-  for (int i = n_procs; --i >= 0;) {
-    if (tid[i] == 0) continue;
+// Searches a slice of the candidates of a task, returns the status of its job
+// Candidates are transformed in batches as wide as the CPU allows
+static PearlDiverStatus do_pd_search(pearl_diver_t *const pd, pearl_diver_task_t *const task, PCurl *const candidates,
+                                     PCurl *const copies) {
+  pearl_diver_job_t *job = task->job;
+  size_t const width = ptrit_batch_width();
+  size_t const increment_offset = job->offset + 4 + PEARL_DIVER_PARTITION_TRITS;
+  size_t searched = 0, unchecked = 0, k = 0;
+  short index = -1;
 
-    if (found_index == -1) {
-      thread_handle_join(tid[i], (void **)&found_index);
+  while (searched < PEARL_DIVER_SLICE_ITERATIONS) {
+    for (k = 0; k < width; k++) {
+      memcpy(&candidates[k], &task->curl, sizeof(PCurl));
+      ptrit_increment(task->curl.state, increment_offset, HASH_LENGTH_TRIT);
+    }
+    memcpy(copies, candidates, width * sizeof(PCurl));
+    ptrit_transform_batch(copies, width);
+    searched += width;
 
-      if (found_index != -1) {
-        found_thread = i;
+    for (k = 0; k < width; k++) {
+      if ((index = job->test(&copies[k], job->param)) >= 0) {
+        break;
+      }
+    }
+
+    if (index >= 0) {
+      // The nonce is written before the job can complete, see pearl_diver_worker
+      if (pearl_diver_job_set_status(job, PEARL_DIVER_SUCCESS)) {
+        ptrits_to_trits(&candidates[k].state[job->offset], &job->ctx->state[job->offset], index,
+                        job->end - job->offset);
+      }
+      break;
+    }
+
+    if ((unchecked += width) >= PEARL_DIVER_STOP_CHECK_STRIDE) {
+      unchecked = 0;
+      if (atomic_load_explicit(&job->status, memory_order_relaxed) != PEARL_DIVER_RUNNING) {
+        break;
       }
-    } else {
-      thread_handle_join(tid[i], NULL);
     }
   }
 
-  switch (found_index) {
-    case -1:
-      free(inst);
-      free(tid);
+  atomic_fetch_add_explicit(&pd->hashes, searched * sizeof(ptrit_s) * 8, memory_order_relaxed);
+
+  return (PearlDiverStatus)atomic_load(&job->status);
+}
+
+static void *pearl_diver_worker(void *const arg) {
+  pearl_diver_t *pd = (pearl_diver_t *)arg;
+  pearl_diver_task_t *task = NULL;
+  pearl_diver_job_t *job = NULL;
+  PearlDiverStatus status = PEARL_DIVER_RUNNING;
+  PCurl *candidates = (PCurl *)malloc(PTRIT_BATCH_MAX * sizeof(PCurl));
+  PCurl *copies = (PCurl *)malloc(PTRIT_BATCH_MAX * sizeof(PCurl));
 
-      return PEARL_DIVER_ERROR;
+  if (candidates == NULL || copies == NULL) {
+    free(candidates);
+    free(copies);
+    return NULL;
   }
 
-  rw_lock_handle_destroy(&statusLock);
+  lock_handle_lock(&pd->lock);
+  while (true) {
+    while (pd->running && pd->tasks == NULL) {
+      cond_handle_wait(&pd->tasks_cond, &pd->lock);
+    }
+    // Tasks left after a stop belong to interrupted jobs and end at once
+    if ((task = pd->tasks) == NULL) {
+      break;
+    }
+    DL_DELETE(pd->tasks, task);
+    lock_handle_unlock(&pd->lock);
+
+    status = do_pd_search(pd, task, candidates, copies);
 
-  ptrits_to_trits(&inst[found_thread].curl.state[offset], &ctx->state[offset], found_index, end - offset);
+    lock_handle_lock(&pd->lock);
+    if (status == PEARL_DIVER_RUNNING) {
+      DL_APPEND(pd->tasks, task);
+      continue;
+    }
+    job = task->job;
+    free(task);
+    if (--job->tasks_count == 0) {
+      pearl_diver_complete(pd, job);
+    }
+  }
+  lock_handle_unlock(&pd->lock);
 
-  free(inst);
-  free(tid);
+  free(candidates);
+  free(copies);
 
-  return PEARL_DIVER_SUCCESS;
+  return NULL;
 }
 
-void init_inst(SearchInstance *const inst, SearchStatus *const status, rw_lock_handle_t *const statusLock,
-               unsigned short const index, PCurl *const curl, unsigned short const offset, unsigned short const end,
-               unsigned short const param, short (*test)(PCurl *const, unsigned short const)) {
-  if (index == 0) {
-    return;
+/*
+ * Public functions
+ */
+
+retcode_t pearl_diver_create(pearl_diver_t **const pd, size_t workers_count, size_t const max_jobs) {
+  pearl_diver_t *diver = NULL;
+
+  if (pd == NULL || max_jobs == 0) {
+    return RC_NULL_PARAM;
+  }
+
+  if (workers_count == 0) {
+    workers_count = system_cpu_available();
   }
-  *inst = (SearchInstance){.index = index - 1,
-                           .offset = offset,
-                           .end = end,
-                           .param = param,
-                           .status = status,
-                           .statusLock = statusLock,
-                           .test = test};
-  memcpy(&(inst->curl), curl, sizeof(PCurl));
-  init_inst(&inst[1], status, statusLock, index - 1, curl, offset, end, param, test);
+
+  if ((diver = (pearl_diver_t *)calloc(1, sizeof(pearl_diver_t))) == NULL) {
+    return RC_OOM;
+  }
+  if ((diver->workers = (thread_handle_t *)calloc(workers_count, sizeof(thread_handle_t))) == NULL) {
+    free(diver);
+    return RC_OOM;
+  }
+
+  diver->running = true;
+  diver->max_jobs = max_jobs;
+  atomic_init(&diver->hashes, 0);
+  lock_handle_init(&diver->lock);
+  cond_handle_init(&diver->tasks_cond);
+  cond_handle_init(&diver->done_cond);
+
+  for (size_t i = 0; i < workers_count; i++) {
+    if (thread_handle_create(&diver->workers[diver->workers_count], pearl_diver_worker, diver) != 0) {
+      break;
+    }
+    diver->workers_count++;
+  }
+
+  if (diver->workers_count == 0) {
+    pearl_diver_destroy(&diver);
+    return RC_FAILED_THREAD_SPAWN;
+  }
+
+  *pd = diver;
+
+  return RC_OK;
 }
 
-void pt_start(thread_handle_t *const tid, SearchInstance *const inst, unsigned short const index) {
-  if (thread_handle_create(&tid[index], run_search_thread, ((void *)&inst[index]))) {
-    tid[index] = 0;
+retcode_t pearl_diver_destroy(pearl_diver_t **const pd) {
+  pearl_diver_t *diver = NULL;
+
+  if (pd == NULL || *pd == NULL) {
+    return RC_NULL_PARAM;
   }
-  if (index == 0) {
-    return;
+  diver = *pd;
+
+  pearl_diver_cancel_all(diver);
+
+  lock_handle_lock(&diver->lock);
+  diver->running = false;
+  cond_handle_broadcast(&diver->tasks_cond);
+  lock_handle_unlock(&diver->lock);
+
+  for (size_t i = 0; i < diver->workers_count; i++) {
+    thread_handle_join(diver->workers[i], NULL);
+  }
+
+  // All jobs are done once the workers are joined, their waiters still have to wake up
+  lock_handle_lock(&diver->lock);
+  while (diver->waiters > 0) {
+    cond_handle_wait(&diver->done_cond, &diver->lock);
   }
-  pt_start(tid, inst, index - 1);
+  lock_handle_unlock(&diver->lock);
+
+  cond_handle_destroy(&diver->done_cond);
+  cond_handle_destroy(&diver->tasks_cond);
+  lock_handle_destroy(&diver->lock);
+  free(diver->workers);
+  free(diver);
+  *pd = NULL;
+
+  return RC_OK;
 }
 
-void *run_search_thread(void *const data) {
-  unsigned short i;
-  PCurl copy;
+pearl_diver_t *pearl_diver_default() {
+  pearl_diver_t *pd = atomic_load(&default_pd);
+  pearl_diver_t *expected = NULL;
 
-  SearchInstance *inst = ((SearchInstance *)data);
+  if (pd != NULL) {
+    return pd;
+  }
 
-  for (i = 0; i < inst->index; i++) {
-    ptrit_increment(inst->curl.state, inst->offset, HASH_LENGTH_TRIT);
+  if (pearl_diver_create(&pd, 0, PEARL_DIVER_DEFAULT_MAX_JOBS) != RC_OK) {
+    return NULL;
+  }
+  // Another thread may have created it concurrently
+  if (!atomic_compare_exchange_strong(&default_pd, &expected, pd)) {
+    pearl_diver_destroy(&pd);
+    return expected;
   }
 
-  intptr_t ret = do_pd_search(inst->test, inst, &copy);
-  return (void *)ret;
+  return pd;
 }
 
-short do_pd_search(short (*test)(PCurl *const, unsigned short const), SearchInstance *const inst, PCurl *const copy) {
-  short index;
+retcode_t pearl_diver_default_destroy() {
+  pearl_diver_t *pd = atomic_exchange(&default_pd, NULL);
 
-  SearchStatus status = SEARCH_RUNNING;
-  while (status == SEARCH_RUNNING) {
-    memcpy(copy, &inst->curl, sizeof(PCurl));
-    ptrit_transform(copy);
-    index = test(copy, inst->param);
-    if (index >= 0) {
-      rw_lock_handle_wrlock(inst->statusLock);
-      *inst->status = SEARCH_FINISHED;
-      rw_lock_handle_unlock(inst->statusLock);
+  if (pd == NULL) {
+    return RC_OK;
+  }
+
+  return pearl_diver_destroy(&pd);
+}
+
+retcode_t pearl_diver_set_max_jobs(pearl_diver_t *const pd, size_t const max_jobs) {
+  pearl_diver_job_t *job = NULL;
+
+  if (pd == NULL || max_jobs == 0) {
+    return RC_NULL_PARAM;
+  }
+
+  lock_handle_lock(&pd->lock);
+  pd->max_jobs = max_jobs;
+  while (pd->running && pd->pending_jobs && pd->active_jobs < pd->max_jobs) {
+    job = pd->pending_jobs;
+    DL_DELETE(pd->pending_jobs, job);
+    pearl_diver_activate(pd, job);
+  }
+  lock_handle_unlock(&pd->lock);
+
+  return RC_OK;
+}
+
+retcode_t pearl_diver_submit(pearl_diver_t *const pd, Curl *const ctx, unsigned short const offset,
+                             unsigned short const end, pearl_diver_test_t const test, unsigned short const param,
+                             pearl_diver_job_t **const job) {
+  pearl_diver_job_t *new_job = NULL;
+
+  if (pd == NULL || ctx == NULL || test == NULL || job == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  if ((new_job = (pearl_diver_job_t *)calloc(1, sizeof(pearl_diver_job_t))) == NULL) {
+    return RC_OOM;
+  }
+  new_job->ctx = ctx;
+  new_job->offset = offset;
+  new_job->end = end;
+  new_job->test = test;
+  new_job->param = param;
+  atomic_init(&new_job->status, PEARL_DIVER_RUNNING);
+
+  ptrit_curl_init(&new_job->curl, CURL_P_81);
+  trits_to_ptrits_fill(ctx->state, new_job->curl.state, STATE_LENGTH);
+  ptrit_offset(&new_job->curl.state[offset], 4);
+  new_job->curl.type = ctx->type;
+
+  lock_handle_lock(&pd->lock);
+  if (!pd->running) {
+    atomic_store(&new_job->status, PEARL_DIVER_INTERRUPTED);
+    new_job->done = true;
+  } else if (pd->active_jobs < pd->max_jobs) {
+    pearl_diver_activate(pd, new_job);
+  } else {
+    DL_APPEND(pd->pending_jobs, new_job);
+  }
+  lock_handle_unlock(&pd->lock);
+
+  *job = new_job;
+
+  return RC_OK;
+}
+
+PearlDiverStatus pearl_diver_wait(pearl_diver_t *const pd, pearl_diver_job_t *const job) {
+  PearlDiverStatus status = PEARL_DIVER_ERROR;
 
-      return index;
+  if (pd == NULL || job == NULL) {
+    return PEARL_DIVER_ERROR;
+  }
+
+  lock_handle_lock(&pd->lock);
+  pd->waiters++;
+  while (!job->done) {
+    cond_handle_wait(&pd->done_cond, &pd->lock);
+  }
+  if (--pd->waiters == 0 && !pd->running) {
+    cond_handle_broadcast(&pd->done_cond);
+  }
+  lock_handle_unlock(&pd->lock);
+
+  status = (PearlDiverStatus)atomic_load(&job->status);
+  free(job);
+
+  return status;
+}
+
+void pearl_diver_cancel(pearl_diver_t *const pd, pearl_diver_job_t *const job) {
+  if (pd == NULL || job == NULL) {
+    return;
+  }
+
+  lock_handle_lock(&pd->lock);
+  if (!job->done) {
+    pearl_diver_job_set_status(job, PEARL_DIVER_INTERRUPTED);
+    if (!job->active) {
+      DL_DELETE(pd->pending_jobs, job);
+      pearl_diver_complete(pd, job);
     }
-    ptrit_increment(inst->curl.state, inst->offset + 1, HASH_LENGTH_TRIT);
+  }
+  lock_handle_unlock(&pd->lock);
+}
+
+void pearl_diver_cancel_all(pearl_diver_t *const pd) {
+  pearl_diver_job_t *job = NULL;
+  pearl_diver_job_t *tmp = NULL;
 
-    rw_lock_handle_rdlock(inst->statusLock);
-    status = *inst->status;
-    rw_lock_handle_unlock(inst->statusLock);
+  if (pd == NULL) {
+    return;
+  }
+
+  lock_handle_lock(&pd->lock);
+  // Active jobs end when their tasks notice the interruption
+  DL_FOREACH(pd->jobs, job) { pearl_diver_job_set_status(job, PEARL_DIVER_INTERRUPTED); }
+  DL_FOREACH_SAFE(pd->pending_jobs, job, tmp) {
+    DL_DELETE(pd->pending_jobs, job);
+    pearl_diver_job_set_status(job, PEARL_DIVER_INTERRUPTED);
+    job->done = true;
+  }
+  cond_handle_broadcast(&pd->done_cond);
+  lock_handle_unlock(&pd->lock);
+}
+
+uint64_t pearl_diver_hashes(pearl_diver_t *const pd) {
+  if (pd == NULL) {
+    return 0;
   }
-  return -1;
-  // return do_pd_search(test, inst, copy);
+
+  return atomic_load_explicit(&pd->hashes, memory_order_relaxed);
+}
+
+PearlDiverStatus pd_search(Curl *const ctx, unsigned short const offset, unsigned short const end,
+                           short (*test)(PCurl *const, unsigned short const), unsigned short const param) {
+  pearl_diver_t *pd = pearl_diver_default();
+  pearl_diver_job_t *job = NULL;
+
+  if (pd == NULL || pearl_diver_submit(pd, ctx, offset, end, test, param, &job) != RC_OK) {
+    return PEARL_DIVER_ERROR;
+  }
+
+  return pearl_diver_wait(pd, job);
 }
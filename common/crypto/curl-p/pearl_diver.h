@@ -8,6 +8,155 @@
 #ifndef __COMMON_CURL_P_PEARL_DIVER_H_
 #define __COMMON_CURL_P_PEARL_DIVER_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common/crypto/curl-p/ptrit.h"
+#include "common/crypto/curl-p/trit.h"
+#include "common/errors.h"
+
 typedef enum { PEARL_DIVER_SUCCESS, PEARL_DIVER_RUNNING, PEARL_DIVER_INTERRUPTED, PEARL_DIVER_ERROR } PearlDiverStatus;
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of candidate states a worker searches before yielding to the next job
+#ifndef PEARL_DIVER_SLICE_ITERATIONS
+#define PEARL_DIVER_SLICE_ITERATIONS 1024
+#endif
+
+// Number of candidate states searched between two checks of the end of a search
+#ifndef PEARL_DIVER_STOP_CHECK_STRIDE
+#define PEARL_DIVER_STOP_CHECK_STRIDE 16
+#endif
+
+// Number of nonce trits, after the 4 trits telling lanes apart, splitting the
+// nonce space between the workers; supports up to 3^8 workers
+#define PEARL_DIVER_PARTITION_TRITS 8
+
+// Maximum number of searches run concurrently by the default pearl diver
+#ifndef PEARL_DIVER_DEFAULT_MAX_JOBS
+#define PEARL_DIVER_DEFAULT_MAX_JOBS 4
+#endif
+
+typedef short (*pearl_diver_test_t)(PCurl *const, unsigned short const);
+
+/**
+ * A pool of long-lived search threads
+ *
+ * Each submitted search is split into one task per worker, each searching its
+ * own partition of the nonce space; tasks are run in slices of
+ * PEARL_DIVER_SLICE_ITERATIONS candidates and requeued behind the tasks of the
+ * other searches so that concurrent searches share the workers fairly. At most
+ * max_jobs searches are run at once, the others waiting in
+ * submission order.
+ */
+typedef struct pearl_diver_s pearl_diver_t;
+typedef struct pearl_diver_job_s pearl_diver_job_t;
+
+/**
+ * Creates a pearl diver and starts its workers
+ *
+ * @param pd The pearl diver
+ * @param workers_count The number of workers, 0 for one per available CPU
+ * @param max_jobs The maximum number of searches run concurrently
+ *
+ * @return a status code
+ */
+retcode_t pearl_diver_create(pearl_diver_t **const pd, size_t workers_count, size_t const max_jobs);
+
+/**
+ * Interrupts all searches, stops the workers and destroys a pearl diver
+ * Threads waiting for a search are woken up before the pearl diver is freed;
+ * no search must be submitted or waited for once it is called
+ *
+ * @param pd The pearl diver
+ *
+ * @return a status code
+ */
+retcode_t pearl_diver_destroy(pearl_diver_t **const pd);
+
+/**
+ * Gets the process-wide pearl diver used by pd_search, creating it if needed
+ *
+ * @return the default pearl diver or NULL if it could not be created
+ */
+pearl_diver_t *pearl_diver_default();
+
+/**
+ * Destroys the process-wide pearl diver, a later pd_search creates a new one
+ *
+ * @return a status code
+ */
+retcode_t pearl_diver_default_destroy();
+
+/**
+ * Sets the maximum number of searches run concurrently, waiting searches are
+ * started if the limit is raised
+ *
+ * @param pd The pearl diver
+ * @param max_jobs The maximum number of searches, at least 1
+ *
+ * @return a status code
+ */
+retcode_t pearl_diver_set_max_jobs(pearl_diver_t *const pd, size_t const max_jobs);
+
+/**
+ * Gets the number of nonces tested so far, a ptrit state testing 64 nonces
+ *
+ * @param pd The pearl diver
+ *
+ * @return the number of nonces
+ */
+uint64_t pearl_diver_hashes(pearl_diver_t *const pd);
+
+/**
+ * Submits a search for a nonce in [offset, end) of the state of a curl
+ * The curl must outlive the search, its state is updated with the nonce found
+ *
+ * @param pd The pearl diver
+ * @param ctx The curl
+ * @param offset The offset of the nonce
+ * @param end The end of the nonce
+ * @param test The function testing the transformed states
+ * @param param The parameter of the test
+ * @param job The search, to be waited for with pearl_diver_wait
+ *
+ * @return a status code
+ */
+retcode_t pearl_diver_submit(pearl_diver_t *const pd, Curl *const ctx, unsigned short const offset,
+                             unsigned short const end, pearl_diver_test_t const test, unsigned short const param,
+                             pearl_diver_job_t **const job);
+
+/**
+ * Waits for the end of a search and releases it
+ *
+ * @param pd The pearl diver
+ * @param job The search
+ *
+ * @return PEARL_DIVER_SUCCESS if a nonce was found, PEARL_DIVER_INTERRUPTED if
+ * the search was cancelled, PEARL_DIVER_ERROR otherwise
+ */
+PearlDiverStatus pearl_diver_wait(pearl_diver_t *const pd, pearl_diver_job_t *const job);
+
+/**
+ * Cancels a search, its waiter returns PEARL_DIVER_INTERRUPTED
+ *
+ * @param pd The pearl diver
+ * @param job The search
+ */
+void pearl_diver_cancel(pearl_diver_t *const pd, pearl_diver_job_t *const job);
+
+/**
+ * Cancels all running and waiting searches
+ *
+ * @param pd The pearl diver
+ */
+void pearl_diver_cancel_all(pearl_diver_t *const pd);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
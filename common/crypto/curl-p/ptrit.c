@@ -8,6 +8,12 @@
 #include "common/crypto/curl-p/ptrit.h"
 #include "utils/forced_inline.h"
 
+// Wide variants are compiled for their instruction set and selected at runtime
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define PTRIT_X86_SIMD
+#include <immintrin.h>
+#endif
+
 static FORCED_INLINE void ptrit_sbox(ptrit_t *const c, ptrit_t const *const s) {
   ptrit_s alpha, beta, delta;
   size_t i = 0;
@@ -22,6 +28,92 @@ static FORCED_INLINE void ptrit_sbox(ptrit_t *const c, ptrit_t const *const s) {
   }
 }
 
+#ifdef PTRIT_X86_SIMD
+
+// Transforms 4 states, lane k of a 256 bits word holding the ptrit of ctxs[k]
+__attribute__((target("avx2"))) static void ptrit_transform_x4(PCurl *const ctxs) {
+  __m256i low[2][STATE_LENGTH], high[2][STATE_LENGTH];
+  __m256i const ones = _mm256_set1_epi64x(-1);
+  __m256i *src_low = low[0], *src_high = high[0], *dst_low = low[1], *dst_high = high[1], *tmp = NULL;
+  __m256i alpha, beta, delta;
+  uint64_t lanes[2][4];
+  size_t round = 0, i = 0, k = 0;
+
+  for (i = 0; i < STATE_LENGTH; ++i) {
+    for (k = 0; k < 4; ++k) {
+      lanes[0][k] = ctxs[k].state[i].low;
+      lanes[1][k] = ctxs[k].state[i].high;
+    }
+    src_low[i] = _mm256_loadu_si256((__m256i const *)lanes[0]);
+    src_high[i] = _mm256_loadu_si256((__m256i const *)lanes[1]);
+  }
+
+  for (round = 0; round < ctxs->type; ++round) {
+    for (i = 0; i < STATE_LENGTH; ++i) {
+      alpha = src_low[CURL_INDEX[i]];
+      beta = src_high[CURL_INDEX[i]];
+      delta = _mm256_and_si256(alpha, _mm256_xor_si256(src_low[CURL_INDEX[i + 1]], beta));
+
+      dst_low[i] = _mm256_xor_si256(delta, ones);
+      dst_high[i] = _mm256_or_si256(_mm256_xor_si256(alpha, src_high[CURL_INDEX[i + 1]]), delta);
+    }
+    tmp = src_low, src_low = dst_low, dst_low = tmp;
+    tmp = src_high, src_high = dst_high, dst_high = tmp;
+  }
+
+  for (i = 0; i < STATE_LENGTH; ++i) {
+    _mm256_storeu_si256((__m256i *)lanes[0], src_low[i]);
+    _mm256_storeu_si256((__m256i *)lanes[1], src_high[i]);
+    for (k = 0; k < 4; ++k) {
+      ctxs[k].state[i].low = lanes[0][k];
+      ctxs[k].state[i].high = lanes[1][k];
+    }
+  }
+}
+
+// Transforms 8 states, lane k of a 512 bits word holding the ptrit of ctxs[k]
+__attribute__((target("avx512f"))) static void ptrit_transform_x8(PCurl *const ctxs) {
+  __m512i low[2][STATE_LENGTH], high[2][STATE_LENGTH];
+  __m512i const ones = _mm512_set1_epi64(-1);
+  __m512i *src_low = low[0], *src_high = high[0], *dst_low = low[1], *dst_high = high[1], *tmp = NULL;
+  __m512i alpha, beta, delta;
+  uint64_t lanes[2][8];
+  size_t round = 0, i = 0, k = 0;
+
+  for (i = 0; i < STATE_LENGTH; ++i) {
+    for (k = 0; k < 8; ++k) {
+      lanes[0][k] = ctxs[k].state[i].low;
+      lanes[1][k] = ctxs[k].state[i].high;
+    }
+    src_low[i] = _mm512_loadu_si512(lanes[0]);
+    src_high[i] = _mm512_loadu_si512(lanes[1]);
+  }
+
+  for (round = 0; round < ctxs->type; ++round) {
+    for (i = 0; i < STATE_LENGTH; ++i) {
+      alpha = src_low[CURL_INDEX[i]];
+      beta = src_high[CURL_INDEX[i]];
+      delta = _mm512_and_si512(alpha, _mm512_xor_si512(src_low[CURL_INDEX[i + 1]], beta));
+
+      dst_low[i] = _mm512_xor_si512(delta, ones);
+      dst_high[i] = _mm512_or_si512(_mm512_xor_si512(alpha, src_high[CURL_INDEX[i + 1]]), delta);
+    }
+    tmp = src_low, src_low = dst_low, dst_low = tmp;
+    tmp = src_high, src_high = dst_high, dst_high = tmp;
+  }
+
+  for (i = 0; i < STATE_LENGTH; ++i) {
+    _mm512_storeu_si512(lanes[0], src_low[i]);
+    _mm512_storeu_si512(lanes[1], src_high[i]);
+    for (k = 0; k < 8; ++k) {
+      ctxs[k].state[i].low = lanes[0][k];
+      ctxs[k].state[i].high = lanes[1][k];
+    }
+  }
+}
+
+#endif
+
 void ptrit_curl_init(PCurl *const ctx, CurlType type) {
   ptrit_curl_reset(ctx);
   ctx->type = type;
@@ -73,3 +165,60 @@ void ptrit_transform(PCurl *const ctx) {
 void ptrit_curl_reset(PCurl *const ctx) {
   memset_safe(ctx->state, sizeof(ptrit_t) * STATE_LENGTH, HIGH_BITS, sizeof(ptrit_t) * STATE_LENGTH);
 }
+
+size_t ptrit_batch_width() {
+#ifdef PTRIT_X86_SIMD
+  if (__builtin_cpu_supports("avx512f")) {
+    return 8;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return 4;
+  }
+#endif
+  return 1;
+}
+
+void ptrit_transform_batch(PCurl *const ctxs, size_t const count) {
+  size_t i = 0;
+
+#ifdef PTRIT_X86_SIMD
+  if (__builtin_cpu_supports("avx512f")) {
+    for (; i + 8 <= count; i += 8) {
+      ptrit_transform_x8(&ctxs[i]);
+    }
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    for (; i + 4 <= count; i += 4) {
+      ptrit_transform_x4(&ctxs[i]);
+    }
+  }
+#endif
+
+  for (; i < count; ++i) {
+    ptrit_transform(&ctxs[i]);
+  }
+}
+
+void ptrit_curl_absorb_batch(PCurl *const ctxs, size_t const count, ptrit_t const *const trits, size_t length) {
+  size_t offset = 0, chunk = 0, k = 0;
+
+  for (; offset < length; offset += HASH_LENGTH_TRIT) {
+    chunk = length - offset < HASH_LENGTH_TRIT ? length - offset : HASH_LENGTH_TRIT;
+    for (k = 0; k < count; ++k) {
+      memcpy(ctxs[k].state, trits + k * length + offset, chunk * sizeof(ptrit_t));
+    }
+    ptrit_transform_batch(ctxs, count);
+  }
+}
+
+void ptrit_curl_squeeze_batch(PCurl *const ctxs, size_t const count, ptrit_t *const trits, size_t length) {
+  size_t offset = 0, chunk = 0, k = 0;
+
+  for (; offset < length; offset += HASH_LENGTH_TRIT) {
+    chunk = length - offset < HASH_LENGTH_TRIT ? length - offset : HASH_LENGTH_TRIT;
+    for (k = 0; k < count; ++k) {
+      memcpy(trits + k * length + offset, ctxs[k].state, chunk * sizeof(ptrit_t));
+    }
+    ptrit_transform_batch(ctxs, count);
+  }
+}
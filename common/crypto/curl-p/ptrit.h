@@ -16,6 +16,9 @@
 extern "C" {
 #endif
 
+// Maximum number of states transformed at once by ptrit_transform_batch
+#define PTRIT_BATCH_MAX 8
+
 typedef struct {
   ptrit_t state[STATE_LENGTH];
   CurlType type;
@@ -27,6 +30,43 @@ void ptrit_curl_squeeze(PCurl* const ctx, ptrit_t* const trits, size_t length);
 void ptrit_transform(PCurl* const ctx);
 void ptrit_curl_reset(PCurl* const ctx);
 
+/**
+ * Gets the number of states the CPU transforms at once: 8 with AVX-512, 4 with
+ * AVX2 and 1 otherwise
+ *
+ * @return the batch width
+ */
+size_t ptrit_batch_width();
+
+/**
+ * Transforms states of the same type, several at a time on CPUs with wide
+ * vector registers, with the same result as ptrit_transform on each of them
+ *
+ * @param ctxs The states
+ * @param count The number of states
+ */
+void ptrit_transform_batch(PCurl* const ctxs, size_t const count);
+
+/**
+ * Absorbs a trits array in each state of a batch
+ *
+ * @param ctxs The states
+ * @param count The number of states
+ * @param trits The count consecutive trits arrays
+ * @param length The length of each trits array
+ */
+void ptrit_curl_absorb_batch(PCurl* const ctxs, size_t const count, ptrit_t const* const trits, size_t length);
+
+/**
+ * Squeezes a trits array out of each state of a batch
+ *
+ * @param ctxs The states
+ * @param count The number of states
+ * @param trits The count consecutive trits arrays
+ * @param length The length of each trits array
+ */
+void ptrit_curl_squeeze_batch(PCurl* const ctxs, size_t const count, ptrit_t* const trits, size_t length);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/*
+ * Measures the number of nonces the pearl diver tests per second, with one
+ * worker and with as many workers as available CPUs, by running a search that
+ * can not succeed for a fixed duration.
+ *
+ * Usage: bench_pearl_diver [milliseconds] (defaults to 3000)
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common/crypto/curl-p/pearl_diver.h"
+#include "utils/system.h"
+#include "utils/time.h"
+
+// Weight no transaction reaches so that the search runs until cancelled
+#define BENCH_MWM HASH_LENGTH_TRIT
+#define BENCH_DEFAULT_DURATION_MS 3000
+// Same nonce as transactions proofs of work
+#define BENCH_NONCE_TRITS 81
+
+static short test_mwm(PCurl *const curl, unsigned short const mwm) {
+  ptrit_s probe = HIGH_BITS;
+
+  for (unsigned short i = HASH_LENGTH_TRIT; i-- > HASH_LENGTH_TRIT - mwm && probe != 0;) {
+    probe &= ~(curl->state[i].low ^ curl->state[i].high);
+  }
+  if (probe == 0) {
+    return -1;
+  }
+  return __builtin_ctzll(probe);
+}
+
+static int bench_workers(size_t const workers_count, uint64_t const duration_ms) {
+  pearl_diver_t *pd = NULL;
+  pearl_diver_job_t *job = NULL;
+  trit_t trits[HASH_LENGTH_TRIT] = {0};
+  Curl curl;
+  uint64_t start = 0, hashes = 0;
+  double elapsed = 0;
+
+  // The null state is left unchanged by the transform and would match at once
+  for (size_t i = 0; i < HASH_LENGTH_TRIT; i++) {
+    trits[i] = (trit_t)(i % 3) - 1;
+  }
+  curl.type = CURL_P_81;
+  curl_init(&curl);
+  curl_absorb(&curl, trits, HASH_LENGTH_TRIT);
+
+  if (pearl_diver_create(&pd, workers_count, 1) != RC_OK) {
+    fprintf(stderr, "Creating the pearl diver failed\n");
+    return EXIT_FAILURE;
+  }
+
+  start = current_timestamp_ms();
+  if (pearl_diver_submit(pd, &curl, HASH_LENGTH_TRIT - BENCH_NONCE_TRITS, HASH_LENGTH_TRIT, test_mwm, BENCH_MWM,
+                         &job) != RC_OK) {
+    fprintf(stderr, "Submitting the search failed\n");
+    pearl_diver_destroy(&pd);
+    return EXIT_FAILURE;
+  }
+  sleep_ms(duration_ms);
+  pearl_diver_cancel(pd, job);
+  pearl_diver_wait(pd, job);
+  elapsed = (current_timestamp_ms() - start) / 1000.0;
+  hashes = pearl_diver_hashes(pd);
+
+  printf("%3zu worker(s): %" PRIu64 " hashes in %.2f s, %.2f Mhashes/s, %.2f Mhashes/s per worker\n", workers_count,
+         hashes, elapsed, hashes / elapsed / 1e6, hashes / elapsed / 1e6 / workers_count);
+
+  pearl_diver_destroy(&pd);
+
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[]) {
+  uint64_t duration_ms = argc > 1 ? strtoull(argv[1], NULL, 10) : BENCH_DEFAULT_DURATION_MS;
+  size_t cpus = system_cpu_available();
+
+  printf("Batch width: %zu ptrit states\n", ptrit_batch_width());
+
+  if (bench_workers(1, duration_ms) != EXIT_SUCCESS) {
+    return EXIT_FAILURE;
+  }
+  if (cpus > 1 && bench_workers(cpus, duration_ms) != EXIT_SUCCESS) {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
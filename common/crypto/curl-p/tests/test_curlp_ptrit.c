@@ -5,6 +5,8 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <stdlib.h>
+#include <string.h>
 #include <unity/unity.h>
 
 #include "common/crypto/curl-p/ptrit.h"
@@ -22,6 +24,43 @@ void run_curl_p_test(PCurl *curl, ptrit_t *exp) {
   // TEST_ASSERT_EQUAL_MEMORY (exp, hash, sizeof(hash));
 }
 
+// Spans the 8 and 4 states wide transforms and the scalar fallback
+#define BATCH_SIZE 13
+
+void run_curl_p_batch_test(CurlType type) {
+  PCurl *batch = (PCurl *)calloc(BATCH_SIZE, sizeof(PCurl));
+  PCurl *expected = (PCurl *)calloc(BATCH_SIZE, sizeof(PCurl));
+  uint64_t seed = 0x9E3779B97F4A7C15ULL;
+
+  TEST_ASSERT_NOT_NULL(batch);
+  TEST_ASSERT_NOT_NULL(expected);
+
+  for (size_t k = 0; k < BATCH_SIZE; k++) {
+    ptrit_curl_init(&batch[k], type);
+    for (size_t i = 0; i < STATE_LENGTH; i++) {
+      seed ^= seed << 13, seed ^= seed >> 7, seed ^= seed << 17;
+      batch[k].state[i].low = seed;
+      seed ^= seed << 13, seed ^= seed >> 7, seed ^= seed << 17;
+      batch[k].state[i].high = seed;
+    }
+    memcpy(&expected[k], &batch[k], sizeof(PCurl));
+    ptrit_transform(&expected[k]);
+  }
+
+  ptrit_transform_batch(batch, BATCH_SIZE);
+
+  for (size_t k = 0; k < BATCH_SIZE; k++) {
+    TEST_ASSERT_EQUAL_MEMORY(expected[k].state, batch[k].state, sizeof(expected[k].state));
+  }
+
+  free(batch);
+  free(expected);
+}
+
+void test_curl_p_27_batch_works(void) { run_curl_p_batch_test(CURL_P_27); }
+
+void test_curl_p_81_batch_works(void) { run_curl_p_batch_test(CURL_P_81); }
+
 void test_curl_p_27_works(void) {
   PCurl curl;
   curl.type = CURL_P_27;
@@ -43,6 +82,8 @@ int main(void) {
 
   RUN_TEST(test_curl_p_27_works);
   RUN_TEST(test_curl_p_81_works);
+  RUN_TEST(test_curl_p_27_batch_works);
+  RUN_TEST(test_curl_p_81_batch_works);
 
   return UNITY_END();
 }
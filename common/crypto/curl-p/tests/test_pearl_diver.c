@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "common/crypto/curl-p/pearl_diver.h"
+#include "utils/handles/thread.h"
+#include "utils/time.h"
+
+#define NUM_JOBS 4
+// Never reached in practice, searches must be cancelled
+#define UNREACHABLE_MWM 81
+
+static trit_t const zeros[HASH_LENGTH_TRIT] = {0};
+
+// Index of a lane whose transformed state ends with mwm null trits, -1 if none
+static short test_mwm(PCurl *const curl, unsigned short const mwm) {
+  ptrit_s probe = HIGH_BITS;
+
+  for (unsigned short i = HASH_LENGTH_TRIT; i-- > HASH_LENGTH_TRIT - mwm && probe != 0;) {
+    probe &= ~(curl->state[i].low ^ curl->state[i].high);
+  }
+  if (probe == 0) {
+    return -1;
+  }
+  return __builtin_ctzll(probe);
+}
+
+static void init_curl(Curl *const curl, trit_t const seed) {
+  trit_t trits[HASH_LENGTH_TRIT] = {0};
+
+  trits[0] = seed;
+  curl->type = CURL_P_81;
+  curl_init(curl);
+  curl_absorb(curl, trits, HASH_LENGTH_TRIT);
+}
+
+void test_concurrent_searches(void) {
+  pearl_diver_t *pd = NULL;
+  pearl_diver_job_t *jobs[NUM_JOBS];
+  Curl curls[NUM_JOBS];
+  trit_t hash[HASH_LENGTH_TRIT];
+  unsigned short const mwm = 9;
+
+  // Less concurrent searches than submitted ones so that some have to wait
+  TEST_ASSERT(pearl_diver_create(&pd, 2, 2) == RC_OK);
+
+  for (size_t i = 0; i < NUM_JOBS; i++) {
+    init_curl(&curls[i], (trit_t)(i % 3) - 1);
+    TEST_ASSERT(pearl_diver_submit(pd, &curls[i], 0, HASH_LENGTH_TRIT, test_mwm, mwm, &jobs[i]) == RC_OK);
+  }
+
+  for (size_t i = 0; i < NUM_JOBS; i++) {
+    TEST_ASSERT_EQUAL_INT(PEARL_DIVER_SUCCESS, pearl_diver_wait(pd, jobs[i]));
+    // Squeezing transforms the state holding the nonce
+    curl_squeeze(&curls[i], hash, HASH_LENGTH_TRIT);
+    TEST_ASSERT_EQUAL_INT8_ARRAY(zeros, &curls[i].state[HASH_LENGTH_TRIT - mwm], mwm);
+  }
+
+  TEST_ASSERT(pearl_diver_destroy(&pd) == RC_OK);
+  TEST_ASSERT_NULL(pd);
+}
+
+void test_cancel(void) {
+  pearl_diver_t *pd = NULL;
+  pearl_diver_job_t *running = NULL;
+  pearl_diver_job_t *pending = NULL;
+  Curl curls[2];
+
+  TEST_ASSERT(pearl_diver_create(&pd, 2, 1) == RC_OK);
+
+  init_curl(&curls[0], 1);
+  init_curl(&curls[1], -1);
+  TEST_ASSERT(pearl_diver_submit(pd, &curls[0], 0, HASH_LENGTH_TRIT, test_mwm, UNREACHABLE_MWM, &running) == RC_OK);
+  TEST_ASSERT(pearl_diver_submit(pd, &curls[1], 0, HASH_LENGTH_TRIT, test_mwm, UNREACHABLE_MWM, &pending) == RC_OK);
+
+  pearl_diver_cancel(pd, pending);
+  TEST_ASSERT_EQUAL_INT(PEARL_DIVER_INTERRUPTED, pearl_diver_wait(pd, pending));
+  pearl_diver_cancel(pd, running);
+  TEST_ASSERT_EQUAL_INT(PEARL_DIVER_INTERRUPTED, pearl_diver_wait(pd, running));
+
+  TEST_ASSERT(pearl_diver_destroy(&pd) == RC_OK);
+}
+
+void test_cancel_all(void) {
+  pearl_diver_t *pd = NULL;
+  pearl_diver_job_t *jobs[NUM_JOBS];
+  Curl curls[NUM_JOBS];
+
+  TEST_ASSERT(pearl_diver_create(&pd, 2, 2) == RC_OK);
+
+  for (size_t i = 0; i < NUM_JOBS; i++) {
+    init_curl(&curls[i], (trit_t)(i % 3) - 1);
+    TEST_ASSERT(pearl_diver_submit(pd, &curls[i], 0, HASH_LENGTH_TRIT, test_mwm, UNREACHABLE_MWM, &jobs[i]) ==
+                RC_OK);
+  }
+
+  pearl_diver_cancel_all(pd);
+  for (size_t i = 0; i < NUM_JOBS; i++) {
+    TEST_ASSERT_EQUAL_INT(PEARL_DIVER_INTERRUPTED, pearl_diver_wait(pd, jobs[i]));
+  }
+
+  TEST_ASSERT(pearl_diver_destroy(&pd) == RC_OK);
+}
+
+typedef struct waiter_s {
+  pearl_diver_t *pd;
+  pearl_diver_job_t *job;
+  PearlDiverStatus status;
+} waiter_t;
+
+static void *waiter_routine(void *arg) {
+  waiter_t *waiter = (waiter_t *)arg;
+
+  waiter->status = pearl_diver_wait(waiter->pd, waiter->job);
+  return NULL;
+}
+
+void test_destroy_with_waiters(void) {
+  pearl_diver_t *pd = NULL;
+  Curl curls[NUM_JOBS];
+  waiter_t waiters[NUM_JOBS];
+  thread_handle_t threads[NUM_JOBS];
+
+  TEST_ASSERT(pearl_diver_create(&pd, 2, 2) == RC_OK);
+
+  for (size_t i = 0; i < NUM_JOBS; i++) {
+    init_curl(&curls[i], (trit_t)(i % 3) - 1);
+    waiters[i].pd = pd;
+    waiters[i].status = PEARL_DIVER_RUNNING;
+    TEST_ASSERT(pearl_diver_submit(pd, &curls[i], 0, HASH_LENGTH_TRIT, test_mwm, UNREACHABLE_MWM,
+                                   &waiters[i].job) == RC_OK);
+    TEST_ASSERT(thread_handle_create(&threads[i], waiter_routine, &waiters[i]) == 0);
+  }
+
+  // Lets the waiters block on their searches, the destruction must not free the pearl diver under them
+  sleep_ms(100);
+  TEST_ASSERT(pearl_diver_destroy(&pd) == RC_OK);
+
+  for (size_t i = 0; i < NUM_JOBS; i++) {
+    thread_handle_join(threads[i], NULL);
+    TEST_ASSERT_EQUAL_INT(PEARL_DIVER_INTERRUPTED, waiters[i].status);
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_concurrent_searches);
+  RUN_TEST(test_cancel);
+  RUN_TEST(test_cancel_all);
+  RUN_TEST(test_destroy_with_waiters);
+
+  return UNITY_END();
+}
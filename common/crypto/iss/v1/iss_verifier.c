@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utlist.h"
+
+#include "common/crypto/iss/v1/iss_verifier.h"
+#include "common/crypto/kerl/kerl_batch.h"
+#include "common/defs.h"
+#include "utils/handles/cond.h"
+#include "utils/handles/lock.h"
+#include "utils/handles/thread.h"
+#include "utils/system.h"
+
+#define HASH_TRYTE_VAL(hash, i) (hash[i * TRYTE_WIDTH] + hash[i * TRYTE_WIDTH + 1] * 3 + hash[i * TRYTE_WIDTH + 2] * 9)
+
+typedef struct iss_verifier_fragment_s {
+  trit_t *trits;
+  size_t rounds;
+} iss_verifier_fragment_t;
+
+typedef struct iss_verifier_batch_s {
+  sponge_type_t type;
+  // Sorted by decreasing number of rounds
+  iss_verifier_fragment_t *fragments;
+  size_t fragments_count;
+  // Guarded by the lock of the verifier
+  size_t claimed;
+  size_t hashed;
+  retcode_t ret;
+  struct iss_verifier_batch_s *prev;
+  struct iss_verifier_batch_s *next;
+} iss_verifier_batch_t;
+
+struct iss_verifier_s {
+  bool running;
+  size_t workers_count;
+  thread_handle_t *workers;
+  // Batches with fragments left to claim
+  iss_verifier_batch_t *batches;
+  lock_handle_t lock;
+  cond_handle_t batches_cond;
+  cond_handle_t done_cond;
+};
+
+/*
+ * Private functions
+ */
+
+static int fragment_cmp(void const *const lhs, void const *const rhs) {
+  size_t const l = ((iss_verifier_fragment_t const *)lhs)->rounds;
+  size_t const r = ((iss_verifier_fragment_t const *)rhs)->rounds;
+
+  return (l < r) - (l > r);
+}
+
+// Fragments sorted by decreasing number of rounds keep the chains still being hashed at the front of a Kerl batch
+static void hash_fragments_kerl(iss_verifier_fragment_t const *const fragments, size_t const count) {
+  trit_t chains[KERL_BATCH_WIDTH * HASH_LENGTH_TRIT];
+  kerl_batch_t batch;
+  size_t width = 0, active = 0, round = 0, k = 0;
+
+  for (size_t i = 0; i < count; i += KERL_BATCH_WIDTH) {
+    width = count - i < KERL_BATCH_WIDTH ? count - i : KERL_BATCH_WIDTH;
+    for (k = 0; k < width; k++) {
+      memcpy(&chains[k * HASH_LENGTH_TRIT], fragments[i + k].trits, HASH_LENGTH_TRIT * sizeof(trit_t));
+    }
+
+    active = width;
+    for (round = 0; round < fragments[i].rounds; round++) {
+      while (fragments[i + active - 1].rounds <= round) {
+        active--;
+      }
+      kerl_batch_init(&batch, active);
+      kerl_batch_absorb(&batch, chains, HASH_LENGTH_TRIT);
+      kerl_batch_squeeze(&batch, chains, HASH_LENGTH_TRIT);
+    }
+
+    for (k = 0; k < width; k++) {
+      memcpy(fragments[i + k].trits, &chains[k * HASH_LENGTH_TRIT], HASH_LENGTH_TRIT * sizeof(trit_t));
+    }
+  }
+}
+
+static retcode_t hash_fragments(sponge_type_t const type, iss_verifier_fragment_t const *const fragments,
+                                size_t const count) {
+  retcode_t ret = RC_OK;
+  sponge_t sponge;
+
+  if (type == SPONGE_KERL) {
+    hash_fragments_kerl(fragments, count);
+    return RC_OK;
+  }
+
+  if ((ret = sponge_init(&sponge, type)) != RC_OK) {
+    return ret;
+  }
+  for (size_t i = 0; i < count; i++) {
+    for (size_t round = 0; round < fragments[i].rounds; round++) {
+      sponge_absorb(&sponge, fragments[i].trits, HASH_LENGTH_TRIT);
+      sponge_squeeze(&sponge, fragments[i].trits, HASH_LENGTH_TRIT);
+      sponge_reset(&sponge);
+    }
+  }
+  sponge_destroy(&sponge);
+
+  return RC_OK;
+}
+
+// Called with the lock held, returns the number of fragments claimed from *start
+static size_t iss_verifier_claim(iss_verifier_t *const verifier, iss_verifier_batch_t *const batch,
+                                 size_t *const start) {
+  size_t count = batch->fragments_count - batch->claimed;
+
+  if (count > ISS_VERIFIER_CHUNK_FRAGMENTS) {
+    count = ISS_VERIFIER_CHUNK_FRAGMENTS;
+  }
+  *start = batch->claimed;
+  batch->claimed += count;
+  if (batch->claimed == batch->fragments_count) {
+    DL_DELETE(verifier->batches, batch);
+  }
+
+  return count;
+}
+
+// Called with the lock held
+static void iss_verifier_complete(iss_verifier_t *const verifier, iss_verifier_batch_t *const batch,
+                                  size_t const count, retcode_t const ret) {
+  if (ret != RC_OK) {
+    batch->ret = ret;
+  }
+  batch->hashed += count;
+  if (batch->hashed == batch->fragments_count) {
+    cond_handle_broadcast(&verifier->done_cond);
+  }
+}
+
+static void *iss_verifier_worker(void *const arg) {
+  iss_verifier_t *verifier = (iss_verifier_t *)arg;
+  iss_verifier_batch_t *batch = NULL;
+  size_t start = 0, count = 0;
+  retcode_t ret = RC_OK;
+
+  lock_handle_lock(&verifier->lock);
+  while (true) {
+    while (verifier->running && verifier->batches == NULL) {
+      cond_handle_wait(&verifier->batches_cond, &verifier->lock);
+    }
+    // Batches left after a stop are completed by their submitters
+    if (!verifier->running) {
+      break;
+    }
+    batch = verifier->batches;
+    count = iss_verifier_claim(verifier, batch, &start);
+    lock_handle_unlock(&verifier->lock);
+
+    ret = hash_fragments(batch->type, &batch->fragments[start], count);
+
+    lock_handle_lock(&verifier->lock);
+    iss_verifier_complete(verifier, batch, count, ret);
+  }
+  lock_handle_unlock(&verifier->lock);
+
+  return NULL;
+}
+
+// Hashes the fragments of a batch with the help of the workers of a verifier
+static retcode_t iss_verifier_run(iss_verifier_t *const verifier, iss_verifier_batch_t *const batch) {
+  size_t start = 0, count = 0;
+  retcode_t ret = RC_OK;
+
+  lock_handle_lock(&verifier->lock);
+  if (!verifier->running) {
+    lock_handle_unlock(&verifier->lock);
+    return hash_fragments(batch->type, batch->fragments, batch->fragments_count);
+  }
+  DL_APPEND(verifier->batches, batch);
+  cond_handle_broadcast(&verifier->batches_cond);
+
+  while (batch->claimed < batch->fragments_count) {
+    count = iss_verifier_claim(verifier, batch, &start);
+    lock_handle_unlock(&verifier->lock);
+
+    ret = hash_fragments(batch->type, &batch->fragments[start], count);
+
+    lock_handle_lock(&verifier->lock);
+    iss_verifier_complete(verifier, batch, count, ret);
+  }
+  while (batch->hashed < batch->fragments_count) {
+    cond_handle_wait(&verifier->done_cond, &verifier->lock);
+  }
+  lock_handle_unlock(&verifier->lock);
+
+  return batch->ret;
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t iss_verifier_create(iss_verifier_t **const verifier, size_t workers_count) {
+  iss_verifier_t *v = NULL;
+
+  if (verifier == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  if (workers_count == 0) {
+    workers_count = system_cpu_available();
+  }
+
+  if ((v = (iss_verifier_t *)calloc(1, sizeof(iss_verifier_t))) == NULL) {
+    return RC_OOM;
+  }
+  if ((v->workers = (thread_handle_t *)calloc(workers_count, sizeof(thread_handle_t))) == NULL) {
+    free(v);
+    return RC_OOM;
+  }
+
+  v->running = true;
+  lock_handle_init(&v->lock);
+  cond_handle_init(&v->batches_cond);
+  cond_handle_init(&v->done_cond);
+
+  for (size_t i = 0; i < workers_count; i++) {
+    if (thread_handle_create(&v->workers[v->workers_count], iss_verifier_worker, v) != 0) {
+      break;
+    }
+    v->workers_count++;
+  }
+
+  if (v->workers_count == 0) {
+    iss_verifier_destroy(&v);
+    return RC_FAILED_THREAD_SPAWN;
+  }
+
+  *verifier = v;
+
+  return RC_OK;
+}
+
+retcode_t iss_verifier_destroy(iss_verifier_t **const verifier) {
+  iss_verifier_t *v = NULL;
+
+  if (verifier == NULL || *verifier == NULL) {
+    return RC_NULL_PARAM;
+  }
+  v = *verifier;
+
+  lock_handle_lock(&v->lock);
+  v->running = false;
+  cond_handle_broadcast(&v->batches_cond);
+  lock_handle_unlock(&v->lock);
+
+  for (size_t i = 0; i < v->workers_count; i++) {
+    thread_handle_join(v->workers[i], NULL);
+  }
+
+  cond_handle_destroy(&v->done_cond);
+  cond_handle_destroy(&v->batches_cond);
+  lock_handle_destroy(&v->lock);
+  free(v->workers);
+  free(v);
+  *verifier = NULL;
+
+  return RC_OK;
+}
+
+retcode_t iss_verifier_sig_digests(iss_verifier_t *const verifier, sponge_type_t const type,
+                                   iss_verifier_job_t const *const jobs, size_t const jobs_count) {
+  retcode_t ret = RC_OK;
+  iss_verifier_batch_t batch;
+  sponge_t sponge;
+  size_t i = 0, j = 0;
+
+  if (jobs == NULL && jobs_count != 0) {
+    return RC_NULL_PARAM;
+  }
+
+  memset(&batch, 0, sizeof(iss_verifier_batch_t));
+  batch.type = type;
+  batch.ret = RC_OK;
+  for (i = 0; i < jobs_count; i++) {
+    assert(jobs[i].sig_len % HASH_LENGTH_TRIT == 0);
+    batch.fragments_count += jobs[i].sig_len / HASH_LENGTH_TRIT;
+  }
+  if ((ret = sponge_init(&sponge, type)) != RC_OK) {
+    return ret;
+  }
+  if (batch.fragments_count != 0 &&
+      (batch.fragments = (iss_verifier_fragment_t *)malloc(batch.fragments_count * sizeof(iss_verifier_fragment_t))) ==
+          NULL) {
+    ret = RC_OOM;
+    goto done;
+  }
+
+  batch.fragments_count = 0;
+  for (i = 0; i < jobs_count; i++) {
+    for (j = 0; j < jobs[i].sig_len / HASH_LENGTH_TRIT; j++) {
+      batch.fragments[batch.fragments_count].trits = &jobs[i].sig[j * HASH_LENGTH_TRIT];
+      batch.fragments[batch.fragments_count].rounds = HASH_TRYTE_VAL(jobs[i].hash, j) - TRYTE_VALUE_MIN;
+      batch.fragments_count++;
+    }
+  }
+  qsort(batch.fragments, batch.fragments_count, sizeof(iss_verifier_fragment_t), fragment_cmp);
+
+  // A single chunk is not worth waking the workers up
+  if (verifier == NULL || batch.fragments_count <= ISS_VERIFIER_CHUNK_FRAGMENTS) {
+    ret = hash_fragments(type, batch.fragments, batch.fragments_count);
+  } else {
+    ret = iss_verifier_run(verifier, &batch);
+  }
+  if (ret != RC_OK) {
+    goto done;
+  }
+
+  for (i = 0; i < jobs_count; i++) {
+    sponge_absorb(&sponge, jobs[i].sig, jobs[i].sig_len);
+    sponge_squeeze(&sponge, jobs[i].digest, HASH_LENGTH_TRIT);
+    sponge_reset(&sponge);
+  }
+
+done:
+  free(batch.fragments);
+  sponge_destroy(&sponge);
+
+  return ret;
+}
+
+#undef HASH_TRYTE_VAL
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __COMMON_CRYPTO_ISS_V1_ISS_VERIFIER_H__
+#define __COMMON_CRYPTO_ISS_V1_ISS_VERIFIER_H__
+
+#include <stddef.h>
+
+#include "common/crypto/sponge/sponge.h"
+#include "common/errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Maximum number of signature fragments a worker hashes before claiming more
+#ifndef ISS_VERIFIER_CHUNK_FRAGMENTS
+#define ISS_VERIFIER_CHUNK_FRAGMENTS 4
+#endif
+
+/**
+ * A signature digest to compute, as iss_sig_digest would
+ */
+typedef struct iss_verifier_job_s {
+  // Normalized hash, one tryte per fragment of the signature
+  trit_t const *hash;
+  // Signature, hashed in place
+  trit_t *sig;
+  // Length of the signature, a multiple of HASH_LENGTH_TRIT
+  size_t sig_len;
+  // Digest of the signature, HASH_LENGTH_TRIT trits
+  trit_t *digest;
+} iss_verifier_job_t;
+
+/**
+ * A pool of long-lived threads computing signature digests
+ *
+ * The hash chains of all fragments of the submitted signatures are
+ * independent: they are shared out between the workers and the submitting
+ * thread in chunks of ISS_VERIFIER_CHUNK_FRAGMENTS fragments, Kerl chunks
+ * being hashed in a single batch of Kerl states.
+ */
+typedef struct iss_verifier_s iss_verifier_t;
+
+/**
+ * Creates a verifier and starts its workers
+ *
+ * @param verifier The verifier
+ * @param workers_count The number of workers, 0 for one per available CPU
+ *
+ * @return a status code
+ */
+retcode_t iss_verifier_create(iss_verifier_t **const verifier, size_t workers_count);
+
+/**
+ * Stops the workers and destroys a verifier
+ * Must not be called while digests are being computed
+ *
+ * @param verifier The verifier
+ *
+ * @return a status code
+ */
+retcode_t iss_verifier_destroy(iss_verifier_t **const verifier);
+
+/**
+ * Computes the digests of signatures, blocking until all of them are done
+ *
+ * @param verifier The verifier, NULL to compute the digests in the calling thread only
+ * @param type The sponge used by the signatures
+ * @param jobs The digests to compute
+ * @param jobs_count The number of digests
+ *
+ * @return a status code
+ */
+retcode_t iss_verifier_sig_digests(iss_verifier_t *const verifier, sponge_type_t const type,
+                                   iss_verifier_job_t const *const jobs, size_t const jobs_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_CRYPTO_ISS_V1_ISS_VERIFIER_H__
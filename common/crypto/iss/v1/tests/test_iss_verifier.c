@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+
+#include <unity/unity.h>
+
+#include "common/crypto/iss/v1/iss.h"
+#include "common/crypto/iss/v1/iss_verifier.h"
+
+#define SIGNATURES_COUNT 5
+#define SIGNATURE_FRAGMENTS 2
+
+static trit_t signatures[SIGNATURES_COUNT][SIGNATURE_FRAGMENTS * ISS_KEY_LENGTH];
+static trit_t expected_signatures[SIGNATURES_COUNT][SIGNATURE_FRAGMENTS * ISS_KEY_LENGTH];
+static trit_t hashes[SIGNATURES_COUNT][SIGNATURE_FRAGMENTS * HASH_LENGTH_TRIT];
+static trit_t digests[SIGNATURES_COUNT][HASH_LENGTH_TRIT];
+static trit_t expected_digests[SIGNATURES_COUNT][HASH_LENGTH_TRIT];
+
+// Hashes are not normalized so that fragments chain from 0 to 26 rounds
+static void fill_signatures(void) {
+  uint32_t state = 42;
+
+  for (size_t i = 0; i < SIGNATURES_COUNT; i++) {
+    for (size_t j = 0; j < SIGNATURE_FRAGMENTS * ISS_KEY_LENGTH; j++) {
+      state = state * 1103515245 + 12345;
+      signatures[i][j] = (trit_t)((state >> 16) % 3) - 1;
+    }
+    for (size_t j = 0; j < SIGNATURE_FRAGMENTS * HASH_LENGTH_TRIT; j++) {
+      state = state * 1103515245 + 12345;
+      hashes[i][j] = (trit_t)((state >> 16) % 3) - 1;
+    }
+  }
+}
+
+static void check_sig_digests(sponge_type_t const type, iss_verifier_t *const verifier) {
+  iss_verifier_job_t jobs[SIGNATURES_COUNT];
+  sponge_t sponge;
+
+  fill_signatures();
+  memcpy(expected_signatures, signatures, sizeof(signatures));
+  TEST_ASSERT_EQUAL_INT(RC_OK, sponge_init(&sponge, type));
+  for (size_t i = 0; i < SIGNATURES_COUNT; i++) {
+    iss_sig_digest(&sponge, expected_digests[i], hashes[i], expected_signatures[i],
+                   SIGNATURE_FRAGMENTS * ISS_KEY_LENGTH);
+    jobs[i].hash = hashes[i];
+    jobs[i].sig = signatures[i];
+    jobs[i].sig_len = SIGNATURE_FRAGMENTS * ISS_KEY_LENGTH;
+    jobs[i].digest = digests[i];
+  }
+  sponge_destroy(&sponge);
+
+  TEST_ASSERT_EQUAL_INT(RC_OK, iss_verifier_sig_digests(verifier, type, jobs, SIGNATURES_COUNT));
+  TEST_ASSERT_EQUAL_MEMORY(expected_digests, digests, sizeof(digests));
+  TEST_ASSERT_EQUAL_MEMORY(expected_signatures, signatures, sizeof(signatures));
+}
+
+void test_sig_digests_inline(void) {
+  check_sig_digests(SPONGE_KERL, NULL);
+  check_sig_digests(SPONGE_CURLP81, NULL);
+}
+
+void test_sig_digests_workers(void) {
+  iss_verifier_t *verifier = NULL;
+
+  TEST_ASSERT_EQUAL_INT(RC_OK, iss_verifier_create(&verifier, 3));
+  check_sig_digests(SPONGE_KERL, verifier);
+  check_sig_digests(SPONGE_CURLP81, verifier);
+  TEST_ASSERT_EQUAL_INT(RC_OK, iss_verifier_destroy(&verifier));
+  TEST_ASSERT_NULL(verifier);
+}
+
+void test_sig_digests_empty(void) {
+  TEST_ASSERT_EQUAL_INT(RC_OK, iss_verifier_sig_digests(NULL, SPONGE_KERL, NULL, 0));
+  TEST_ASSERT_EQUAL_INT(RC_NULL_PARAM, iss_verifier_sig_digests(NULL, SPONGE_KERL, NULL, 1));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_sig_digests_inline);
+  RUN_TEST(test_sig_digests_workers);
+  RUN_TEST(test_sig_digests_empty);
+
+  return UNITY_END();
+}
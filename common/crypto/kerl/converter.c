@@ -16,6 +16,10 @@
 #define BYTE_LEN 48
 #define BYTE_LEN_2 24
 #define TRIT_LEN 243
+// Number of trits converted per multiplication or division of the bigint,
+// 3^CHUNK_TRITS being the largest power of 3 fitting in a limb
+#define CHUNK_TRITS 20
+#define CHUNK_RADIX 3486784401u
 
 static const uint32_t HALF_3[] = {
     0xa5ce8964, 0x9f007669, 0x1484504f, 0x3ade00d9, 0x0c24486e, 0x50979d57,
@@ -45,14 +49,14 @@ void space_reverse(uint8_t *const bytes) {
 }
 
 void convert_trits_to_bytes(trit_t const *const trits, uint8_t *const bytes) {
-  size_t i = 0, j = 0;
-  size_t sz = 1, size = 1;
+  size_t i = 0, j = 0, len = 0;
+  size_t size = 1;
   uint8_t all_minus_1 = 1;
-  uint32_t carry;
+  uint32_t carry, radix, chunk;
   uint32_t *base = (uint32_t *)bytes;
   uint64_t v;
 
-  memset(base, 0, INT_LEN);
+  memset(base, 0, INT_LEN * sizeof(uint32_t));
 
   for (i = 0; i < TRIT_LEN - 1; i++) {
     if (trits[i] != -1) {
@@ -66,31 +70,25 @@ void convert_trits_to_bytes(trit_t const *const trits, uint8_t *const bytes) {
     bigint_not(base, INT_LEN);
     bigint_add_small(base, 1);
   } else {
-    for (i = (TRIT_LEN - 1); i-- > 0;) {
-      // multiply by radix
-      {
-        sz = size;
-        carry = 0;
-
-        for (j = 0; j < sz; j++) {
-          v = ((uint64_t)base[j]) * ((uint64_t)RADIX) + ((uint64_t)carry);
-          carry = (v >> 32uLL);
-          base[j] = (uint32_t)(v & 0xFFFFFFFFuLL);
-        }
-
-        if (carry) {
-          base[sz] = carry;
-          size++;
-        }
+    // Horner's scheme on chunks of trits, the most significant chunk holding the remainder
+    for (i = TRIT_LEN - 1; i > 0; i -= len) {
+      len = i % CHUNK_TRITS ? i % CHUNK_TRITS : CHUNK_TRITS;
+      radix = 1;
+      chunk = 0;
+      for (j = i; j-- > i - len;) {
+        radix *= RADIX;
+        chunk = chunk * RADIX + (uint32_t)(trits[j] + 1);
       }
 
-      // addition
-      {
-        sz = bigint_add_small(base, trits[i] + 1);
-
-        if (sz > size) {
-          size = sz;
-        }
+      // multiply by radix^len and add the chunk
+      carry = chunk;
+      for (j = 0; j < size; j++) {
+        v = ((uint64_t)base[j]) * ((uint64_t)radix) + ((uint64_t)carry);
+        carry = (uint32_t)(v >> 32uLL);
+        base[j] = (uint32_t)(v & 0xFFFFFFFFuLL);
+      }
+      if (carry && size < INT_LEN) {
+        base[size++] = carry;
       }
     }
 
@@ -115,10 +113,11 @@ void convert_trits_to_bytes(trit_t const *const trits, uint8_t *const bytes) {
 }
 
 void convert_bytes_to_trits(uint8_t *const bytes, trit_t *const trits) {
-  size_t i = 0, j = 0;
+  size_t i = 0, j = 0, len = 0;
+  size_t size = INT_LEN;
   uint8_t flip_trits = 0;
   uint64_t lhs, rem;
-  uint64_t rhs = RADIX;
+  uint32_t chunk;
   uint32_t *base = (uint32_t *)bytes;
 
   if (is_null(base)) {
@@ -148,14 +147,23 @@ void convert_bytes_to_trits(uint8_t *const bytes, trit_t *const trits) {
     }
   }
 
-  for (; i < TRIT_LEN - 1; i++) {
+  // Each division by radix^CHUNK_TRITS yields a chunk of trits, least significant first
+  for (; i < TRIT_LEN - 1; i += len) {
+    len = TRIT_LEN - 1 - i < CHUNK_TRITS ? TRIT_LEN - 1 - i : CHUNK_TRITS;
     rem = 0;
-    for (j = INT_LEN; j-- > 0;) {
+    for (j = size; j-- > 0;) {
       lhs = (rem << 32) | base[j];
-      base[j] = (uint32_t)(lhs / rhs);
-      rem = (uint32_t)(lhs % rhs);
+      base[j] = (uint32_t)(lhs / CHUNK_RADIX);
+      rem = lhs % CHUNK_RADIX;
+    }
+    while (size > 1 && base[size - 1] == 0) {
+      size--;
+    }
+    chunk = (uint32_t)rem;
+    for (j = 0; j < len; j++) {
+      trits[i + j] = (trit_t)(chunk % RADIX) - 1;
+      chunk /= RADIX;
     }
-    trits[i] = ((uint8_t)rem) - 1;
   }
 
   if (flip_trits) {
@@ -168,4 +176,6 @@ void convert_bytes_to_trits(uint8_t *const bytes, trit_t *const trits) {
 #undef INT_LEN
 #undef BYTE_LEN
 #undef TRIT_LEN
+#undef CHUNK_TRITS
+#undef CHUNK_RADIX
 #undef RADIX
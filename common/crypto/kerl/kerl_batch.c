@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "common/crypto/kerl/converter.h"
+#include "common/crypto/kerl/kerl_batch.h"
+#include "common/defs.h"
+#include "utils/forced_inline.h"
+
+// Keccak-384 with the parameters of kerl_init
+#define RATE_BYTE_LEN (832 / 8)
+#define HASH_BYTE_LEN (384 / 8)
+#define SUFFIX 0x01
+#define ROUNDS 24
+
+// The AVX2 variant is compiled for its instruction set and selected at runtime
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define KERL_BATCH_X86_SIMD
+#endif
+
+#define ROTL64(x, n) (((x) << (n)) | ((x) >> (64 - (n))))
+
+static uint64_t const ROUND_CONSTANTS[ROUNDS] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL, 0x000000000000808bULL,
+    0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL, 0x0000000000000088ULL,
+    0x0000000080008009ULL, 0x000000008000000aULL, 0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+};
+
+// Rotation offsets of the rho step, in the order the pi step visits the lanes
+static unsigned const RHO_OFFSETS[24] = {1,  3,  6,  10, 15, 21, 28, 36, 45, 55, 2,  14,
+                                         27, 41, 56, 8,  25, 43, 62, 18, 39, 61, 20, 44};
+static unsigned const PI_LANES[24] = {10, 7,  11, 17, 18, 3,  5,  16, 8,  21, 24, 4,
+                                      15, 23, 19, 13, 12, 2,  20, 14, 22, 9,  6,  1};
+
+static FORCED_INLINE void keccak_p1600_rounds(uint64_t a[25][KERL_BATCH_WIDTH]) {
+  uint64_t c[5][KERL_BATCH_WIDTH], t[KERL_BATCH_WIDTH], u[KERL_BATCH_WIDTH];
+  size_t round, i, j, k;
+
+  for (round = 0; round < ROUNDS; round++) {
+    // theta
+    for (i = 0; i < 5; i++) {
+      for (k = 0; k < KERL_BATCH_WIDTH; k++) {
+        c[i][k] = a[i][k] ^ a[i + 5][k] ^ a[i + 10][k] ^ a[i + 15][k] ^ a[i + 20][k];
+      }
+    }
+    for (i = 0; i < 5; i++) {
+      for (k = 0; k < KERL_BATCH_WIDTH; k++) {
+        t[k] = c[(i + 4) % 5][k] ^ ROTL64(c[(i + 1) % 5][k], 1);
+      }
+      for (j = 0; j < 25; j += 5) {
+        for (k = 0; k < KERL_BATCH_WIDTH; k++) {
+          a[j + i][k] ^= t[k];
+        }
+      }
+    }
+
+    // rho and pi
+    for (k = 0; k < KERL_BATCH_WIDTH; k++) {
+      t[k] = a[1][k];
+    }
+    for (i = 0; i < 24; i++) {
+      j = PI_LANES[i];
+      for (k = 0; k < KERL_BATCH_WIDTH; k++) {
+        u[k] = a[j][k];
+        a[j][k] = ROTL64(t[k], RHO_OFFSETS[i]);
+        t[k] = u[k];
+      }
+    }
+
+    // chi
+    for (j = 0; j < 25; j += 5) {
+      for (i = 0; i < 5; i++) {
+        for (k = 0; k < KERL_BATCH_WIDTH; k++) {
+          c[i][k] = a[j + i][k];
+        }
+      }
+      for (i = 0; i < 5; i++) {
+        for (k = 0; k < KERL_BATCH_WIDTH; k++) {
+          a[j + i][k] = c[i][k] ^ (~c[(i + 1) % 5][k] & c[(i + 2) % 5][k]);
+        }
+      }
+    }
+
+    // iota
+    for (k = 0; k < KERL_BATCH_WIDTH; k++) {
+      a[0][k] ^= ROUND_CONSTANTS[round];
+    }
+  }
+}
+
+static void keccak_p1600_batch_generic(uint64_t a[25][KERL_BATCH_WIDTH]) { keccak_p1600_rounds(a); }
+
+#ifdef KERL_BATCH_X86_SIMD
+__attribute__((target("avx2"))) static void keccak_p1600_batch_avx2(uint64_t a[25][KERL_BATCH_WIDTH]) {
+  keccak_p1600_rounds(a);
+}
+#endif
+
+static void keccak_p1600_batch(uint64_t a[25][KERL_BATCH_WIDTH]) {
+#ifdef KERL_BATCH_X86_SIMD
+  if (__builtin_cpu_supports("avx2")) {
+    keccak_p1600_batch_avx2(a);
+    return;
+  }
+#endif
+  keccak_p1600_batch_generic(a);
+}
+
+// Lanes are little-endian whatever the host
+static void kerl_batch_add_bytes(kerl_batch_t* const ctx, uint8_t const bytes[][HASH_BYTE_LEN]) {
+  size_t i, k;
+
+  for (i = 0; i < HASH_BYTE_LEN; i++) {
+    for (k = 0; k < ctx->count; k++) {
+      ctx->lanes[ctx->byte_index / 8][k] ^= (uint64_t)bytes[k][i] << (8 * (ctx->byte_index % 8));
+    }
+    if (++ctx->byte_index == RATE_BYTE_LEN) {
+      keccak_p1600_batch(ctx->lanes);
+      ctx->byte_index = 0;
+    }
+  }
+}
+
+static void kerl_batch_pad(kerl_batch_t* const ctx) {
+  size_t k;
+
+  for (k = 0; k < ctx->count; k++) {
+    ctx->lanes[ctx->byte_index / 8][k] ^= (uint64_t)SUFFIX << (8 * (ctx->byte_index % 8));
+    ctx->lanes[(RATE_BYTE_LEN - 1) / 8][k] ^= (uint64_t)0x80 << (8 * ((RATE_BYTE_LEN - 1) % 8));
+  }
+  keccak_p1600_batch(ctx->lanes);
+  ctx->byte_index = 0;
+  ctx->squeezing = true;
+}
+
+static void kerl_batch_extract_bytes(kerl_batch_t* const ctx, uint8_t bytes[][HASH_BYTE_LEN]) {
+  size_t i, k;
+
+  for (i = 0; i < HASH_BYTE_LEN; i++) {
+    if (ctx->byte_index == RATE_BYTE_LEN) {
+      keccak_p1600_batch(ctx->lanes);
+      ctx->byte_index = 0;
+    }
+    for (k = 0; k < ctx->count; k++) {
+      bytes[k][i] = (uint8_t)(ctx->lanes[ctx->byte_index / 8][k] >> (8 * (ctx->byte_index % 8)));
+    }
+    ctx->byte_index++;
+  }
+}
+
+void kerl_batch_init(kerl_batch_t* const ctx, size_t const count) {
+  assert(count <= KERL_BATCH_WIDTH);
+
+  memset(ctx->lanes, 0, sizeof(ctx->lanes));
+  ctx->count = count;
+  ctx->byte_index = 0;
+  ctx->squeezing = false;
+}
+
+void kerl_batch_absorb(kerl_batch_t* const ctx, trit_t const* const trits, size_t const length) {
+  uint8_t bytes[KERL_BATCH_WIDTH][HASH_BYTE_LEN];
+  size_t offset, k;
+
+  assert(length % HASH_LENGTH_TRIT == 0);
+
+  for (offset = 0; offset < length; offset += HASH_LENGTH_TRIT) {
+    for (k = 0; k < ctx->count; k++) {
+      convert_trits_to_bytes(&trits[k * length + offset], bytes[k]);
+    }
+    kerl_batch_add_bytes(ctx, bytes);
+  }
+}
+
+void kerl_batch_squeeze(kerl_batch_t* const ctx, trit_t* const trits, size_t const length) {
+  uint8_t bytes[KERL_BATCH_WIDTH][HASH_BYTE_LEN], tmp[HASH_BYTE_LEN];
+  size_t offset, i, k;
+
+  assert(length % HASH_LENGTH_TRIT == 0);
+
+  for (offset = 0; offset < length; offset += HASH_LENGTH_TRIT) {
+    if (!ctx->squeezing) {
+      kerl_batch_pad(ctx);
+    }
+    kerl_batch_extract_bytes(ctx, bytes);
+
+    for (k = 0; k < ctx->count; k++) {
+      memcpy(tmp, bytes[k], HASH_BYTE_LEN);
+      convert_bytes_to_trits(tmp, &trits[k * length + offset]);
+      for (i = 0; i < HASH_BYTE_LEN; i++) {
+        bytes[k][i] ^= 0xFF;
+      }
+    }
+
+    // As kerl_squeeze, the next squeeze starts over from the complemented output
+    kerl_batch_init(ctx, ctx->count);
+    kerl_batch_add_bytes(ctx, bytes);
+  }
+}
+
+#undef ROTL64
+#undef ROUNDS
+#undef SUFFIX
+#undef HASH_BYTE_LEN
+#undef RATE_BYTE_LEN
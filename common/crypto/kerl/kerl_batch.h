@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __COMMON_CRYPTO_KERL_KERL_BATCH_H__
+#define __COMMON_CRYPTO_KERL_KERL_BATCH_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "common/stdint.h"
+#include "common/trinary/trits.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Maximum number of Kerl states hashed at once
+#define KERL_BATCH_WIDTH 4
+
+/**
+ * Independent Kerl states absorbing and squeezing the same number of trits,
+ * their Keccak-f[1600] permutations being run together with lane k of each
+ * word belonging to the state k
+ */
+typedef struct kerl_batch_s {
+  uint64_t lanes[25][KERL_BATCH_WIDTH];
+  size_t count;
+  size_t byte_index;
+  bool squeezing;
+} kerl_batch_t;
+
+/**
+ * Initializes a batch of Kerl states
+ *
+ * @param ctx The batch
+ * @param count The number of states, at most KERL_BATCH_WIDTH
+ */
+void kerl_batch_init(kerl_batch_t* const ctx, size_t const count);
+
+/**
+ * Absorbs trits into each state of a batch, like kerl_absorb
+ *
+ * @param ctx The batch
+ * @param trits count consecutive arrays of length trits, one per state
+ * @param length The number of trits absorbed by each state, a multiple of 243
+ */
+void kerl_batch_absorb(kerl_batch_t* const ctx, trit_t const* const trits, size_t const length);
+
+/**
+ * Squeezes trits out of each state of a batch, like kerl_squeeze
+ *
+ * @param ctx The batch
+ * @param trits count consecutive arrays of length trits, one per state
+ * @param length The number of trits squeezed out of each state, a multiple of 243
+ */
+void kerl_batch_squeeze(kerl_batch_t* const ctx, trit_t* const trits, size_t const length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_CRYPTO_KERL_KERL_BATCH_H__
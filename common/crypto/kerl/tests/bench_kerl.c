@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/*
+ * Measures the number of trits to bytes and bytes to trits conversions per
+ * second, and the number of 243 trits Kerl hashes per second with a single
+ * Kerl state and with batches of KERL_BATCH_WIDTH states.
+ *
+ * Usage: bench_kerl [iterations] (defaults to 100000)
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/crypto/kerl/converter.h"
+#include "common/crypto/kerl/kerl.h"
+#include "common/crypto/kerl/kerl_batch.h"
+#include "common/defs.h"
+#include "utils/time.h"
+
+#define BENCH_DEFAULT_ITERATIONS 100000
+
+static void report(char const *const name, uint64_t const count, uint64_t const start) {
+  double elapsed = (current_timestamp_us() - start) / 1e6;
+
+  printf("%-16s %" PRIu64 " in %.2f s, %.0f/s\n", name, count, elapsed, count / elapsed);
+}
+
+int main(int argc, char *argv[]) {
+  uint64_t iterations = argc > 1 ? strtoull(argv[1], NULL, 10) : BENCH_DEFAULT_ITERATIONS;
+  trit_t trits[KERL_BATCH_WIDTH * HASH_LENGTH_TRIT];
+  uint8_t bytes[HASH_LENGTH_BYTE];
+  uint64_t start = 0, i = 0;
+  kerl_batch_t batch;
+  Kerl kerl;
+
+  for (i = 0; i < KERL_BATCH_WIDTH * HASH_LENGTH_TRIT; i++) {
+    trits[i] = (trit_t)(i % 3) - 1;
+  }
+
+  start = current_timestamp_us();
+  for (i = 0; i < iterations; i++) {
+    convert_trits_to_bytes(trits, bytes);
+    // Feeds the result back so that the conversion can not be hoisted
+    trits[i % (HASH_LENGTH_TRIT - 1)] = (trit_t)(bytes[i % HASH_LENGTH_BYTE] % 3) - 1;
+  }
+  report("trits to bytes", iterations, start);
+
+  start = current_timestamp_us();
+  for (i = 0; i < iterations; i++) {
+    memset(bytes, (int)i, 4);
+    convert_bytes_to_trits(bytes, trits);
+  }
+  report("bytes to trits", iterations, start);
+
+  start = current_timestamp_us();
+  for (i = 0; i < iterations; i++) {
+    kerl_init(&kerl);
+    kerl_absorb(&kerl, trits, HASH_LENGTH_TRIT);
+    kerl_squeeze(&kerl, trits, HASH_LENGTH_TRIT);
+  }
+  report("kerl", iterations, start);
+
+  start = current_timestamp_us();
+  for (i = 0; i < iterations; i += KERL_BATCH_WIDTH) {
+    kerl_batch_init(&batch, KERL_BATCH_WIDTH);
+    kerl_batch_absorb(&batch, trits, HASH_LENGTH_TRIT);
+    kerl_batch_squeeze(&batch, trits, HASH_LENGTH_TRIT);
+  }
+  report("kerl batch", i, start);
+
+  return EXIT_SUCCESS;
+}
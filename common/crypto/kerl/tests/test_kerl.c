@@ -11,6 +11,7 @@
 #include <unity/unity.h>
 
 #include "common/crypto/kerl/kerl.h"
+#include "common/crypto/kerl/kerl_batch.h"
 #include "common/trinary/trit_tryte.h"
 #include "common/trinary/trits.h"
 
@@ -92,12 +93,44 @@ void test_multi_squeeze(void) {
   TEST_ASSERT_EQUAL_MEMORY(expected, trytes, TRYTE_LENGTH * 2);
 }
 
+static void run_batch_test(size_t const count, size_t const absorb_length, size_t const squeeze_length) {
+  trit_t in[KERL_BATCH_WIDTH * TRIT_LENGTH * 2];
+  trit_t out[KERL_BATCH_WIDTH * TRIT_LENGTH * 2];
+  trit_t expected[TRIT_LENGTH * 2];
+  kerl_batch_t batch;
+  Kerl kerl;
+
+  for (size_t i = 0; i < count * absorb_length; i++) {
+    in[i] = (trit_t)((i * 7 + i / 5) % 3) - 1;
+  }
+
+  kerl_batch_init(&batch, count);
+  kerl_batch_absorb(&batch, in, absorb_length);
+  kerl_batch_squeeze(&batch, out, squeeze_length);
+
+  for (size_t k = 0; k < count; k++) {
+    kerl_init(&kerl);
+    kerl_absorb(&kerl, &in[k * absorb_length], absorb_length);
+    kerl_squeeze(&kerl, expected, squeeze_length);
+    TEST_ASSERT_EQUAL_INT8_ARRAY(expected, &out[k * squeeze_length], squeeze_length);
+  }
+}
+
+void test_batch(void) {
+  for (size_t count = 1; count <= KERL_BATCH_WIDTH; count++) {
+    run_batch_test(count, TRIT_LENGTH, TRIT_LENGTH);
+    run_batch_test(count, TRIT_LENGTH * 2, TRIT_LENGTH);
+    run_batch_test(count, TRIT_LENGTH, TRIT_LENGTH * 2);
+  }
+}
+
 int main(void) {
   UNITY_BEGIN();
 
   RUN_TEST(test_one_absorb);
   RUN_TEST(test_multi_squeeze_multi_absorb);
   RUN_TEST(test_multi_squeeze);
+  RUN_TEST(test_batch);
 
   return UNITY_END();
 }
@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/*
+ * Measures the hashing hot paths: Curl-P-81 with trits, ptrits and BCT states,
+ * Kerl with a single state and with batches of states, the Troika
+ * permutations and the trinary converters.
+ * Every case reports the time per message and the throughput, messages being
+ * counted at 5 trits per byte as on the wire. Lanes are the number of
+ * messages a call processes at once: 1 for scalar states, 64 for a ptrit
+ * state and the widest batch the CPU supports for batched states.
+ *
+ * With -c, the results are printed as CSV lines "name,lanes,ns_per_op,mb_per_s"
+ * that can be diffed between commits. With -b, the results are compared to
+ * such a file and the run fails if any case got slower than the tolerance.
+ *
+ * Usage: bench_hashing [-c] [-d milliseconds per case] [-b baseline.csv]
+ * [-t tolerance percent] (defaults to 500 milliseconds and 10 percent)
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "common/crypto/curl-p/bct.h"
+#include "common/crypto/curl-p/ptrit.h"
+#include "common/crypto/curl-p/trit.h"
+#include "common/crypto/ftroika/ftroika.h"
+#include "common/crypto/kerl/kerl.h"
+#include "common/crypto/kerl/kerl_batch.h"
+#include "common/crypto/troika/troika.h"
+#include "common/trinary/bct.h"
+#include "common/trinary/trit_byte.h"
+#include "common/trinary/trit_ptrit.h"
+#include "common/trinary/trit_tryte.h"
+#include "utils/time.h"
+
+#define BENCH_DEFAULT_DURATION_MS 500
+#define BENCH_DEFAULT_TOLERANCE 10.0
+// Messages are serialized transactions, a multiple of the Kerl block size
+#define BENCH_MESSAGE_TRITS 8019
+#define BENCH_PTRIT_LANES 64
+#define BENCH_TROIKA_STATE_TRITS 729
+#define BENCH_MAX_CASES 16
+#define BENCH_MAX_NAME 32
+
+typedef struct bench_case_s {
+  char const *name;
+  // Number of messages processed by a call to run
+  size_t lanes;
+  // Length of a message
+  size_t trits;
+  void (*run)(void);
+} bench_case_t;
+
+typedef struct bench_result_s {
+  char name[BENCH_MAX_NAME];
+  size_t lanes;
+  double ns_per_op;
+  double mb_per_s;
+} bench_result_t;
+
+static trit_t message[KERL_BATCH_WIDTH * BENCH_MESSAGE_TRITS];
+static trit_t hash[KERL_BATCH_WIDTH * HASH_LENGTH_TRIT];
+static byte_t message_bytes[MIN_BYTES(BENCH_MESSAGE_TRITS)];
+static tryte_t message_trytes[BENCH_MESSAGE_TRITS / NUMBER_OF_TRITS_IN_A_TRYTE];
+static bct_t message_bct[(BENCH_MESSAGE_TRITS + 3) / 4];
+static bct_t hash_bct[(HASH_LENGTH_TRIT + 3) / 4];
+static ptrit_t *message_ptrits = NULL;
+static ptrit_t hash_ptrits[PTRIT_BATCH_MAX * HASH_LENGTH_TRIT];
+static trit_t troika_state[BENCH_TROIKA_STATE_TRITS];
+static t27_t ftroika_state[SLICESIZE];
+static size_t ptrit_width = 1;
+
+static Curl curl;
+static BCurl bcurl;
+static PCurl pcurls[PTRIT_BATCH_MAX];
+static Kerl kerl;
+static kerl_batch_t kerl_batch;
+
+static void run_curl(void) {
+  curl_reset(&curl);
+  curl_absorb(&curl, message, BENCH_MESSAGE_TRITS);
+  curl_squeeze(&curl, hash, HASH_LENGTH_TRIT);
+}
+
+static void run_bct_curl(void) {
+  s_curl_reset(&bcurl);
+  s_curl_absorb(&bcurl, message_bct, 0, BENCH_MESSAGE_TRITS);
+  s_curl_squeeze(&bcurl, hash_bct, 0, HASH_LENGTH_TRIT);
+}
+
+static void run_ptrit_curl(void) {
+  ptrit_curl_reset(&pcurls[0]);
+  ptrit_curl_absorb(&pcurls[0], message_ptrits, BENCH_MESSAGE_TRITS);
+  ptrit_curl_squeeze(&pcurls[0], hash_ptrits, HASH_LENGTH_TRIT);
+}
+
+static void run_ptrit_curl_batch(void) {
+  for (size_t i = 0; i < ptrit_width; i++) {
+    ptrit_curl_reset(&pcurls[i]);
+  }
+  ptrit_curl_absorb_batch(pcurls, ptrit_width, message_ptrits, BENCH_MESSAGE_TRITS);
+  ptrit_curl_squeeze_batch(pcurls, ptrit_width, hash_ptrits, HASH_LENGTH_TRIT);
+}
+
+static void run_kerl(void) {
+  kerl_reset(&kerl);
+  kerl_absorb(&kerl, message, BENCH_MESSAGE_TRITS);
+  kerl_squeeze(&kerl, hash, HASH_LENGTH_TRIT);
+}
+
+static void run_kerl_batch(void) {
+  kerl_batch_init(&kerl_batch, KERL_BATCH_WIDTH);
+  kerl_batch_absorb(&kerl_batch, message, BENCH_MESSAGE_TRITS);
+  kerl_batch_squeeze(&kerl_batch, hash, HASH_LENGTH_TRIT);
+}
+
+static void run_troika_permutation(void) { troika_permutation(troika_state, NUM_ROUNDS); }
+
+static void run_ftroika_permutation(void) { ftroika_permutation(ftroika_state, NUM_ROUNDS); }
+
+static void run_trits_to_bytes(void) { trits_to_bytes(message, message_bytes, BENCH_MESSAGE_TRITS); }
+
+static void run_bytes_to_trits(void) {
+  bytes_to_trits(message_bytes, sizeof(message_bytes), message, BENCH_MESSAGE_TRITS);
+}
+
+static void run_trits_to_trytes(void) { trits_to_trytes(message, message_trytes, BENCH_MESSAGE_TRITS); }
+
+static void run_trytes_to_trits(void) { trytes_to_trits(message_trytes, message, BENCH_MESSAGE_TRITS); }
+
+static int bench_setup(void) {
+  size_t i, lane;
+
+  ptrit_width = ptrit_batch_width();
+  if ((message_ptrits = (ptrit_t *)calloc(PTRIT_BATCH_MAX * BENCH_MESSAGE_TRITS, sizeof(ptrit_t))) == NULL) {
+    return EXIT_FAILURE;
+  }
+
+  for (i = 0; i < KERL_BATCH_WIDTH * BENCH_MESSAGE_TRITS; i++) {
+    message[i] = (trit_t)((i * 7 + i / 13) % 3) - 1;
+  }
+  // Troika trits are in [0, 2]
+  for (i = 0; i < BENCH_TROIKA_STATE_TRITS; i++) {
+    troika_state[i] = (trit_t)(message[i] + 1);
+  }
+  ftroika_nullify_state(ftroika_state);
+  ftroika_trits_to_rate(ftroika_state, troika_state, TROIKA_RATE);
+
+  // Lanes hash distinct messages
+  for (i = 0; i < PTRIT_BATCH_MAX; i++) {
+    for (lane = 0; lane < BENCH_PTRIT_LANES; lane++) {
+      trits_to_ptrits(message + (i + lane) % KERL_BATCH_WIDTH * BENCH_MESSAGE_TRITS,
+                      message_ptrits + i * BENCH_MESSAGE_TRITS, lane, BENCH_MESSAGE_TRITS);
+    }
+  }
+  copy_trits_to_bct(message_bct, 0, message, BENCH_MESSAGE_TRITS);
+  trits_to_bytes(message, message_bytes, BENCH_MESSAGE_TRITS);
+  trits_to_trytes(message, message_trytes, BENCH_MESSAGE_TRITS);
+
+  curl.type = CURL_P_81;
+  curl_init(&curl);
+  bcurl.type = CURL_P_81;
+  init_s_curl(&bcurl);
+  for (i = 0; i < PTRIT_BATCH_MAX; i++) {
+    ptrit_curl_init(&pcurls[i], CURL_P_81);
+  }
+  kerl_init(&kerl);
+
+  return EXIT_SUCCESS;
+}
+
+/**
+ * Runs a case for at least a duration, doubling the number of calls until it
+ * is reached so that timer resolution and warm up are negligible
+ */
+static void bench_run(bench_case_t const *const bench, uint64_t const duration_us, bench_result_t *const result) {
+  uint64_t calls = 1, start = 0, elapsed = 0;
+
+  bench->run();
+  for (;; calls *= 2) {
+    start = current_timestamp_us();
+    for (uint64_t i = 0; i < calls; i++) {
+      bench->run();
+    }
+    if ((elapsed = current_timestamp_us() - start) >= duration_us) {
+      break;
+    }
+  }
+
+  snprintf(result->name, sizeof(result->name), "%s", bench->name);
+  result->lanes = bench->lanes;
+  result->ns_per_op = elapsed * 1e3 / (calls * bench->lanes);
+  result->mb_per_s = (double)calls * bench->lanes * bench->trits / NUMBER_OF_TRITS_IN_A_BYTE / elapsed;
+}
+
+/**
+ * Compares results to those of a previous run
+ *
+ * @return the number of cases slower than the tolerance, -1 if the baseline could not be read
+ */
+static int bench_compare(char const *const path, double const tolerance, bench_result_t const *const results,
+                         size_t const count) {
+  FILE *file = NULL;
+  char line[128];
+  bench_result_t baseline;
+  double change = 0;
+  int regressions = 0;
+
+  if ((file = fopen(path, "r")) == NULL) {
+    fprintf(stderr, "Opening baseline %s failed\n", path);
+    return -1;
+  }
+
+  while (fgets(line, sizeof(line), file)) {
+    if (sscanf(line, "%31[^,],%zu,%lf,%lf", baseline.name, &baseline.lanes, &baseline.ns_per_op,
+               &baseline.mb_per_s) != 4) {
+      continue;
+    }
+    for (size_t i = 0; i < count; i++) {
+      if (strcmp(results[i].name, baseline.name) != 0 || results[i].lanes != baseline.lanes) {
+        continue;
+      }
+      change = (results[i].ns_per_op / baseline.ns_per_op - 1) * 100;
+      if (change > tolerance) {
+        regressions++;
+      }
+      fprintf(stderr, "%-20s %4zu lanes: %10.1f -> %10.1f ns/op, %+6.1f%%%s\n", baseline.name, baseline.lanes,
+              baseline.ns_per_op, results[i].ns_per_op, change, change > tolerance ? " REGRESSION" : "");
+    }
+  }
+
+  fclose(file);
+  return regressions;
+}
+
+int main(int argc, char *argv[]) {
+  bool csv = false;
+  uint64_t duration_ms = BENCH_DEFAULT_DURATION_MS;
+  char const *baseline = NULL;
+  double tolerance = BENCH_DEFAULT_TOLERANCE;
+  bench_result_t results[BENCH_MAX_CASES];
+  size_t cases_count = 0;
+  int opt = 0, regressions = 0;
+
+  while ((opt = getopt(argc, argv, "cd:b:t:")) != -1) {
+    switch (opt) {
+      case 'c':
+        csv = true;
+        break;
+      case 'd':
+        duration_ms = strtoull(optarg, NULL, 10);
+        break;
+      case 'b':
+        baseline = optarg;
+        break;
+      case 't':
+        tolerance = strtod(optarg, NULL);
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-c] [-d milliseconds] [-b baseline.csv] [-t tolerance percent]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+  }
+
+  if (bench_setup() != EXIT_SUCCESS) {
+    fprintf(stderr, "Allocating messages failed\n");
+    return EXIT_FAILURE;
+  }
+
+  bench_case_t const cases[] = {
+      {"curl", 1, BENCH_MESSAGE_TRITS, run_curl},
+      {"bct_curl", 1, BENCH_MESSAGE_TRITS, run_bct_curl},
+      {"ptrit_curl", BENCH_PTRIT_LANES, BENCH_MESSAGE_TRITS, run_ptrit_curl},
+      {"ptrit_curl_batch", BENCH_PTRIT_LANES * ptrit_width, BENCH_MESSAGE_TRITS, run_ptrit_curl_batch},
+      {"kerl", 1, BENCH_MESSAGE_TRITS, run_kerl},
+      {"kerl_batch", KERL_BATCH_WIDTH, BENCH_MESSAGE_TRITS, run_kerl_batch},
+      {"troika_permutation", 1, TROIKA_RATE, run_troika_permutation},
+      {"ftroika_permutation", 1, TROIKA_RATE, run_ftroika_permutation},
+      {"trits_to_bytes", 1, BENCH_MESSAGE_TRITS, run_trits_to_bytes},
+      {"bytes_to_trits", 1, BENCH_MESSAGE_TRITS, run_bytes_to_trits},
+      {"trits_to_trytes", 1, BENCH_MESSAGE_TRITS, run_trits_to_trytes},
+      {"trytes_to_trits", 1, BENCH_MESSAGE_TRITS, run_trytes_to_trits},
+  };
+  cases_count = sizeof(cases) / sizeof(cases[0]);
+
+  if (csv) {
+    printf("name,lanes,ns_per_op,mb_per_s\n");
+  } else {
+    printf("Batch width: %zu ptrit states, %d Kerl states\n", ptrit_width, KERL_BATCH_WIDTH);
+  }
+  for (size_t i = 0; i < cases_count; i++) {
+    bench_run(&cases[i], duration_ms * 1000, &results[i]);
+    if (csv) {
+      printf("%s,%zu,%.1f,%.2f\n", results[i].name, results[i].lanes, results[i].ns_per_op, results[i].mb_per_s);
+    } else {
+      printf("%-20s %4zu lanes: %10.1f ns/op, %8.2f MB/s\n", results[i].name, results[i].lanes, results[i].ns_per_op,
+             results[i].mb_per_s);
+    }
+    fflush(stdout);
+  }
+
+  free(message_ptrits);
+
+  if (baseline && (regressions = bench_compare(baseline, tolerance, results, cases_count)) != 0) {
+    if (regressions > 0) {
+      fprintf(stderr, "%d case(s) more than %.1f%% slower than the baseline\n", regressions, tolerance);
+    }
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -33,6 +33,18 @@ const char* error_2_string(retcode_t err) {
     case RC_SQLITE3_FAILED_STEP:
     // Storage SQL Module
     case RC_SQL_FAILED_WRITE_STATEMENT:
+    // Storage LMDB Module
+    case RC_LMDB_FAILED_OPEN_DB:
+    case RC_LMDB_NO_PATH_FOR_DB_SPECIFIED:
+    case RC_LMDB_FAILED_NOT_IMPLEMENTED:
+    case RC_LMDB_FAILED_BEGIN:
+    case RC_LMDB_FAILED_COMMIT:
+    case RC_LMDB_FAILED_GET:
+    case RC_LMDB_FAILED_PUT:
+    case RC_LMDB_FAILED_CURSOR:
+    case RC_LMDB_KEY_EXISTS:
+    case RC_LMDB_INVALID_RECORD:
+    case RC_LMDB_INCOMPATIBLE_DB:
     // Core Module
     case RC_CORE_NULL_CORE:
     case RC_CORE_FAILED_DATABASE_INIT:
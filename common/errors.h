@@ -79,6 +79,7 @@ extern "C" {
 #define RC_MODULE_CONSENSUS_SNAPSHOT (0x0D << RC_SHIFT_MODULE)
 #define RC_MODULE_LEDGER_VALIDATOR (0x0E << RC_SHIFT_MODULE)
 #define RC_MODULE_CONSENSUS_TIP_SELECTOR (0x0F << RC_SHIFT_MODULE)
+#define RC_MODULE_STORAGE_LMDB (0x10 << RC_SHIFT_MODULE)
 
 #define RC_MODULE_UTILS (0xA1 << RC_SHIFT_MODULE)
 
@@ -173,6 +174,19 @@ enum retcode_t {
   // Storage SQL Module
   RC_SQL_FAILED_WRITE_STATEMENT = 0x01 | RC_MODULE_STORAGE_SQL | RC_SEVERITY_MAJOR,
 
+  // Storage LMDB Module
+  RC_LMDB_FAILED_OPEN_DB = 0x01 | RC_MODULE_STORAGE_LMDB | RC_SEVERITY_FATAL,
+  RC_LMDB_NO_PATH_FOR_DB_SPECIFIED = 0x02 | RC_MODULE_STORAGE_LMDB | RC_SEVERITY_FATAL,
+  RC_LMDB_FAILED_NOT_IMPLEMENTED = 0x03 | RC_MODULE_STORAGE_LMDB | RC_SEVERITY_MAJOR,
+  RC_LMDB_FAILED_BEGIN = 0x04 | RC_MODULE_STORAGE_LMDB | RC_SEVERITY_MAJOR,
+  RC_LMDB_FAILED_COMMIT = 0x05 | RC_MODULE_STORAGE_LMDB | RC_SEVERITY_MAJOR,
+  RC_LMDB_FAILED_GET = 0x06 | RC_MODULE_STORAGE_LMDB | RC_SEVERITY_MAJOR,
+  RC_LMDB_FAILED_PUT = 0x07 | RC_MODULE_STORAGE_LMDB | RC_SEVERITY_MAJOR,
+  RC_LMDB_FAILED_CURSOR = 0x08 | RC_MODULE_STORAGE_LMDB | RC_SEVERITY_MAJOR,
+  RC_LMDB_KEY_EXISTS = 0x09 | RC_MODULE_STORAGE_LMDB | RC_SEVERITY_MODERATE,
+  RC_LMDB_INVALID_RECORD = 0x0A | RC_MODULE_STORAGE_LMDB | RC_SEVERITY_MAJOR,
+  RC_LMDB_INCOMPATIBLE_DB = 0x0B | RC_MODULE_STORAGE_LMDB | RC_SEVERITY_FATAL,
+
   // Core Module
   RC_CORE_NULL_CORE = 0x01 | RC_MODULE_CORE | RC_SEVERITY_FATAL,
   RC_CORE_FAILED_DATABASE_INIT = 0x02 | RC_MODULE_CORE | RC_SEVERITY_FATAL,
@@ -301,6 +315,9 @@ enum retcode_t {
   RC_UTILS_SOCKET_CONNECT = 0x12 | RC_MODULE_UTILS | RC_SEVERITY_MAJOR,
   RC_UTILS_SOCKET_RECV = 0x13 | RC_MODULE_UTILS | RC_SEVERITY_MINOR,
   RC_UTILS_SOCKET_SEND = 0x14 | RC_MODULE_UTILS | RC_SEVERITY_MINOR,
+  // Utils MPSC ring
+  RC_UTILS_RING_FULL = 0x15 | RC_MODULE_UTILS | RC_SEVERITY_MINOR,
+  RC_UTILS_RING_EMPTY = 0x16 | RC_MODULE_UTILS | RC_SEVERITY_MINOR,
 
   // Broadcaster module
   RC_BROADCASTER_FAILED_PUSH_QUEUE = 0x01 | RC_MODULE_BROADCASTER | RC_SEVERITY_MINOR,
@@ -309,6 +326,7 @@ enum retcode_t {
   // Processor component module
   RC_PROCESSOR_INVALID_TRANSACTION = 0x01 | RC_MODULE_PROCESSOR | RC_SEVERITY_MODERATE,
   RC_PROCESSOR_INVALID_REQUEST = 0x02 | RC_MODULE_PROCESSOR | RC_SEVERITY_MODERATE,
+  RC_PROCESSOR_INVALID_WORKER = 0x03 | RC_MODULE_PROCESSOR | RC_SEVERITY_MINOR,
 
   // Receiver component module
   RC_RECEIVER_COMPONENT_NULL_STATE = 0x01 | RC_MODULE_RECEIVER_COMPONENT | RC_SEVERITY_FATAL,
@@ -425,6 +443,9 @@ enum retcode_t {
 
   // Helpers Module
   RC_HELPERS_POW_INVALID_TX = 0x01 | RC_MODULE_HELPERS | RC_SEVERITY_MODERATE,
+  // The nonce search was interrupted or could not be run
+  RC_HELPERS_POW_FAILED = 0x02 | RC_MODULE_HELPERS | RC_SEVERITY_MODERATE,
+  RC_HELPERS_INVALID_SECURITY = 0x03 | RC_MODULE_HELPERS | RC_SEVERITY_MODERATE,
 
   // Crypto Module
   RC_CRYPTO_UNSUPPORTED_SPONGE_TYPE = 0x01 | RC_MODULE_HELPERS | RC_SEVERITY_MAJOR,
@@ -11,22 +11,35 @@
 #include "utarray.h"
 
 #include "common/crypto/curl-p/hashcash.h"
+#include "common/crypto/curl-p/ptrit.h"
 #include "common/helpers/digest.h"
 #include "common/helpers/pow.h"
+#include "common/trinary/trit_ptrit.h"
 #include "common/trinary/trit_tryte.h"
 #include "utils/export.h"
 #include "utils/time.h"
 
 #define NONCE_LENGTH 27 * 3
+// Trits preceding the trunk, they are absorbed the same way wherever the bundle is attached
+#define POW_MIDSTATE_TRITS (NUM_TRITS_SERIALIZED_TRANSACTION - NUM_TRITS_HASH - NUM_TRITS_TRUNK - NUM_TRITS_BRANCH)
+// Number of transactions absorbed at once by a ptrit Curl
+#define POW_MIDSTATE_LANES 64
 
 trit_t *do_pow(Curl *const curl, trit_t const *const trits_in, size_t const trits_len, uint8_t const mwm) {
   tryte_t *nonce_trits = (tryte_t *)calloc(NONCE_LENGTH + 1, sizeof(tryte_t));
 
+  if (nonce_trits == NULL) {
+    return NULL;
+  }
+
   curl_absorb(curl, trits_in, trits_len - HASH_LENGTH_TRIT);
   memcpy(curl->state, trits_in + trits_len - HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
 
-  // FIXME(th0br0) deal with result value of `hashcash` call
-  hashcash(curl, BODY, HASH_LENGTH_TRIT - NONCE_LENGTH, HASH_LENGTH_TRIT, mwm);
+  // The search may have been interrupted, see pearl_diver_cancel_all
+  if (hashcash(curl, BODY, HASH_LENGTH_TRIT - NONCE_LENGTH, HASH_LENGTH_TRIT, mwm) != PEARL_DIVER_SUCCESS) {
+    free(nonce_trits);
+    return NULL;
+  }
 
   memcpy(nonce_trits, curl->state + HASH_LENGTH_TRIT - NONCE_LENGTH, NONCE_LENGTH);
 
@@ -89,43 +102,142 @@ IOTA_EXPORT flex_trit_t *iota_pow_flex(flex_trit_t const *const flex_trits_in, s
   return nonce_flex_trits;
 }
 
+/**
+ * Absorbs the trits preceding the trunk of transactions, which do not depend
+ * on where the bundle is attached, a batch of ptrit Curls at a time
+ *
+ * @param txs The transactions
+ * @param count The number of transactions
+ * @param midstates The Curl state of each transaction after the absorption
+ *
+ * @return a status code
+ */
+static retcode_t pow_bundle_midstates(iota_transaction_t **const txs, size_t const count, trit_t *const midstates) {
+  retcode_t ret = RC_OK;
+  flex_trit_t txflex[FLEX_TRIT_SIZE_8019];
+  trit_t trits[POW_MIDSTATE_TRITS];
+  size_t const group_size = POW_MIDSTATE_LANES * PTRIT_BATCH_MAX;
+  size_t group_count = 0, curls_count = 0, i = 0, j = 0;
+  PCurl *curls = (PCurl *)calloc(PTRIT_BATCH_MAX, sizeof(PCurl));
+  ptrit_t *acc = (ptrit_t *)calloc(PTRIT_BATCH_MAX * POW_MIDSTATE_TRITS, sizeof(ptrit_t));
+
+  if (curls == NULL || acc == NULL) {
+    ret = RC_OOM;
+    goto done;
+  }
+
+  for (i = 0; i < count; i += group_size) {
+    group_count = count - i < group_size ? count - i : group_size;
+    curls_count = (group_count + POW_MIDSTATE_LANES - 1) / POW_MIDSTATE_LANES;
+
+    for (j = 0; j < curls_count; j++) {
+      ptrit_curl_init(&curls[j], CURL_P_81);
+    }
+    memset(acc, 0, curls_count * POW_MIDSTATE_TRITS * sizeof(ptrit_t));
+
+    for (j = 0; j < group_count; j++) {
+      transaction_serialize_on_flex_trits(txs[i + j], txflex);
+      flex_trits_to_trits(trits, POW_MIDSTATE_TRITS, txflex, NUM_TRITS_SERIALIZED_TRANSACTION, POW_MIDSTATE_TRITS);
+      trits_to_ptrits(trits, acc + (j / POW_MIDSTATE_LANES) * POW_MIDSTATE_TRITS, j % POW_MIDSTATE_LANES,
+                      POW_MIDSTATE_TRITS);
+    }
+
+    ptrit_curl_absorb_batch(curls, curls_count, acc, POW_MIDSTATE_TRITS);
+
+    for (j = 0; j < group_count; j++) {
+      ptrits_to_trits(curls[j / POW_MIDSTATE_LANES].state, midstates + (i + j) * STATE_LENGTH, j % POW_MIDSTATE_LANES,
+                      STATE_LENGTH);
+    }
+  }
+
+done:
+  free(curls);
+  free(acc);
+  return ret;
+}
+
 IOTA_EXPORT retcode_t iota_pow_bundle(bundle_transactions_t *const bundle, flex_trit_t const *const trunk,
                                       flex_trit_t const *const branch, uint8_t const mwm) {
+  return iota_pow_bundle_timed(bundle, trunk, branch, mwm, NULL);
+}
+
+IOTA_EXPORT retcode_t iota_pow_bundle_timed(bundle_transactions_t *const bundle, flex_trit_t const *const trunk,
+                                            flex_trit_t const *const branch, uint8_t const mwm,
+                                            iota_pow_timing_t *const timing) {
+  retcode_t ret = RC_OK;
   flex_trit_t txflex[FLEX_TRIT_SIZE_8019];
+  flex_trit_t nonce[FLEX_TRIT_SIZE_81];
+  flex_trit_t ctrunk[FLEX_TRIT_SIZE_243];
+  trit_t trits[NUM_TRITS_SERIALIZED_TRANSACTION];
+  trit_t hash[HASH_LENGTH_TRIT];
+  iota_transaction_t **txs = NULL;
   iota_transaction_t *tx = NULL;
-  flex_trit_t *nonce = NULL;
-  flex_trit_t *ctrunk = NULL;
-  size_t cur_idx = 0;
+  trit_t *midstates = NULL;
+  size_t count = 0, cur_idx = 0;
+  uint64_t start = current_timestamp_us(), tx_start = 0;
+  Curl curl;
 
   if (bundle == NULL || trunk == NULL || branch == NULL) {
     return RC_NULL_PARAM;
   }
 
+  if (timing) {
+    memset(timing, 0, sizeof(iota_pow_timing_t));
+  }
+
   if (bundle_transactions_size(bundle) == 0) {
     return RC_OK;
   }
 
   tx = (iota_transaction_t *)utarray_front(bundle);
-  cur_idx = tx->essence.last_index + 1;
+  count = tx->essence.last_index + 1;
 
-  do {
-    cur_idx--;
+  if (count != bundle_transactions_size(bundle)) {
+    return RC_HELPERS_POW_INVALID_TX;
+  }
 
-    for (tx = (iota_transaction_t *)utarray_front(bundle); tx != NULL && tx->essence.current_index != cur_idx;
-         tx = (iota_transaction_t *)utarray_next(bundle, tx))
-      ;
+  if ((txs = (iota_transaction_t **)calloc(count, sizeof(iota_transaction_t *))) == NULL ||
+      (midstates = (trit_t *)malloc(count * STATE_LENGTH * sizeof(trit_t))) == NULL) {
+    ret = RC_OOM;
+    goto done;
+  }
 
-    if (tx == NULL) {
-      return RC_HELPERS_POW_INVALID_TX;
+  BUNDLE_FOREACH(bundle, tx) {
+    if (transaction_current_index(tx) >= count || txs[transaction_current_index(tx)] != NULL) {
+      ret = RC_HELPERS_POW_INVALID_TX;
+      goto done;
     }
+    txs[transaction_current_index(tx)] = tx;
+  }
+
+  if (timing) {
+    if ((timing->transactions_us = (uint64_t *)calloc(count, sizeof(uint64_t))) == NULL) {
+      ret = RC_OOM;
+      goto done;
+    }
+    timing->transactions_count = count;
+  }
 
-    if (transaction_current_index(tx) == transaction_last_index(tx)) {
+  // Only the trunk, branch and last chunk of each transaction are left to absorb once its trunk is known
+  if ((ret = pow_bundle_midstates(txs, count, midstates)) != RC_OK) {
+    goto done;
+  }
+  if (timing) {
+    timing->midstates_us = current_timestamp_us() - start;
+  }
+
+  cur_idx = count;
+  do {
+    cur_idx--;
+    tx_start = current_timestamp_us();
+    tx = txs[cur_idx];
+
+    if (cur_idx == count - 1) {
       transaction_set_trunk(tx, trunk);
       transaction_set_branch(tx, branch);
     } else {
       transaction_set_trunk(tx, ctrunk);
       transaction_set_branch(tx, trunk);
-      free(ctrunk);
     }
     transaction_set_attachment_timestamp(tx, current_timestamp_ms());
     transaction_set_attachment_timestamp_lower(tx, 0);
@@ -135,21 +247,52 @@ IOTA_EXPORT retcode_t iota_pow_bundle(bundle_transactions_t *const bundle, flex_
     }
 
     transaction_serialize_on_flex_trits(tx, txflex);
+    flex_trits_to_trits(trits, NUM_TRITS_SERIALIZED_TRANSACTION, txflex, NUM_TRITS_SERIALIZED_TRANSACTION,
+                        NUM_TRITS_SERIALIZED_TRANSACTION);
+
+    curl.type = CURL_P_81;
+    memcpy(curl.state, midstates + cur_idx * STATE_LENGTH, STATE_LENGTH * sizeof(trit_t));
+    curl_absorb(&curl, trits + POW_MIDSTATE_TRITS, NUM_TRITS_TRUNK + NUM_TRITS_BRANCH);
+    memcpy(curl.state, trits + NUM_TRITS_SERIALIZED_TRANSACTION - HASH_LENGTH_TRIT, HASH_LENGTH_TRIT * sizeof(trit_t));
 
-    if ((nonce = iota_pow_flex(txflex, NUM_TRITS_SERIALIZED_TRANSACTION, mwm)) == NULL) {
-      return RC_OOM;
+    if (hashcash(&curl, BODY, HASH_LENGTH_TRIT - NONCE_LENGTH, HASH_LENGTH_TRIT, mwm) != PEARL_DIVER_SUCCESS) {
+      ret = RC_HELPERS_POW_FAILED;
+      goto done;
     }
+    flex_trits_from_trits(nonce, NUM_TRITS_NONCE, curl.state + HASH_LENGTH_TRIT - NONCE_LENGTH, NUM_TRITS_NONCE,
+                          NUM_TRITS_NONCE);
     transaction_set_nonce(tx, nonce);
-    free(nonce);
 
-    if (transaction_current_index(tx) != 0) {
-      transaction_serialize_on_flex_trits(tx, txflex);
-      if ((ctrunk = iota_flex_digest(txflex, NUM_TRITS_SERIALIZED_TRANSACTION)) == NULL) {
-        return RC_OOM;
-      }
+    if (cur_idx != 0) {
+      // The hash is squeezed after absorbing the last chunk, now holding the nonce, in the searched state
+      memcpy(trits, curl.state, HASH_LENGTH_TRIT * sizeof(trit_t));
+      curl_absorb(&curl, trits, HASH_LENGTH_TRIT);
+      curl_squeeze(&curl, hash, HASH_LENGTH_TRIT);
+      flex_trits_from_trits(ctrunk, HASH_LENGTH_TRIT, hash, HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
     }
 
+    if (timing) {
+      timing->transactions_us[cur_idx] = current_timestamp_us() - tx_start;
+    }
   } while (cur_idx != 0);
 
-  return RC_OK;
+  if (timing) {
+    timing->total_us = current_timestamp_us() - start;
+  }
+
+done:
+  free(txs);
+  free(midstates);
+  if (ret != RC_OK && timing) {
+    iota_pow_timing_free(timing);
+  }
+  return ret;
+}
+
+IOTA_EXPORT void iota_pow_timing_free(iota_pow_timing_t *const timing) {
+  if (timing) {
+    free(timing->transactions_us);
+    timing->transactions_us = NULL;
+    timing->transactions_count = 0;
+  }
 }
@@ -19,6 +19,15 @@
 extern "C" {
 #endif
 
+typedef struct iota_pow_timing_s {
+  // Absorbing the trits preceding the trunk of all transactions at once
+  uint64_t midstates_us;
+  // Attaching each transaction, indexed by current index
+  uint64_t *transactions_us;
+  size_t transactions_count;
+  uint64_t total_us;
+} iota_pow_timing_t;
+
 trit_t *do_pow(Curl *const curl, trit_t const *const trits_in, size_t const trits_len, uint8_t const mwm);
 
 IOTA_EXPORT char *iota_pow_trytes(char const *const trytes_in, uint8_t const mwm);
@@ -28,6 +37,28 @@ IOTA_EXPORT flex_trit_t *iota_pow_flex(flex_trit_t const *const flex_trits_in, s
 IOTA_EXPORT retcode_t iota_pow_bundle(bundle_transactions_t *const bundle, flex_trit_t const *const trunk,
                                       flex_trit_t const *const branch, uint8_t const mwm);
 
+/**
+ * Attaches a bundle like iota_pow_bundle and measures the time spent
+ *
+ * @param bundle The bundle
+ * @param trunk The trunk of the last transaction
+ * @param branch The branch of the transactions
+ * @param mwm The minimum weight magnitude
+ * @param timing The timing, to be released with iota_pow_timing_free
+ *
+ * @return a status code
+ */
+IOTA_EXPORT retcode_t iota_pow_bundle_timed(bundle_transactions_t *const bundle, flex_trit_t const *const trunk,
+                                            flex_trit_t const *const branch, uint8_t const mwm,
+                                            iota_pow_timing_t *const timing);
+
+/**
+ * Releases the per-transaction timing of a bundle attachment
+ *
+ * @param timing The timing
+ */
+IOTA_EXPORT void iota_pow_timing_free(iota_pow_timing_t *const timing);
+
 #ifdef __cplusplus
 }
 #endif
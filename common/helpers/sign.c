@@ -13,15 +13,100 @@
 #include "common/crypto/iss/normalize.h"
 #include "common/crypto/iss/v1/iss_kerl.h"
 #include "common/crypto/kerl/kerl.h"
+#include "common/crypto/kerl/kerl_batch.h"
 #include "common/defs.h"
 #include "common/helpers/sign.h"
 #include "common/trinary/trit_tryte.h"
 #include "utils/export.h"
+#include "utils/handles/thread.h"
+#include "utils/system.h"
+
+typedef struct address_gen_batch_s {
+  trit_t const* seed;
+  size_t start;
+  size_t count;
+  size_t security;
+  size_t stride;
+  flex_trit_t* addresses;
+} address_gen_batch_t;
+
+typedef struct address_gen_worker_s {
+  address_gen_batch_t const* batch;
+  size_t id;
+  retcode_t ret;
+} address_gen_worker_t;
+
+/**
+ * Digests the keys like iss_kerl_key_digest, hashing the chains of KERL_BATCH_WIDTH fragments at once
+ *
+ * @param key The keys, consumed
+ * @param digest The digests, may be the keys
+ * @param key_length The length of the keys
+ * @param kerl The Kerl state digesting the hashed keys
+ */
+static void key_digest(trit_t* const key, trit_t* const digest, size_t const key_length, Kerl* const kerl) {
+  size_t const fragments_count = key_length / HASH_LENGTH_TRIT;
+  size_t count = 0, i = 0, j = 0;
+  kerl_batch_t batch;
+
+  for (i = 0; i < fragments_count; i += count) {
+    count = fragments_count - i < KERL_BATCH_WIDTH ? fragments_count - i : KERL_BATCH_WIDTH;
+    for (j = 0; j < TRYTE_VALUE_MAX - TRYTE_VALUE_MIN; j++) {
+      kerl_batch_init(&batch, count);
+      kerl_batch_absorb(&batch, &key[i * HASH_LENGTH_TRIT], HASH_LENGTH_TRIT);
+      kerl_batch_squeeze(&batch, &key[i * HASH_LENGTH_TRIT], HASH_LENGTH_TRIT);
+    }
+  }
 
-IOTA_EXPORT trit_t* iota_sign_address_gen_trits(trit_t const* const seed, size_t const index, size_t const security) {
-  Kerl kerl;
+  for (i = 0; i < key_length / ISS_KEY_LENGTH; i++) {
+    kerl_absorb(kerl, &key[i * ISS_KEY_LENGTH], ISS_KEY_LENGTH);
+    kerl_squeeze(kerl, &digest[i * HASH_LENGTH_TRIT], HASH_LENGTH_TRIT);
+    kerl_reset(kerl);
+  }
+}
+
+static void address_gen(trit_t const* const seed, size_t const index, size_t const security, trit_t* const key,
+                        trit_t* const address, Kerl* const kerl) {
   trit_t subseed[HASH_LENGTH_TRIT];
   size_t const key_length = security * ISS_KEY_LENGTH;
+
+  kerl_init(kerl);
+  memcpy(subseed, seed, HASH_LENGTH_TRIT);
+  iss_kerl_subseed(subseed, subseed, index, kerl);
+  iss_kerl_key(subseed, key, key_length, kerl);
+  memset(subseed, 0, HASH_LENGTH_TRIT);
+  key_digest(key, key, key_length, kerl);
+  iss_kerl_address(key, address, security * HASH_LENGTH_TRIT, kerl);
+  memset(key, 0, key_length * sizeof(trit_t));
+  kerl_reset(kerl);
+}
+
+static void* address_gen_worker(void* arg) {
+  address_gen_worker_t* worker = (address_gen_worker_t*)arg;
+  address_gen_batch_t const* batch = worker->batch;
+  trit_t address[HASH_LENGTH_TRIT];
+  trit_t* key = NULL;
+  Kerl kerl;
+
+  if ((key = (trit_t*)calloc(batch->security * ISS_KEY_LENGTH, sizeof(trit_t))) == NULL) {
+    worker->ret = RC_OOM;
+    return NULL;
+  }
+
+  for (size_t i = worker->id; i < batch->count; i += batch->stride) {
+    address_gen(batch->seed, batch->start + i, batch->security, key, address, &kerl);
+    flex_trits_from_trits(batch->addresses + i * FLEX_TRIT_SIZE_243, HASH_LENGTH_TRIT, address, HASH_LENGTH_TRIT,
+                          HASH_LENGTH_TRIT);
+  }
+
+  free(key);
+  worker->ret = RC_OK;
+
+  return NULL;
+}
+
+IOTA_EXPORT trit_t* iota_sign_address_gen_trits(trit_t const* const seed, size_t const index, size_t const security) {
+  Kerl kerl;
   trit_t* address = NULL;
   trit_t* key = NULL;
 
@@ -29,7 +114,7 @@ IOTA_EXPORT trit_t* iota_sign_address_gen_trits(trit_t const* const seed, size_t
     return NULL;
   }
 
-  if ((key = (trit_t*)calloc(key_length, sizeof(trit_t))) == NULL) {
+  if ((key = (trit_t*)calloc(security * ISS_KEY_LENGTH, sizeof(trit_t))) == NULL) {
     return NULL;
   }
 
@@ -38,20 +123,88 @@ IOTA_EXPORT trit_t* iota_sign_address_gen_trits(trit_t const* const seed, size_t
     return NULL;
   }
 
-  kerl_init(&kerl);
-  memcpy(subseed, seed, HASH_LENGTH_TRIT);
-  iss_kerl_subseed(subseed, subseed, index, &kerl);
-  iss_kerl_key(subseed, key, key_length, &kerl);
-  memset(subseed, 0, HASH_LENGTH_TRIT);
-  iss_kerl_key_digest(key, key, key_length, &kerl);
-  iss_kerl_address(key, address, security * HASH_LENGTH_TRIT, &kerl);
-  memset(key, 0, key_length * sizeof(trit_t));
-  kerl_reset(&kerl);
+  address_gen(seed, index, security, key, address, &kerl);
   free(key);
 
   return address;
 }
 
+IOTA_EXPORT retcode_t iota_sign_addresses_gen_flex_trits(flex_trit_t const* const seed, size_t const start,
+                                                         size_t const count, size_t const security,
+                                                         flex_trit_t* const addresses) {
+  retcode_t ret = RC_OK;
+  trit_t seed_trits[HASH_LENGTH_TRIT];
+  address_gen_batch_t batch;
+  address_gen_worker_t* workers = NULL;
+  thread_handle_t* threads = NULL;
+  size_t workers_count = system_cpu_available();
+  size_t started = 0;
+
+  if (seed == NULL || addresses == NULL) {
+    return RC_NULL_PARAM;
+  }
+  if (!(security > 0 && security <= 3)) {
+    return RC_HELPERS_INVALID_SECURITY;
+  }
+  if (count == 0) {
+    return RC_OK;
+  }
+
+  if (workers_count > count) {
+    workers_count = count;
+  }
+  if (workers_count == 0) {
+    workers_count = 1;
+  }
+
+  if ((workers = (address_gen_worker_t*)calloc(workers_count, sizeof(address_gen_worker_t))) == NULL ||
+      (threads = (thread_handle_t*)calloc(workers_count, sizeof(thread_handle_t))) == NULL) {
+    ret = RC_OOM;
+    goto done;
+  }
+
+  flex_trits_to_trits(seed_trits, HASH_LENGTH_TRIT, seed, HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
+  batch.seed = seed_trits;
+  batch.start = start;
+  batch.count = count;
+  batch.security = security;
+  batch.stride = workers_count;
+  batch.addresses = addresses;
+
+  // The calling thread generates the first share of the addresses itself
+  for (size_t i = 0; i < workers_count; i++) {
+    workers[i].batch = &batch;
+    workers[i].id = i;
+    workers[i].ret = RC_OK;
+  }
+  for (started = 1; started < workers_count; started++) {
+    if (thread_handle_create(&threads[started], address_gen_worker, &workers[started]) != 0) {
+      break;
+    }
+  }
+  // Shares of the workers that could not be started are generated here too
+  for (size_t i = started; i < workers_count; i++) {
+    address_gen_worker(&workers[i]);
+  }
+  address_gen_worker(&workers[0]);
+  for (size_t i = 1; i < started; i++) {
+    thread_handle_join(threads[i], NULL);
+  }
+
+  for (size_t i = 0; i < workers_count; i++) {
+    if (workers[i].ret != RC_OK) {
+      ret = workers[i].ret;
+      break;
+    }
+  }
+
+done:
+  memset_safe(seed_trits, HASH_LENGTH_TRIT * sizeof(trit_t), 0, HASH_LENGTH_TRIT * sizeof(trit_t));
+  free(workers);
+  free(threads);
+  return ret;
+}
+
 IOTA_EXPORT char* iota_sign_address_gen_trytes(char const* const seed, size_t const index, size_t const security) {
   trit_t seed_trits[HASH_LENGTH_TRIT];
   char* address = NULL;
@@ -10,6 +10,7 @@
 
 #include <stddef.h>
 
+#include "common/errors.h"
 #include "common/trinary/flex_trit.h"
 #include "utils/export.h"
 #include "utils/memset_safe.h"
@@ -23,6 +24,22 @@ IOTA_EXPORT char* iota_sign_address_gen_trytes(char const* const seed, size_t co
 IOTA_EXPORT flex_trit_t* iota_sign_address_gen_flex_trits(flex_trit_t const* const seed, size_t const index,
                                                           size_t const security);
 
+/**
+ * Generates the addresses of consecutive indexes, spread over one thread per
+ * available CPU
+ *
+ * @param seed The seed
+ * @param start The index of the first address
+ * @param count The number of addresses
+ * @param security The security level, from 1 to 3
+ * @param addresses count * FLEX_TRIT_SIZE_243 flex trits receiving the addresses
+ *
+ * @return a status code
+ */
+IOTA_EXPORT retcode_t iota_sign_addresses_gen_flex_trits(flex_trit_t const* const seed, size_t const start,
+                                                         size_t const count, size_t const security,
+                                                         flex_trit_t* const addresses);
+
 IOTA_EXPORT trit_t* iota_sign_signature_gen_trits(trit_t const* const seed, size_t const index, size_t const security,
                                                   trit_t const* const bundle_hash);
 IOTA_EXPORT char* iota_sign_signature_gen_trytes(char const* const seed, size_t const index, size_t const security,
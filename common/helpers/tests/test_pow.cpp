@@ -14,6 +14,7 @@
 
 #include "common/helpers/digest.h"
 #include "common/helpers/pow.h"
+#include "common/model/bundle.h"
 
 namespace {
 const std::string TX_TRYTES =
@@ -97,4 +98,63 @@ TEST(PoWTest, testsFlexPoW) {
   EXPECT_EQ("999", hash.substr(NUM_TRYTES_HASH - 3));
 }
 
+TEST(PoWTest, testsBundlePoW) {
+  using namespace testing;
+
+  size_t const count = 4;
+  flex_trit_t tx_trits[FLEX_TRIT_SIZE_8019] = {0};
+  flex_trit_t trunk[FLEX_TRIT_SIZE_243] = {0};
+  flex_trit_t branch[FLEX_TRIT_SIZE_243] = {0};
+  bundle_transactions_t *bundle = NULL;
+  iota_transaction_t tx;
+  iota_pow_timing_t timing;
+
+  flex_trits_from_trytes(tx_trits, NUM_TRITS_SERIALIZED_TRANSACTION, (const tryte_t *)TX_TRYTES.c_str(),
+                         TX_TRYTES.length(), TX_TRYTES.size());
+  flex_trits_from_trytes(trunk, NUM_TRITS_HASH, (const tryte_t *)TX_TRYTES.c_str(), NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  flex_trits_from_trytes(branch, NUM_TRITS_HASH, (const tryte_t *)TX_TRYTES.c_str() + NUM_TRYTES_HASH,
+                         NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+
+  bundle_transactions_new(&bundle);
+  // Added out of order, transactions are attached by current index
+  for (size_t i = count; i-- > 0;) {
+    transaction_deserialize_from_trits(&tx, tx_trits, false);
+    transaction_set_current_index(&tx, i);
+    transaction_set_last_index(&tx, count - 1);
+    bundle_transactions_add(bundle, &tx);
+  }
+
+  ASSERT_EQ(iota_pow_bundle_timed(bundle, trunk, branch, 9, &timing), RC_OK);
+  EXPECT_EQ(timing.transactions_count, count);
+
+  iota_transaction_t *txs[count];
+  flex_trit_t *hashes[count];
+  iota_transaction_t *curr_tx = NULL;
+  BUNDLE_FOREACH(bundle, curr_tx) {
+    txs[transaction_current_index(curr_tx)] = curr_tx;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    transaction_serialize_on_flex_trits(txs[i], tx_trits);
+    hashes[i] = iota_flex_digest(tx_trits, NUM_TRITS_SERIALIZED_TRANSACTION);
+
+    tryte_t hash[NUM_TRYTES_HASH] = {0};
+    flex_trits_to_trytes(hash, NUM_TRYTES_HASH, hashes[i], NUM_TRITS_HASH, NUM_TRITS_HASH);
+    EXPECT_EQ("999", std::string((const char *)hash, NUM_TRYTES_HASH).substr(NUM_TRYTES_HASH - 3));
+  }
+
+  EXPECT_EQ(memcmp(transaction_trunk(txs[count - 1]), trunk, FLEX_TRIT_SIZE_243), 0);
+  EXPECT_EQ(memcmp(transaction_branch(txs[count - 1]), branch, FLEX_TRIT_SIZE_243), 0);
+  for (size_t i = 0; i < count - 1; i++) {
+    EXPECT_EQ(memcmp(transaction_trunk(txs[i]), hashes[i + 1], FLEX_TRIT_SIZE_243), 0);
+    EXPECT_EQ(memcmp(transaction_branch(txs[i]), trunk, FLEX_TRIT_SIZE_243), 0);
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    std::free(hashes[i]);
+  }
+  iota_pow_timing_free(&timing);
+  bundle_transactions_free(&bundle);
+}
+
 }  // namespace
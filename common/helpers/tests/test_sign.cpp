@@ -1089,4 +1089,25 @@ TEST(KerlTest, testFlexSignature) {
 
   free(out_1);
 }
+
+TEST(KerlTest, testBatchAddressGeneration) {
+  const std::string SEED =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZ9ABCDEFGHIJKLMNOPQRSTUVWXYZ9ABCDEFGHIJKLMNOPQ"
+      "RSTUVWXYZ9";
+  size_t const start = 2;
+  size_t const count = 5;
+  flex_trit_t seed[FLEX_TRIT_SIZE_243];
+  flex_trit_t addresses[count * FLEX_TRIT_SIZE_243];
+
+  flex_trits_from_trytes(seed, HASH_LENGTH_TRIT, (tryte_t const*)SEED.c_str(), HASH_LENGTH_TRYTE, HASH_LENGTH_TRYTE);
+
+  EXPECT_EQ(iota_sign_addresses_gen_flex_trits(seed, start, count, 2, addresses), RC_OK);
+  for (size_t i = 0; i < count; i++) {
+    flex_trit_t* address = iota_sign_address_gen_flex_trits(seed, start + i, 2);
+    EXPECT_TRUE(memcmp(address, addresses + i * FLEX_TRIT_SIZE_243, FLEX_TRIT_SIZE_243) == 0);
+    free(address);
+  }
+
+  EXPECT_EQ(iota_sign_addresses_gen_flex_trits(seed, start, count, 4, addresses), RC_HELPERS_INVALID_SECURITY);
+}
 }  // namespace
@@ -5,60 +5,102 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <stdlib.h>
+
 #include "common/model/bundle.h"
-#include "common/crypto/iss/v1/iss_kerl.h"
 #include "common/model/transfer.h"
+#include "common/trinary/add.h"
 #include "common/trinary/trit_long.h"
 #include "common/trinary/tryte_long.h"
 
 static UT_icd bundle_transactions_icd = {sizeof(iota_transaction_t), 0, 0, 0};
 
+// Returns the transaction following the input and the transactions holding the rest of its signature
+static iota_transaction_t *input_signature_end(bundle_transactions_t const *const bundle,
+                                               iota_transaction_t *const input_tx) {
+  iota_transaction_t *curr_tx = input_tx;
+
+  do {
+    curr_tx = (iota_transaction_t *)utarray_next(bundle, curr_tx);
+  } while (curr_tx != NULL &&
+           memcmp(transaction_address(curr_tx), transaction_address(input_tx), FLEX_TRIT_SIZE_243) == 0 &&
+           transaction_value(curr_tx) == 0);
+
+  return curr_tx;
+}
+
 /**
  * Validate signatures in a bundle,
  * it's a private method called by bundle_validator()
+ * The digests of all signature fragments are computed at once by the ISS
+ * verifier before the addresses are checked
  *
  * @param {bundle_transactions_t} bundle - the bundle with transactions.
+ * @param {iss_verifier_t} verifier - the verifier, NULL to compute the digests in the calling thread
  * @param {trit_t} normalized_bundle - the bundle hash
  * @param {Kerl} address_kerl - the kerl instance for address calculation
- * @param {Kerl} sig_frag_kerl - the kerl instance for signature calculation
  * @param {bool} is_valid - the result of validation
  *
  * @return {retcode_t}
  */
-static retcode_t validate_signatures(bundle_transactions_t const *const bundle, trit_t const *const normalized_bundle,
-                                     Kerl *const address_kerl, Kerl *const sig_frag_kerl, bool *const is_valid) {
-  iota_transaction_t *curr_tx = NULL, *curr_inp_tx = NULL;
-  trit_t digested_sig_trits[NUM_TRITS_ADDRESS];
+static retcode_t validate_signatures(bundle_transactions_t const *const bundle, iss_verifier_t *const verifier,
+                                     trit_t const *const normalized_bundle, Kerl *const address_kerl,
+                                     bool *const is_valid) {
+  retcode_t ret = RC_OK;
+  iota_transaction_t *curr_tx = NULL, *curr_inp_tx = NULL, *end_tx = NULL;
   trit_t digested_address[NUM_TRITS_ADDRESS];
-  trit_t key[NUM_TRITS_SIGNATURE];
   flex_trit_t digest[FLEX_TRIT_SIZE_243];
-  size_t offset = 0, next_offset = 0;
+  size_t const max_jobs = utarray_len(bundle);
+  iss_verifier_job_t *jobs = NULL;
+  trit_t *keys = NULL, *digests = NULL;
+  size_t jobs_count = 0, offset = 0;
 
   *is_valid = true;
 
+  jobs = (iss_verifier_job_t *)malloc(max_jobs * sizeof(iss_verifier_job_t));
+  keys = (trit_t *)malloc(max_jobs * NUM_TRITS_SIGNATURE * sizeof(trit_t));
+  digests = (trit_t *)malloc(max_jobs * NUM_TRITS_ADDRESS * sizeof(trit_t));
+  if (jobs == NULL || keys == NULL || digests == NULL) {
+    ret = RC_OOM;
+    goto done;
+  }
+
   for (curr_tx = (iota_transaction_t *)utarray_eltptr(bundle, 0); curr_tx != NULL;) {
     if (transaction_value(curr_tx) >= 0) {
       curr_tx = (iota_transaction_t *)utarray_next(bundle, curr_tx);
       continue;
     }
-    curr_inp_tx = curr_tx;
-    offset = 0;
-    next_offset = 0;
-    kerl_init(address_kerl);
-    do {
-      kerl_init(sig_frag_kerl);
-      next_offset = (offset + ISS_FRAGMENTS * RADIX - 1) % NUM_TRITS_HASH + 1;
-      flex_trits_to_trits(key, NUM_TRITS_SIGNATURE, transaction_signature(curr_inp_tx), NUM_TRITS_SIGNATURE,
-                          NUM_TRITS_SIGNATURE);
-      iss_kerl_sig_digest(digested_sig_trits, &normalized_bundle[offset % NUM_TRITS_HASH], key, NUM_TRITS_SIGNATURE,
-                          sig_frag_kerl);
-      kerl_absorb(address_kerl, digested_sig_trits, NUM_TRITS_ADDRESS);
-      curr_inp_tx = (iota_transaction_t *)utarray_next(bundle, curr_inp_tx);
-      offset = next_offset;
-    } while (curr_inp_tx != NULL &&
-             memcmp(transaction_address(curr_inp_tx), transaction_address(curr_tx), FLEX_TRIT_SIZE_243) == 0 &&
-             transaction_value(curr_inp_tx) == 0);
+    end_tx = input_signature_end(bundle, curr_tx);
+    for (curr_inp_tx = curr_tx, offset = 0; curr_inp_tx != end_tx;
+         curr_inp_tx = (iota_transaction_t *)utarray_next(bundle, curr_inp_tx)) {
+      jobs[jobs_count].hash = &normalized_bundle[offset % NUM_TRITS_HASH];
+      jobs[jobs_count].sig = &keys[jobs_count * NUM_TRITS_SIGNATURE];
+      jobs[jobs_count].sig_len = NUM_TRITS_SIGNATURE;
+      jobs[jobs_count].digest = &digests[jobs_count * NUM_TRITS_ADDRESS];
+      flex_trits_to_trits(jobs[jobs_count].sig, NUM_TRITS_SIGNATURE, transaction_signature(curr_inp_tx),
+                          NUM_TRITS_SIGNATURE, NUM_TRITS_SIGNATURE);
+      offset = (offset + ISS_FRAGMENTS * RADIX - 1) % NUM_TRITS_HASH + 1;
+      jobs_count++;
+    }
+    curr_tx = end_tx;
+  }
+
+  if ((ret = iss_verifier_sig_digests(verifier, SPONGE_KERL, jobs, jobs_count)) != RC_OK) {
+    goto done;
+  }
 
+  jobs_count = 0;
+  for (curr_tx = (iota_transaction_t *)utarray_eltptr(bundle, 0); curr_tx != NULL;) {
+    if (transaction_value(curr_tx) >= 0) {
+      curr_tx = (iota_transaction_t *)utarray_next(bundle, curr_tx);
+      continue;
+    }
+    end_tx = input_signature_end(bundle, curr_tx);
+    kerl_init(address_kerl);
+    for (curr_inp_tx = curr_tx; curr_inp_tx != end_tx;
+         curr_inp_tx = (iota_transaction_t *)utarray_next(bundle, curr_inp_tx)) {
+      kerl_absorb(address_kerl, jobs[jobs_count++].digest, NUM_TRITS_ADDRESS);
+    }
     kerl_squeeze(address_kerl, digested_address, NUM_TRITS_ADDRESS);
     flex_trits_from_trits(digest, NUM_TRITS_HASH, digested_address, NUM_TRITS_ADDRESS, NUM_TRITS_ADDRESS);
 
@@ -66,10 +108,15 @@ static retcode_t validate_signatures(bundle_transactions_t const *const bundle,
       *is_valid = false;
       break;
     }
-    curr_tx = curr_inp_tx;
+    curr_tx = end_tx;
   }
 
-  return RC_OK;
+done:
+  free(jobs);
+  free(keys);
+  free(digests);
+
+  return ret;
 }
 
 void bundle_transactions_new(bundle_transactions_t **const bundle) { utarray_new(*bundle, &bundle_transactions_icd); }
@@ -137,13 +184,18 @@ void bundle_finalize(bundle_transactions_t *bundle, Kerl *const kerl) {
 }
 
 retcode_t bundle_validator(bundle_transactions_t *const bundle, bundle_status_t *const status) {
+  return bundle_validator_with_verifier(bundle, NULL, status);
+}
+
+retcode_t bundle_validator_with_verifier(bundle_transactions_t *const bundle, iss_verifier_t *const verifier,
+                                         bundle_status_t *const status) {
   retcode_t res = RC_OK;
   iota_transaction_t *curr_tx = NULL;
   int64_t index = 0, last_index = 0;
   int64_t bundle_value = 0, tx_value = 0;
   flex_trit_t bundle_hash[FLEX_TRIT_SIZE_243];
   bool valid_sig = false;
-  Kerl shared_kerl1, shared_kerl2;
+  Kerl shared_kerl1;
   flex_trit_t bundle_hash_calculated[FLEX_TRIT_SIZE_243];
   trit_t normalized_bundle[HASH_LENGTH_TRIT];
 
@@ -200,7 +252,7 @@ retcode_t bundle_validator(bundle_transactions_t *const bundle, bundle_status_t
 
       normalize_flex_hash_to_trits(bundle_hash_calculated, normalized_bundle);
 
-      res = validate_signatures(bundle, normalized_bundle, &shared_kerl1, &shared_kerl2, &valid_sig);
+      res = validate_signatures(bundle, verifier, normalized_bundle, &shared_kerl1, &valid_sig);
       if (res != RC_OK || !valid_sig) {
         *status = BUNDLE_INVALID_SIGNATURE;
         break;
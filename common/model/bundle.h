@@ -9,6 +9,7 @@
 #define __COMMON_MODEL_BUNDLE_H__
 
 #include "common/crypto/iss/normalize.h"
+#include "common/crypto/iss/v1/iss_verifier.h"
 #include "common/crypto/kerl/kerl.h"
 #include "common/errors.h"
 #include "common/model/transaction.h"
@@ -52,6 +53,18 @@ void bundle_calculate_hash(bundle_transactions_t *bundle, Kerl *const kerl, flex
 void bundle_finalize(bundle_transactions_t *bundle, Kerl *const kerl);
 retcode_t bundle_validator(bundle_transactions_t *const bundle, bundle_status_t *const status);
 
+/**
+ * Validates a bundle like bundle_validator, the signature digests being computed by a verifier
+ *
+ * @param bundle The bundle
+ * @param verifier The verifier, NULL to compute the digests in the calling thread
+ * @param status The status of the bundle
+ *
+ * @return a status code
+ */
+retcode_t bundle_validator_with_verifier(bundle_transactions_t *const bundle, iss_verifier_t *const verifier,
+                                         bundle_status_t *const status);
+
 void bundle_reset_indexes(bundle_transactions_t *const bundle);
 
 #ifdef DEBUG
@@ -0,0 +1,441 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "uthash.h"
+#include "utlist.h"
+
+#include "common/storage/approvers_index.h"
+#include "utils/handles/lock.h"
+#include "utils/handles/rw_lock.h"
+
+#define APPROVERS_INDEX_INITIAL_VERTICES 1024
+#define APPROVERS_INDEX_INITIAL_APPROVERS 2
+#define APPROVERS_INDEX_INITIAL_SET_IDS 64
+#define APPROVERS_INDEX_NO_POSITION UINT32_MAX
+
+typedef enum approvers_index_set_e {
+  // Stored transactions without approvers
+  APPROVERS_INDEX_SET_TIPS,
+  // Transactions referenced as trunk or branch but not stored
+  APPROVERS_INDEX_SET_MISSING,
+  APPROVERS_INDEX_SET_COUNT
+} approvers_index_set_t;
+
+typedef struct approvers_index_id_set_s {
+  uint32_t *ids;
+  uint32_t count;
+  uint32_t capacity;
+} approvers_index_id_set_t;
+
+typedef struct approvers_index_entry_s {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  uint32_t id;
+  UT_hash_handle hh;
+} approvers_index_entry_t;
+
+typedef struct approvers_index_vertex_s {
+  approvers_index_entry_t *entry;
+  uint32_t *approvers;
+  uint32_t approvers_count;
+  uint32_t approvers_capacity;
+  int64_t arrival_timestamp;
+  bool stored;
+  uint32_t positions[APPROVERS_INDEX_SET_COUNT];
+} approvers_index_vertex_t;
+
+struct approvers_index_s {
+  char *db_path;
+  size_t references;
+  rw_lock_handle_t lock;
+  approvers_index_entry_t *entries;
+  approvers_index_vertex_t *vertices;
+  uint32_t vertices_count;
+  uint32_t vertices_capacity;
+  approvers_index_id_set_t sets[APPROVERS_INDEX_SET_COUNT];
+  approvers_index_t *next;
+};
+
+static approvers_index_t *registry = NULL;
+static lock_handle_t registry_lock;
+
+/*
+ * Private functions
+ */
+
+static approvers_index_vertex_t *approvers_index_find(approvers_index_t const *const index,
+                                                      flex_trit_t const *const hash) {
+  approvers_index_entry_t *entry = NULL;
+
+  HASH_FIND(hh, index->entries, hash, FLEX_TRIT_SIZE_243, entry);
+  if (entry == NULL) {
+    return NULL;
+  }
+  return &index->vertices[entry->id];
+}
+
+static retcode_t approvers_index_find_or_add(approvers_index_t *const index, flex_trit_t const *const hash,
+                                             uint32_t *const id) {
+  approvers_index_entry_t *entry = NULL;
+  approvers_index_vertex_t *vertices = NULL;
+
+  HASH_FIND(hh, index->entries, hash, FLEX_TRIT_SIZE_243, entry);
+  if (entry != NULL) {
+    *id = entry->id;
+    return RC_OK;
+  }
+
+  if (index->vertices_count == index->vertices_capacity) {
+    uint32_t capacity = index->vertices_capacity ? 2 * index->vertices_capacity : APPROVERS_INDEX_INITIAL_VERTICES;
+    if ((vertices = realloc(index->vertices, capacity * sizeof(approvers_index_vertex_t))) == NULL) {
+      return RC_STORAGE_OOM;
+    }
+    index->vertices = vertices;
+    index->vertices_capacity = capacity;
+  }
+
+  if ((entry = (approvers_index_entry_t *)malloc(sizeof(approvers_index_entry_t))) == NULL) {
+    return RC_STORAGE_OOM;
+  }
+  memcpy(entry->hash, hash, FLEX_TRIT_SIZE_243);
+  entry->id = index->vertices_count++;
+  HASH_ADD(hh, index->entries, hash, FLEX_TRIT_SIZE_243, entry);
+
+  memset(&index->vertices[entry->id], 0, sizeof(approvers_index_vertex_t));
+  index->vertices[entry->id].entry = entry;
+  for (size_t i = 0; i < APPROVERS_INDEX_SET_COUNT; i++) {
+    index->vertices[entry->id].positions[i] = APPROVERS_INDEX_NO_POSITION;
+  }
+  *id = entry->id;
+
+  return RC_OK;
+}
+
+static retcode_t approvers_index_set_add(approvers_index_t *const index, approvers_index_set_t const set,
+                                         uint32_t const id) {
+  approvers_index_id_set_t *id_set = &index->sets[set];
+  uint32_t *ids = NULL;
+
+  if (index->vertices[id].positions[set] != APPROVERS_INDEX_NO_POSITION) {
+    return RC_OK;
+  }
+
+  if (id_set->count == id_set->capacity) {
+    uint32_t capacity = id_set->capacity ? 2 * id_set->capacity : APPROVERS_INDEX_INITIAL_SET_IDS;
+    if ((ids = realloc(id_set->ids, capacity * sizeof(uint32_t))) == NULL) {
+      return RC_STORAGE_OOM;
+    }
+    id_set->ids = ids;
+    id_set->capacity = capacity;
+  }
+  index->vertices[id].positions[set] = id_set->count;
+  id_set->ids[id_set->count++] = id;
+
+  return RC_OK;
+}
+
+static void approvers_index_set_remove(approvers_index_t *const index, approvers_index_set_t const set,
+                                       uint32_t const id) {
+  approvers_index_id_set_t *id_set = &index->sets[set];
+  uint32_t position = index->vertices[id].positions[set];
+  uint32_t last = 0;
+
+  if (position == APPROVERS_INDEX_NO_POSITION) {
+    return;
+  }
+
+  // Moves the last id into the freed slot
+  last = id_set->ids[--id_set->count];
+  id_set->ids[position] = last;
+  index->vertices[last].positions[set] = position;
+  index->vertices[id].positions[set] = APPROVERS_INDEX_NO_POSITION;
+}
+
+static void approvers_index_set_load(approvers_index_t *const index, approvers_index_set_t const set,
+                                     iota_stor_pack_t *const pack, size_t const limit) {
+  approvers_index_id_set_t const *id_set = &index->sets[set];
+
+  pack->insufficient_capacity = false;
+  for (uint32_t i = 0; i < id_set->count && pack->num_loaded < limit; i++) {
+    if (pack->num_loaded == pack->capacity) {
+      pack->insufficient_capacity = true;
+      break;
+    }
+    memcpy(pack->models[pack->num_loaded++], index->vertices[id_set->ids[i]].entry->hash, FLEX_TRIT_SIZE_243);
+  }
+}
+
+static retcode_t approvers_index_add_approver(approvers_index_t *const index, uint32_t const approvee,
+                                              uint32_t const approver) {
+  approvers_index_vertex_t *vertex = &index->vertices[approvee];
+  uint32_t *approvers = NULL;
+
+  if (vertex->approvers_count == vertex->approvers_capacity) {
+    uint32_t capacity = vertex->approvers_capacity ? 2 * vertex->approvers_capacity : APPROVERS_INDEX_INITIAL_APPROVERS;
+    if ((approvers = realloc(vertex->approvers, capacity * sizeof(uint32_t))) == NULL) {
+      return RC_STORAGE_OOM;
+    }
+    vertex->approvers = approvers;
+    vertex->approvers_capacity = capacity;
+  }
+  vertex->approvers[vertex->approvers_count++] = approver;
+
+  if (vertex->stored && vertex->approvers_count == 1) {
+    approvers_index_set_remove(index, APPROVERS_INDEX_SET_TIPS, approvee);
+  }
+
+  return RC_OK;
+}
+
+static void approvers_index_free(approvers_index_t *const index) {
+  approvers_index_entry_t *entry = NULL;
+  approvers_index_entry_t *tmp = NULL;
+
+  HASH_ITER(hh, index->entries, entry, tmp) {
+    HASH_DEL(index->entries, entry);
+    free(entry);
+  }
+  for (uint32_t i = 0; i < index->vertices_count; i++) {
+    free(index->vertices[i].approvers);
+  }
+  free(index->vertices);
+  for (size_t i = 0; i < APPROVERS_INDEX_SET_COUNT; i++) {
+    free(index->sets[i].ids);
+  }
+  free(index->db_path);
+  rw_lock_handle_destroy(&index->lock);
+  free(index);
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t approvers_index_registry_init() {
+  registry = NULL;
+  lock_handle_init(&registry_lock);
+  return RC_OK;
+}
+
+retcode_t approvers_index_registry_destroy() {
+  approvers_index_t *index = NULL;
+  approvers_index_t *tmp = NULL;
+
+  LL_FOREACH_SAFE(registry, index, tmp) {
+    LL_DELETE(registry, index);
+    approvers_index_free(index);
+  }
+  lock_handle_destroy(&registry_lock);
+  return RC_OK;
+}
+
+retcode_t approvers_index_acquire(char const *const db_path, approvers_index_loader_t const loader, void *const arg,
+                                  approvers_index_t **const index) {
+  retcode_t ret = RC_OK;
+  approvers_index_t *iter = NULL;
+  char *canonical_path = NULL;
+
+  if (db_path == NULL || index == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  // Different spellings of the same file share an index, a path that can't be resolved, e.g. of a file that doesn't
+  // exist, is used as is
+  if ((canonical_path = realpath(db_path, NULL)) == NULL && (canonical_path = strdup(db_path)) == NULL) {
+    return RC_STORAGE_OOM;
+  }
+
+  *index = NULL;
+  lock_handle_lock(&registry_lock);
+
+  LL_FOREACH(registry, iter) {
+    if (strcmp(iter->db_path, canonical_path) == 0) {
+      iter->references++;
+      *index = iter;
+      goto done;
+    }
+  }
+
+  if ((iter = (approvers_index_t *)calloc(1, sizeof(approvers_index_t))) == NULL) {
+    ret = RC_STORAGE_OOM;
+    goto done;
+  }
+  iter->db_path = canonical_path;
+  canonical_path = NULL;
+  iter->references = 1;
+  rw_lock_handle_init(&iter->lock);
+
+  if (loader && (ret = loader(iter, arg)) != RC_OK) {
+    approvers_index_free(iter);
+    goto done;
+  }
+
+  LL_PREPEND(registry, iter);
+  *index = iter;
+
+done:
+  lock_handle_unlock(&registry_lock);
+  free(canonical_path);
+  return ret;
+}
+
+retcode_t approvers_index_release(approvers_index_t *const index) {
+  if (index == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  lock_handle_lock(&registry_lock);
+  if (--index->references == 0) {
+    LL_DELETE(registry, index);
+    approvers_index_free(index);
+  }
+  lock_handle_unlock(&registry_lock);
+
+  return RC_OK;
+}
+
+retcode_t approvers_index_add(approvers_index_t *const index, flex_trit_t const *const hash,
+                              flex_trit_t const *const trunk, flex_trit_t const *const branch,
+                              int64_t const arrival_timestamp) {
+  retcode_t ret = RC_OK;
+  uint32_t hash_id = 0, trunk_id = 0, branch_id = 0;
+
+  if (index == NULL || hash == NULL || trunk == NULL || branch == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_wrlock(&index->lock);
+
+  if ((ret = approvers_index_find_or_add(index, hash, &hash_id)) != RC_OK) {
+    goto done;
+  }
+  if (index->vertices[hash_id].stored) {
+    goto done;
+  }
+  index->vertices[hash_id].arrival_timestamp = arrival_timestamp;
+  index->vertices[hash_id].stored = true;
+  approvers_index_set_remove(index, APPROVERS_INDEX_SET_MISSING, hash_id);
+  if (index->vertices[hash_id].approvers_count == 0 &&
+      (ret = approvers_index_set_add(index, APPROVERS_INDEX_SET_TIPS, hash_id)) != RC_OK) {
+    goto done;
+  }
+
+  if ((ret = approvers_index_find_or_add(index, trunk, &trunk_id)) != RC_OK ||
+      (ret = approvers_index_find_or_add(index, branch, &branch_id)) != RC_OK) {
+    goto done;
+  }
+
+  if ((ret = approvers_index_add_approver(index, trunk_id, hash_id)) != RC_OK) {
+    goto done;
+  }
+  if (branch_id != trunk_id && (ret = approvers_index_add_approver(index, branch_id, hash_id)) != RC_OK) {
+    goto done;
+  }
+
+  if (!index->vertices[trunk_id].stored &&
+      (ret = approvers_index_set_add(index, APPROVERS_INDEX_SET_MISSING, trunk_id)) != RC_OK) {
+    goto done;
+  }
+  if (!index->vertices[branch_id].stored &&
+      (ret = approvers_index_set_add(index, APPROVERS_INDEX_SET_MISSING, branch_id)) != RC_OK) {
+    goto done;
+  }
+
+done:
+  rw_lock_handle_unlock(&index->lock);
+  return ret;
+}
+
+retcode_t approvers_index_load_approvers(approvers_index_t *const index, flex_trit_t const *const approvee,
+                                         iota_stor_pack_t *const pack, int64_t const before_timestamp) {
+  approvers_index_vertex_t const *vertex = NULL;
+  approvers_index_vertex_t const *approver = NULL;
+
+  if (index == NULL || approvee == NULL || pack == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  pack->insufficient_capacity = false;
+  rw_lock_handle_rdlock(&index->lock);
+
+  if ((vertex = approvers_index_find(index, approvee)) == NULL) {
+    goto done;
+  }
+
+  for (uint32_t i = 0; i < vertex->approvers_count; i++) {
+    approver = &index->vertices[vertex->approvers[i]];
+    if (before_timestamp != 0 && approver->arrival_timestamp >= before_timestamp) {
+      continue;
+    }
+    if (pack->num_loaded == pack->capacity) {
+      pack->insufficient_capacity = true;
+      break;
+    }
+    memcpy(pack->models[pack->num_loaded++], approver->entry->hash, FLEX_TRIT_SIZE_243);
+  }
+
+done:
+  rw_lock_handle_unlock(&index->lock);
+  return RC_OK;
+}
+
+retcode_t approvers_index_approvers_count(approvers_index_t *const index, flex_trit_t const *const approvee,
+                                          size_t *const count) {
+  approvers_index_vertex_t const *vertex = NULL;
+
+  if (index == NULL || approvee == NULL || count == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_rdlock(&index->lock);
+  vertex = approvers_index_find(index, approvee);
+  *count = vertex ? vertex->approvers_count : 0;
+  rw_lock_handle_unlock(&index->lock);
+
+  return RC_OK;
+}
+
+retcode_t approvers_index_load_tips(approvers_index_t *const index, iota_stor_pack_t *const pack, size_t const limit) {
+  if (index == NULL || pack == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_rdlock(&index->lock);
+  approvers_index_set_load(index, APPROVERS_INDEX_SET_TIPS, pack, limit);
+  rw_lock_handle_unlock(&index->lock);
+
+  return RC_OK;
+}
+
+retcode_t approvers_index_load_missing(approvers_index_t *const index, iota_stor_pack_t *const pack,
+                                       size_t const limit) {
+  if (index == NULL || pack == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_rdlock(&index->lock);
+  approvers_index_set_load(index, APPROVERS_INDEX_SET_MISSING, pack, limit);
+  rw_lock_handle_unlock(&index->lock);
+
+  return RC_OK;
+}
+
+size_t approvers_index_size(approvers_index_t *const index) {
+  size_t size = 0;
+
+  if (index == NULL) {
+    return 0;
+  }
+
+  rw_lock_handle_rdlock(&index->lock);
+  size = index->vertices_count;
+  rw_lock_handle_unlock(&index->lock);
+
+  return size;
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __COMMON_STORAGE_APPROVERS_INDEX_H__
+#define __COMMON_STORAGE_APPROVERS_INDEX_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/errors.h"
+#include "common/storage/pack.h"
+#include "common/trinary/flex_trit.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A process-wide, memory-resident approvee -> approvers adjacency index
+ *
+ * Every hash seen either as a stored transaction or as a trunk/branch of one is
+ * given a dense 32-bit id; approvers are then stored as arrays of ids so that
+ * walking the tangle upwards never needs a storage query.
+ * The index also maintains the set of tips (stored transactions without
+ * approvers) and the set of missing transactions (referenced but not stored)
+ * so that both can be listed in time proportional to the result.
+ * One index is shared by all connections opened on the same database and is
+ * kept up to date by the storage backend on each transaction insertion.
+ */
+typedef struct approvers_index_s approvers_index_t;
+
+/**
+ * Fills a freshly created index from the underlying database
+ *
+ * @param index The index
+ * @param arg User provided argument
+ *
+ * @return a status code
+ */
+typedef retcode_t (*approvers_index_loader_t)(approvers_index_t *const index, void *const arg);
+
+/**
+ * Initializes the registry of approvers indexes
+ * Should only be called once per process
+ *
+ * @return a status code
+ */
+retcode_t approvers_index_registry_init();
+
+/**
+ * Destroys the registry of approvers indexes
+ * Should only be called once per process
+ *
+ * @return a status code
+ */
+retcode_t approvers_index_registry_destroy();
+
+/**
+ * Gets a reference to the index of a database, creating and loading it if needed
+ *
+ * @param db_path The path of the database, resolved so that every path of the same file gets the same index
+ * @param loader Called once, with the registry locked, if the index is created
+ * @param arg Argument passed to the loader
+ * @param index The index
+ *
+ * @return a status code
+ */
+retcode_t approvers_index_acquire(char const *const db_path, approvers_index_loader_t const loader, void *const arg,
+                                  approvers_index_t **const index);
+
+/**
+ * Releases a reference to an index, destroying it when no connection uses it anymore
+ *
+ * @param index The index
+ *
+ * @return a status code
+ */
+retcode_t approvers_index_release(approvers_index_t *const index);
+
+/**
+ * Records a transaction and its two approvees
+ *
+ * @param index The index
+ * @param hash The hash of the transaction
+ * @param trunk The trunk of the transaction
+ * @param branch The branch of the transaction
+ * @param arrival_timestamp The arrival timestamp of the transaction
+ *
+ * @return a status code
+ */
+retcode_t approvers_index_add(approvers_index_t *const index, flex_trit_t const *const hash,
+                              flex_trit_t const *const trunk, flex_trit_t const *const branch,
+                              int64_t const arrival_timestamp);
+
+/**
+ * Loads hashes of the approvers of a transaction
+ *
+ * @param index The index
+ * @param approvee The hash of the approvee
+ * @param pack A pack to be filled with hashes
+ * @param before_timestamp If not 0, only approvers arrived before this timestamp are loaded
+ *
+ * @return a status code
+ */
+retcode_t approvers_index_load_approvers(approvers_index_t *const index, flex_trit_t const *const approvee,
+                                         iota_stor_pack_t *const pack, int64_t const before_timestamp);
+
+/**
+ * Gets the number of approvers of a transaction
+ *
+ * @param index The index
+ * @param approvee The hash of the approvee
+ * @param count The number of approvers
+ *
+ * @return a status code
+ */
+retcode_t approvers_index_approvers_count(approvers_index_t *const index, flex_trit_t const *const approvee,
+                                          size_t *const count);
+
+/**
+ * Loads hashes of tips, i.e. stored transactions without approvers
+ *
+ * @param index The index
+ * @param pack A pack to be filled with hashes
+ * @param limit The maximum number of hashes to load
+ *
+ * @return a status code
+ */
+retcode_t approvers_index_load_tips(approvers_index_t *const index, iota_stor_pack_t *const pack, size_t const limit);
+
+/**
+ * Loads hashes of transactions referenced as trunk or branch but not stored
+ *
+ * @param index The index
+ * @param pack A pack to be filled with hashes
+ * @param limit The maximum number of hashes to load
+ *
+ * @return a status code
+ */
+retcode_t approvers_index_load_missing(approvers_index_t *const index, iota_stor_pack_t *const pack,
+                                       size_t const limit);
+
+/**
+ * Gets the number of vertices in an index
+ *
+ * @param index The index
+ *
+ * @return the number of vertices
+ */
+size_t approvers_index_size(approvers_index_t *const index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_STORAGE_APPROVERS_INDEX_H__
@@ -14,7 +14,6 @@
 
 #define TRANSACTION_TABLE_NAME "iota_transaction"
 
-#define TRANSACTION_COL_SIG_OR_MSG "signature_or_message"
 #define TRANSACTION_COL_ADDRESS "address"
 #define TRANSACTION_COL_VALUE "value"
 #define TRANSACTION_COL_OBSOLETE_TAG "obsolete_tag"
@@ -34,7 +33,11 @@
 #define TRANSACTION_COL_SOLID "solid"
 #define TRANSACTION_COL_ARRIVAL_TIME "arrival_timestamp"
 
-#define TRANSACTION_NUM_COLS 19
+#define TRANSACTION_NUM_COLS 18
+
+#define TRANSACTION_PAYLOAD_TABLE_NAME "iota_transaction_payload"
+
+#define TRANSACTION_COL_SIG_OR_MSG "signature_or_message"
 
 /*
  * Milestone definitions
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+
+#include "common/storage/key_codec.h"
+
+size_t storage_key_encode(byte_t *const key, flex_trit_t const *const flex_trits, size_t const num_trits) {
+  flex_trits_to_bytes(key, num_trits, flex_trits, num_trits, num_trits);
+  return STORAGE_KEY_SIZE(num_trits);
+}
+
+void storage_key_decode(flex_trit_t *const flex_trits, byte_t const *const key, size_t const key_size,
+                        size_t const num_trits) {
+  byte_t buffer[STORAGE_KEY_SIZE_6561];
+  size_t size = STORAGE_KEY_SIZE(num_trits);
+
+  if (key_size >= size) {
+    flex_trits_from_bytes(flex_trits, num_trits, key, num_trits, num_trits);
+    return;
+  }
+
+  if (key_size) {
+    memcpy(buffer, key, key_size);
+  }
+  memset(buffer + key_size, 0, size - key_size);
+  flex_trits_from_bytes(flex_trits, num_trits, buffer, num_trits, num_trits);
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __COMMON_STORAGE_KEY_CODEC_H__
+#define __COMMON_STORAGE_KEY_CODEC_H__
+
+#include <stddef.h>
+
+#include "common/defs.h"
+#include "common/trinary/bytes.h"
+#include "common/trinary/flex_trit.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Trits of keys and indexes are persisted packed 5 per byte, whatever the flex_trit encoding of the process, so
+ * that they are as small as possible and compare the same in every build
+ */
+#define STORAGE_KEY_SIZE(num_trits) (((num_trits) + NUMBER_OF_TRITS_IN_A_BYTE - 1) / NUMBER_OF_TRITS_IN_A_BYTE)
+#define STORAGE_KEY_SIZE_81 STORAGE_KEY_SIZE(81)
+#define STORAGE_KEY_SIZE_243 STORAGE_KEY_SIZE(243)
+#define STORAGE_KEY_SIZE_6561 STORAGE_KEY_SIZE(6561)
+
+/**
+ * Encodes flex trits to their storage representation
+ *
+ * @param key The encoded key, must be at least STORAGE_KEY_SIZE(num_trits) bytes
+ * @param flex_trits The flex trits
+ * @param num_trits The number of trits, at most 6561
+ *
+ * @return the size of the key
+ */
+size_t storage_key_encode(byte_t *const key, flex_trit_t const *const flex_trits, size_t const num_trits);
+
+/**
+ * Decodes flex trits from their storage representation
+ * Missing trailing bytes, e.g. trimmed by the storage, are decoded as null trits
+ *
+ * @param flex_trits The decoded flex trits
+ * @param key The encoded key
+ * @param key_size The size of the key
+ * @param num_trits The number of trits, at most 6561
+ */
+void storage_key_decode(flex_trit_t *const flex_trits, byte_t const *const key, size_t const key_size,
+                        size_t const num_trits);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_STORAGE_KEY_CODEC_H__
@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "utlist.h"
+
+#include "common/model/transaction.h"
+#include "common/storage/kv/lmdb/connection.h"
+#include "common/storage/kv/lmdb/wrappers.h"
+#include "utils/handles/lock.h"
+#include "utils/logger_helper.h"
+
+#define LMDB_LOGGER_ID "lmdb"
+// Only reserves address space, the file grows with the data
+#define LMDB_MAP_SIZE (1ULL << 40)
+#define LMDB_MAX_DBS 16
+#define LMDB_MAX_READERS 512
+
+#define LMDB_LAYOUT_KEY "layout"
+
+/**
+ * Keys are encoded independently of the build but records hold flex trits and
+ * transaction fields as laid out in memory, so an environment can only be
+ * opened by builds sharing the layout of the one that created it
+ */
+typedef struct lmdb_layout_s {
+  uint32_t num_trits_per_flex_trit;
+  uint32_t essence_size;
+  uint32_t attachment_size;
+  uint32_t metadata_size;
+} lmdb_layout_t;
+
+static logger_id_t logger_id;
+static lmdb_environment_t* environments = NULL;
+static lock_handle_t environments_lock;
+
+static retcode_t check_layout(MDB_txn* const txn, lmdb_databases_t const* const dbs) {
+  lmdb_layout_t layout;
+  MDB_val key = {.mv_size = sizeof(LMDB_LAYOUT_KEY) - 1, .mv_data = LMDB_LAYOUT_KEY};
+  MDB_val value;
+  int rc = 0;
+
+  memset(&layout, 0, sizeof(lmdb_layout_t));
+  layout.num_trits_per_flex_trit = NUM_TRITS_PER_FLEX_TRIT;
+  layout.essence_size = sizeof(iota_transaction_fields_essence_t);
+  layout.attachment_size = sizeof(iota_transaction_fields_attachment_t);
+  layout.metadata_size = sizeof(iota_transaction_fields_metadata_t);
+
+  if ((rc = mdb_get(txn, dbs->layout, &key, &value)) == MDB_NOTFOUND) {
+    value.mv_size = sizeof(lmdb_layout_t);
+    value.mv_data = &layout;
+    return mdb_put(txn, dbs->layout, &key, &value, 0) == MDB_SUCCESS ? RC_OK : RC_LMDB_FAILED_PUT;
+  } else if (rc != MDB_SUCCESS) {
+    return RC_LMDB_FAILED_GET;
+  }
+
+  if (value.mv_size != sizeof(lmdb_layout_t) || memcmp(value.mv_data, &layout, sizeof(lmdb_layout_t)) != 0) {
+    log_critical(logger_id, "Database was written by a build with another flex trit encoding or record layout\n");
+    return RC_LMDB_INCOMPATIBLE_DB;
+  }
+
+  return RC_OK;
+}
+
+static retcode_t open_databases(lmdb_environment_t* const environment) {
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  lmdb_databases_t* dbs = &environment->dbs;
+  int rc = 0;
+
+  if ((ret = begin_transaction(environment->env, false, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  rc = mdb_dbi_open(txn, "transaction_essence", MDB_CREATE, &dbs->transaction_essence);
+  rc |= mdb_dbi_open(txn, "transaction_attachment", MDB_CREATE, &dbs->transaction_attachment);
+  rc |= mdb_dbi_open(txn, "transaction_data", MDB_CREATE, &dbs->transaction_data);
+  rc |= mdb_dbi_open(txn, "transaction_metadata", MDB_CREATE, &dbs->transaction_metadata);
+  rc |= mdb_dbi_open(txn, "transaction_by_address", MDB_CREATE | MDB_DUPSORT | MDB_DUPFIXED,
+                     &dbs->transaction_by_address);
+  rc |= mdb_dbi_open(txn, "transaction_by_bundle", MDB_CREATE | MDB_DUPSORT | MDB_DUPFIXED,
+                     &dbs->transaction_by_bundle);
+  rc |= mdb_dbi_open(txn, "transaction_by_tag", MDB_CREATE | MDB_DUPSORT | MDB_DUPFIXED, &dbs->transaction_by_tag);
+  rc |= mdb_dbi_open(txn, "milestone", MDB_CREATE, &dbs->milestone);
+  rc |= mdb_dbi_open(txn, "milestone_by_hash", MDB_CREATE, &dbs->milestone_by_hash);
+  rc |= mdb_dbi_open(txn, "state_delta", MDB_CREATE, &dbs->state_delta);
+  rc |= mdb_dbi_open(txn, "layout", MDB_CREATE, &dbs->layout);
+
+  if (rc != MDB_SUCCESS) {
+    mdb_txn_abort(txn);
+    return RC_LMDB_FAILED_OPEN_DB;
+  }
+
+  if ((ret = check_layout(txn, dbs)) != RC_OK) {
+    mdb_txn_abort(txn);
+    return ret;
+  }
+
+  return end_transaction(txn);
+}
+
+static void environment_free(lmdb_environment_t* const environment) {
+  if (environment->env) {
+    mdb_env_close(environment->env);
+  }
+  free(environment->db_path);
+  free(environment);
+}
+
+static retcode_t environment_acquire(char const* const db_path, lmdb_environment_t** const environment) {
+  retcode_t ret = RC_OK;
+  lmdb_environment_t* iter = NULL;
+  char* canonical_path = NULL;
+  int rc = 0;
+
+  // Environments are registered under their resolved path since one must not be opened twice through different
+  // spellings, a path that can't be resolved yet is the one of a file that doesn't exist and isn't opened
+  if ((canonical_path = realpath(db_path, NULL)) == NULL && (canonical_path = strdup(db_path)) == NULL) {
+    return RC_STORAGE_OOM;
+  }
+
+  *environment = NULL;
+  lock_handle_lock(&environments_lock);
+
+  LL_FOREACH(environments, iter) {
+    if (strcmp(iter->db_path, canonical_path) == 0) {
+      iter->references++;
+      *environment = iter;
+      goto done;
+    }
+  }
+
+  if ((iter = (lmdb_environment_t*)calloc(1, sizeof(lmdb_environment_t))) == NULL) {
+    ret = RC_STORAGE_OOM;
+    goto done;
+  }
+  iter->references = 1;
+
+  if (mdb_env_create(&iter->env) != MDB_SUCCESS) {
+    iter->env = NULL;
+    ret = RC_LMDB_FAILED_OPEN_DB;
+    goto failure;
+  }
+  if (mdb_env_set_mapsize(iter->env, LMDB_MAP_SIZE) != MDB_SUCCESS ||
+      mdb_env_set_maxdbs(iter->env, LMDB_MAX_DBS) != MDB_SUCCESS ||
+      mdb_env_set_maxreaders(iter->env, LMDB_MAX_READERS) != MDB_SUCCESS) {
+    ret = RC_LMDB_FAILED_OPEN_DB;
+    goto failure;
+  }
+  // NOTLS because connections, and thus read transactions, are shared between threads
+  if ((rc = mdb_env_open(iter->env, db_path, MDB_NOSUBDIR | MDB_NOTLS, 0644)) != MDB_SUCCESS) {
+    log_critical(logger_id, "Failed to open db on path %s: %s\n", db_path, mdb_strerror(rc));
+    ret = RC_LMDB_FAILED_OPEN_DB;
+    goto failure;
+  }
+  if ((ret = open_databases(iter)) != RC_OK) {
+    goto failure;
+  }
+  // The file now exists
+  if ((iter->db_path = realpath(db_path, NULL)) == NULL) {
+    ret = RC_LMDB_FAILED_OPEN_DB;
+    goto failure;
+  }
+
+  LL_PREPEND(environments, iter);
+  *environment = iter;
+  goto done;
+
+failure:
+  environment_free(iter);
+done:
+  lock_handle_unlock(&environments_lock);
+  free(canonical_path);
+  return ret;
+}
+
+static void environment_release(lmdb_environment_t* const environment) {
+  lock_handle_lock(&environments_lock);
+  if (--environment->references == 0) {
+    LL_DELETE(environments, environment);
+    environment_free(environment);
+  }
+  lock_handle_unlock(&environments_lock);
+}
+
+static retcode_t load_approvers_index(approvers_index_t* const index, lmdb_connection_t* const connection) {
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  MDB_cursor* cursor = NULL;
+  MDB_val key, value, metadata_value;
+  iota_transaction_fields_attachment_t const* attachment = NULL;
+  iota_transaction_fields_metadata_t const* metadata = NULL;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  int rc = 0;
+
+  if ((ret = begin_transaction(connection->environment->env, true, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  if (mdb_cursor_open(txn, connection->environment->dbs.transaction_attachment, &cursor) != MDB_SUCCESS) {
+    ret = RC_LMDB_FAILED_CURSOR;
+    goto done;
+  }
+
+  for (rc = mdb_cursor_get(cursor, &key, &value, MDB_FIRST); rc == MDB_SUCCESS;
+       rc = mdb_cursor_get(cursor, &key, &value, MDB_NEXT)) {
+    if (key.mv_size != STORAGE_KEY_SIZE_243 || value.mv_size != sizeof(iota_transaction_fields_attachment_t) ||
+        mdb_get(txn, connection->environment->dbs.transaction_metadata, &key, &metadata_value) != MDB_SUCCESS) {
+      ret = RC_LMDB_INVALID_RECORD;
+      goto done;
+    }
+    attachment = (iota_transaction_fields_attachment_t const*)value.mv_data;
+    metadata = (iota_transaction_fields_metadata_t const*)metadata_value.mv_data;
+    trits_key_decode(&key, hash, NUM_TRITS_HASH);
+    if ((ret = approvers_index_add(index, hash, attachment->trunk, attachment->branch,
+                                   metadata->arrival_timestamp)) != RC_OK) {
+      goto done;
+    }
+  }
+
+  if (rc != MDB_NOTFOUND) {
+    ret = RC_LMDB_FAILED_CURSOR;
+    goto done;
+  }
+
+  log_info(logger_id, "Approvers index loaded with %zu vertices\n", approvers_index_size(index));
+
+done:
+  if (cursor) {
+    mdb_cursor_close(cursor);
+  }
+  mdb_txn_abort(txn);
+  return ret;
+}
+
+retcode_t lmdb_environments_init() {
+  environments = NULL;
+  lock_handle_init(&environments_lock);
+  return RC_OK;
+}
+
+retcode_t lmdb_environments_destroy() {
+  lmdb_environment_t* environment = NULL;
+  lmdb_environment_t* tmp = NULL;
+
+  LL_FOREACH_SAFE(environments, environment, tmp) {
+    LL_DELETE(environments, environment);
+    environment_free(environment);
+  }
+  lock_handle_destroy(&environments_lock);
+  return RC_OK;
+}
+
+retcode_t connection_init(storage_connection_t* const connection, connection_config_t const* const config) {
+  lmdb_connection_t* lmdb_connection = NULL;
+  retcode_t ret = RC_OK;
+
+  if (connection == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  logger_id = logger_helper_enable(LMDB_LOGGER_ID, LOGGER_DEBUG, true);
+
+  if ((connection->actual = calloc(1, sizeof(lmdb_connection_t))) == NULL) {
+    return RC_OOM;
+  }
+  lmdb_connection = (lmdb_connection_t*)connection->actual;
+
+  if (config->db_path == NULL) {
+    log_critical(logger_id, "No path for db specified\n");
+    ret = RC_LMDB_NO_PATH_FOR_DB_SPECIFIED;
+    goto failure;
+  }
+
+  if ((ret = environment_acquire(config->db_path, &lmdb_connection->environment)) != RC_OK) {
+    log_critical(logger_id, "Failed to open db on path: %s\n", config->db_path);
+    goto failure;
+  }
+
+  if ((ret = approvers_index_acquire(config->db_path, (approvers_index_loader_t)load_approvers_index, lmdb_connection,
+                                     &lmdb_connection->approvers_index)) != RC_OK) {
+    log_critical(logger_id, "Failed to load approvers index\n");
+    goto failure;
+  }
+
+  return RC_OK;
+
+failure:
+  connection_destroy(connection);
+  connection->actual = NULL;
+  return ret;
+}
+
+retcode_t connection_destroy(storage_connection_t* const connection) {
+  lmdb_connection_t* lmdb_connection = NULL;
+
+  if (connection == NULL) {
+    return RC_NULL_PARAM;
+  }
+  lmdb_connection = (lmdb_connection_t*)connection->actual;
+
+  if (lmdb_connection->approvers_index) {
+    approvers_index_release(lmdb_connection->approvers_index);
+  }
+  if (lmdb_connection->environment) {
+    environment_release(lmdb_connection->environment);
+  }
+  free(lmdb_connection);
+
+  return RC_OK;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __COMMON_STORAGE_KV_LMDB_CONNECTION_H__
+#define __COMMON_STORAGE_KV_LMDB_CONNECTION_H__
+
+#include <stddef.h>
+
+#include <lmdb.h>
+
+#include "common/storage/approvers_index.h"
+#include "common/storage/connection.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Named databases of an environment, one per column family
+ */
+typedef struct lmdb_databases_s {
+  // hash -> essence
+  MDB_dbi transaction_essence;
+  // hash -> attachment
+  MDB_dbi transaction_attachment;
+  // hash -> signature or message, trailing null trits trimmed
+  MDB_dbi transaction_data;
+  // hash -> metadata
+  MDB_dbi transaction_metadata;
+  // address -> hashes
+  MDB_dbi transaction_by_address;
+  // bundle -> hashes
+  MDB_dbi transaction_by_bundle;
+  // tag -> hashes
+  MDB_dbi transaction_by_tag;
+  // big-endian index -> hash
+  MDB_dbi milestone;
+  // hash -> big-endian index
+  MDB_dbi milestone_by_hash;
+  // big-endian index -> serialized state delta
+  MDB_dbi state_delta;
+  // "layout" -> layout of the records written by the build that created the environment
+  MDB_dbi layout;
+} lmdb_databases_t;
+
+/**
+ * An LMDB environment must only be opened once per process so it is shared by
+ * all connections opened on the same path
+ */
+typedef struct lmdb_environment_s {
+  char* db_path;
+  size_t references;
+  MDB_env* env;
+  lmdb_databases_t dbs;
+  struct lmdb_environment_s* next;
+} lmdb_environment_t;
+
+typedef struct lmdb_connection_s {
+  lmdb_environment_t* environment;
+  approvers_index_t* approvers_index;
+} lmdb_connection_t;
+
+/**
+ * Initializes the registry of environments
+ * Should only be called once per process
+ *
+ * @return a status code
+ */
+retcode_t lmdb_environments_init();
+
+/**
+ * Destroys the registry of environments
+ * Should only be called once per process
+ *
+ * @return a status code
+ */
+retcode_t lmdb_environments_destroy();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_STORAGE_KV_LMDB_CONNECTION_H__
@@ -0,0 +1,1049 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <lmdb.h>
+
+#include "utlist.h"
+
+#include "common/model/milestone.h"
+#include "common/model/transaction.h"
+#include "common/storage/approvers_index.h"
+#include "common/storage/kv/lmdb/connection.h"
+#include "common/storage/kv/lmdb/wrappers.h"
+#include "common/storage/storage.h"
+#include "common/storage/transaction_cache.h"
+#include "utils/logger_helper.h"
+#include "utils/time.h"
+
+#define LMDB_LOGGER_ID "lmdb"
+
+static logger_id_t logger_id;
+
+retcode_t storage_init() {
+  retcode_t ret = RC_OK;
+
+  logger_id = logger_helper_enable(LMDB_LOGGER_ID, LOGGER_DEBUG, true);
+
+  if ((ret = lmdb_environments_init()) != RC_OK) {
+    return ret;
+  }
+
+  if ((ret = approvers_index_registry_init()) != RC_OK) {
+    return ret;
+  }
+
+  return transaction_cache_registry_init();
+}
+
+retcode_t storage_destroy() {
+  logger_helper_release(logger_id);
+  approvers_index_registry_destroy();
+  transaction_cache_registry_destroy();
+
+  return lmdb_environments_destroy();
+}
+
+/*
+ * Generic functions
+ */
+
+enum transaction_record {
+  RECORD_ESSENCE = (1u << 0),
+  RECORD_ATTACHMENT = (1u << 1),
+  RECORD_DATA = (1u << 2),
+  RECORD_METADATA = (1u << 3),
+  RECORD_CONSENSUS = (1u << 4),
+};
+
+// Hashes are keyed by their compact representation, see key_codec.h
+static void hash_key(MDB_val* const key, byte_t* const buffer, flex_trit_t const* const hash) {
+  trits_key_encode(key, buffer, hash, NUM_TRITS_HASH);
+}
+
+static retcode_t record_get(MDB_txn* const txn, MDB_dbi const dbi, MDB_val* const key, void* const record,
+                            size_t const size) {
+  MDB_val value;
+
+  if (mdb_get(txn, dbi, key, &value) != MDB_SUCCESS) {
+    return RC_LMDB_FAILED_GET;
+  }
+  if (value.mv_size != size) {
+    return RC_LMDB_INVALID_RECORD;
+  }
+  memcpy(record, value.mv_data, size);
+
+  return RC_OK;
+}
+
+static retcode_t record_put(MDB_txn* const txn, MDB_dbi const dbi, MDB_val* const key, void const* const record,
+                            size_t const size) {
+  MDB_val value = {.mv_size = size, .mv_data = (void*)record};
+
+  if (mdb_put(txn, dbi, key, &value, 0) != MDB_SUCCESS) {
+    return RC_LMDB_FAILED_PUT;
+  }
+
+  return RC_OK;
+}
+
+static bool pack_push_hash(iota_stor_pack_t* const pack, flex_trit_t const* const hash) {
+  if (pack->num_loaded == pack->capacity) {
+    pack->insufficient_capacity = true;
+    return false;
+  }
+  memcpy(pack->models[pack->num_loaded++], hash, FLEX_TRIT_SIZE_243);
+  return true;
+}
+
+/*
+ * Transaction operations
+ */
+
+static retcode_t transaction_put(MDB_txn* const txn, lmdb_databases_t const* const dbs,
+                                 iota_transaction_t const* const tx, uint64_t const arrival_timestamp,
+                                 bool* const stored) {
+  retcode_t ret = RC_OK;
+  MDB_val key, index_key, value;
+  byte_t key_buffer[STORAGE_KEY_SIZE_243];
+  byte_t index_key_buffer[STORAGE_KEY_SIZE_243];
+  iota_transaction_fields_metadata_t metadata;
+  int rc = 0;
+
+  *stored = false;
+  hash_key(&key, key_buffer, tx->consensus.hash);
+
+  // The essence is written first so that an already stored transaction is detected before any other write
+  value.mv_size = sizeof(iota_transaction_fields_essence_t);
+  value.mv_data = (void*)&tx->essence;
+  if ((rc = mdb_put(txn, dbs->transaction_essence, &key, &value, MDB_NOOVERWRITE)) == MDB_KEYEXIST) {
+    return RC_OK;
+  } else if (rc != MDB_SUCCESS) {
+    return RC_LMDB_FAILED_PUT;
+  }
+
+  memset(&metadata, 0, sizeof(iota_transaction_fields_metadata_t));
+  metadata.arrival_timestamp = arrival_timestamp;
+
+  if ((ret = record_put(txn, dbs->transaction_attachment, &key, &tx->attachment,
+                        sizeof(iota_transaction_fields_attachment_t))) != RC_OK ||
+      (ret = record_put(txn, dbs->transaction_metadata, &key, &metadata,
+                        sizeof(iota_transaction_fields_metadata_t))) != RC_OK) {
+    return ret;
+  }
+
+  value_compress(&value, tx->data.signature_or_message, FLEX_TRIT_SIZE_6561);
+  if (mdb_put(txn, dbs->transaction_data, &key, &value, 0) != MDB_SUCCESS) {
+    return RC_LMDB_FAILED_PUT;
+  }
+
+  hash_key(&index_key, index_key_buffer, tx->essence.address);
+  if (mdb_put(txn, dbs->transaction_by_address, &index_key, &key, 0) != MDB_SUCCESS) {
+    return RC_LMDB_FAILED_PUT;
+  }
+  hash_key(&index_key, index_key_buffer, tx->essence.bundle);
+  if (mdb_put(txn, dbs->transaction_by_bundle, &index_key, &key, 0) != MDB_SUCCESS) {
+    return RC_LMDB_FAILED_PUT;
+  }
+  trits_key_encode(&index_key, index_key_buffer, tx->attachment.tag, NUM_TRITS_TAG);
+  if (mdb_put(txn, dbs->transaction_by_tag, &index_key, &key, 0) != MDB_SUCCESS) {
+    return RC_LMDB_FAILED_PUT;
+  }
+
+  *stored = true;
+  return RC_OK;
+}
+
+static retcode_t transaction_load_records(lmdb_connection_t const* const lmdb_connection,
+                                          flex_trit_t const* const hash, uint8_t const records,
+                                          iota_stor_pack_t* const pack) {
+  lmdb_databases_t const* dbs = &lmdb_connection->environment->dbs;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  MDB_val key, value;
+  byte_t key_buffer[STORAGE_KEY_SIZE_243];
+  iota_transaction_t* tx = NULL;
+  int rc = 0;
+
+  pack->insufficient_capacity = false;
+  hash_key(&key, key_buffer, hash);
+
+  if ((ret = begin_transaction(lmdb_connection->environment->env, true, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  // Every stored transaction has an essence, its absence means the transaction is unknown
+  if ((rc = mdb_get(txn, dbs->transaction_essence, &key, &value)) == MDB_NOTFOUND) {
+    goto done;
+  } else if (rc != MDB_SUCCESS) {
+    ret = RC_LMDB_FAILED_GET;
+    goto done;
+  } else if (value.mv_size != sizeof(iota_transaction_fields_essence_t)) {
+    ret = RC_LMDB_INVALID_RECORD;
+    goto done;
+  }
+
+  if (pack->num_loaded == pack->capacity) {
+    pack->insufficient_capacity = true;
+    goto done;
+  }
+  tx = (iota_transaction_t*)pack->models[pack->num_loaded];
+
+  if (records & RECORD_ESSENCE) {
+    memcpy(&tx->essence, value.mv_data, sizeof(iota_transaction_fields_essence_t));
+    tx->loaded_columns_mask.essence |= MASK_ESSENCE_ALL;
+  }
+  if (records & RECORD_ATTACHMENT) {
+    if ((ret = record_get(txn, dbs->transaction_attachment, &key, &tx->attachment,
+                          sizeof(iota_transaction_fields_attachment_t))) != RC_OK) {
+      goto done;
+    }
+    tx->loaded_columns_mask.attachment |= MASK_ATTACHMENT_ALL;
+  }
+  if (records & RECORD_DATA) {
+    if (mdb_get(txn, dbs->transaction_data, &key, &value) != MDB_SUCCESS) {
+      ret = RC_LMDB_FAILED_GET;
+      goto done;
+    }
+    value_decompress(&value, tx->data.signature_or_message, FLEX_TRIT_SIZE_6561);
+    tx->loaded_columns_mask.data |= MASK_DATA_ALL;
+  }
+  if (records & RECORD_METADATA) {
+    if ((ret = record_get(txn, dbs->transaction_metadata, &key, &tx->metadata,
+                          sizeof(iota_transaction_fields_metadata_t))) != RC_OK) {
+      goto done;
+    }
+    tx->loaded_columns_mask.metadata |= MASK_METADATA_ALL;
+  }
+  if (records & RECORD_CONSENSUS) {
+    memcpy(tx->consensus.hash, hash, FLEX_TRIT_SIZE_243);
+    tx->loaded_columns_mask.consensus |= MASK_CONSENSUS_ALL;
+  }
+
+  pack->num_loaded++;
+
+done:
+  mdb_txn_abort(txn);
+  return ret;
+}
+
+enum metadata_field {
+  METADATA_SNAPSHOT_INDEX,
+  METADATA_SOLID,
+};
+
+typedef struct metadata_update_params_s {
+  MDB_txn* txn;
+  lmdb_databases_t const* dbs;
+  enum metadata_field field;
+  uint64_t value;
+} metadata_update_params_t;
+
+static retcode_t metadata_update_do_func(metadata_update_params_t* const params, flex_trit_t const* const hash) {
+  retcode_t ret = RC_OK;
+  MDB_val key;
+  byte_t key_buffer[STORAGE_KEY_SIZE_243];
+  iota_transaction_fields_metadata_t metadata;
+
+  hash_key(&key, key_buffer, hash);
+  if ((ret = record_get(params->txn, params->dbs->transaction_metadata, &key, &metadata,
+                        sizeof(iota_transaction_fields_metadata_t))) == RC_LMDB_FAILED_GET) {
+    // Updating an unknown transaction is a no-op, as it is with SQL
+    return RC_OK;
+  } else if (ret != RC_OK) {
+    return ret;
+  }
+
+  if (params->field == METADATA_SNAPSHOT_INDEX) {
+    metadata.snapshot_index = params->value;
+  } else {
+    metadata.solid = params->value;
+  }
+
+  return record_put(params->txn, params->dbs->transaction_metadata, &key, &metadata,
+                    sizeof(iota_transaction_fields_metadata_t));
+}
+
+static retcode_t update_transactions(storage_connection_t const* const connection, hash243_set_t const hashes,
+                                     flex_trit_t const* const hash, enum metadata_field const field,
+                                     uint64_t const value) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  metadata_update_params_t params = {
+      .txn = NULL, .dbs = &lmdb_connection->environment->dbs, .field = field, .value = value};
+
+  if ((ret = begin_transaction(lmdb_connection->environment->env, false, &params.txn)) != RC_OK) {
+    return ret;
+  }
+
+  if (hash) {
+    ret = metadata_update_do_func(&params, hash);
+  } else {
+    ret = hash243_set_for_each(&hashes, (hash243_on_container_func)metadata_update_do_func, &params);
+  }
+
+  if (ret != RC_OK) {
+    mdb_txn_abort(params.txn);
+    return ret;
+  }
+
+  return end_transaction(params.txn);
+}
+
+retcode_t iota_stor_transaction_count(storage_connection_t const* const connection, size_t* const count) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  MDB_stat stat;
+
+  if ((ret = begin_transaction(lmdb_connection->environment->env, true, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  if (mdb_stat(txn, lmdb_connection->environment->dbs.transaction_essence, &stat) != MDB_SUCCESS) {
+    ret = RC_LMDB_FAILED_GET;
+    goto done;
+  }
+  *count = stat.ms_entries;
+
+done:
+  mdb_txn_abort(txn);
+  return ret;
+}
+
+retcode_t iota_stor_transaction_store(storage_connection_t const* const connection,
+                                      iota_transaction_t const* const tx) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  uint64_t arrival_timestamp = current_timestamp_ms();
+  bool stored = false;
+
+  if ((ret = begin_transaction(lmdb_connection->environment->env, false, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  if ((ret = transaction_put(txn, &lmdb_connection->environment->dbs, tx, arrival_timestamp, &stored)) != RC_OK) {
+    mdb_txn_abort(txn);
+    return ret;
+  } else if (!stored) {
+    mdb_txn_abort(txn);
+    return RC_LMDB_KEY_EXISTS;
+  }
+
+  if ((ret = end_transaction(txn)) != RC_OK) {
+    return ret;
+  }
+
+  return approvers_index_add(lmdb_connection->approvers_index, tx->consensus.hash, tx->attachment.trunk,
+                             tx->attachment.branch, arrival_timestamp);
+}
+
+retcode_t iota_stor_transactions_store_batch(storage_connection_t const* const connection,
+                                             iota_transaction_t const* const* const txs, size_t const count,
+                                             bool* const stored) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  uint64_t arrival_timestamp = current_timestamp_ms();
+
+  if (txs == NULL || stored == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  memset(stored, false, count * sizeof(bool));
+  if (count == 0) {
+    return RC_OK;
+  }
+
+  if ((ret = begin_transaction(lmdb_connection->environment->env, false, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  // Both already persisted transactions and duplicates within the batch are rejected by MDB_NOOVERWRITE
+  for (size_t i = 0; i < count; i++) {
+    if ((ret = transaction_put(txn, &lmdb_connection->environment->dbs, txs[i], arrival_timestamp, &stored[i])) !=
+        RC_OK) {
+      mdb_txn_abort(txn);
+      memset(stored, false, count * sizeof(bool));
+      return ret;
+    }
+  }
+
+  if ((ret = end_transaction(txn)) != RC_OK) {
+    memset(stored, false, count * sizeof(bool));
+    return ret;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    if (stored[i] && (ret = approvers_index_add(lmdb_connection->approvers_index, txs[i]->consensus.hash,
+                                                txs[i]->attachment.trunk, txs[i]->attachment.branch,
+                                                arrival_timestamp)) != RC_OK) {
+      return ret;
+    }
+  }
+
+  return RC_OK;
+}
+
+retcode_t iota_stor_transaction_load(storage_connection_t const* const connection, transaction_field_t const field,
+                                     flex_trit_t const* const key, iota_stor_pack_t* const pack) {
+  if (field != TRANSACTION_FIELD_HASH) {
+    return RC_LMDB_FAILED_NOT_IMPLEMENTED;
+  }
+
+  return transaction_load_records((lmdb_connection_t*)connection->actual, key,
+                                  RECORD_ESSENCE | RECORD_ATTACHMENT | RECORD_DATA | RECORD_CONSENSUS, pack);
+}
+
+retcode_t iota_stor_transaction_load_essence_and_metadata(storage_connection_t const* const connection,
+                                                          flex_trit_t const* const hash, iota_stor_pack_t* const pack) {
+  return transaction_load_records((lmdb_connection_t*)connection->actual, hash, RECORD_ESSENCE | RECORD_METADATA,
+                                  pack);
+}
+
+retcode_t iota_stor_transaction_load_essence_attachment_and_metadata(storage_connection_t const* const connection,
+                                                                     flex_trit_t const* const hash,
+                                                                     iota_stor_pack_t* const pack) {
+  return transaction_load_records((lmdb_connection_t*)connection->actual, hash,
+                                  RECORD_ESSENCE | RECORD_ATTACHMENT | RECORD_METADATA, pack);
+}
+
+retcode_t iota_stor_transaction_load_essence_and_consensus(storage_connection_t const* const connection,
+                                                           flex_trit_t const* const hash,
+                                                           iota_stor_pack_t* const pack) {
+  return transaction_load_records((lmdb_connection_t*)connection->actual, hash, RECORD_ESSENCE | RECORD_CONSENSUS,
+                                  pack);
+}
+
+retcode_t iota_stor_transaction_load_metadata(storage_connection_t const* const connection,
+                                              flex_trit_t const* const hash, iota_stor_pack_t* const pack) {
+  return transaction_load_records((lmdb_connection_t*)connection->actual, hash, RECORD_METADATA, pack);
+}
+
+typedef retcode_t (*duplicates_do_func)(void* const params, flex_trit_t const* const value, bool* const stop);
+
+// Iterates over the hashes indexed under a key, duplicates being stored encoded
+static retcode_t duplicates_for_each(MDB_txn* const txn, MDB_dbi const dbi, flex_trit_t const* const key,
+                                     size_t const key_num_trits, duplicates_do_func const func, void* const params) {
+  retcode_t ret = RC_OK;
+  MDB_cursor* cursor = NULL;
+  MDB_val mdb_key, value;
+  byte_t key_buffer[STORAGE_KEY_SIZE_243];
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  bool stop = false;
+  int rc = 0;
+
+  trits_key_encode(&mdb_key, key_buffer, key, key_num_trits);
+
+  if (mdb_cursor_open(txn, dbi, &cursor) != MDB_SUCCESS) {
+    return RC_LMDB_FAILED_CURSOR;
+  }
+
+  for (rc = mdb_cursor_get(cursor, &mdb_key, &value, MDB_SET_KEY); rc == MDB_SUCCESS && !stop;
+       rc = mdb_cursor_get(cursor, &mdb_key, &value, MDB_NEXT_DUP)) {
+    trits_key_decode(&value, hash, NUM_TRITS_HASH);
+    if ((ret = func(params, hash, &stop)) != RC_OK) {
+      goto done;
+    }
+  }
+
+  if (rc != MDB_SUCCESS && rc != MDB_NOTFOUND) {
+    ret = RC_LMDB_FAILED_CURSOR;
+  }
+
+done:
+  mdb_cursor_close(cursor);
+  return ret;
+}
+
+static retcode_t load_hash_do_func(iota_stor_pack_t* const pack, flex_trit_t const* const hash, bool* const stop) {
+  *stop = !pack_push_hash(pack, hash);
+  return RC_OK;
+}
+
+retcode_t iota_stor_transaction_load_hashes(storage_connection_t const* const connection,
+                                            transaction_field_t const field, flex_trit_t const* const key,
+                                            iota_stor_pack_t* const pack) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+
+  if (field != TRANSACTION_FIELD_ADDRESS) {
+    return RC_LMDB_FAILED_NOT_IMPLEMENTED;
+  }
+
+  if ((ret = begin_transaction(lmdb_connection->environment->env, true, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  pack->insufficient_capacity = false;
+  ret = duplicates_for_each(txn, lmdb_connection->environment->dbs.transaction_by_address, key, NUM_TRITS_HASH,
+                            (duplicates_do_func)load_hash_do_func, pack);
+
+  mdb_txn_abort(txn);
+  return ret;
+}
+
+retcode_t iota_stor_transaction_load_hashes_of_approvers(storage_connection_t const* const connection,
+                                                         flex_trit_t const* const approvee_hash,
+                                                         iota_stor_pack_t* const pack, int64_t before_timestamp) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+
+  return approvers_index_load_approvers(lmdb_connection->approvers_index, approvee_hash, pack, before_timestamp);
+}
+
+retcode_t iota_stor_transaction_load_hashes_of_requests(storage_connection_t const* const connection,
+                                                        iota_stor_pack_t* const pack, size_t const limit) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+
+  return approvers_index_load_missing(lmdb_connection->approvers_index, pack, limit);
+}
+
+retcode_t iota_stor_transaction_load_hashes_of_tips(storage_connection_t const* const connection,
+                                                    iota_stor_pack_t* const pack, size_t const limit) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+
+  return approvers_index_load_tips(lmdb_connection->approvers_index, pack, limit);
+}
+
+typedef struct milestone_candidates_params_s {
+  MDB_txn* txn;
+  MDB_dbi milestone_by_hash;
+  iota_stor_pack_t* pack;
+} milestone_candidates_params_t;
+
+static retcode_t milestone_candidate_do_func(milestone_candidates_params_t* const params,
+                                             flex_trit_t const* const hash, bool* const stop) {
+  MDB_val key, value;
+  byte_t key_buffer[STORAGE_KEY_SIZE_243];
+  int rc = 0;
+
+  hash_key(&key, key_buffer, hash);
+  if ((rc = mdb_get(params->txn, params->milestone_by_hash, &key, &value)) == MDB_SUCCESS) {
+    return RC_OK;
+  } else if (rc != MDB_NOTFOUND) {
+    return RC_LMDB_FAILED_GET;
+  }
+  *stop = !pack_push_hash(params->pack, hash);
+
+  return RC_OK;
+}
+
+retcode_t iota_stor_transaction_load_hashes_of_milestone_candidates(storage_connection_t const* const connection,
+                                                                    iota_stor_pack_t* const pack,
+                                                                    flex_trit_t const* const coordinator) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  milestone_candidates_params_t params = {
+      .txn = NULL, .milestone_by_hash = lmdb_connection->environment->dbs.milestone_by_hash, .pack = pack};
+
+  if ((ret = begin_transaction(lmdb_connection->environment->env, true, &params.txn)) != RC_OK) {
+    return ret;
+  }
+
+  pack->insufficient_capacity = false;
+  ret = duplicates_for_each(params.txn, lmdb_connection->environment->dbs.transaction_by_address, coordinator,
+                            NUM_TRITS_HASH, (duplicates_do_func)milestone_candidate_do_func, &params);
+
+  mdb_txn_abort(params.txn);
+  return ret;
+}
+
+retcode_t iota_stor_transaction_update_solid_state(storage_connection_t const* const connection,
+                                                   flex_trit_t const* const hash, bool const is_solid) {
+  return update_transactions(connection, NULL, hash, METADATA_SOLID, is_solid);
+}
+
+retcode_t iota_stor_transactions_update_solid_state(storage_connection_t const* const connection,
+                                                    hash243_set_t const hashes, bool const is_solid) {
+  return update_transactions(connection, hashes, NULL, METADATA_SOLID, is_solid);
+}
+
+retcode_t iota_stor_transactions_update_snapshot_index(storage_connection_t const* const connection,
+                                                       hash243_set_t const hashes, uint64_t const snapshot_index) {
+  return update_transactions(connection, hashes, NULL, METADATA_SNAPSHOT_INDEX, snapshot_index);
+}
+
+retcode_t iota_stor_transaction_update_snapshot_index(storage_connection_t const* const connection,
+                                                      flex_trit_t const* const hash, uint64_t const snapshot_index) {
+  return update_transactions(connection, NULL, hash, METADATA_SNAPSHOT_INDEX, snapshot_index);
+}
+
+retcode_t iota_stor_transaction_exist(storage_connection_t const* const connection, transaction_field_t const field,
+                                      flex_trit_t const* const key, bool* const exist) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  MDB_val mdb_key, value;
+  byte_t key_buffer[STORAGE_KEY_SIZE_243];
+  MDB_stat stat;
+  int rc = 0;
+
+  if (field != TRANSACTION_FIELD_NONE && field != TRANSACTION_FIELD_HASH) {
+    return RC_LMDB_FAILED_NOT_IMPLEMENTED;
+  }
+
+  *exist = false;
+  if ((ret = begin_transaction(lmdb_connection->environment->env, true, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  if (field == TRANSACTION_FIELD_NONE || key == NULL) {
+    if (mdb_stat(txn, lmdb_connection->environment->dbs.transaction_essence, &stat) != MDB_SUCCESS) {
+      ret = RC_LMDB_FAILED_GET;
+      goto done;
+    }
+    *exist = stat.ms_entries > 0;
+  } else {
+    hash_key(&mdb_key, key_buffer, key);
+    if ((rc = mdb_get(txn, lmdb_connection->environment->dbs.transaction_essence, &mdb_key, &value)) == MDB_SUCCESS) {
+      *exist = true;
+    } else if (rc != MDB_NOTFOUND) {
+      ret = RC_LMDB_FAILED_GET;
+    }
+  }
+
+done:
+  mdb_txn_abort(txn);
+  return ret;
+}
+
+retcode_t iota_stor_transaction_approvers_count(storage_connection_t const* const connection,
+                                                flex_trit_t const* const hash, size_t* const count) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+
+  return approvers_index_approvers_count(lmdb_connection->approvers_index, hash, count);
+}
+
+typedef struct find_params_s {
+  MDB_txn* txn;
+  lmdb_databases_t const* dbs;
+  hash243_queue_t bundles;
+  hash243_queue_t addresses;
+  hash81_queue_t tags;
+  hash243_queue_t approvees;
+  hash243_set_t found;
+  iota_stor_pack_t* pack;
+} find_params_t;
+
+static bool hash243_queue_includes(hash243_queue_t const queue, flex_trit_t const* const hash) {
+  hash243_queue_entry_t* iter = NULL;
+
+  CDL_FOREACH(queue, iter) {
+    if (memcmp(iter->hash, hash, FLEX_TRIT_SIZE_243) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool hash81_queue_includes(hash81_queue_t const queue, flex_trit_t const* const hash) {
+  hash81_queue_entry_t* iter = NULL;
+
+  CDL_FOREACH(queue, iter) {
+    if (memcmp(iter->hash, hash, FLEX_TRIT_SIZE_81) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Loads a candidate hash if it matches every non-empty filter
+static retcode_t find_do_func(find_params_t* const params, flex_trit_t const* const hash, bool* const stop) {
+  retcode_t ret = RC_OK;
+  MDB_val key;
+  byte_t key_buffer[STORAGE_KEY_SIZE_243];
+  iota_transaction_fields_essence_t essence;
+  iota_transaction_fields_attachment_t attachment;
+
+  if (hash243_set_contains(&params->found, hash)) {
+    return RC_OK;
+  }
+
+  hash_key(&key, key_buffer, hash);
+  if (params->bundles || params->addresses) {
+    if ((ret = record_get(params->txn, params->dbs->transaction_essence, &key, &essence,
+                          sizeof(iota_transaction_fields_essence_t))) != RC_OK) {
+      return ret;
+    }
+    if ((params->bundles && !hash243_queue_includes(params->bundles, essence.bundle)) ||
+        (params->addresses && !hash243_queue_includes(params->addresses, essence.address))) {
+      return RC_OK;
+    }
+  }
+  if (params->tags || params->approvees) {
+    if ((ret = record_get(params->txn, params->dbs->transaction_attachment, &key, &attachment,
+                          sizeof(iota_transaction_fields_attachment_t))) != RC_OK) {
+      return ret;
+    }
+    if ((params->tags && !hash81_queue_includes(params->tags, attachment.tag)) ||
+        (params->approvees && !hash243_queue_includes(params->approvees, attachment.trunk) &&
+         !hash243_queue_includes(params->approvees, attachment.branch))) {
+      return RC_OK;
+    }
+  }
+
+  if (!pack_push_hash(params->pack, hash)) {
+    *stop = true;
+    return RC_OK;
+  }
+
+  return hash243_set_add(&params->found, hash);
+}
+
+static retcode_t find_from_approvees(find_params_t* const params, approvers_index_t* const approvers_index) {
+  retcode_t ret = RC_OK;
+  hash243_queue_entry_t* iter = NULL;
+  iota_stor_pack_t approvers;
+  size_t count = 0;
+  bool stop = false;
+
+  CDL_FOREACH(params->approvees, iter) {
+    if ((ret = approvers_index_approvers_count(approvers_index, iter->hash, &count)) != RC_OK) {
+      return ret;
+    }
+    if (count == 0) {
+      continue;
+    }
+    if ((ret = hash_pack_init(&approvers, count)) != RC_OK) {
+      return ret;
+    }
+    if ((ret = approvers_index_load_approvers(approvers_index, iter->hash, &approvers, 0)) == RC_OK) {
+      for (size_t i = 0; i < approvers.num_loaded && !stop && ret == RC_OK; i++) {
+        ret = find_do_func(params, approvers.models[i], &stop);
+      }
+    }
+    hash_pack_free(&approvers);
+    if (ret != RC_OK || stop) {
+      return ret;
+    }
+  }
+
+  return RC_OK;
+}
+
+static retcode_t find_from_all(find_params_t* const params) {
+  retcode_t ret = RC_OK;
+  MDB_cursor* cursor = NULL;
+  MDB_val key, value;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  bool stop = false;
+  int rc = 0;
+
+  if (mdb_cursor_open(params->txn, params->dbs->transaction_essence, &cursor) != MDB_SUCCESS) {
+    return RC_LMDB_FAILED_CURSOR;
+  }
+
+  for (rc = mdb_cursor_get(cursor, &key, &value, MDB_FIRST); rc == MDB_SUCCESS && !stop;
+       rc = mdb_cursor_get(cursor, &key, &value, MDB_NEXT)) {
+    trits_key_decode(&key, hash, NUM_TRITS_HASH);
+    if ((ret = find_do_func(params, hash, &stop)) != RC_OK) {
+      goto done;
+    }
+  }
+
+  if (rc != MDB_SUCCESS && rc != MDB_NOTFOUND) {
+    ret = RC_LMDB_FAILED_CURSOR;
+  }
+
+done:
+  mdb_cursor_close(cursor);
+  return ret;
+}
+
+retcode_t iota_stor_transaction_find(storage_connection_t const* const connection, hash243_queue_t const bundles,
+                                     hash243_queue_t const addresses, hash81_queue_t const tags,
+                                     hash243_queue_t const approvees, iota_stor_pack_t* const pack) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  find_params_t params = {.txn = NULL,
+                          .dbs = &lmdb_connection->environment->dbs,
+                          .bundles = bundles,
+                          .addresses = addresses,
+                          .tags = tags,
+                          .approvees = approvees,
+                          .found = NULL,
+                          .pack = pack};
+  hash243_queue_entry_t* iter243 = NULL;
+  hash81_queue_entry_t* iter81 = NULL;
+
+  if ((ret = begin_transaction(lmdb_connection->environment->env, true, &params.txn)) != RC_OK) {
+    return ret;
+  }
+
+  pack->insufficient_capacity = false;
+
+  // Candidates are enumerated from the first non-empty filter and checked against the others
+  if (bundles) {
+    CDL_FOREACH(bundles, iter243) {
+      if ((ret = duplicates_for_each(params.txn, params.dbs->transaction_by_bundle, iter243->hash, NUM_TRITS_HASH,
+                                     (duplicates_do_func)find_do_func, &params)) != RC_OK ||
+          pack->insufficient_capacity) {
+        break;
+      }
+    }
+  } else if (addresses) {
+    CDL_FOREACH(addresses, iter243) {
+      if ((ret = duplicates_for_each(params.txn, params.dbs->transaction_by_address, iter243->hash,
+                                     NUM_TRITS_HASH, (duplicates_do_func)find_do_func, &params)) != RC_OK ||
+          pack->insufficient_capacity) {
+        break;
+      }
+    }
+  } else if (tags) {
+    CDL_FOREACH(tags, iter81) {
+      if ((ret = duplicates_for_each(params.txn, params.dbs->transaction_by_tag, iter81->hash, NUM_TRITS_TAG,
+                                     (duplicates_do_func)find_do_func, &params)) != RC_OK ||
+          pack->insufficient_capacity) {
+        break;
+      }
+    }
+  } else if (approvees) {
+    ret = find_from_approvees(&params, lmdb_connection->approvers_index);
+  } else {
+    ret = find_from_all(&params);
+  }
+
+  hash243_set_free(&params.found);
+  mdb_txn_abort(params.txn);
+  return ret;
+}
+
+/*
+ * Milestone operations
+ */
+
+static retcode_t milestone_load_by_index(lmdb_connection_t const* const lmdb_connection, MDB_cursor_op const op,
+                                         uint64_t const index, iota_stor_pack_t* const pack) {
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  MDB_cursor* cursor = NULL;
+  MDB_val key, value;
+  uint8_t key_buffer[LMDB_INDEX_KEY_SIZE];
+  iota_milestone_t* milestone = NULL;
+  int rc = 0;
+
+  pack->insufficient_capacity = false;
+  index_key_encode(&key, key_buffer, index);
+
+  if ((ret = begin_transaction(lmdb_connection->environment->env, true, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  if (mdb_cursor_open(txn, lmdb_connection->environment->dbs.milestone, &cursor) != MDB_SUCCESS) {
+    ret = RC_LMDB_FAILED_CURSOR;
+    goto done;
+  }
+
+  if ((rc = mdb_cursor_get(cursor, &key, &value, op)) == MDB_NOTFOUND) {
+    goto done;
+  } else if (rc != MDB_SUCCESS) {
+    ret = RC_LMDB_FAILED_CURSOR;
+    goto done;
+  } else if (value.mv_size != STORAGE_KEY_SIZE_243) {
+    ret = RC_LMDB_INVALID_RECORD;
+    goto done;
+  }
+
+  if (pack->num_loaded == pack->capacity) {
+    pack->insufficient_capacity = true;
+    goto done;
+  }
+  milestone = (iota_milestone_t*)pack->models[pack->num_loaded++];
+  milestone->index = index_key_decode(&key);
+  trits_key_decode(&value, milestone->hash, NUM_TRITS_HASH);
+
+done:
+  if (cursor) {
+    mdb_cursor_close(cursor);
+  }
+  mdb_txn_abort(txn);
+  return ret;
+}
+
+retcode_t iota_stor_milestone_store(storage_connection_t const* const connection,
+                                    iota_milestone_t const* const milestone) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  lmdb_databases_t const* dbs = &lmdb_connection->environment->dbs;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  MDB_val index_key, hash;
+  uint8_t key_buffer[LMDB_INDEX_KEY_SIZE];
+  byte_t hash_buffer[STORAGE_KEY_SIZE_243];
+  int rc = 0;
+
+  index_key_encode(&index_key, key_buffer, milestone->index);
+  hash_key(&hash, hash_buffer, milestone->hash);
+
+  if ((ret = begin_transaction(lmdb_connection->environment->env, false, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  // Both the index and the hash of a milestone are unique
+  if ((rc = mdb_put(txn, dbs->milestone, &index_key, &hash, MDB_NOOVERWRITE)) != MDB_SUCCESS ||
+      (rc = mdb_put(txn, dbs->milestone_by_hash, &hash, &index_key, MDB_NOOVERWRITE)) != MDB_SUCCESS) {
+    mdb_txn_abort(txn);
+    return rc == MDB_KEYEXIST ? RC_LMDB_KEY_EXISTS : RC_LMDB_FAILED_PUT;
+  }
+
+  return end_transaction(txn);
+}
+
+retcode_t iota_stor_milestone_load(storage_connection_t const* const connection, flex_trit_t const* const hash,
+                                   iota_stor_pack_t* const pack) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  MDB_val key, value;
+  byte_t key_buffer[STORAGE_KEY_SIZE_243];
+  iota_milestone_t* milestone = NULL;
+  int rc = 0;
+
+  pack->insufficient_capacity = false;
+  hash_key(&key, key_buffer, hash);
+
+  if ((ret = begin_transaction(lmdb_connection->environment->env, true, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  if ((rc = mdb_get(txn, lmdb_connection->environment->dbs.milestone_by_hash, &key, &value)) == MDB_NOTFOUND) {
+    goto done;
+  } else if (rc != MDB_SUCCESS) {
+    ret = RC_LMDB_FAILED_GET;
+    goto done;
+  }
+
+  if (pack->num_loaded == pack->capacity) {
+    pack->insufficient_capacity = true;
+    goto done;
+  }
+  milestone = (iota_milestone_t*)pack->models[pack->num_loaded++];
+  milestone->index = index_key_decode(&value);
+  memcpy(milestone->hash, hash, FLEX_TRIT_SIZE_243);
+
+done:
+  mdb_txn_abort(txn);
+  return ret;
+}
+
+retcode_t iota_stor_milestone_load_first(storage_connection_t const* const connection, iota_stor_pack_t* const pack) {
+  return milestone_load_by_index((lmdb_connection_t*)connection->actual, MDB_FIRST, 0, pack);
+}
+
+retcode_t iota_stor_milestone_load_last(storage_connection_t const* const connection, iota_stor_pack_t* const pack) {
+  return milestone_load_by_index((lmdb_connection_t*)connection->actual, MDB_LAST, 0, pack);
+}
+
+retcode_t iota_stor_milestone_load_next(storage_connection_t const* const connection, uint64_t const index,
+                                        iota_stor_pack_t* const pack) {
+  return milestone_load_by_index((lmdb_connection_t*)connection->actual, MDB_SET_KEY, index + 1, pack);
+}
+
+retcode_t iota_stor_milestone_exist(storage_connection_t const* const connection, flex_trit_t const* const hash,
+                                    bool* const exist) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  MDB_val key, value;
+  byte_t key_buffer[STORAGE_KEY_SIZE_243];
+  MDB_stat stat;
+  int rc = 0;
+
+  *exist = false;
+  if ((ret = begin_transaction(lmdb_connection->environment->env, true, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  if (hash) {
+    hash_key(&key, key_buffer, hash);
+    if ((rc = mdb_get(txn, lmdb_connection->environment->dbs.milestone_by_hash, &key, &value)) == MDB_SUCCESS) {
+      *exist = true;
+    } else if (rc != MDB_NOTFOUND) {
+      ret = RC_LMDB_FAILED_GET;
+    }
+  } else if (mdb_stat(txn, lmdb_connection->environment->dbs.milestone, &stat) != MDB_SUCCESS) {
+    ret = RC_LMDB_FAILED_GET;
+  } else {
+    *exist = stat.ms_entries > 0;
+  }
+
+  mdb_txn_abort(txn);
+  return ret;
+}
+
+/*
+ * State delta operations
+ */
+
+retcode_t iota_stor_state_delta_store(storage_connection_t const* const connection, uint64_t const index,
+                                      state_delta_t const* const delta) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  MDB_val key, value;
+  uint8_t key_buffer[LMDB_INDEX_KEY_SIZE];
+  byte_t* bytes = NULL;
+  size_t size = 0;
+
+  size = state_delta_serialized_size(delta);
+  if ((bytes = (byte_t*)calloc(size, sizeof(byte_t))) == NULL) {
+    return RC_STORAGE_OOM;
+  }
+
+  if ((ret = state_delta_serialize(delta, bytes)) != RC_OK) {
+    goto done;
+  }
+
+  index_key_encode(&key, key_buffer, index);
+  value.mv_size = size;
+  value.mv_data = bytes;
+
+  if ((ret = begin_transaction(lmdb_connection->environment->env, false, &txn)) != RC_OK) {
+    goto done;
+  }
+
+  if (mdb_put(txn, lmdb_connection->environment->dbs.state_delta, &key, &value, 0) != MDB_SUCCESS) {
+    mdb_txn_abort(txn);
+    ret = RC_LMDB_FAILED_PUT;
+    goto done;
+  }
+
+  ret = end_transaction(txn);
+
+done:
+  free(bytes);
+  return ret;
+}
+
+retcode_t iota_stor_state_delta_load(storage_connection_t const* const connection, uint64_t const index,
+                                     state_delta_t* const delta) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  MDB_val key, value;
+  uint8_t key_buffer[LMDB_INDEX_KEY_SIZE];
+  int rc = 0;
+
+  *delta = NULL;
+  index_key_encode(&key, key_buffer, index);
+
+  if ((ret = begin_transaction(lmdb_connection->environment->env, true, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  if ((rc = mdb_get(txn, lmdb_connection->environment->dbs.state_delta, &key, &value)) == MDB_SUCCESS) {
+    ret = state_delta_deserialize((byte_t const*)value.mv_data, value.mv_size, delta);
+  } else if (rc != MDB_NOTFOUND) {
+    ret = RC_LMDB_FAILED_GET;
+  }
+
+  mdb_txn_abort(txn);
+  return ret;
+}
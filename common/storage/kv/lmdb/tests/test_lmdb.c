@@ -0,0 +1,372 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <unity/unity.h>
+
+#include "common/model/milestone.h"
+#include "common/model/transaction.h"
+#include "common/storage/kv/lmdb/connection.h"
+#include "common/storage/storage.h"
+#include "common/storage/tests/helpers/defs.h"
+#include "utils/containers/hash/hash243_set.h"
+#include "utils/files.h"
+
+static char *test_db_path = "common/storage/kv/lmdb/tests/test.db";
+static char *test_db_lock_path = "common/storage/kv/lmdb/tests/test.db-lock";
+
+static storage_connection_t connection;
+
+static iota_transaction_t *test_transaction_new() {
+  flex_trit_t tx_test_trits[FLEX_TRIT_SIZE_8019];
+
+  flex_trits_from_trytes(tx_test_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES,
+                         NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  return transaction_deserialize(tx_test_trits, true);
+}
+
+// Makes a copy of a transaction distinguishable by flipping one trit of its hash
+static void test_transaction_distinguish(iota_transaction_t *const tx, size_t const index) {
+  trit_t modified_trit = flex_trits_at(transaction_hash(tx), FLEX_TRIT_SIZE_243, index);
+
+  flex_trits_set_at(tx->consensus.hash, FLEX_TRIT_SIZE_243, index, abs(modified_trit) > 0 ? 0 : 1);
+}
+
+void test_init_connection(void) {
+  connection_config_t config;
+  config.db_path = test_db_path;
+  TEST_ASSERT(connection_init(&connection, &config) == RC_OK);
+}
+
+void test_shared_environment(void) {
+  connection_config_t config;
+  storage_connection_t other;
+
+  // Another spelling of the same path shares the environment and the approvers index
+  config.db_path = "common/storage/kv/lmdb/tests/../tests/test.db";
+  TEST_ASSERT(connection_init(&other, &config) == RC_OK);
+  TEST_ASSERT(((lmdb_connection_t *)other.actual)->environment ==
+              ((lmdb_connection_t *)connection.actual)->environment);
+  TEST_ASSERT(((lmdb_connection_t *)other.actual)->approvers_index ==
+              ((lmdb_connection_t *)connection.actual)->approvers_index);
+  TEST_ASSERT(connection_destroy(&other) == RC_OK);
+}
+
+void test_destroy_connection(void) { TEST_ASSERT(connection_destroy(&connection) == RC_OK); }
+
+void test_initialized_db_empty(void) {
+  bool exist = true;
+  size_t count = 1;
+
+  TEST_ASSERT(iota_stor_transaction_exist(&connection, TRANSACTION_FIELD_NONE, NULL, &exist) == RC_OK);
+  TEST_ASSERT(exist == false);
+  TEST_ASSERT(iota_stor_milestone_exist(&connection, NULL, &exist) == RC_OK);
+  TEST_ASSERT(exist == false);
+  TEST_ASSERT(iota_stor_transaction_count(&connection, &count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(0, count);
+}
+
+void test_stored_transaction(void) {
+  iota_transaction_t *test_tx = test_transaction_new();
+  DECLARE_PACK_SINGLE_TX(tx, tx_ptr, pack);
+  bool exist = false;
+
+  TEST_ASSERT(iota_stor_transaction_store(&connection, test_tx) == RC_OK);
+  // Test primary key constraint violation
+  TEST_ASSERT(iota_stor_transaction_store(&connection, test_tx) == RC_LMDB_KEY_EXISTS);
+
+  TEST_ASSERT(iota_stor_transaction_exist(&connection, TRANSACTION_FIELD_NONE, NULL, &exist) == RC_OK);
+  TEST_ASSERT(exist == true);
+  TEST_ASSERT(iota_stor_transaction_exist(&connection, TRANSACTION_FIELD_HASH, transaction_hash(test_tx), &exist) ==
+              RC_OK);
+  TEST_ASSERT(exist == true);
+
+  memset(&tx, 0, sizeof(iota_transaction_t));
+  TEST_ASSERT(iota_stor_transaction_load(&connection, TRANSACTION_FIELD_HASH, transaction_hash(test_tx), &pack) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_nonce(&tx), transaction_nonce(test_tx), FLEX_TRIT_SIZE_81);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_signature(&tx), transaction_signature(test_tx), FLEX_TRIT_SIZE_6561);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_address(&tx), transaction_address(test_tx), FLEX_TRIT_SIZE_243);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_branch(&tx), transaction_branch(test_tx), FLEX_TRIT_SIZE_243);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_trunk(&tx), transaction_trunk(test_tx), FLEX_TRIT_SIZE_243);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_bundle(&tx), transaction_bundle(test_tx), FLEX_TRIT_SIZE_243);
+  TEST_ASSERT_EQUAL_INT(transaction_value(&tx), transaction_value(test_tx));
+  TEST_ASSERT_EQUAL_INT(transaction_timestamp(&tx), transaction_timestamp(test_tx));
+  TEST_ASSERT_EQUAL_INT(transaction_current_index(&tx), transaction_current_index(test_tx));
+  TEST_ASSERT_EQUAL_INT(transaction_last_index(&tx), transaction_last_index(test_tx));
+  TEST_ASSERT_EQUAL_MEMORY(transaction_hash(&tx), transaction_hash(test_tx), FLEX_TRIT_SIZE_243);
+
+  // Unknown transactions are not loaded
+  test_transaction_distinguish(test_tx, 0);
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_load(&connection, TRANSACTION_FIELD_HASH, transaction_hash(test_tx), &pack) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(0, pack.num_loaded);
+
+  transaction_free(test_tx);
+}
+
+void test_stored_milestone(void) {
+  iota_milestone_t milestone;
+  DECLARE_PACK_SINGLE_MILESTONE(ms, ms_ptr, ms_pack);
+  bool exist = false;
+
+  milestone.index = 42;
+  memset(milestone.hash, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
+  flex_trits_set_at(milestone.hash, FLEX_TRIT_SIZE_243, 0, 1);
+
+  TEST_ASSERT(iota_stor_milestone_store(&connection, &milestone) == RC_OK);
+  // Test index and hash unique constraints violations
+  TEST_ASSERT(iota_stor_milestone_store(&connection, &milestone) == RC_LMDB_KEY_EXISTS);
+  milestone.index++;
+  TEST_ASSERT(iota_stor_milestone_store(&connection, &milestone) == RC_LMDB_KEY_EXISTS);
+
+  flex_trits_set_at(milestone.hash, FLEX_TRIT_SIZE_243, 1, 1);
+  TEST_ASSERT(iota_stor_milestone_store(&connection, &milestone) == RC_OK);
+
+  TEST_ASSERT(iota_stor_milestone_load_last(&connection, &ms_pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, ms_pack.num_loaded);
+  TEST_ASSERT_EQUAL_INT(43, ms.index);
+  TEST_ASSERT_EQUAL_MEMORY(ms.hash, milestone.hash, FLEX_TRIT_SIZE_243);
+
+  hash_pack_reset(&ms_pack);
+  TEST_ASSERT(iota_stor_milestone_load_first(&connection, &ms_pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, ms_pack.num_loaded);
+  TEST_ASSERT_EQUAL_INT(42, ms.index);
+
+  hash_pack_reset(&ms_pack);
+  TEST_ASSERT(iota_stor_milestone_load_next(&connection, 42, &ms_pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, ms_pack.num_loaded);
+  TEST_ASSERT_EQUAL_INT(43, ms.index);
+
+  hash_pack_reset(&ms_pack);
+  TEST_ASSERT(iota_stor_milestone_load_next(&connection, 43, &ms_pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(0, ms_pack.num_loaded);
+
+  hash_pack_reset(&ms_pack);
+  TEST_ASSERT(iota_stor_milestone_load(&connection, milestone.hash, &ms_pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, ms_pack.num_loaded);
+  TEST_ASSERT_EQUAL_INT(43, ms.index);
+
+  TEST_ASSERT(iota_stor_milestone_exist(&connection, NULL, &exist) == RC_OK);
+  TEST_ASSERT(exist == true);
+  TEST_ASSERT(iota_stor_milestone_exist(&connection, milestone.hash, &exist) == RC_OK);
+  TEST_ASSERT(exist == true);
+}
+
+void test_stored_load_hashes(void) {
+  flex_trit_t *hashes[5];
+  iota_stor_pack_t pack = {.models = (void **)hashes, .capacity = 5, .num_loaded = 0, .insufficient_capacity = false};
+  iota_transaction_t *test_tx = test_transaction_new();
+  size_t count = 0;
+
+  for (size_t i = 0; i < 5; ++i) {
+    hashes[i] = (flex_trit_t *)malloc(FLEX_TRIT_SIZE_243);
+  }
+
+  TEST_ASSERT(iota_stor_transaction_load_hashes(&connection, TRANSACTION_FIELD_ADDRESS, transaction_address(test_tx),
+                                                &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_hash(test_tx), hashes[0], FLEX_TRIT_SIZE_243);
+
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_load_hashes_of_milestone_candidates(&connection, &pack,
+                                                                        transaction_address(test_tx)) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_load_hashes_of_approvers(&connection, transaction_trunk(test_tx), &pack, 0) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_hash(test_tx), hashes[0], FLEX_TRIT_SIZE_243);
+  TEST_ASSERT(iota_stor_transaction_approvers_count(&connection, transaction_trunk(test_tx), &count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, count);
+
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_load_hashes_of_tips(&connection, &pack, 5) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_hash(test_tx), hashes[0], FLEX_TRIT_SIZE_243);
+
+  for (size_t i = 0; i < 5; ++i) {
+    free(hashes[i]);
+  }
+  transaction_free(test_tx);
+}
+
+void test_find(void) {
+  flex_trit_t *hashes[5];
+  iota_stor_pack_t pack = {.models = (void **)hashes, .capacity = 5, .num_loaded = 0, .insufficient_capacity = false};
+  iota_transaction_t *test_tx = test_transaction_new();
+  hash243_queue_t bundles = NULL, addresses = NULL, approvees = NULL;
+  hash81_queue_t tags = NULL;
+
+  for (size_t i = 0; i < 5; ++i) {
+    hashes[i] = (flex_trit_t *)malloc(FLEX_TRIT_SIZE_243);
+  }
+
+  TEST_ASSERT(hash243_queue_push(&bundles, transaction_bundle(test_tx)) == RC_OK);
+  TEST_ASSERT(hash243_queue_push(&approvees, transaction_branch(test_tx)) == RC_OK);
+  TEST_ASSERT(iota_stor_transaction_find(&connection, bundles, addresses, tags, approvees, &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_hash(test_tx), hashes[0], FLEX_TRIT_SIZE_243);
+
+  // Filters are intersected
+  hash_pack_reset(&pack);
+  TEST_ASSERT(hash243_queue_push(&addresses, transaction_hash(test_tx)) == RC_OK);
+  TEST_ASSERT(iota_stor_transaction_find(&connection, bundles, addresses, tags, approvees, &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(0, pack.num_loaded);
+
+  hash_pack_reset(&pack);
+  TEST_ASSERT(hash81_queue_push(&tags, transaction_tag(test_tx)) == RC_OK);
+  TEST_ASSERT(iota_stor_transaction_find(&connection, NULL, NULL, tags, NULL, &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+
+  hash243_queue_free(&bundles);
+  hash243_queue_free(&addresses);
+  hash243_queue_free(&approvees);
+  hash81_queue_free(&tags);
+  for (size_t i = 0; i < 5; ++i) {
+    free(hashes[i]);
+  }
+  transaction_free(test_tx);
+}
+
+void test_milestone_state_delta(void) {
+  state_delta_t state_delta1 = NULL, state_delta2 = NULL;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+
+  for (int64_t i = -100; i <= 100; i++) {
+    memset(hash, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
+    memcpy(hash, &i, sizeof(int64_t));
+    TEST_ASSERT(state_delta_add(&state_delta1, hash, i) == RC_OK);
+  }
+
+  TEST_ASSERT(iota_stor_state_delta_store(&connection, 42, &state_delta1) == RC_OK);
+
+  TEST_ASSERT(iota_stor_state_delta_load(&connection, 43, &state_delta2) == RC_OK);
+  TEST_ASSERT(state_delta2 == NULL);
+
+  TEST_ASSERT(iota_stor_state_delta_load(&connection, 42, &state_delta2) == RC_OK);
+  TEST_ASSERT(state_delta2 != NULL);
+  TEST_ASSERT_EQUAL_INT(HASH_COUNT(state_delta1), HASH_COUNT(state_delta2));
+  TEST_ASSERT_EQUAL_INT64(state_delta_sum(&state_delta1), state_delta_sum(&state_delta2));
+
+  state_delta_destroy(&state_delta1);
+  state_delta_destroy(&state_delta2);
+}
+
+void test_transactions_update_metadata(void) {
+  iota_transaction_t *test_tx = test_transaction_new();
+  iota_transaction_t second_test_transaction = *test_tx;
+  DECLARE_PACK_SINGLE_TX(tx, tx_ptr, pack);
+  hash243_set_t hashes = NULL;
+
+  test_transaction_distinguish(&second_test_transaction, 1);
+  TEST_ASSERT(iota_stor_transaction_store(&connection, &second_test_transaction) == RC_OK);
+
+  TEST_ASSERT(iota_stor_transaction_update_snapshot_index(&connection, transaction_hash(test_tx), 123456) == RC_OK);
+  TEST_ASSERT(iota_stor_transaction_load_metadata(&connection, transaction_hash(test_tx), &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_EQUAL_INT(123456, transaction_snapshot_index(&tx));
+  TEST_ASSERT_FALSE(transaction_solid(&tx));
+
+  hash243_set_add(&hashes, transaction_hash(test_tx));
+  hash243_set_add(&hashes, transaction_hash(&second_test_transaction));
+  TEST_ASSERT(iota_stor_transactions_update_solid_state(&connection, hashes, true) == RC_OK);
+
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_load_essence_and_metadata(&connection, transaction_hash(test_tx), &pack) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_TRUE(transaction_solid(&tx));
+  TEST_ASSERT_EQUAL_INT(123456, transaction_snapshot_index(&tx));
+
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_load_essence_attachment_and_metadata(
+                  &connection, transaction_hash(&second_test_transaction), &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_TRUE(transaction_solid(&tx));
+  TEST_ASSERT_EQUAL_INT(0, transaction_snapshot_index(&tx));
+
+  hash243_set_free(&hashes);
+  transaction_free(test_tx);
+}
+
+void test_transactions_store_batch(void) {
+  iota_transaction_t *test_tx = test_transaction_new();
+  iota_transaction_t third_test_transaction = *test_tx;
+  iota_transaction_t const *txs[3] = {test_tx, &third_test_transaction, &third_test_transaction};
+  bool stored[3] = {true, false, true};
+  size_t count_before = 0, count_after = 0;
+
+  test_transaction_distinguish(&third_test_transaction, 3);
+
+  TEST_ASSERT(iota_stor_transaction_count(&connection, &count_before) == RC_OK);
+  TEST_ASSERT(iota_stor_transactions_store_batch(&connection, txs, 3, stored) == RC_OK);
+  TEST_ASSERT_FALSE(stored[0]);
+  TEST_ASSERT_TRUE(stored[1]);
+  TEST_ASSERT_FALSE(stored[2]);
+  TEST_ASSERT(iota_stor_transaction_count(&connection, &count_after) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(count_before + 1, count_after);
+
+  transaction_free(test_tx);
+}
+
+void test_incompatible_layout(void) {
+  connection_config_t config;
+  MDB_env *env = NULL;
+  MDB_txn *txn = NULL;
+  MDB_dbi layout;
+  MDB_val key = {.mv_size = strlen("layout"), .mv_data = "layout"};
+  MDB_val value;
+  uint32_t other_layout[4] = {0};
+
+  // Pretends the database was written by a build with another record layout
+  TEST_ASSERT(mdb_env_create(&env) == MDB_SUCCESS);
+  TEST_ASSERT(mdb_env_set_maxdbs(env, 16) == MDB_SUCCESS);
+  TEST_ASSERT(mdb_env_open(env, test_db_path, MDB_NOSUBDIR, 0644) == MDB_SUCCESS);
+  TEST_ASSERT(mdb_txn_begin(env, NULL, 0, &txn) == MDB_SUCCESS);
+  TEST_ASSERT(mdb_dbi_open(txn, "layout", 0, &layout) == MDB_SUCCESS);
+  value.mv_size = sizeof(other_layout);
+  value.mv_data = other_layout;
+  TEST_ASSERT(mdb_put(txn, layout, &key, &value, 0) == MDB_SUCCESS);
+  TEST_ASSERT(mdb_txn_commit(txn) == MDB_SUCCESS);
+  mdb_env_close(env);
+
+  config.db_path = test_db_path;
+  TEST_ASSERT(connection_init(&connection, &config) == RC_LMDB_INCOMPATIBLE_DB);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  remove_file(test_db_path);
+  remove_file(test_db_lock_path);
+  TEST_ASSERT(storage_init() == RC_OK);
+
+  RUN_TEST(test_init_connection);
+  RUN_TEST(test_shared_environment);
+  RUN_TEST(test_initialized_db_empty);
+  RUN_TEST(test_stored_transaction);
+  RUN_TEST(test_stored_milestone);
+  RUN_TEST(test_stored_load_hashes);
+  RUN_TEST(test_find);
+  RUN_TEST(test_milestone_state_delta);
+  RUN_TEST(test_transactions_update_metadata);
+  RUN_TEST(test_transactions_store_batch);
+  RUN_TEST(test_destroy_connection);
+  RUN_TEST(test_incompatible_layout);
+
+  TEST_ASSERT(storage_destroy() == RC_OK);
+  remove_file(test_db_path);
+  remove_file(test_db_lock_path);
+
+  return UNITY_END();
+}
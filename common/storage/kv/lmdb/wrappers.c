@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+
+#include "common/storage/kv/lmdb/wrappers.h"
+
+retcode_t begin_transaction(MDB_env* const env, bool const read_only, MDB_txn** const txn) {
+  if (mdb_txn_begin(env, NULL, read_only ? MDB_RDONLY : 0, txn) != MDB_SUCCESS) {
+    return RC_LMDB_FAILED_BEGIN;
+  }
+  return RC_OK;
+}
+
+retcode_t end_transaction(MDB_txn* const txn) {
+  if (mdb_txn_commit(txn) != MDB_SUCCESS) {
+    return RC_LMDB_FAILED_COMMIT;
+  }
+  return RC_OK;
+}
+
+void value_compress(MDB_val* const value, flex_trit_t const* const flex_trits, size_t const num_bytes) {
+  ssize_t i = num_bytes - 1;
+
+  for (; i >= 0 && flex_trits[i] == FLEX_TRIT_NULL_VALUE; --i)
+    ;
+  value->mv_data = (void*)flex_trits;
+  value->mv_size = i + 1;
+}
+
+void value_decompress(MDB_val const* const value, flex_trit_t* const flex_trits, size_t const num_bytes) {
+  size_t size = value->mv_size < num_bytes ? value->mv_size : num_bytes;
+
+  memcpy(flex_trits, value->mv_data, size);
+  memset(flex_trits + size, FLEX_TRIT_NULL_VALUE, num_bytes - size);
+}
+
+void index_key_encode(MDB_val* const key, uint8_t* const buffer, uint64_t const index) {
+  // Big-endian so that the lexicographic order of keys is the numeric order of indexes
+  for (size_t i = 0; i < LMDB_INDEX_KEY_SIZE; i++) {
+    buffer[i] = (index >> (8 * (LMDB_INDEX_KEY_SIZE - 1 - i))) & 0xFF;
+  }
+  key->mv_data = buffer;
+  key->mv_size = LMDB_INDEX_KEY_SIZE;
+}
+
+uint64_t index_key_decode(MDB_val const* const key) {
+  uint8_t const* buffer = (uint8_t const*)key->mv_data;
+  uint64_t index = 0;
+
+  for (size_t i = 0; i < LMDB_INDEX_KEY_SIZE && i < key->mv_size; i++) {
+    index = (index << 8) | buffer[i];
+  }
+  return index;
+}
+
+void trits_key_encode(MDB_val* const key, byte_t* const buffer, flex_trit_t const* const flex_trits,
+                      size_t const num_trits) {
+  key->mv_size = storage_key_encode(buffer, flex_trits, num_trits);
+  key->mv_data = buffer;
+}
+
+void trits_key_decode(MDB_val const* const key, flex_trit_t* const flex_trits, size_t const num_trits) {
+  storage_key_decode(flex_trits, (byte_t const*)key->mv_data, key->mv_size, num_trits);
+}
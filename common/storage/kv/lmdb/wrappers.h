@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __COMMON_STORAGE_KV_LMDB_WRAPPERS_H__
+#define __COMMON_STORAGE_KV_LMDB_WRAPPERS_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <lmdb.h>
+
+#include "common/errors.h"
+#include "common/storage/key_codec.h"
+#include "common/trinary/flex_trit.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LMDB_INDEX_KEY_SIZE 8
+
+retcode_t begin_transaction(MDB_env* const env, bool const read_only, MDB_txn** const txn);
+retcode_t end_transaction(MDB_txn* const txn);
+
+void value_compress(MDB_val* const value, flex_trit_t const* const flex_trits, size_t const num_bytes);
+void value_decompress(MDB_val const* const value, flex_trit_t* const flex_trits, size_t const num_bytes);
+
+void index_key_encode(MDB_val* const key, uint8_t* const buffer, uint64_t const index);
+uint64_t index_key_decode(MDB_val const* const key);
+
+void trits_key_encode(MDB_val* const key, byte_t* const buffer, flex_trit_t const* const flex_trits,
+                      size_t const num_trits);
+void trits_key_decode(MDB_val const* const key, flex_trit_t* const flex_trits, size_t const num_trits);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_STORAGE_KV_LMDB_WRAPPERS_H__
@@ -1,5 +1,5 @@
+-- Hot vertex table, every field but the signature or message so that rows stay narrow
 CREATE TABLE IF NOT EXISTS iota_transaction (
-  signature_or_message BLOB NOT NULL,
   address BLOB NOT NULL,
   value INTEGER NOT NULL,
   obsolete_tag BLOB,
@@ -28,6 +28,12 @@ CREATE INDEX IF NOT EXISTS tag_index ON iota_transaction(tag);
 CREATE INDEX IF NOT EXISTS transaction_hash_index ON iota_transaction(hash);
 CREATE INDEX IF NOT EXISTS arrival_time_index ON iota_transaction(arrival_timestamp);
 
+-- Cold payload table, only read when a full transaction is loaded
+CREATE TABLE IF NOT EXISTS iota_transaction_payload (
+  hash BLOB NOT NULL PRIMARY KEY,
+  signature_or_message BLOB NOT NULL
+);
+
 CREATE TABLE IF NOT EXISTS iota_milestone (
   id INTEGER NOT NULL PRIMARY KEY,
   hash BLOB NOT NULL UNIQUE,
@@ -10,6 +10,7 @@
 
 #include <sqlite3.h>
 
+#include "common/model/transaction.h"
 #include "common/storage/sql/sqlite3/connection.h"
 #include "common/storage/sql/sqlite3/wrappers.h"
 #include "common/storage/sql/statements.h"
@@ -24,18 +25,12 @@ static retcode_t prepare_statements(sqlite3_connection_t* const connection) {
 
   ret =
       prepare_statement(connection->db, &connection->statements.transaction_insert, iota_statement_transaction_insert);
+  ret |= prepare_statement(connection->db, &connection->statements.transaction_payload_insert,
+                           iota_statement_transaction_payload_insert);
   ret |= prepare_statement(connection->db, &connection->statements.transaction_select_by_hash,
                            iota_statement_transaction_select_by_hash);
   ret |= prepare_statement(connection->db, &connection->statements.transaction_select_hashes_by_address,
                            iota_statement_transaction_select_hashes_by_address);
-  ret |= prepare_statement(connection->db, &connection->statements.transaction_select_hashes_of_approvers,
-                           iota_statement_transaction_select_hashes_of_approvers);
-  ret |= prepare_statement(connection->db, &connection->statements.transaction_select_hashes_of_approvers_before_date,
-                           iota_statement_transaction_select_hashes_of_approvers_before_date);
-  ret |= prepare_statement(connection->db, &connection->statements.transaction_select_hashes_of_transactions_to_request,
-                           iota_statement_transaction_select_hashes_of_transactions_to_request);
-  ret |= prepare_statement(connection->db, &connection->statements.transaction_select_hashes_of_tips,
-                           iota_statement_transaction_select_hashes_of_tips);
   ret |= prepare_statement(connection->db, &connection->statements.transaction_select_hashes_of_milestone_candidates,
                            iota_statement_transaction_select_hashes_of_milestone_candidates);
   ret |= prepare_statement(connection->db, &connection->statements.transaction_update_snapshot_index,
@@ -45,8 +40,6 @@ static retcode_t prepare_statements(sqlite3_connection_t* const connection) {
   ret |= prepare_statement(connection->db, &connection->statements.transaction_exist, iota_statement_transaction_exist);
   ret |= prepare_statement(connection->db, &connection->statements.transaction_exist_by_hash,
                            iota_statement_transaction_exist_by_hash);
-  ret |= prepare_statement(connection->db, &connection->statements.transaction_approvers_count,
-                           iota_statement_transaction_approvers_count);
   ret |= prepare_statement(connection->db, &connection->statements.transaction_count, iota_statement_transaction_count);
   ret |= prepare_statement(connection->db, &connection->statements.transaction_select_essence_and_metadata,
                            iota_statement_transaction_select_essence_and_metadata);
@@ -82,18 +75,14 @@ static retcode_t finalize_statements(sqlite3_connection_t* const connection) {
   retcode_t ret = RC_OK;
 
   ret = finalize_statement(connection->statements.transaction_insert);
+  ret |= finalize_statement(connection->statements.transaction_payload_insert);
   ret |= finalize_statement(connection->statements.transaction_select_by_hash);
   ret |= finalize_statement(connection->statements.transaction_select_hashes_by_address);
-  ret |= finalize_statement(connection->statements.transaction_select_hashes_of_approvers);
-  ret |= finalize_statement(connection->statements.transaction_select_hashes_of_approvers_before_date);
-  ret |= finalize_statement(connection->statements.transaction_select_hashes_of_transactions_to_request);
-  ret |= finalize_statement(connection->statements.transaction_select_hashes_of_tips);
   ret |= finalize_statement(connection->statements.transaction_select_hashes_of_milestone_candidates);
   ret |= finalize_statement(connection->statements.transaction_update_snapshot_index);
   ret |= finalize_statement(connection->statements.transaction_update_solid_state);
   ret |= finalize_statement(connection->statements.transaction_exist);
   ret |= finalize_statement(connection->statements.transaction_exist_by_hash);
-  ret |= finalize_statement(connection->statements.transaction_approvers_count);
   ret |= finalize_statement(connection->statements.transaction_count);
   ret |= finalize_statement(connection->statements.transaction_select_essence_and_metadata);
   ret |= finalize_statement(connection->statements.transaction_select_essence_attachment_and_metadata);
@@ -116,11 +105,46 @@ static retcode_t finalize_statements(sqlite3_connection_t* const connection) {
   return ret;
 }
 
+static retcode_t load_approvers_index(approvers_index_t* const index, sqlite3_connection_t* const connection) {
+  retcode_t ret = RC_OK;
+  sqlite3_stmt* sqlite_statement = NULL;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  flex_trit_t trunk[FLEX_TRIT_SIZE_243];
+  flex_trit_t branch[FLEX_TRIT_SIZE_243];
+  int rc = 0;
+
+  if ((ret = prepare_statement(connection->db, &sqlite_statement, iota_statement_transaction_select_approvers_index)) !=
+      RC_OK) {
+    goto done;
+  }
+
+  while ((rc = sqlite3_step(sqlite_statement)) == SQLITE_ROW) {
+    column_decompress_load(sqlite_statement, 0, hash, NUM_TRITS_HASH);
+    column_decompress_load(sqlite_statement, 1, trunk, NUM_TRITS_TRUNK);
+    column_decompress_load(sqlite_statement, 2, branch, NUM_TRITS_BRANCH);
+    if ((ret = approvers_index_add(index, hash, trunk, branch, sqlite3_column_int64(sqlite_statement, 3))) != RC_OK) {
+      goto done;
+    }
+  }
+
+  if (rc != SQLITE_DONE) {
+    ret = RC_SQLITE3_FAILED_STEP;
+    goto done;
+  }
+
+  log_info(logger_id, "Approvers index loaded with %zu vertices\n", approvers_index_size(index));
+
+done:
+  finalize_statement(sqlite_statement);
+  return ret;
+}
+
 retcode_t connection_init(storage_connection_t* const connection, connection_config_t const* const config) {
   sqlite3_connection_t* sqlite3_connection = NULL;
   char* err_msg = NULL;
   char* sql = NULL;
   int rc = 0;
+  retcode_t ret = RC_OK;
 
   if (connection == NULL) {
     return RC_NULL_PARAM;
@@ -155,7 +179,17 @@ retcode_t connection_init(storage_connection_t* const connection, connection_con
     return RC_SQLITE3_FAILED_INSERT_DB;
   }
 
-  return prepare_statements(sqlite3_connection);
+  if ((ret = prepare_statements(sqlite3_connection)) != RC_OK) {
+    return ret;
+  }
+
+  if ((ret = approvers_index_acquire(config->db_path, (approvers_index_loader_t)load_approvers_index,
+                                     sqlite3_connection, &sqlite3_connection->approvers_index)) != RC_OK) {
+    log_critical(logger_id, "Failed to load approvers index\n");
+    return ret;
+  }
+
+  return RC_OK;
 }
 
 retcode_t connection_destroy(storage_connection_t* const connection) {
@@ -167,6 +201,9 @@ retcode_t connection_destroy(storage_connection_t* const connection) {
   }
   sqlite3_connection = (sqlite3_connection_t*)connection->actual;
 
+  if (sqlite3_connection->approvers_index) {
+    approvers_index_release(sqlite3_connection->approvers_index);
+  }
   ret = finalize_statements(sqlite3_connection);
   sqlite3_close(sqlite3_connection->db);
   sqlite3_connection->db = NULL;
@@ -8,6 +8,7 @@
 #ifndef __COMMON_STORAGE_SQL_SQLITE3_CONNECTION_H__
 #define __COMMON_STORAGE_SQL_SQLITE3_CONNECTION_H__
 
+#include "common/storage/approvers_index.h"
 #include "common/storage/connection.h"
 #include "common/storage/sql/statements.h"
 
@@ -18,6 +19,7 @@ extern "C" {
 typedef struct sqlite3_connection_s {
   sqlite3* db;
   iota_statements_t statements;
+  approvers_index_t* approvers_index;
 } sqlite3_connection_t;
 
 #ifdef __cplusplus
@@ -9,19 +9,25 @@
 #include <inttypes.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <sqlite3.h>
 
 #include "common/model/milestone.h"
 #include "common/model/transaction.h"
+#include "common/storage/approvers_index.h"
 #include "common/storage/sql/sqlite3/connection.h"
 #include "common/storage/sql/sqlite3/wrappers.h"
 #include "common/storage/sql/statements.h"
 #include "common/storage/storage.h"
+#include "common/storage/transaction_cache.h"
 #include "utils/logger_helper.h"
+#include "utils/macros.h"
 #include "utils/time.h"
 
 #define SQLITE3_LOGGER_ID "sqlite3"
+// Stays below SQLITE_MAX_VARIABLE_NUMBER default value of 999
+#define SQLITE3_MAX_IN_CLAUSE_HASHES 512
 
 static logger_id_t logger_id;
 
@@ -30,6 +36,8 @@ static void error_log_callback(void* const arg, int const err_code, char const*
 }
 
 retcode_t storage_init() {
+  retcode_t ret = RC_OK;
+
   logger_id = logger_helper_enable(SQLITE3_LOGGER_ID, LOGGER_DEBUG, true);
 
   if (sqlite3_config(SQLITE_CONFIG_LOG, error_log_callback, NULL) != SQLITE_OK) {
@@ -50,11 +58,17 @@ retcode_t storage_init() {
     return RC_SQLITE3_FAILED_INITIALIZE;
   }
 
-  return RC_OK;
+  if ((ret = approvers_index_registry_init()) != RC_OK) {
+    return ret;
+  }
+
+  return transaction_cache_registry_init();
 }
 
 retcode_t storage_destroy() {
   logger_helper_release(logger_id);
+  approvers_index_registry_destroy();
+  transaction_cache_registry_destroy();
 
   if (sqlite3_shutdown() != SQLITE_OK) {
     return RC_SQLITE3_FAILED_SHUTDOWN;
@@ -110,7 +124,7 @@ static retcode_t execute_statement_load_gen(sqlite3_stmt* const sqlite_statement
       break;
     }
     if (model == MODEL_HASH) {
-      column_decompress_load(sqlite_statement, 0, ((flex_trit_t*)pack->models[pack->num_loaded++]), FLEX_TRIT_SIZE_243);
+      column_decompress_load(sqlite_statement, 0, ((flex_trit_t*)pack->models[pack->num_loaded++]), NUM_TRITS_HASH);
     } else if (model == MODEL_TRANSACTION) {
       select_transactions_populate_from_row(sqlite_statement, pack->models[pack->num_loaded++]);
     } else if (model == MODEL_MILESTONE) {
@@ -171,7 +185,7 @@ static retcode_t update_transactions(storage_connection_t const* const connectio
   retcode_t ret_rollback;
   bool should_rollback_if_failed = false;
 
-  if ((ret = begin_transaction(sqlite3_connection->db)) != RC_OK) {
+  if ((ret = begin_immediate_transaction(sqlite3_connection->db)) != RC_OK) {
     return ret;
   }
 
@@ -220,7 +234,7 @@ static retcode_t bind_execute_hash_do_func(bind_execute_hash_params_t* const par
     return RC_SQLITE3_FAILED_BINDING;
   }
 
-  if (column_compress_bind(params->sqlite_statement, 2, hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+  if (column_compress_bind(params->sqlite_statement, 2, hash, NUM_TRITS_HASH) != RC_OK) {
     return RC_SQLITE3_FAILED_BINDING;
   }
 
@@ -258,44 +272,44 @@ static retcode_t execute_statement_load_transaction_metadata(sqlite3_stmt* const
 }
 
 static void select_transactions_populate_from_row(sqlite3_stmt* const statement, iota_transaction_t* const tx) {
-  column_decompress_load(statement, 0, tx->data.signature_or_message, FLEX_TRIT_SIZE_6561);
+  column_decompress_load(statement, 0, tx->data.signature_or_message, NUM_TRITS_SIGNATURE);
   tx->loaded_columns_mask.data |= MASK_DATA_SIG_OR_MSG;
-  column_decompress_load(statement, 1, tx->essence.address, FLEX_TRIT_SIZE_243);
+  column_decompress_load(statement, 1, tx->essence.address, NUM_TRITS_ADDRESS);
   tx->loaded_columns_mask.essence |= MASK_ESSENCE_ADDRESS;
   transaction_set_value(tx, sqlite3_column_int64(statement, 2));
-  column_decompress_load(statement, 3, tx->essence.obsolete_tag, FLEX_TRIT_SIZE_81);
+  column_decompress_load(statement, 3, tx->essence.obsolete_tag, NUM_TRITS_OBSOLETE_TAG);
   tx->loaded_columns_mask.essence |= MASK_ESSENCE_OBSOLETE_TAG;
   transaction_set_timestamp(tx, sqlite3_column_int64(statement, 4));
   transaction_set_current_index(tx, sqlite3_column_int64(statement, 5));
   transaction_set_last_index(tx, sqlite3_column_int64(statement, 6));
-  column_decompress_load(statement, 7, tx->essence.bundle, FLEX_TRIT_SIZE_243);
+  column_decompress_load(statement, 7, tx->essence.bundle, NUM_TRITS_BUNDLE);
   tx->loaded_columns_mask.essence |= MASK_ESSENCE_BUNDLE;
-  column_decompress_load(statement, 8, tx->attachment.trunk, FLEX_TRIT_SIZE_243);
+  column_decompress_load(statement, 8, tx->attachment.trunk, NUM_TRITS_TRUNK);
   tx->loaded_columns_mask.attachment |= MASK_ATTACHMENT_TRUNK;
-  column_decompress_load(statement, 9, tx->attachment.branch, FLEX_TRIT_SIZE_243);
+  column_decompress_load(statement, 9, tx->attachment.branch, NUM_TRITS_BRANCH);
   tx->loaded_columns_mask.attachment |= MASK_ATTACHMENT_BRANCH;
-  column_decompress_load(statement, 10, tx->attachment.tag, FLEX_TRIT_SIZE_81);
+  column_decompress_load(statement, 10, tx->attachment.tag, NUM_TRITS_TAG);
   tx->loaded_columns_mask.attachment |= MASK_ATTACHMENT_TAG;
   transaction_set_attachment_timestamp(tx, sqlite3_column_int64(statement, 11));
   transaction_set_attachment_timestamp_upper(tx, sqlite3_column_int64(statement, 12));
   transaction_set_attachment_timestamp_lower(tx, sqlite3_column_int64(statement, 13));
-  column_decompress_load(statement, 14, tx->attachment.nonce, FLEX_TRIT_SIZE_81);
+  column_decompress_load(statement, 14, tx->attachment.nonce, NUM_TRITS_NONCE);
   tx->loaded_columns_mask.attachment |= MASK_ATTACHMENT_NONCE;
-  column_decompress_load(statement, 15, tx->consensus.hash, FLEX_TRIT_SIZE_243);
+  column_decompress_load(statement, 15, tx->consensus.hash, NUM_TRITS_HASH);
   tx->loaded_columns_mask.consensus |= MASK_CONSENSUS_HASH;
 }
 
 static void select_transactions_populate_from_row_essence_and_metadata(sqlite3_stmt* const statement,
                                                                        iota_transaction_t* const tx) {
-  column_decompress_load(statement, 0, tx->essence.address, FLEX_TRIT_SIZE_243);
+  column_decompress_load(statement, 0, tx->essence.address, NUM_TRITS_ADDRESS);
   tx->loaded_columns_mask.essence |= MASK_ESSENCE_ADDRESS;
   transaction_set_value(tx, sqlite3_column_int64(statement, 1));
-  column_decompress_load(statement, 2, tx->essence.obsolete_tag, FLEX_TRIT_SIZE_81);
+  column_decompress_load(statement, 2, tx->essence.obsolete_tag, NUM_TRITS_OBSOLETE_TAG);
   tx->loaded_columns_mask.essence |= MASK_ESSENCE_OBSOLETE_TAG;
   transaction_set_timestamp(tx, sqlite3_column_int64(statement, 3));
   transaction_set_current_index(tx, sqlite3_column_int64(statement, 4));
   transaction_set_last_index(tx, sqlite3_column_int64(statement, 5));
-  column_decompress_load(statement, 6, tx->essence.bundle, FLEX_TRIT_SIZE_243);
+  column_decompress_load(statement, 6, tx->essence.bundle, NUM_TRITS_BUNDLE);
   tx->loaded_columns_mask.essence |= MASK_ESSENCE_BUNDLE;
   transaction_set_snapshot_index(tx, sqlite3_column_int64(statement, 7));
   transaction_set_solid(tx, sqlite3_column_int(statement, 8));
@@ -303,26 +317,26 @@ static void select_transactions_populate_from_row_essence_and_metadata(sqlite3_s
 
 static void select_transactions_populate_from_row_essence_attachment_and_metadata(sqlite3_stmt* const statement,
                                                                                   iota_transaction_t* const tx) {
-  column_decompress_load(statement, 0, tx->essence.address, FLEX_TRIT_SIZE_243);
+  column_decompress_load(statement, 0, tx->essence.address, NUM_TRITS_ADDRESS);
   tx->loaded_columns_mask.essence |= MASK_ESSENCE_ADDRESS;
   transaction_set_value(tx, sqlite3_column_int64(statement, 1));
-  column_decompress_load(statement, 2, tx->essence.obsolete_tag, FLEX_TRIT_SIZE_81);
+  column_decompress_load(statement, 2, tx->essence.obsolete_tag, NUM_TRITS_OBSOLETE_TAG);
   tx->loaded_columns_mask.essence |= MASK_ESSENCE_OBSOLETE_TAG;
   transaction_set_timestamp(tx, sqlite3_column_int64(statement, 3));
   transaction_set_current_index(tx, sqlite3_column_int64(statement, 4));
   transaction_set_last_index(tx, sqlite3_column_int64(statement, 5));
-  column_decompress_load(statement, 6, tx->essence.bundle, FLEX_TRIT_SIZE_243);
+  column_decompress_load(statement, 6, tx->essence.bundle, NUM_TRITS_BUNDLE);
   tx->loaded_columns_mask.essence |= MASK_ESSENCE_BUNDLE;
-  column_decompress_load(statement, 7, tx->attachment.trunk, FLEX_TRIT_SIZE_243);
+  column_decompress_load(statement, 7, tx->attachment.trunk, NUM_TRITS_TRUNK);
   tx->loaded_columns_mask.attachment |= MASK_ATTACHMENT_TRUNK;
-  column_decompress_load(statement, 8, tx->attachment.branch, FLEX_TRIT_SIZE_243);
+  column_decompress_load(statement, 8, tx->attachment.branch, NUM_TRITS_BRANCH);
   tx->loaded_columns_mask.attachment |= MASK_ATTACHMENT_BRANCH;
   transaction_set_attachment_timestamp(tx, sqlite3_column_int64(statement, 9));
   transaction_set_attachment_timestamp_upper(tx, sqlite3_column_int64(statement, 10));
   transaction_set_attachment_timestamp_lower(tx, sqlite3_column_int64(statement, 11));
-  column_decompress_load(statement, 12, tx->attachment.nonce, FLEX_TRIT_SIZE_81);
+  column_decompress_load(statement, 12, tx->attachment.nonce, NUM_TRITS_NONCE);
   tx->loaded_columns_mask.attachment |= MASK_ATTACHMENT_NONCE;
-  column_decompress_load(statement, 13, tx->attachment.tag, FLEX_TRIT_SIZE_81);
+  column_decompress_load(statement, 13, tx->attachment.tag, NUM_TRITS_TAG);
   tx->loaded_columns_mask.attachment |= MASK_ATTACHMENT_TAG;
   transaction_set_snapshot_index(tx, sqlite3_column_int64(statement, 14));
   transaction_set_solid(tx, sqlite3_column_int(statement, 15));
@@ -331,17 +345,17 @@ static void select_transactions_populate_from_row_essence_attachment_and_metadat
 
 static void select_transactions_populate_from_row_essence_and_consensus(sqlite3_stmt* const statement,
                                                                         iota_transaction_t* const tx) {
-  column_decompress_load(statement, 0, tx->essence.address, FLEX_TRIT_SIZE_243);
+  column_decompress_load(statement, 0, tx->essence.address, NUM_TRITS_ADDRESS);
   tx->loaded_columns_mask.essence |= MASK_ESSENCE_ADDRESS;
   transaction_set_value(tx, sqlite3_column_int64(statement, 1));
-  column_decompress_load(statement, 2, tx->essence.obsolete_tag, FLEX_TRIT_SIZE_81);
+  column_decompress_load(statement, 2, tx->essence.obsolete_tag, NUM_TRITS_OBSOLETE_TAG);
   tx->loaded_columns_mask.essence |= MASK_ESSENCE_OBSOLETE_TAG;
   transaction_set_timestamp(tx, sqlite3_column_int64(statement, 3));
   transaction_set_current_index(tx, sqlite3_column_int64(statement, 4));
   transaction_set_last_index(tx, sqlite3_column_int64(statement, 5));
-  column_decompress_load(statement, 6, tx->essence.bundle, FLEX_TRIT_SIZE_243);
+  column_decompress_load(statement, 6, tx->essence.bundle, NUM_TRITS_BUNDLE);
   tx->loaded_columns_mask.essence |= MASK_ESSENCE_BUNDLE;
-  column_decompress_load(statement, 7, tx->consensus.hash, FLEX_TRIT_SIZE_243);
+  column_decompress_load(statement, 7, tx->consensus.hash, NUM_TRITS_HASH);
   tx->loaded_columns_mask.consensus |= MASK_CONSENSUS_HASH;
 }
 
@@ -370,29 +384,31 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_transaction_store(storage_connection_t const* const connection,
-                                      iota_transaction_t const* const tx) {
-  sqlite3_connection_t const* sqlite3_connection = (sqlite3_connection_t*)connection->actual;
+static retcode_t transaction_insert(sqlite3_connection_t const* const sqlite3_connection,
+                                    iota_transaction_t const* const tx, uint64_t const arrival_timestamp) {
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_insert;
-
-  if (column_compress_bind(sqlite_statement, 1, tx->data.signature_or_message, FLEX_TRIT_SIZE_6561) != RC_OK ||
-      column_compress_bind(sqlite_statement, 2, tx->essence.address, FLEX_TRIT_SIZE_243) != RC_OK ||
-      sqlite3_bind_int64(sqlite_statement, 3, tx->essence.value) != SQLITE_OK ||
-      column_compress_bind(sqlite_statement, 4, tx->essence.obsolete_tag, FLEX_TRIT_SIZE_81) != RC_OK ||
-      sqlite3_bind_int64(sqlite_statement, 5, tx->essence.timestamp) != SQLITE_OK ||
-      sqlite3_bind_int64(sqlite_statement, 6, tx->essence.current_index) != SQLITE_OK ||
-      sqlite3_bind_int64(sqlite_statement, 7, tx->essence.last_index) != SQLITE_OK ||
-      column_compress_bind(sqlite_statement, 8, tx->essence.bundle, FLEX_TRIT_SIZE_243) != RC_OK ||
-      column_compress_bind(sqlite_statement, 9, tx->attachment.trunk, FLEX_TRIT_SIZE_243) != RC_OK ||
-      column_compress_bind(sqlite_statement, 10, tx->attachment.branch, FLEX_TRIT_SIZE_243) != RC_OK ||
-      column_compress_bind(sqlite_statement, 11, tx->attachment.tag, FLEX_TRIT_SIZE_81) != RC_OK ||
-      sqlite3_bind_int64(sqlite_statement, 12, tx->attachment.attachment_timestamp) != SQLITE_OK ||
-      sqlite3_bind_int64(sqlite_statement, 13, tx->attachment.attachment_timestamp_upper) != SQLITE_OK ||
-      sqlite3_bind_int64(sqlite_statement, 14, tx->attachment.attachment_timestamp_lower) != SQLITE_OK ||
-      column_compress_bind(sqlite_statement, 15, tx->attachment.nonce, FLEX_TRIT_SIZE_81) != RC_OK ||
-      column_compress_bind(sqlite_statement, 16, tx->consensus.hash, FLEX_TRIT_SIZE_243) != RC_OK ||
-      sqlite3_bind_int64(sqlite_statement, 17, current_timestamp_ms()) != SQLITE_OK) {
+  sqlite3_stmt* sqlite_payload_statement = sqlite3_connection->statements.transaction_payload_insert;
+
+  if (column_compress_bind(sqlite_statement, 1, tx->essence.address, NUM_TRITS_ADDRESS) != RC_OK ||
+      sqlite3_bind_int64(sqlite_statement, 2, tx->essence.value) != SQLITE_OK ||
+      column_compress_bind(sqlite_statement, 3, tx->essence.obsolete_tag, NUM_TRITS_OBSOLETE_TAG) != RC_OK ||
+      sqlite3_bind_int64(sqlite_statement, 4, tx->essence.timestamp) != SQLITE_OK ||
+      sqlite3_bind_int64(sqlite_statement, 5, tx->essence.current_index) != SQLITE_OK ||
+      sqlite3_bind_int64(sqlite_statement, 6, tx->essence.last_index) != SQLITE_OK ||
+      column_compress_bind(sqlite_statement, 7, tx->essence.bundle, NUM_TRITS_BUNDLE) != RC_OK ||
+      column_compress_bind(sqlite_statement, 8, tx->attachment.trunk, NUM_TRITS_TRUNK) != RC_OK ||
+      column_compress_bind(sqlite_statement, 9, tx->attachment.branch, NUM_TRITS_BRANCH) != RC_OK ||
+      column_compress_bind(sqlite_statement, 10, tx->attachment.tag, NUM_TRITS_TAG) != RC_OK ||
+      sqlite3_bind_int64(sqlite_statement, 11, tx->attachment.attachment_timestamp) != SQLITE_OK ||
+      sqlite3_bind_int64(sqlite_statement, 12, tx->attachment.attachment_timestamp_upper) != SQLITE_OK ||
+      sqlite3_bind_int64(sqlite_statement, 13, tx->attachment.attachment_timestamp_lower) != SQLITE_OK ||
+      column_compress_bind(sqlite_statement, 14, tx->attachment.nonce, NUM_TRITS_NONCE) != RC_OK ||
+      column_compress_bind(sqlite_statement, 15, tx->consensus.hash, NUM_TRITS_HASH) != RC_OK ||
+      sqlite3_bind_int64(sqlite_statement, 16, arrival_timestamp) != SQLITE_OK ||
+      column_compress_bind(sqlite_payload_statement, 1, tx->consensus.hash, NUM_TRITS_HASH) != RC_OK ||
+      column_compress_bind(sqlite_payload_statement, 2, tx->data.signature_or_message, NUM_TRITS_SIGNATURE) !=
+          RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -401,8 +417,146 @@ retcode_t iota_stor_transaction_store(storage_connection_t const* const connecti
     goto done;
   }
 
+  if ((ret = execute_statement_store_update(sqlite_payload_statement)) != RC_OK) {
+    goto done;
+  }
+
 done:
   sqlite3_reset(sqlite_statement);
+  sqlite3_reset(sqlite_payload_statement);
+  return ret;
+}
+
+retcode_t iota_stor_transaction_store(storage_connection_t const* const connection,
+                                      iota_transaction_t const* const tx) {
+  sqlite3_connection_t const* sqlite3_connection = (sqlite3_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  retcode_t ret_rollback;
+  uint64_t arrival_timestamp = current_timestamp_ms();
+
+  // The vertex and its payload are inserted atomically
+  if ((ret = begin_immediate_transaction(sqlite3_connection->db)) != RC_OK) {
+    return ret;
+  }
+
+  if ((ret = transaction_insert(sqlite3_connection, tx, arrival_timestamp)) != RC_OK) {
+    if ((ret_rollback = rollback_transaction(sqlite3_connection->db)) != RC_OK) {
+      return ret_rollback;
+    }
+    return ret;
+  }
+
+  if ((ret = end_transaction(sqlite3_connection->db)) != RC_OK) {
+    return ret;
+  }
+
+  return approvers_index_add(sqlite3_connection->approvers_index, tx->consensus.hash, tx->attachment.trunk,
+                             tx->attachment.branch, arrival_timestamp);
+}
+
+static retcode_t transactions_select_existing(sqlite3_connection_t const* const sqlite3_connection,
+                                              iota_transaction_t const* const* const txs, size_t const count,
+                                              hash243_set_t* const existing) {
+  retcode_t ret = RC_OK;
+  sqlite3_stmt* sqlite_statement = NULL;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  char* statement = iota_statement_transaction_select_hashes_in_build(count);
+
+  if (statement == NULL) {
+    return RC_STORAGE_OOM;
+  }
+
+  if ((ret = prepare_statement(sqlite3_connection->db, &sqlite_statement, statement)) != RC_OK) {
+    goto done;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    if (column_compress_bind(sqlite_statement, i + 1, txs[i]->consensus.hash, NUM_TRITS_HASH) != RC_OK) {
+      ret = RC_SQLITE3_FAILED_BINDING;
+      goto done;
+    }
+  }
+
+  while (sqlite3_step(sqlite_statement) == SQLITE_ROW) {
+    column_decompress_load(sqlite_statement, 0, hash, NUM_TRITS_HASH);
+    if ((ret = hash243_set_add(existing, hash)) != RC_OK) {
+      goto done;
+    }
+  }
+
+done:
+  finalize_statement(sqlite_statement);
+  free(statement);
+  return ret;
+}
+
+retcode_t iota_stor_transactions_store_batch(storage_connection_t const* const connection,
+                                             iota_transaction_t const* const* const txs, size_t const count,
+                                             bool* const stored) {
+  sqlite3_connection_t const* sqlite3_connection = (sqlite3_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  retcode_t ret_rollback;
+  uint64_t arrival_timestamp = current_timestamp_ms();
+  hash243_set_t existing = NULL;
+  bool should_rollback_if_failed = false;
+
+  if (txs == NULL || stored == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  memset(stored, false, count * sizeof(bool));
+  if (count == 0) {
+    return RC_OK;
+  }
+
+  if ((ret = begin_immediate_transaction(sqlite3_connection->db)) != RC_OK) {
+    goto done;
+  }
+  should_rollback_if_failed = true;
+
+  // Looked up inside the transaction so that a concurrent store can not slip in between the lookup and the inserts
+  for (size_t offset = 0; offset < count; offset += SQLITE3_MAX_IN_CLAUSE_HASHES) {
+    if ((ret = transactions_select_existing(sqlite3_connection, txs + offset,
+                                            MIN(count - offset, SQLITE3_MAX_IN_CLAUSE_HASHES), &existing)) != RC_OK) {
+      goto done;
+    }
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    // Also skips duplicates within the batch since stored hashes are added to the set
+    if (hash243_set_contains(&existing, txs[i]->consensus.hash)) {
+      continue;
+    }
+    if ((ret = transaction_insert(sqlite3_connection, txs[i], arrival_timestamp)) != RC_OK) {
+      goto done;
+    }
+    if ((ret = hash243_set_add(&existing, txs[i]->consensus.hash)) != RC_OK) {
+      goto done;
+    }
+    stored[i] = true;
+  }
+
+  if ((ret = end_transaction(sqlite3_connection->db)) != RC_OK) {
+    goto done;
+  }
+  should_rollback_if_failed = false;
+
+  for (size_t i = 0; i < count; i++) {
+    if (stored[i] && (ret = approvers_index_add(sqlite3_connection->approvers_index, txs[i]->consensus.hash,
+                                                txs[i]->attachment.trunk, txs[i]->attachment.branch,
+                                                arrival_timestamp)) != RC_OK) {
+      goto done;
+    }
+  }
+
+done:
+  hash243_set_free(&existing);
+  if (ret != RC_OK && should_rollback_if_failed) {
+    memset(stored, false, count * sizeof(bool));
+    if ((ret_rollback = rollback_transaction(sqlite3_connection->db)) != RC_OK) {
+      return ret_rollback;
+    }
+  }
   return ret;
 }
 
@@ -411,18 +565,18 @@ retcode_t iota_stor_transaction_load(storage_connection_t const* const connectio
   sqlite3_connection_t const* sqlite3_connection = (sqlite3_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = NULL;
-  size_t num_key_bytes;
+  size_t num_key_trits;
 
   switch (field) {
     case TRANSACTION_FIELD_HASH:
       sqlite_statement = sqlite3_connection->statements.transaction_select_by_hash;
-      num_key_bytes = FLEX_TRIT_SIZE_243;
+      num_key_trits = NUM_TRITS_HASH;
       break;
     default:
       return RC_SQLITE3_FAILED_NOT_IMPLEMENTED;
   }
 
-  if (column_compress_bind(sqlite_statement, 1, key, num_key_bytes) != RC_OK) {
+  if (column_compress_bind(sqlite_statement, 1, key, num_key_trits) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -442,7 +596,7 @@ retcode_t iota_stor_transaction_load_essence_and_metadata(storage_connection_t c
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_select_essence_and_metadata;
 
-  if (column_compress_bind(sqlite_statement, 1, hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+  if (column_compress_bind(sqlite_statement, 1, hash, NUM_TRITS_HASH) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -463,7 +617,7 @@ retcode_t iota_stor_transaction_load_essence_attachment_and_metadata(storage_con
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_select_essence_attachment_and_metadata;
 
-  if (column_compress_bind(sqlite_statement, 1, hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+  if (column_compress_bind(sqlite_statement, 1, hash, NUM_TRITS_HASH) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -484,7 +638,7 @@ retcode_t iota_stor_transaction_load_essence_and_consensus(storage_connection_t
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_select_essence_and_consensus;
 
-  if (column_compress_bind(sqlite_statement, 1, hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+  if (column_compress_bind(sqlite_statement, 1, hash, NUM_TRITS_HASH) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -504,7 +658,7 @@ retcode_t iota_stor_transaction_load_metadata(storage_connection_t const* const
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_select_metadata;
 
-  if (column_compress_bind(sqlite_statement, 1, hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+  if (column_compress_bind(sqlite_statement, 1, hash, NUM_TRITS_HASH) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -523,19 +677,19 @@ retcode_t iota_stor_transaction_load_hashes(storage_connection_t const* const co
                                             iota_stor_pack_t* const pack) {
   sqlite3_connection_t const* sqlite3_connection = (sqlite3_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
-  size_t num_bytes_key;
+  size_t num_key_trits;
   sqlite3_stmt* sqlite_statement = NULL;
 
   switch (field) {
     case TRANSACTION_FIELD_ADDRESS:
       sqlite_statement = sqlite3_connection->statements.transaction_select_hashes_by_address;
-      num_bytes_key = FLEX_TRIT_SIZE_243;
+      num_key_trits = NUM_TRITS_HASH;
       break;
     default:
       return RC_SQLITE3_FAILED_NOT_IMPLEMENTED;
   }
 
-  if (column_compress_bind(sqlite_statement, 1, key, num_bytes_key) != RC_OK) {
+  if (column_compress_bind(sqlite_statement, 1, key, num_key_trits) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -553,69 +707,22 @@ retcode_t iota_stor_transaction_load_hashes_of_approvers(storage_connection_t co
                                                          flex_trit_t const* const approvee_hash,
                                                          iota_stor_pack_t* const pack, int64_t before_timestamp) {
   sqlite3_connection_t const* sqlite3_connection = (sqlite3_connection_t*)connection->actual;
-  retcode_t ret = RC_OK;
-  sqlite3_stmt* sqlite_statement =
-      before_timestamp != 0 ? sqlite3_connection->statements.transaction_select_hashes_of_approvers_before_date
-                            : sqlite3_connection->statements.transaction_select_hashes_of_approvers;
-
-  if (column_compress_bind(sqlite_statement, 1, approvee_hash, FLEX_TRIT_SIZE_243) != RC_OK ||
-      column_compress_bind(sqlite_statement, 2, approvee_hash, FLEX_TRIT_SIZE_243) != RC_OK) {
-    ret = RC_SQLITE3_FAILED_BINDING;
-    goto done;
-  }
-
-  if (before_timestamp != 0 && sqlite3_bind_int64(sqlite_statement, 3, before_timestamp) != SQLITE_OK) {
-    ret = RC_SQLITE3_FAILED_BINDING;
-    goto done;
-  }
 
-  if ((ret = execute_statement_load_hashes(sqlite_statement, pack)) != RC_OK) {
-    goto done;
-  }
-
-done:
-  sqlite3_reset(sqlite_statement);
-  return ret;
+  return approvers_index_load_approvers(sqlite3_connection->approvers_index, approvee_hash, pack, before_timestamp);
 }
 
 retcode_t iota_stor_transaction_load_hashes_of_requests(storage_connection_t const* const connection,
                                                         iota_stor_pack_t* const pack, size_t const limit) {
   sqlite3_connection_t const* sqlite3_connection = (sqlite3_connection_t*)connection->actual;
-  retcode_t ret = RC_OK;
-  sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_select_hashes_of_transactions_to_request;
-
-  if (sqlite3_bind_int(sqlite_statement, 1, limit) != SQLITE_OK) {
-    ret = RC_SQLITE3_FAILED_BINDING;
-    goto done;
-  }
-
-  if ((ret = execute_statement_load_hashes(sqlite_statement, pack)) != RC_OK) {
-    goto done;
-  }
 
-done:
-  sqlite3_reset(sqlite_statement);
-  return ret;
+  return approvers_index_load_missing(sqlite3_connection->approvers_index, pack, limit);
 }
 
 retcode_t iota_stor_transaction_load_hashes_of_tips(storage_connection_t const* const connection,
                                                     iota_stor_pack_t* const pack, size_t const limit) {
   sqlite3_connection_t const* sqlite3_connection = (sqlite3_connection_t*)connection->actual;
-  retcode_t ret = RC_OK;
-  sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_select_hashes_of_tips;
-
-  if (sqlite3_bind_int(sqlite_statement, 1, limit) != SQLITE_OK) {
-    ret = RC_SQLITE3_FAILED_BINDING;
-    goto done;
-  }
 
-  if ((ret = execute_statement_load_hashes(sqlite_statement, pack)) != RC_OK) {
-    goto done;
-  }
-
-done:
-  sqlite3_reset(sqlite_statement);
-  return ret;
+  return approvers_index_load_tips(sqlite3_connection->approvers_index, pack, limit);
 }
 
 retcode_t iota_stor_transaction_load_hashes_of_milestone_candidates(storage_connection_t const* const connection,
@@ -625,7 +732,7 @@ retcode_t iota_stor_transaction_load_hashes_of_milestone_candidates(storage_conn
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_select_hashes_of_milestone_candidates;
 
-  if (column_compress_bind(sqlite_statement, 1, coordinator, FLEX_TRIT_SIZE_243) != RC_OK) {
+  if (column_compress_bind(sqlite_statement, 1, coordinator, NUM_TRITS_HASH) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -646,7 +753,7 @@ retcode_t iota_stor_transaction_update_solid_state(storage_connection_t const* c
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_update_solid_state;
 
   if (sqlite3_bind_int(sqlite_statement, 1, (int)is_solid) != SQLITE_OK ||
-      column_compress_bind(sqlite_statement, 2, hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+      column_compress_bind(sqlite_statement, 2, hash, NUM_TRITS_HASH) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -681,7 +788,7 @@ retcode_t iota_stor_transaction_update_snapshot_index(storage_connection_t const
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_update_snapshot_index;
 
   if (sqlite3_bind_int64(sqlite_statement, 1, snapshot_index) != SQLITE_OK ||
-      column_compress_bind(sqlite_statement, 2, hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+      column_compress_bind(sqlite_statement, 2, hash, NUM_TRITS_HASH) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -700,7 +807,7 @@ retcode_t iota_stor_transaction_exist(storage_connection_t const* const connecti
   sqlite3_connection_t const* sqlite3_connection = (sqlite3_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = NULL;
-  size_t num_bytes_key;
+  size_t num_key_trits;
 
   switch (field) {
     case TRANSACTION_FIELD_NONE:
@@ -708,14 +815,14 @@ retcode_t iota_stor_transaction_exist(storage_connection_t const* const connecti
       break;
     case TRANSACTION_FIELD_HASH:
       sqlite_statement = sqlite3_connection->statements.transaction_exist_by_hash;
-      num_bytes_key = FLEX_TRIT_SIZE_243;
+      num_key_trits = NUM_TRITS_HASH;
       break;
     default:
       return RC_SQLITE3_FAILED_NOT_IMPLEMENTED;
   }
 
   if (field != TRANSACTION_FIELD_NONE && key) {
-    if (column_compress_bind(sqlite_statement, 1, (void*)key, num_bytes_key) != RC_OK) {
+    if (column_compress_bind(sqlite_statement, 1, (void*)key, num_key_trits) != RC_OK) {
       ret = RC_SQLITE3_FAILED_BINDING;
       goto done;
     }
@@ -733,27 +840,8 @@ done:
 retcode_t iota_stor_transaction_approvers_count(storage_connection_t const* const connection,
                                                 flex_trit_t const* const hash, size_t* const count) {
   sqlite3_connection_t const* sqlite3_connection = (sqlite3_connection_t*)connection->actual;
-  int rc = 0;
-  retcode_t ret = RC_OK;
-  sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_approvers_count;
-
-  if (column_compress_bind(sqlite_statement, 1, hash, FLEX_TRIT_SIZE_243) != RC_OK ||
-      column_compress_bind(sqlite_statement, 2, hash, FLEX_TRIT_SIZE_243) != RC_OK) {
-    ret = RC_SQLITE3_FAILED_BINDING;
-    goto done;
-  }
 
-  rc = sqlite3_step(sqlite_statement);
-  if (rc == SQLITE_ROW) {
-    *count = sqlite3_column_int64(sqlite_statement, 0);
-  } else if (rc != SQLITE_OK && rc != SQLITE_DONE) {
-    ret = RC_SQLITE3_FAILED_STEP;
-    goto done;
-  }
-
-done:
-  sqlite3_reset(sqlite_statement);
-  return ret;
+  return approvers_index_approvers_count(sqlite3_connection->approvers_index, hash, count);
 }
 
 retcode_t iota_stor_transaction_find(storage_connection_t const* const connection, hash243_queue_t const bundles,
@@ -782,7 +870,7 @@ retcode_t iota_stor_transaction_find(storage_connection_t const* const connectio
   }
 
   CDL_FOREACH(bundles, iter243) {
-    if (column_compress_bind(sqlite_statement, column++, iter243->hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+    if (column_compress_bind(sqlite_statement, column++, iter243->hash, NUM_TRITS_HASH) != RC_OK) {
       ret = RC_SQLITE3_FAILED_BINDING;
       goto done;
     }
@@ -794,7 +882,7 @@ retcode_t iota_stor_transaction_find(storage_connection_t const* const connectio
   }
 
   CDL_FOREACH(addresses, iter243) {
-    if (column_compress_bind(sqlite_statement, column++, iter243->hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+    if (column_compress_bind(sqlite_statement, column++, iter243->hash, NUM_TRITS_HASH) != RC_OK) {
       ret = RC_SQLITE3_FAILED_BINDING;
       goto done;
     }
@@ -806,7 +894,7 @@ retcode_t iota_stor_transaction_find(storage_connection_t const* const connectio
   }
 
   CDL_FOREACH(tags, iter81) {
-    if (column_compress_bind(sqlite_statement, column++, iter81->hash, FLEX_TRIT_SIZE_81) != RC_OK) {
+    if (column_compress_bind(sqlite_statement, column++, iter81->hash, NUM_TRITS_TAG) != RC_OK) {
       ret = RC_SQLITE3_FAILED_BINDING;
       goto done;
     }
@@ -818,11 +906,11 @@ retcode_t iota_stor_transaction_find(storage_connection_t const* const connectio
   }
 
   CDL_FOREACH(approvees, iter243) {
-    if (column_compress_bind(sqlite_statement, column, iter243->hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+    if (column_compress_bind(sqlite_statement, column, iter243->hash, NUM_TRITS_HASH) != RC_OK) {
       ret = RC_SQLITE3_FAILED_BINDING;
       goto done;
     }
-    if (column_compress_bind(sqlite_statement, column + approvees_count, iter243->hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+    if (column_compress_bind(sqlite_statement, column + approvees_count, iter243->hash, NUM_TRITS_HASH) != RC_OK) {
       ret = RC_SQLITE3_FAILED_BINDING;
       goto done;
     }
@@ -850,7 +938,7 @@ static retcode_t execute_statement_load_milestones(sqlite3_stmt* const sqlite_st
 
 static void select_milestones_populate_from_row(sqlite3_stmt* const statement, iota_milestone_t* const milestone) {
   milestone->index = sqlite3_column_int64(statement, 0);
-  column_decompress_load(statement, 1, milestone->hash, FLEX_TRIT_SIZE_243);
+  column_decompress_load(statement, 1, milestone->hash, NUM_TRITS_HASH);
 }
 
 retcode_t iota_stor_milestone_store(storage_connection_t const* const connection,
@@ -861,7 +949,7 @@ retcode_t iota_stor_milestone_store(storage_connection_t const* const connection
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.milestone_insert;
 
   if (sqlite3_bind_int64(sqlite_statement, 1, milestone->index) != SQLITE_OK ||
-      column_compress_bind(sqlite_statement, 2, (flex_trit_t*)milestone->hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+      column_compress_bind(sqlite_statement, 2, (flex_trit_t*)milestone->hash, NUM_TRITS_HASH) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -881,7 +969,7 @@ retcode_t iota_stor_milestone_load(storage_connection_t const* const connection,
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.milestone_select_by_hash;
 
-  if (column_compress_bind(sqlite_statement, 1, hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+  if (column_compress_bind(sqlite_statement, 1, hash, NUM_TRITS_HASH) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -956,7 +1044,7 @@ retcode_t iota_stor_milestone_exist(storage_connection_t const* const connection
   }
 
   if (hash) {
-    if (column_compress_bind(sqlite_statement, 1, hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+    if (column_compress_bind(sqlite_statement, 1, hash, NUM_TRITS_HASH) != RC_OK) {
       ret = RC_SQLITE3_FAILED_BINDING;
       goto done;
     }
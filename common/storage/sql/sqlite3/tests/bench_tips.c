@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/*
+ * Compares loading tips and transactions to request through the in-memory
+ * index against the former NOT EXISTS anti-join queries.
+ *
+ * Usage: bench_tips [rows...] (defaults to 1000000 and 10000000 rows)
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sqlite3.h>
+
+#include "common/model/transaction.h"
+#include "common/storage/defs.h"
+#include "common/storage/sql/sqlite3/connection.h"
+#include "common/storage/storage.h"
+#include "utils/files.h"
+
+#define BENCH_BATCH_SIZE 10000
+#define BENCH_LIMIT 5000
+#define BENCH_APPROVEE_WINDOW 1000
+#define BENCH_MISSING_PERIOD 100
+#define BENCH_COUNTER_TRITS 40
+
+static char *bench_db_path = "bench_tips.db";
+static char *ciri_db_path = "common/storage/sql/sqlite3/tests/ciri.db";
+
+static char *anti_join_tips =
+    "SELECT " TRANSACTION_COL_HASH " FROM " TRANSACTION_TABLE_NAME
+    " a WHERE NOT(EXISTS(SELECT 1 FROM " TRANSACTION_TABLE_NAME " b WHERE b." TRANSACTION_COL_TRUNK
+    " = a." TRANSACTION_COL_HASH " OR b." TRANSACTION_COL_BRANCH " = a." TRANSACTION_COL_HASH ")) LIMIT ?";
+
+static char *anti_join_requests =
+    "SELECT " TRANSACTION_COL_TRUNK " FROM " TRANSACTION_TABLE_NAME
+    " a WHERE NOT(EXISTS(SELECT 1 FROM " TRANSACTION_TABLE_NAME " b WHERE b." TRANSACTION_COL_HASH
+    " = a." TRANSACTION_COL_TRUNK ")) UNION SELECT " TRANSACTION_COL_BRANCH " FROM " TRANSACTION_TABLE_NAME
+    " a WHERE NOT(EXISTS(SELECT 1 FROM " TRANSACTION_TABLE_NAME " b WHERE b." TRANSACTION_COL_HASH
+    " = a." TRANSACTION_COL_BRANCH ")) LIMIT ?";
+
+static uint64_t now_us() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000ULL;
+}
+
+// Encodes a counter in balanced ternary so that every counter maps to a distinct hash
+static void counter_to_hash(int64_t counter, flex_trit_t *const hash) {
+  int64_t rem = 0;
+
+  memset(hash, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
+  for (size_t i = 0; i < BENCH_COUNTER_TRITS && counter != 0; i++) {
+    rem = counter % 3;
+    counter /= 3;
+    if (rem > 1) {
+      rem -= 3;
+      counter++;
+    } else if (rem < -1) {
+      rem += 3;
+      counter--;
+    }
+    flex_trits_set_at(hash, FLEX_TRIT_SIZE_243, i, (trit_t)rem);
+  }
+}
+
+static int64_t random_approvee(int64_t const id) {
+  if (id == 0) {
+    return 0;
+  }
+  // Regularly references a transaction that will never be stored
+  if (rand() % BENCH_MISSING_PERIOD == 0) {
+    return -id;
+  }
+  return id - 1 - rand() % (id < BENCH_APPROVEE_WINDOW ? id : BENCH_APPROVEE_WINDOW);
+}
+
+static retcode_t populate(storage_connection_t const *const connection, iota_transaction_t *const txs,
+                          iota_transaction_t const **const txs_ptrs, bool *const stored, size_t const from,
+                          size_t const to) {
+  retcode_t ret = RC_OK;
+  size_t count = 0;
+
+  for (size_t offset = from; offset < to; offset += count) {
+    count = to - offset < BENCH_BATCH_SIZE ? to - offset : BENCH_BATCH_SIZE;
+    for (size_t i = 0; i < count; i++) {
+      int64_t id = offset + i + 1;
+      counter_to_hash(id, txs[i].consensus.hash);
+      counter_to_hash(random_approvee(id), txs[i].attachment.trunk);
+      counter_to_hash(random_approvee(id), txs[i].attachment.branch);
+      txs_ptrs[i] = &txs[i];
+    }
+    if ((ret = iota_stor_transactions_store_batch(connection, txs_ptrs, count, stored)) != RC_OK) {
+      return ret;
+    }
+  }
+
+  return ret;
+}
+
+static size_t run_anti_join(storage_connection_t const *const connection, char const *const query) {
+  sqlite3 *db = ((sqlite3_connection_t *)connection->actual)->db;
+  sqlite3_stmt *statement = NULL;
+  size_t rows = 0;
+
+  if (sqlite3_prepare_v2(db, query, -1, &statement, NULL) != SQLITE_OK) {
+    return 0;
+  }
+  sqlite3_bind_int(statement, 1, BENCH_LIMIT);
+  while (sqlite3_step(statement) == SQLITE_ROW) {
+    rows++;
+  }
+  sqlite3_finalize(statement);
+
+  return rows;
+}
+
+static void bench(storage_connection_t const *const connection, size_t const rows, iota_stor_pack_t *const pack) {
+  uint64_t start = 0;
+  uint64_t anti_join_tips_us = 0, anti_join_requests_us = 0, index_tips_us = 0, index_requests_us = 0;
+  size_t anti_join_tips_count = 0, anti_join_requests_count = 0, index_tips_count = 0, index_requests_count = 0;
+
+  start = now_us();
+  anti_join_tips_count = run_anti_join(connection, anti_join_tips);
+  anti_join_tips_us = now_us() - start;
+
+  start = now_us();
+  anti_join_requests_count = run_anti_join(connection, anti_join_requests);
+  anti_join_requests_us = now_us() - start;
+
+  hash_pack_reset(pack);
+  start = now_us();
+  iota_stor_transaction_load_hashes_of_tips(connection, pack, BENCH_LIMIT);
+  index_tips_us = now_us() - start;
+  index_tips_count = pack->num_loaded;
+
+  hash_pack_reset(pack);
+  start = now_us();
+  iota_stor_transaction_load_hashes_of_requests(connection, pack, BENCH_LIMIT);
+  index_requests_us = now_us() - start;
+  index_requests_count = pack->num_loaded;
+
+  printf("%zu rows\n", rows);
+  printf("  tips:     anti-join %10" PRIu64 " us (%zu hashes), index %10" PRIu64 " us (%zu hashes)\n",
+         anti_join_tips_us, anti_join_tips_count, index_tips_us, index_tips_count);
+  printf("  requests: anti-join %10" PRIu64 " us (%zu hashes), index %10" PRIu64 " us (%zu hashes)\n",
+         anti_join_requests_us, anti_join_requests_count, index_requests_us, index_requests_count);
+}
+
+int main(int argc, char *argv[]) {
+  storage_connection_t connection;
+  connection_config_t config = {.db_path = bench_db_path};
+  size_t default_rows[] = {1000000, 10000000};
+  size_t *rows = default_rows;
+  size_t rows_count = sizeof(default_rows) / sizeof(default_rows[0]);
+  size_t populated = 0;
+  iota_transaction_t *txs = (iota_transaction_t *)calloc(BENCH_BATCH_SIZE, sizeof(iota_transaction_t));
+  iota_transaction_t const **txs_ptrs = (iota_transaction_t const **)calloc(BENCH_BATCH_SIZE, sizeof(void *));
+  bool *stored = (bool *)calloc(BENCH_BATCH_SIZE, sizeof(bool));
+  iota_stor_pack_t pack;
+  uint64_t start = 0;
+
+  if (argc >= 2) {
+    rows_count = argc - 1;
+    rows = (size_t *)calloc(rows_count, sizeof(size_t));
+    for (int i = 1; i < argc; i++) {
+      rows[i - 1] = strtoull(argv[i], NULL, 10);
+    }
+  }
+
+  if (storage_init() != RC_OK || copy_file(bench_db_path, ciri_db_path) != RC_OK ||
+      connection_init(&connection, &config) != RC_OK || hash_pack_init(&pack, BENCH_LIMIT) != RC_OK) {
+    fprintf(stderr, "Initializing benchmark failed\n");
+    return EXIT_FAILURE;
+  }
+
+  srand(42);
+  for (size_t i = 0; i < rows_count; i++) {
+    if (rows[i] > populated) {
+      if (populate(&connection, txs, txs_ptrs, stored, populated, rows[i]) != RC_OK) {
+        fprintf(stderr, "Populating database failed\n");
+        return EXIT_FAILURE;
+      }
+      populated = rows[i];
+    }
+
+    // Measures the cost of rebuilding the index when the database is first opened
+    connection_destroy(&connection);
+    start = now_us();
+    connection_init(&connection, &config);
+    printf("%zu rows: index loaded in %" PRIu64 " ms\n", populated, (now_us() - start) / 1000);
+
+    bench(&connection, populated, &pack);
+  }
+
+  hash_pack_free(&pack);
+  connection_destroy(&connection);
+  storage_destroy();
+  remove_file(bench_db_path);
+  free(txs);
+  free(txs_ptrs);
+  free(stored);
+  if (rows != default_rows) {
+    free(rows);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -215,8 +215,12 @@ void test_stored_load_hashes_by_address(void) {
 }
 
 void test_stored_load_hashes_of_approvers(void) {
-  flex_trit_t hashes[5][FLEX_TRIT_SIZE_243];
+  flex_trit_t *hashes[5];
   iota_stor_pack_t pack = {.models = (void **)hashes, .capacity = 5, .num_loaded = 0, .insufficient_capacity = false};
+  size_t count = 0;
+  for (size_t i = 0; i < 5; ++i) {
+    hashes[i] = (flex_trit_t *)malloc(FLEX_TRIT_SIZE_243);
+  }
 
   flex_trit_t tx_test_trits[FLEX_TRIT_SIZE_8019];
   flex_trits_from_trytes(tx_test_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES,
@@ -227,6 +231,60 @@ void test_stored_load_hashes_of_approvers(void) {
               RC_OK);
   TEST_ASSERT_EQUAL_INT(0, pack.num_loaded);
 
+  TEST_ASSERT(iota_stor_transaction_load_hashes_of_approvers(&connection, transaction_trunk(test_tx), &pack, 0) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_hash(test_tx), ((flex_trit_t *)pack.models[0]), FLEX_TRIT_SIZE_243);
+
+  // Approvers arrived after the given timestamp are filtered out
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_load_hashes_of_approvers(&connection, transaction_trunk(test_tx), &pack, 1) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(0, pack.num_loaded);
+
+  TEST_ASSERT(iota_stor_transaction_approvers_count(&connection, transaction_trunk(test_tx), &count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, count);
+  TEST_ASSERT(iota_stor_transaction_approvers_count(&connection, transaction_hash(test_tx), &count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(0, count);
+
+  for (size_t i = 0; i < 5; ++i) {
+    free(hashes[i]);
+  }
+  transaction_free(test_tx);
+}
+
+void test_stored_load_hashes_of_tips_and_requests(void) {
+  flex_trit_t *hashes[5];
+  iota_stor_pack_t pack = {.models = (void **)hashes, .capacity = 5, .num_loaded = 0, .insufficient_capacity = false};
+  size_t expected_requests = 0;
+  for (size_t i = 0; i < 5; ++i) {
+    hashes[i] = (flex_trit_t *)malloc(FLEX_TRIT_SIZE_243);
+  }
+
+  flex_trit_t tx_test_trits[FLEX_TRIT_SIZE_8019];
+  flex_trits_from_trytes(tx_test_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES,
+                         NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  iota_transaction_t *test_tx = transaction_deserialize(tx_test_trits, true);
+
+  TEST_ASSERT(iota_stor_transaction_load_hashes_of_tips(&connection, &pack, 5) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_hash(test_tx), ((flex_trit_t *)pack.models[0]), FLEX_TRIT_SIZE_243);
+
+  // Trunk and branch of the only stored transaction are missing
+  hash_pack_reset(&pack);
+  expected_requests = memcmp(transaction_trunk(test_tx), transaction_branch(test_tx), FLEX_TRIT_SIZE_243) ? 2 : 1;
+  TEST_ASSERT(iota_stor_transaction_load_hashes_of_requests(&connection, &pack, 5) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(expected_requests, pack.num_loaded);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_trunk(test_tx), ((flex_trit_t *)pack.models[0]), FLEX_TRIT_SIZE_243);
+
+  // Limit is honored
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_load_hashes_of_tips(&connection, &pack, 0) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(0, pack.num_loaded);
+
+  for (size_t i = 0; i < 5; ++i) {
+    free(hashes[i]);
+  }
   transaction_free(test_tx);
 }
 
@@ -389,6 +447,45 @@ void test_transactions_arrival_time(void) {
   transaction_free(test_tx);
 }
 
+void test_transactions_store_batch(void) {
+  flex_trit_t tx_test_trits[FLEX_TRIT_SIZE_8019];
+  flex_trits_from_trytes(tx_test_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES,
+                         NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  iota_transaction_t *test_tx = transaction_deserialize(tx_test_trits, true);
+  iota_transaction_t third_test_transaction = *test_tx;
+  iota_transaction_t const *txs[3] = {test_tx, &third_test_transaction, &third_test_transaction};
+  bool stored[3] = {true, false, true};
+  bool exist = false;
+  size_t count_before = 0, count_after = 0;
+
+  // Make it distinguishable from the transactions stored by previous tests
+  trit_t modified_trit = flex_trits_at(transaction_hash(test_tx), FLEX_TRIT_SIZE_243, 3);
+  if (abs(modified_trit) > 0) {
+    modified_trit = 0;
+  } else {
+    modified_trit = 1;
+  }
+  flex_trits_set_at(third_test_transaction.consensus.hash, FLEX_TRIT_SIZE_243, 3, modified_trit);
+
+  TEST_ASSERT(iota_stor_transaction_count(&connection, &count_before) == RC_OK);
+  TEST_ASSERT(iota_stor_transactions_store_batch(&connection, txs, 3, stored) == RC_OK);
+  TEST_ASSERT_FALSE(stored[0]);
+  TEST_ASSERT_TRUE(stored[1]);
+  TEST_ASSERT_FALSE(stored[2]);
+  TEST_ASSERT(iota_stor_transaction_count(&connection, &count_after) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(count_before + 1, count_after);
+  TEST_ASSERT(iota_stor_transaction_exist(&connection, TRANSACTION_FIELD_HASH,
+                                          transaction_hash(&third_test_transaction), &exist) == RC_OK);
+  TEST_ASSERT(exist == true);
+
+  TEST_ASSERT(iota_stor_transactions_store_batch(&connection, txs, 3, stored) == RC_OK);
+  TEST_ASSERT_FALSE(stored[0]);
+  TEST_ASSERT_FALSE(stored[1]);
+  TEST_ASSERT_FALSE(stored[2]);
+
+  transaction_free(test_tx);
+}
+
 int main(int argc, char *argv[]) {
   UNITY_BEGIN();
   TEST_ASSERT(storage_init() == RC_OK);
@@ -410,12 +507,14 @@ int main(int argc, char *argv[]) {
   RUN_TEST(test_stored_milestone);
   RUN_TEST(test_stored_load_hashes_by_address);
   RUN_TEST(test_stored_load_hashes_of_approvers);
+  RUN_TEST(test_stored_load_hashes_of_tips_and_requests);
   RUN_TEST(test_milestone_state_delta);
   RUN_TEST(test_transaction_update_snapshot_index);
   RUN_TEST(test_transaction_update_solid_state);
   RUN_TEST(test_transactions_update_solid_states_one_transaction);
   RUN_TEST(test_transactions_update_solid_states_two_transaction);
   RUN_TEST(test_transactions_arrival_time);
+  RUN_TEST(test_transactions_store_batch);
   RUN_TEST(test_destroy_connection);
 
   TEST_ASSERT(storage_destroy() == RC_OK);
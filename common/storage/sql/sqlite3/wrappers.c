@@ -34,6 +34,13 @@ retcode_t begin_transaction(sqlite3* const db) {
   return RC_OK;
 }
 
+retcode_t begin_immediate_transaction(sqlite3* const db) {
+  if ((sqlite3_exec(db, "BEGIN IMMEDIATE TRANSACTION;", NULL, NULL, NULL)) != SQLITE_OK) {
+    return RC_SQLITE3_FAILED_BEGIN;
+  }
+  return RC_OK;
+}
+
 retcode_t end_transaction(sqlite3* const db) {
   if (sqlite3_exec(db, "END TRANSACTION;", NULL, NULL, NULL) != SQLITE_OK) {
     return RC_SQLITE3_FAILED_END;
@@ -49,28 +56,26 @@ retcode_t rollback_transaction(sqlite3* const db) {
 }
 
 retcode_t column_compress_bind(sqlite3_stmt* const statement, size_t const index, flex_trit_t const* const flex_trits,
-                               size_t const num_bytes) {
-  ssize_t i = num_bytes - 1;
+                               size_t const num_trits) {
+  byte_t key[STORAGE_KEY_SIZE_6561];
+  ssize_t i = storage_key_encode(key, flex_trits, num_trits) - 1;
   int rc = 0;
 
-  for (; i >= 0 && flex_trits[i] == FLEX_TRIT_NULL_VALUE; --i)
+  for (; i >= 0 && key[i] == 0; --i)
     ;
-  if ((rc = sqlite3_bind_blob(statement, index, flex_trits, i + 1, NULL)) != SQLITE_OK) {
+  if ((rc = sqlite3_bind_blob(statement, index, key, i + 1, SQLITE_TRANSIENT)) != SQLITE_OK) {
     return RC_SQLITE3_FAILED_BINDING;
   }
   return RC_OK;
 }
 
 void column_decompress_load(sqlite3_stmt* const statement, size_t const index, flex_trit_t* const flex_trits,
-                            size_t const num_bytes) {
-  char const* buffer = NULL;
+                            size_t const num_trits) {
+  byte_t const* buffer = NULL;
   size_t column_size = 0;
 
   if ((buffer = sqlite3_column_blob(statement, index))) {
     column_size = sqlite3_column_bytes(statement, index);
-    memcpy(flex_trits, buffer, column_size);
-    memset(flex_trits + column_size, FLEX_TRIT_NULL_VALUE, num_bytes - column_size);
-  } else {
-    memset(flex_trits, FLEX_TRIT_NULL_VALUE, num_bytes);
   }
+  storage_key_decode(flex_trits, buffer, column_size, num_trits);
 }
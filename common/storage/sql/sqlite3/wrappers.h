@@ -11,6 +11,7 @@
 #include <sqlite3.h>
 
 #include "common/errors.h"
+#include "common/storage/key_codec.h"
 #include "common/trinary/flex_trit.h"
 
 #ifdef __cplusplus
@@ -21,13 +22,17 @@ retcode_t prepare_statement(sqlite3* const db, sqlite3_stmt** const sqlite_state
 retcode_t finalize_statement(sqlite3_stmt* const sqlite_statement);
 
 retcode_t begin_transaction(sqlite3* const db);
+// Takes the write lock upfront, waiting for it with the busy handler: a deferred transaction reading before writing
+// fails at once with SQLITE_BUSY when another connection wrote in the meantime
+retcode_t begin_immediate_transaction(sqlite3* const db);
 retcode_t end_transaction(sqlite3* const db);
 retcode_t rollback_transaction(sqlite3* const db);
 
+// Trits are bound and loaded in their compact storage representation, see key_codec.h
 retcode_t column_compress_bind(sqlite3_stmt* const statement, size_t const index, flex_trit_t const* const flex_trits,
-                               size_t const num_bytes);
+                               size_t const num_trits);
 void column_decompress_load(sqlite3_stmt* const statement, size_t const index, flex_trit_t* const flex_trits,
-                            size_t const num_bytes);
+                            size_t const num_trits);
 
 #ifdef __cplusplus
 }
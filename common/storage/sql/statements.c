@@ -35,13 +35,15 @@ char *iota_statement_in_clause_build(size_t const count) {
  */
 
 char *iota_statement_transaction_insert =
-    "INSERT INTO " TRANSACTION_TABLE_NAME "(" TRANSACTION_COL_SIG_OR_MSG "," TRANSACTION_COL_ADDRESS
-    "," TRANSACTION_COL_VALUE "," TRANSACTION_COL_OBSOLETE_TAG "," TRANSACTION_COL_TIMESTAMP
-    "," TRANSACTION_COL_CURRENT_INDEX "," TRANSACTION_COL_LAST_INDEX "," TRANSACTION_COL_BUNDLE
-    "," TRANSACTION_COL_TRUNK "," TRANSACTION_COL_BRANCH "," TRANSACTION_COL_TAG
-    "," TRANSACTION_COL_ATTACHMENT_TIMESTAMP "," TRANSACTION_COL_ATTACHMENT_TIMESTAMP_UPPER
+    "INSERT INTO " TRANSACTION_TABLE_NAME "(" TRANSACTION_COL_ADDRESS "," TRANSACTION_COL_VALUE
+    "," TRANSACTION_COL_OBSOLETE_TAG "," TRANSACTION_COL_TIMESTAMP "," TRANSACTION_COL_CURRENT_INDEX
+    "," TRANSACTION_COL_LAST_INDEX "," TRANSACTION_COL_BUNDLE "," TRANSACTION_COL_TRUNK "," TRANSACTION_COL_BRANCH
+    "," TRANSACTION_COL_TAG "," TRANSACTION_COL_ATTACHMENT_TIMESTAMP "," TRANSACTION_COL_ATTACHMENT_TIMESTAMP_UPPER
     "," TRANSACTION_COL_ATTACHMENT_TIMESTAMP_LOWER "," TRANSACTION_COL_NONCE "," TRANSACTION_COL_HASH
-    "," TRANSACTION_COL_ARRIVAL_TIME ")VALUES(?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)";
+    "," TRANSACTION_COL_ARRIVAL_TIME ")VALUES(?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)";
+
+char *iota_statement_transaction_payload_insert =
+    "INSERT INTO " TRANSACTION_PAYLOAD_TABLE_NAME "(" TRANSACTION_COL_HASH "," TRANSACTION_COL_SIG_OR_MSG ")VALUES(?,?)";
 
 char *iota_statement_transaction_select_by_hash =
     "SELECT " TRANSACTION_COL_SIG_OR_MSG "," TRANSACTION_COL_ADDRESS "," TRANSACTION_COL_VALUE
@@ -49,34 +51,15 @@ char *iota_statement_transaction_select_by_hash =
     "," TRANSACTION_COL_LAST_INDEX "," TRANSACTION_COL_BUNDLE "," TRANSACTION_COL_TRUNK "," TRANSACTION_COL_BRANCH
     "," TRANSACTION_COL_TAG "," TRANSACTION_COL_ATTACHMENT_TIMESTAMP "," TRANSACTION_COL_ATTACHMENT_TIMESTAMP_UPPER
     "," TRANSACTION_COL_ATTACHMENT_TIMESTAMP_LOWER "," TRANSACTION_COL_NONCE "," TRANSACTION_COL_HASH
-    " FROM " TRANSACTION_TABLE_NAME " WHERE " TRANSACTION_COL_HASH "=?";
+    " FROM " TRANSACTION_TABLE_NAME " JOIN " TRANSACTION_PAYLOAD_TABLE_NAME " USING(" TRANSACTION_COL_HASH
+    ") WHERE " TRANSACTION_COL_HASH "=?";
 
 char *iota_statement_transaction_select_hashes_by_address =
     "SELECT " TRANSACTION_COL_HASH " FROM " TRANSACTION_TABLE_NAME " WHERE " TRANSACTION_COL_ADDRESS "=?";
 
-char *iota_statement_transaction_select_hashes_of_approvers =
-    "SELECT " TRANSACTION_COL_HASH " FROM " TRANSACTION_TABLE_NAME " WHERE " TRANSACTION_COL_BRANCH
-    "=? OR " TRANSACTION_COL_TRUNK "=?";
-
-char *iota_statement_transaction_select_hashes_of_approvers_before_date =
-    "SELECT " TRANSACTION_COL_HASH " FROM " TRANSACTION_TABLE_NAME " WHERE (" TRANSACTION_COL_BRANCH
-    "=? OR " TRANSACTION_COL_TRUNK "=?) AND " TRANSACTION_COL_ARRIVAL_TIME "<?";
-
-char *iota_statement_transaction_select_hashes_of_transactions_to_request =
-    "SELECT " TRANSACTION_COL_TRUNK " FROM " TRANSACTION_TABLE_NAME
-    " a WHERE NOT(EXISTS(SELECT 1 FROM " TRANSACTION_TABLE_NAME " b WHERE b." TRANSACTION_COL_HASH
-    " = a." TRANSACTION_COL_TRUNK ")) UNION SELECT " TRANSACTION_COL_BRANCH " FROM " TRANSACTION_TABLE_NAME
-    " a WHERE NOT(EXISTS(SELECT 1 FROM " TRANSACTION_TABLE_NAME " b WHERE b." TRANSACTION_COL_HASH
-    " = a." TRANSACTION_COL_BRANCH ")) LIMIT ?";
-
-char *iota_statement_transaction_select_hashes_of_tips =
-    "SELECT " TRANSACTION_COL_HASH " FROM " TRANSACTION_TABLE_NAME
-    " a WHERE NOT(EXISTS(SELECT 1 FROM " TRANSACTION_TABLE_NAME " b WHERE b." TRANSACTION_COL_TRUNK
-    " = a." TRANSACTION_COL_HASH " OR b." TRANSACTION_COL_BRANCH " = a." TRANSACTION_COL_HASH ")) LIMIT ?";
-
 char *iota_statement_transaction_select_hashes_of_milestone_candidates =
     "SELECT " TRANSACTION_COL_HASH " FROM " TRANSACTION_TABLE_NAME " WHERE " TRANSACTION_COL_ADDRESS
-    " LIKE ? EXCEPT SELECT " MILESTONE_COL_HASH " FROM " MILESTONE_TABLE_NAME;
+    "=? EXCEPT SELECT " MILESTONE_COL_HASH " FROM " MILESTONE_TABLE_NAME;
 
 char *iota_statement_transaction_update_snapshot_index =
     "UPDATE " TRANSACTION_TABLE_NAME " SET " TRANSACTION_COL_SNAPSHOT_INDEX "=? WHERE " TRANSACTION_COL_HASH "=?";
@@ -92,9 +75,6 @@ char *iota_statement_transaction_exist_by_hash =
     "SELECT 1 WHERE EXISTS(SELECT 1 "
     "FROM " TRANSACTION_TABLE_NAME " WHERE " TRANSACTION_COL_HASH "=?)";
 
-char *iota_statement_transaction_approvers_count =
-    "SELECT COUNT(*) FROM " TRANSACTION_TABLE_NAME " WHERE branch=? OR trunk=?";
-
 char *iota_statement_transaction_count = "SELECT COUNT(*) FROM " TRANSACTION_TABLE_NAME;
 
 char *iota_statement_transaction_find =
@@ -109,6 +89,13 @@ char *iota_statement_transaction_find =
 // Update accordingly if `iota_statement_transaction_find` is modified
 static size_t iota_statement_transaction_find_size = 328;
 
+char *iota_statement_transaction_select_hashes_in =
+    "SELECT " TRANSACTION_COL_HASH " FROM " TRANSACTION_TABLE_NAME " WHERE " TRANSACTION_COL_HASH " IN(%s)";
+
+char *iota_statement_transaction_select_approvers_index =
+    "SELECT " TRANSACTION_COL_HASH "," TRANSACTION_COL_TRUNK "," TRANSACTION_COL_BRANCH "," TRANSACTION_COL_ARRIVAL_TIME
+    " FROM " TRANSACTION_TABLE_NAME;
+
 /*
  * Partial Transaction statements
  */
@@ -165,6 +152,23 @@ char *iota_statement_transaction_find_build(size_t const bundles_count, size_t c
   return statement;
 }
 
+char *iota_statement_transaction_select_hashes_in_build(size_t const hashes_count) {
+  size_t statement_size = strlen(iota_statement_transaction_select_hashes_in) + 2 * hashes_count;
+  char *statement = (char *)malloc(statement_size);
+  char *hashes_in_clause = iota_statement_in_clause_build(hashes_count);
+
+  if (statement != NULL && hashes_in_clause != NULL) {
+    snprintf(statement, statement_size, iota_statement_transaction_select_hashes_in, hashes_in_clause);
+  } else {
+    free(statement);
+    statement = NULL;
+  }
+
+  free(hashes_in_clause);
+
+  return statement;
+}
+
 /*
  * Milestone statements
  */
@@ -18,18 +18,14 @@ extern "C" {
 
 typedef struct iota_statements_s {
   sqlite3_stmt* transaction_insert;
+  sqlite3_stmt* transaction_payload_insert;
   sqlite3_stmt* transaction_select_by_hash;
   sqlite3_stmt* transaction_select_hashes_by_address;
-  sqlite3_stmt* transaction_select_hashes_of_approvers;
-  sqlite3_stmt* transaction_select_hashes_of_approvers_before_date;
-  sqlite3_stmt* transaction_select_hashes_of_transactions_to_request;
-  sqlite3_stmt* transaction_select_hashes_of_tips;
   sqlite3_stmt* transaction_select_hashes_of_milestone_candidates;
   sqlite3_stmt* transaction_update_snapshot_index;
   sqlite3_stmt* transaction_update_solid_state;
   sqlite3_stmt* transaction_exist;
   sqlite3_stmt* transaction_exist_by_hash;
-  sqlite3_stmt* transaction_approvers_count;
   sqlite3_stmt* transaction_count;
   sqlite3_stmt* transaction_select_essence_and_metadata;
   sqlite3_stmt* transaction_select_essence_attachment_and_metadata;
@@ -57,20 +53,18 @@ extern char* iota_statement_in_clause_build(size_t const count);
  */
 
 extern char* iota_statement_transaction_insert;
+extern char* iota_statement_transaction_payload_insert;
 extern char* iota_statement_transaction_select_by_hash;
 extern char* iota_statement_transaction_select_hashes_by_address;
-extern char* iota_statement_transaction_select_hashes_of_approvers;
-extern char* iota_statement_transaction_select_hashes_of_approvers_before_date;
-extern char* iota_statement_transaction_select_hashes_of_transactions_to_request;
-extern char* iota_statement_transaction_select_hashes_of_tips;
 extern char* iota_statement_transaction_select_hashes_of_milestone_candidates;
 extern char* iota_statement_transaction_update_snapshot_index;
 extern char* iota_statement_transaction_update_solid_state;
 extern char* iota_statement_transaction_exist;
 extern char* iota_statement_transaction_exist_by_hash;
-extern char* iota_statement_transaction_approvers_count;
 extern char* iota_statement_transaction_count;
 extern char* iota_statement_transaction_find;
+extern char* iota_statement_transaction_select_hashes_in;
+extern char* iota_statement_transaction_select_approvers_index;
 
 /*
  * Partial Transaction statements
@@ -87,6 +81,7 @@ extern char* iota_statement_transaction_select_metadata;
 
 extern char* iota_statement_transaction_find_build(size_t const bundles_count, size_t const addresses_count,
                                                    size_t const tags_count, size_t const approvees_count);
+extern char* iota_statement_transaction_select_hashes_in_build(size_t const hashes_count);
 
 /*
  * Milestone statements
@@ -59,6 +59,21 @@ extern retcode_t iota_stor_transaction_count(storage_connection_t const* const c
 extern retcode_t iota_stor_transaction_store(storage_connection_t const* const connection,
                                              iota_transaction_t const* const data_in);
 
+/**
+ * Stores a batch of transactions in a single storage transaction
+ * Transactions already persisted, or appearing twice in the batch, are skipped
+ *
+ * @param connection The storage connection
+ * @param txs The transactions
+ * @param count The number of transactions
+ * @param stored Filled with, for each transaction, whether it was newly stored
+ *
+ * @return a status code
+ */
+extern retcode_t iota_stor_transactions_store_batch(storage_connection_t const* const connection,
+                                                    iota_transaction_t const* const* const txs, size_t const count,
+                                                    bool* const stored);
+
 extern retcode_t iota_stor_transaction_load(storage_connection_t const* const connection,
                                             transaction_field_t const field, flex_trit_t const* const key,
                                             iota_stor_pack_t* const pack);
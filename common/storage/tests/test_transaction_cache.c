@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+
+#include <unity/unity.h>
+
+#include "common/storage/transaction_cache.h"
+
+static transaction_cache_t *cache = NULL;
+static field_mask_t const metadata_mask = {.metadata = MASK_METADATA_ALL};
+static field_mask_t const essence_mask = {.essence = MASK_ESSENCE_ALL};
+
+static void hash_from_index(flex_trit_t *const hash, uint32_t const index) {
+  memset(hash, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
+  memcpy(hash, &index, sizeof(index));
+}
+
+void test_shared_by_path() {
+  transaction_cache_t *other = NULL;
+
+  TEST_ASSERT(transaction_cache_acquire("test_transaction_cache", &other) == RC_OK);
+  TEST_ASSERT_EQUAL_PTR(cache, other);
+  TEST_ASSERT(transaction_cache_release(other) == RC_OK);
+
+  TEST_ASSERT(transaction_cache_acquire("test_transaction_cache_other", &other) == RC_OK);
+  TEST_ASSERT(cache != other);
+  TEST_ASSERT(transaction_cache_release(other) == RC_OK);
+}
+
+void test_load_store() {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  iota_transaction_t tx, loaded;
+  transaction_cache_stats_t stats;
+  uint64_t ticket = 0;
+
+  hash_from_index(hash, 1);
+  memset(&tx, 0, sizeof(iota_transaction_t));
+  memset(&loaded, 0, sizeof(iota_transaction_t));
+  transaction_set_snapshot_index(&tx, 42);
+  transaction_set_current_index(&tx, 3);
+
+  TEST_ASSERT_FALSE(transaction_cache_load(cache, hash, &metadata_mask, &loaded, &ticket));
+  TEST_ASSERT(transaction_cache_store(cache, hash, &tx, &metadata_mask, ticket) == RC_OK);
+  TEST_ASSERT_TRUE(transaction_cache_load(cache, hash, &metadata_mask, &loaded, &ticket));
+  TEST_ASSERT_EQUAL_INT(42, transaction_snapshot_index(&loaded));
+  TEST_ASSERT_EQUAL_INT(MASK_METADATA_ALL, loaded.loaded_columns_mask.metadata);
+  TEST_ASSERT_EQUAL_INT(0, loaded.loaded_columns_mask.essence);
+
+  // Only the stored groups of fields are served, others are merged once loaded
+  TEST_ASSERT_FALSE(transaction_cache_load(cache, hash, &essence_mask, &loaded, &ticket));
+  TEST_ASSERT(transaction_cache_store(cache, hash, &tx, &essence_mask, ticket) == RC_OK);
+  TEST_ASSERT_TRUE(transaction_cache_load(cache, hash, &essence_mask, &loaded, &ticket));
+  TEST_ASSERT_EQUAL_INT(3, transaction_current_index(&loaded));
+  TEST_ASSERT_TRUE(transaction_cache_load(cache, hash, &metadata_mask, &loaded, &ticket));
+
+  transaction_cache_stats(cache, &stats);
+  TEST_ASSERT_EQUAL_INT(3, stats.hits);
+  TEST_ASSERT_EQUAL_INT(2, stats.misses);
+  TEST_ASSERT_EQUAL_INT(1, stats.size);
+}
+
+void test_invalidate() {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  iota_transaction_t tx;
+  uint64_t ticket = 0;
+
+  hash_from_index(hash, 1);
+  memset(&tx, 0, sizeof(iota_transaction_t));
+
+  TEST_ASSERT_TRUE(transaction_cache_load(cache, hash, &metadata_mask, &tx, &ticket));
+  transaction_cache_invalidate(cache, hash);
+  TEST_ASSERT_FALSE(transaction_cache_load(cache, hash, &metadata_mask, &tx, &ticket));
+
+  // A fill racing with an invalidation is discarded
+  transaction_cache_invalidate(cache, hash);
+  TEST_ASSERT(transaction_cache_store(cache, hash, &tx, &metadata_mask, ticket) == RC_OK);
+  TEST_ASSERT_FALSE(transaction_cache_load(cache, hash, &metadata_mask, &tx, &ticket));
+}
+
+void test_eviction() {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  flex_trit_t hot[FLEX_TRIT_SIZE_243];
+  iota_transaction_t tx;
+  transaction_cache_stats_t stats;
+  uint64_t ticket = 0;
+
+  memset(&tx, 0, sizeof(iota_transaction_t));
+  hash_from_index(hot, 0);
+  TEST_ASSERT_FALSE(transaction_cache_load(cache, hot, &metadata_mask, &tx, &ticket));
+  TEST_ASSERT(transaction_cache_store(cache, hot, &tx, &metadata_mask, ticket) == RC_OK);
+
+  for (uint32_t i = 1; i <= 4 * TRANSACTION_CACHE_CAPACITY; i++) {
+    hash_from_index(hash, i);
+    if (!transaction_cache_load(cache, hash, &metadata_mask, &tx, &ticket)) {
+      TEST_ASSERT(transaction_cache_store(cache, hash, &tx, &metadata_mask, ticket) == RC_OK);
+    }
+    // Referenced entries are given a second chance
+    if (i % 16 == 0) {
+      TEST_ASSERT_TRUE(transaction_cache_load(cache, hot, &metadata_mask, &tx, &ticket));
+    }
+  }
+
+  transaction_cache_stats(cache, &stats);
+  TEST_ASSERT_EQUAL_INT(stats.capacity, stats.size);
+  TEST_ASSERT(stats.evictions > 0);
+}
+
+int main() {
+  UNITY_BEGIN();
+
+  TEST_ASSERT(transaction_cache_registry_init() == RC_OK);
+  TEST_ASSERT(transaction_cache_acquire("test_transaction_cache", &cache) == RC_OK);
+
+  RUN_TEST(test_shared_by_path);
+  RUN_TEST(test_load_store);
+  RUN_TEST(test_invalidate);
+  RUN_TEST(test_eviction);
+
+  TEST_ASSERT(transaction_cache_release(cache) == RC_OK);
+  TEST_ASSERT(transaction_cache_registry_destroy() == RC_OK);
+
+  return UNITY_END();
+}
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "uthash.h"
+#include "utlist.h"
+
+#include "common/storage/transaction_cache.h"
+#include "utils/fnv.h"
+#include "utils/handles/lock.h"
+#include "utils/handles/rw_lock.h"
+
+#define TRANSACTION_CACHE_SHARDS 64
+// Number of leading hash bytes mixed to pick a shard
+#define TRANSACTION_CACHE_SHARD_KEY_BYTES 16
+
+typedef struct transaction_cache_entry_s {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  iota_transaction_t tx;
+  // Second chance bit of the CLOCK eviction, set by lookups holding the shard read lock
+  atomic_bool referenced;
+  UT_hash_handle hh;
+  struct transaction_cache_entry_s *prev;
+  struct transaction_cache_entry_s *next;
+} transaction_cache_entry_t;
+
+typedef struct transaction_cache_shard_s {
+  rw_lock_handle_t lock;
+  transaction_cache_entry_t *entries;
+  // Circular list whose head is the hand of the clock
+  transaction_cache_entry_t *clock;
+  size_t size;
+  // Incremented on each invalidation, see transaction_cache_load
+  uint64_t generation;
+  atomic_uint_fast64_t hits;
+  atomic_uint_fast64_t misses;
+  atomic_uint_fast64_t evictions;
+  atomic_uint_fast64_t invalidations;
+} transaction_cache_shard_t;
+
+struct transaction_cache_s {
+  char *db_path;
+  size_t references;
+  size_t shard_capacity;
+  transaction_cache_shard_t shards[TRANSACTION_CACHE_SHARDS];
+  transaction_cache_t *next;
+};
+
+static transaction_cache_t *registry = NULL;
+static lock_handle_t registry_lock;
+
+/*
+ * Private functions
+ */
+
+static transaction_cache_shard_t *transaction_cache_shard(transaction_cache_t *const cache,
+                                                          flex_trit_t const *const hash) {
+  // A single flex trit does not carry enough entropy with every encoding
+  uint64_t key = fnv1a_64(hash, TRANSACTION_CACHE_SHARD_KEY_BYTES);
+
+  return &cache->shards[key % TRANSACTION_CACHE_SHARDS];
+}
+
+static bool field_mask_includes(field_mask_t const *const mask, field_mask_t const *const requested) {
+  return (mask->essence & requested->essence) == requested->essence &&
+         (mask->attachment & requested->attachment) == requested->attachment &&
+         (mask->consensus & requested->consensus) == requested->consensus &&
+         (mask->data & requested->data) == requested->data &&
+         (mask->metadata & requested->metadata) == requested->metadata;
+}
+
+// Copies the groups of fields selected by mask and merges the loaded columns masks
+static void transaction_copy_fields(iota_transaction_t *const dst, iota_transaction_t const *const src,
+                                    field_mask_t const *const mask) {
+  if (mask->essence) {
+    memcpy(&dst->essence, &src->essence, sizeof(iota_transaction_fields_essence_t));
+    dst->loaded_columns_mask.essence |= mask->essence;
+  }
+  if (mask->attachment) {
+    memcpy(&dst->attachment, &src->attachment, sizeof(iota_transaction_fields_attachment_t));
+    dst->loaded_columns_mask.attachment |= mask->attachment;
+  }
+  if (mask->consensus) {
+    memcpy(&dst->consensus, &src->consensus, sizeof(iota_transaction_fields_consensus_t));
+    dst->loaded_columns_mask.consensus |= mask->consensus;
+  }
+  if (mask->data) {
+    memcpy(&dst->data, &src->data, sizeof(iota_transaction_fields_data_t));
+    dst->loaded_columns_mask.data |= mask->data;
+  }
+  if (mask->metadata) {
+    memcpy(&dst->metadata, &src->metadata, sizeof(iota_transaction_fields_metadata_t));
+    dst->loaded_columns_mask.metadata |= mask->metadata;
+  }
+}
+
+static void transaction_cache_shard_remove(transaction_cache_shard_t *const shard,
+                                           transaction_cache_entry_t *const entry) {
+  HASH_DEL(shard->entries, entry);
+  CDL_DELETE(shard->clock, entry);
+  shard->size--;
+  free(entry);
+}
+
+// Removes the first entry not referenced since the hand last passed it
+static void transaction_cache_shard_evict(transaction_cache_shard_t *const shard) {
+  while (atomic_exchange_explicit(&shard->clock->referenced, false, memory_order_relaxed)) {
+    shard->clock = shard->clock->next;
+  }
+  transaction_cache_shard_remove(shard, shard->clock);
+  atomic_fetch_add_explicit(&shard->evictions, 1, memory_order_relaxed);
+}
+
+static void transaction_cache_free(transaction_cache_t *const cache) {
+  transaction_cache_entry_t *entry = NULL;
+  transaction_cache_entry_t *tmp = NULL;
+
+  for (size_t i = 0; i < TRANSACTION_CACHE_SHARDS; i++) {
+    HASH_ITER(hh, cache->shards[i].entries, entry, tmp) {
+      HASH_DEL(cache->shards[i].entries, entry);
+      free(entry);
+    }
+    rw_lock_handle_destroy(&cache->shards[i].lock);
+  }
+  free(cache->db_path);
+  free(cache);
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t transaction_cache_registry_init() {
+  registry = NULL;
+  lock_handle_init(&registry_lock);
+  return RC_OK;
+}
+
+retcode_t transaction_cache_registry_destroy() {
+  transaction_cache_t *cache = NULL;
+  transaction_cache_t *tmp = NULL;
+
+  LL_FOREACH_SAFE(registry, cache, tmp) {
+    LL_DELETE(registry, cache);
+    transaction_cache_free(cache);
+  }
+  lock_handle_destroy(&registry_lock);
+  return RC_OK;
+}
+
+retcode_t transaction_cache_acquire(char const *const db_path, transaction_cache_t **const cache) {
+  retcode_t ret = RC_OK;
+  transaction_cache_t *iter = NULL;
+
+  if (db_path == NULL || cache == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  *cache = NULL;
+  lock_handle_lock(&registry_lock);
+
+  LL_FOREACH(registry, iter) {
+    if (strcmp(iter->db_path, db_path) == 0) {
+      iter->references++;
+      *cache = iter;
+      goto done;
+    }
+  }
+
+  if ((iter = (transaction_cache_t *)calloc(1, sizeof(transaction_cache_t))) == NULL) {
+    ret = RC_STORAGE_OOM;
+    goto done;
+  }
+  if ((iter->db_path = strdup(db_path)) == NULL) {
+    free(iter);
+    ret = RC_STORAGE_OOM;
+    goto done;
+  }
+  iter->references = 1;
+  iter->shard_capacity = (TRANSACTION_CACHE_CAPACITY + TRANSACTION_CACHE_SHARDS - 1) / TRANSACTION_CACHE_SHARDS;
+  for (size_t i = 0; i < TRANSACTION_CACHE_SHARDS; i++) {
+    rw_lock_handle_init(&iter->shards[i].lock);
+    atomic_init(&iter->shards[i].hits, 0);
+    atomic_init(&iter->shards[i].misses, 0);
+    atomic_init(&iter->shards[i].evictions, 0);
+    atomic_init(&iter->shards[i].invalidations, 0);
+  }
+
+  LL_PREPEND(registry, iter);
+  *cache = iter;
+
+done:
+  lock_handle_unlock(&registry_lock);
+  return ret;
+}
+
+retcode_t transaction_cache_release(transaction_cache_t *const cache) {
+  if (cache == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  lock_handle_lock(&registry_lock);
+  if (--cache->references == 0) {
+    LL_DELETE(registry, cache);
+    transaction_cache_free(cache);
+  }
+  lock_handle_unlock(&registry_lock);
+
+  return RC_OK;
+}
+
+bool transaction_cache_load(transaction_cache_t *const cache, flex_trit_t const *const hash,
+                            field_mask_t const *const mask, iota_transaction_t *const tx, uint64_t *const ticket) {
+  transaction_cache_shard_t *shard = transaction_cache_shard(cache, hash);
+  transaction_cache_entry_t *entry = NULL;
+  bool hit = false;
+
+  rw_lock_handle_rdlock(&shard->lock);
+  HASH_FIND(hh, shard->entries, hash, FLEX_TRIT_SIZE_243, entry);
+  if (entry && field_mask_includes(&entry->tx.loaded_columns_mask, mask)) {
+    transaction_copy_fields(tx, &entry->tx, mask);
+    atomic_store_explicit(&entry->referenced, true, memory_order_relaxed);
+    hit = true;
+  } else {
+    *ticket = shard->generation;
+  }
+  rw_lock_handle_unlock(&shard->lock);
+
+  atomic_fetch_add_explicit(hit ? &shard->hits : &shard->misses, 1, memory_order_relaxed);
+
+  return hit;
+}
+
+retcode_t transaction_cache_store(transaction_cache_t *const cache, flex_trit_t const *const hash,
+                                  iota_transaction_t const *const tx, field_mask_t const *const mask,
+                                  uint64_t const ticket) {
+  transaction_cache_shard_t *shard = transaction_cache_shard(cache, hash);
+  transaction_cache_entry_t *entry = NULL;
+  retcode_t ret = RC_OK;
+
+  rw_lock_handle_wrlock(&shard->lock);
+
+  // The transaction was invalidated, possibly after being loaded, since the lookup
+  if (shard->generation != ticket) {
+    goto done;
+  }
+
+  HASH_FIND(hh, shard->entries, hash, FLEX_TRIT_SIZE_243, entry);
+  if (entry == NULL) {
+    if ((entry = (transaction_cache_entry_t *)calloc(1, sizeof(transaction_cache_entry_t))) == NULL) {
+      ret = RC_STORAGE_OOM;
+      goto done;
+    }
+    if (shard->size >= cache->shard_capacity) {
+      transaction_cache_shard_evict(shard);
+    }
+    memcpy(entry->hash, hash, FLEX_TRIT_SIZE_243);
+    atomic_init(&entry->referenced, false);
+    HASH_ADD(hh, shard->entries, hash, FLEX_TRIT_SIZE_243, entry);
+    // Appended right behind the hand so that it is the last entry to be considered
+    CDL_APPEND(shard->clock, entry);
+    shard->size++;
+  }
+  transaction_copy_fields(&entry->tx, tx, mask);
+
+done:
+  rw_lock_handle_unlock(&shard->lock);
+  return ret;
+}
+
+void transaction_cache_invalidate(transaction_cache_t *const cache, flex_trit_t const *const hash) {
+  transaction_cache_shard_t *shard = transaction_cache_shard(cache, hash);
+  transaction_cache_entry_t *entry = NULL;
+
+  rw_lock_handle_wrlock(&shard->lock);
+  shard->generation++;
+  HASH_FIND(hh, shard->entries, hash, FLEX_TRIT_SIZE_243, entry);
+  if (entry) {
+    transaction_cache_shard_remove(shard, entry);
+    atomic_fetch_add_explicit(&shard->invalidations, 1, memory_order_relaxed);
+  }
+  rw_lock_handle_unlock(&shard->lock);
+}
+
+void transaction_cache_stats(transaction_cache_t *const cache, transaction_cache_stats_t *const stats) {
+  transaction_cache_shard_t *shard = NULL;
+
+  memset(stats, 0, sizeof(transaction_cache_stats_t));
+  for (size_t i = 0; i < TRANSACTION_CACHE_SHARDS; i++) {
+    shard = &cache->shards[i];
+    stats->hits += atomic_load_explicit(&shard->hits, memory_order_relaxed);
+    stats->misses += atomic_load_explicit(&shard->misses, memory_order_relaxed);
+    stats->evictions += atomic_load_explicit(&shard->evictions, memory_order_relaxed);
+    stats->invalidations += atomic_load_explicit(&shard->invalidations, memory_order_relaxed);
+    rw_lock_handle_rdlock(&shard->lock);
+    stats->size += shard->size;
+    rw_lock_handle_unlock(&shard->lock);
+  }
+  stats->capacity = cache->shard_capacity * TRANSACTION_CACHE_SHARDS;
+}
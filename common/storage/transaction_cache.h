@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __COMMON_STORAGE_TRANSACTION_CACHE_H__
+#define __COMMON_STORAGE_TRANSACTION_CACHE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/errors.h"
+#include "common/model/transaction.h"
+#include "common/trinary/flex_trit.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Maximum number of transactions held by the cache of a database
+#ifndef TRANSACTION_CACHE_CAPACITY
+#define TRANSACTION_CACHE_CAPACITY 16384
+#endif
+
+/**
+ * A process-wide cache of deserialized transactions keyed by hash
+ *
+ * Entries are partial transaction models, the loaded_columns_mask telling which
+ * groups of fields they hold; a lookup hits when every requested group is
+ * present and further loads of other groups are merged in the same entry.
+ * Entries are spread over independently locked shards so that concurrent
+ * lookups never contend on a single lock, and each shard evicts with the CLOCK
+ * approximation of LRU which, unlike a strict LRU list, does not need to modify
+ * the shard on a hit.
+ * One cache is shared by all tangles opened on the same database; metadata
+ * updates must invalidate the corresponding entries.
+ */
+typedef struct transaction_cache_s transaction_cache_t;
+
+typedef struct transaction_cache_stats_s {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+  uint64_t invalidations;
+  size_t size;
+  size_t capacity;
+} transaction_cache_stats_t;
+
+/**
+ * Initializes the registry of transaction caches
+ * Should only be called once per process
+ *
+ * @return a status code
+ */
+retcode_t transaction_cache_registry_init();
+
+/**
+ * Destroys the registry of transaction caches
+ * Should only be called once per process
+ *
+ * @return a status code
+ */
+retcode_t transaction_cache_registry_destroy();
+
+/**
+ * Gets a reference to the cache of a database, creating it if needed
+ *
+ * @param db_path The path of the database
+ * @param cache The cache
+ *
+ * @return a status code
+ */
+retcode_t transaction_cache_acquire(char const *const db_path, transaction_cache_t **const cache);
+
+/**
+ * Releases a reference to a cache, destroying it when no tangle uses it anymore
+ *
+ * @param cache The cache
+ *
+ * @return a status code
+ */
+retcode_t transaction_cache_release(transaction_cache_t *const cache);
+
+/**
+ * Looks up a transaction, copying the requested groups of fields on a hit
+ * On a miss, a ticket is given that must be passed to the following store so
+ * that an invalidation happening while the transaction is loaded from the
+ * database can not be overwritten by stale data
+ *
+ * @param cache The cache
+ * @param hash The hash of the transaction
+ * @param mask The groups of fields requested
+ * @param tx The transaction to fill, its loaded_columns_mask is or-ed with mask on a hit
+ * @param ticket The ticket, set on a miss
+ *
+ * @return true on a hit, false otherwise
+ */
+bool transaction_cache_load(transaction_cache_t *const cache, flex_trit_t const *const hash,
+                            field_mask_t const *const mask, iota_transaction_t *const tx, uint64_t *const ticket);
+
+/**
+ * Stores groups of fields of a transaction, merging them with an existing
+ * entry and evicting another one if the shard is full
+ *
+ * @param cache The cache
+ * @param hash The hash of the transaction
+ * @param tx The transaction
+ * @param mask The groups of fields loaded in the transaction
+ * @param ticket The ticket given by the missed lookup
+ *
+ * @return a status code
+ */
+retcode_t transaction_cache_store(transaction_cache_t *const cache, flex_trit_t const *const hash,
+                                  iota_transaction_t const *const tx, field_mask_t const *const mask,
+                                  uint64_t const ticket);
+
+/**
+ * Removes a transaction from the cache
+ *
+ * @param cache The cache
+ * @param hash The hash of the transaction
+ */
+void transaction_cache_invalidate(transaction_cache_t *const cache, flex_trit_t const *const hash);
+
+/**
+ * Gets the counters of a cache
+ *
+ * @param cache The cache
+ * @param stats The counters
+ */
+void transaction_cache_stats(transaction_cache_t *const cache, transaction_cache_stats_t *const stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_STORAGE_TRANSACTION_CACHE_H__
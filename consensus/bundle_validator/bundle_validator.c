@@ -5,16 +5,35 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "uthash.h"
+
 #include "consensus/bundle_validator/bundle_validator.h"
 #include "common/crypto/iss/normalize.h"
 #include "common/crypto/iss/v1/iss_kerl.h"
 #include "common/trinary/trit_long.h"
 #include "consensus/conf.h"
+#include "utils/handles/lock.h"
 #include "utils/logger_helper.h"
 
 #define BUNDLE_VALIDATOR_LOGGER_ID "bundle_validator"
 
+typedef struct bundle_cache_entry_s {
+  flex_trit_t tail_hash[FLEX_TRIT_SIZE_243];
+  bundle_status_t status;
+  // Sum of the values moved by the bundle, per address
+  state_delta_t delta;
+  UT_hash_handle hh;
+} bundle_cache_entry_t;
+
 static logger_id_t logger_id;
+// Validated bundles, least recently used first
+static bundle_cache_entry_t* cache = NULL;
+static lock_handle_t cache_lock;
+static bool cache_enabled = false;
+static iss_verifier_t* verifier = NULL;
 
 /*
  * Private functions
@@ -52,23 +71,126 @@ static retcode_t load_bundle_transactions(tangle_t const* const tangle, flex_tri
   return res;
 }
 
+// The status of a bundle only depends on its transactions, all reached from the tail hash, once they are all stored
+static bool bundle_status_is_final(bundle_status_t const status) {
+  return status != BUNDLE_NOT_INITIALIZED && status != BUNDLE_TAIL_NOT_FOUND && status != BUNDLE_INCOMPLETE;
+}
+
+static void cache_entry_free(bundle_cache_entry_t* const entry) {
+  state_delta_destroy(&entry->delta);
+  free(entry);
+}
+
+// Called with the cache lock held, the entry found becomes the most recently used
+static bundle_cache_entry_t* cache_find(flex_trit_t const* const tail_hash) {
+  bundle_cache_entry_t* entry = NULL;
+
+  HASH_FIND(hh, cache, tail_hash, FLEX_TRIT_SIZE_243, entry);
+  if (entry != NULL) {
+    HASH_DELETE(hh, cache, entry);
+    HASH_ADD(hh, cache, tail_hash, FLEX_TRIT_SIZE_243, entry);
+  }
+
+  return entry;
+}
+
+static retcode_t cache_add(flex_trit_t const* const tail_hash, bundle_transactions_t const* const bundle,
+                           bundle_status_t const status) {
+  retcode_t ret = RC_OK;
+  bundle_cache_entry_t* entry = NULL;
+  iota_transaction_t* tx = NULL;
+
+  if ((entry = (bundle_cache_entry_t*)calloc(1, sizeof(bundle_cache_entry_t))) == NULL) {
+    return RC_OOM;
+  }
+  memcpy(entry->tail_hash, tail_hash, FLEX_TRIT_SIZE_243);
+  entry->status = status;
+  if (status == BUNDLE_VALID) {
+    BUNDLE_FOREACH(bundle, tx) {
+      if (transaction_value(tx) != 0 &&
+          (ret = state_delta_add_or_sum(&entry->delta, transaction_address(tx), transaction_value(tx))) != RC_OK) {
+        cache_entry_free(entry);
+        return ret;
+      }
+    }
+  }
+
+  lock_handle_lock(&cache_lock);
+  if (cache_find(tail_hash) != NULL) {
+    // Validated concurrently
+    cache_entry_free(entry);
+  } else {
+    if (HASH_COUNT(cache) >= BUNDLE_VALIDATOR_CACHE_SIZE) {
+      bundle_cache_entry_t* oldest = cache;
+      HASH_DELETE(hh, cache, oldest);
+      cache_entry_free(oldest);
+    }
+    HASH_ADD(hh, cache, tail_hash, FLEX_TRIT_SIZE_243, entry);
+  }
+  lock_handle_unlock(&cache_lock);
+
+  return RC_OK;
+}
+
 /*
  * Public functions
  */
 
-retcode_t iota_consensus_bundle_validator_init() {
+retcode_t iota_consensus_bundle_validator_init(iss_verifier_t* const iss_verifier) {
   logger_id = logger_helper_enable(BUNDLE_VALIDATOR_LOGGER_ID, LOGGER_DEBUG, true);
+  verifier = iss_verifier;
+  lock_handle_init(&cache_lock);
+  cache_enabled = true;
   return RC_OK;
 }
 
 retcode_t iota_consensus_bundle_validator_destroy() {
+  iota_consensus_bundle_validator_clear_cache();
+  cache_enabled = false;
+  verifier = NULL;
+  lock_handle_destroy(&cache_lock);
   logger_helper_release(logger_id);
   return RC_OK;
 }
 
+void iota_consensus_bundle_validator_clear_cache() {
+  bundle_cache_entry_t* entry = NULL, *tmp = NULL;
+
+  if (!cache_enabled) {
+    return;
+  }
+
+  lock_handle_lock(&cache_lock);
+  HASH_ITER(hh, cache, entry, tmp) {
+    HASH_DELETE(hh, cache, entry);
+    cache_entry_free(entry);
+  }
+  lock_handle_unlock(&cache_lock);
+}
+
+void iota_consensus_bundle_validator_evict(hash243_set_t const hashes) {
+  hash243_set_entry_t* iter = NULL, *tmp = NULL;
+  bundle_cache_entry_t* entry = NULL;
+
+  if (!cache_enabled) {
+    return;
+  }
+
+  lock_handle_lock(&cache_lock);
+  HASH_ITER(hh, hashes, iter, tmp) {
+    HASH_FIND(hh, cache, iter->hash, FLEX_TRIT_SIZE_243, entry);
+    if (entry != NULL) {
+      HASH_DELETE(hh, cache, entry);
+      cache_entry_free(entry);
+    }
+  }
+  lock_handle_unlock(&cache_lock);
+}
+
 retcode_t iota_consensus_bundle_validator_validate(tangle_t const* const tangle, flex_trit_t* const tail_hash,
                                                    bundle_transactions_t* const bundle, bundle_status_t* const status) {
   retcode_t res = RC_OK;
+  bundle_cache_entry_t* entry = NULL;
 
   if (bundle == NULL) {
     log_error(logger_id, "Bundle is not initialized\n");
@@ -82,5 +204,64 @@ retcode_t iota_consensus_bundle_validator_validate(tangle_t const* const tangle,
     *status = BUNDLE_TAIL_NOT_FOUND;
     return res;
   }
-  return bundle_validator(bundle, status);
+
+  if (cache_enabled) {
+    lock_handle_lock(&cache_lock);
+    if ((entry = cache_find(tail_hash)) != NULL) {
+      *status = entry->status;
+    }
+    lock_handle_unlock(&cache_lock);
+    if (entry != NULL) {
+      return RC_OK;
+    }
+  }
+
+  if ((res = bundle_validator_with_verifier(bundle, verifier, status)) != RC_OK) {
+    return res;
+  }
+
+  if (cache_enabled && bundle_status_is_final(*status)) {
+    return cache_add(tail_hash, bundle, *status);
+  }
+
+  return RC_OK;
+}
+
+retcode_t iota_consensus_bundle_validator_validate_delta(tangle_t const* const tangle, flex_trit_t* const tail_hash,
+                                                         state_delta_t* const delta, bundle_status_t* const status) {
+  retcode_t res = RC_OK;
+  bundle_cache_entry_t* entry = NULL;
+  bundle_transactions_t* bundle = NULL;
+  iota_transaction_t* tx = NULL;
+
+  if (cache_enabled) {
+    lock_handle_lock(&cache_lock);
+    if ((entry = cache_find(tail_hash)) != NULL) {
+      *status = entry->status;
+      if (delta != NULL && entry->status == BUNDLE_VALID) {
+        res = state_delta_apply_patch(delta, &entry->delta);
+      }
+    }
+    lock_handle_unlock(&cache_lock);
+    if (entry != NULL) {
+      return res;
+    }
+  }
+
+  bundle_transactions_new(&bundle);
+  if ((res = iota_consensus_bundle_validator_validate(tangle, tail_hash, bundle, status)) != RC_OK) {
+    goto done;
+  }
+  if (delta != NULL && *status == BUNDLE_VALID) {
+    BUNDLE_FOREACH(bundle, tx) {
+      if (transaction_value(tx) != 0 &&
+          (res = state_delta_add_or_sum(delta, transaction_address(tx), transaction_value(tx))) != RC_OK) {
+        goto done;
+      }
+    }
+  }
+
+done:
+  bundle_transactions_free(&bundle);
+  return res;
 }
@@ -11,17 +11,72 @@
 #include "common/errors.h"
 #include "common/model/bundle.h"
 #include "common/trinary/trit_array.h"
+#include "consensus/snapshot/state_delta.h"
 #include "consensus/tangle/tangle.h"
+#include "utils/containers/hash/hash243_set.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-retcode_t iota_consensus_bundle_validator_init();
+// Maximum number of validated bundles remembered, the least recently used being dropped first
+#ifndef BUNDLE_VALIDATOR_CACHE_SIZE
+#define BUNDLE_VALIDATOR_CACHE_SIZE 4096
+#endif
+
+/**
+ * Initializes the bundle validator
+ *
+ * @param iss_verifier The verifier computing signature digests, NULL to compute them in the validating thread
+ *
+ * @return a status code
+ */
+retcode_t iota_consensus_bundle_validator_init(iss_verifier_t* const iss_verifier);
 retcode_t iota_consensus_bundle_validator_destroy();
+
+/**
+ * Loads and validates the bundle of a tail
+ * The signatures and hash of a bundle already validated are not checked again
+ *
+ * @param tangle The tangle
+ * @param tail_hash The hash of the tail
+ * @param bundle The bundle, filled with its transactions
+ * @param status The status of the bundle
+ *
+ * @return a status code
+ */
 retcode_t iota_consensus_bundle_validator_validate(tangle_t const* const tangle, flex_trit_t* const tail_hash,
                                                    bundle_transactions_t* const bundle, bundle_status_t* const status);
 
+/**
+ * Validates the bundle of a tail and sums the values it moves into a delta
+ * The transactions of a bundle already validated are not loaded again
+ *
+ * @param tangle The tangle
+ * @param tail_hash The hash of the tail
+ * @param delta The delta the values are summed into if the bundle is valid, may be NULL
+ * @param status The status of the bundle
+ *
+ * @return a status code
+ */
+retcode_t iota_consensus_bundle_validator_validate_delta(tangle_t const* const tangle, flex_trit_t* const tail_hash,
+                                                         state_delta_t* const delta, bundle_status_t* const status);
+
+/**
+ * Forgets all validated bundles
+ */
+void iota_consensus_bundle_validator_clear_cache();
+
+/**
+ * Forgets the validated bundles of some tails
+ * A cached status and delta only depend on the transactions of the bundle, so
+ * a snapshot change does not invalidate them, but the bundles it confirms are
+ * not walked through anymore and only take the place of others
+ *
+ * @param hashes The hashes, those that are not tails of validated bundles are ignored
+ */
+void iota_consensus_bundle_validator_evict(hash243_set_t const hashes);
+
 #ifdef __cplusplus
 }
 #endif
@@ -29,7 +29,7 @@ static char *ciri_db_path = "consensus/bundle_validator/tests/ciri.db";
 
 void setUp() {
   TEST_ASSERT(tangle_setup(&tangle, &config, test_db_path, ciri_db_path) == RC_OK);
-  TEST_ASSERT(iota_consensus_bundle_validator_init() == RC_OK);
+  TEST_ASSERT(iota_consensus_bundle_validator_init(NULL) == RC_OK);
 }
 
 void tearDown() {
@@ -181,6 +181,61 @@ void test_iota_consensus_bundle_validator_validate_size_4_value_valid() {
   transactions_free(txs, 4);
 }
 
+void test_iota_consensus_bundle_validator_validate_delta_cached() {
+  bundle_transactions_t *bundle;
+  bundle_status_t bundle_status = BUNDLE_NOT_INITIALIZED;
+  iota_transaction_t *txs[4];
+  state_delta_t delta = NULL;
+  hash243_set_t confirmed = NULL;
+  state_delta_entry_t *entry = NULL;
+
+  tryte_t const *const trytes[4] = {TX_1_OF_4_VALUE_BUNDLE_TRYTES, TX_2_OF_4_VALUE_BUNDLE_TRYTES,
+                                    TX_3_OF_4_VALUE_BUNDLE_TRYTES, TX_4_OF_4_VALUE_BUNDLE_TRYTES};
+
+  transactions_deserialize(trytes, txs, 4, true);
+  TEST_ASSERT(build_tangle(&tangle, txs, 4) == RC_OK);
+
+  TEST_ASSERT(iota_consensus_bundle_validator_validate_delta(&tangle, transaction_hash(txs[0]), &delta,
+                                                             &bundle_status) == RC_OK);
+  TEST_ASSERT(bundle_status == BUNDLE_VALID);
+  TEST_ASSERT_EQUAL_INT(3, state_delta_size(delta));
+  TEST_ASSERT_EQUAL_INT(0, state_delta_sum(&delta));
+  state_delta_find(delta, transaction_address(txs[1]), entry);
+  TEST_ASSERT_NOT_NULL(entry);
+  TEST_ASSERT(entry->value == transaction_value(txs[1]));
+
+  // Served from the cache, values are summed into the delta again
+  TEST_ASSERT(iota_consensus_bundle_validator_validate_delta(&tangle, transaction_hash(txs[0]), &delta,
+                                                             &bundle_status) == RC_OK);
+  TEST_ASSERT(bundle_status == BUNDLE_VALID);
+  TEST_ASSERT_EQUAL_INT(3, state_delta_size(delta));
+  TEST_ASSERT(entry->value == 2 * transaction_value(txs[1]));
+
+  bundle_transactions_new(&bundle);
+  TEST_ASSERT(iota_consensus_bundle_validator_validate(&tangle, transaction_hash(txs[0]), bundle, &bundle_status) ==
+              RC_OK);
+  TEST_ASSERT(bundle_status == BUNDLE_VALID);
+  TEST_ASSERT_EQUAL_INT(4, bundle_transactions_size(bundle));
+  bundle_transactions_free(&bundle);
+
+  iota_consensus_bundle_validator_clear_cache();
+  TEST_ASSERT(iota_consensus_bundle_validator_validate_delta(&tangle, transaction_hash(txs[0]), NULL,
+                                                             &bundle_status) == RC_OK);
+  TEST_ASSERT(bundle_status == BUNDLE_VALID);
+
+  // Hashes of non-tail transactions are ignored
+  TEST_ASSERT(hash243_set_add(&confirmed, transaction_hash(txs[0])) == RC_OK);
+  TEST_ASSERT(hash243_set_add(&confirmed, transaction_hash(txs[1])) == RC_OK);
+  iota_consensus_bundle_validator_evict(confirmed);
+  TEST_ASSERT(iota_consensus_bundle_validator_validate_delta(&tangle, transaction_hash(txs[0]), NULL,
+                                                             &bundle_status) == RC_OK);
+  TEST_ASSERT(bundle_status == BUNDLE_VALID);
+  hash243_set_free(&confirmed);
+
+  state_delta_destroy(&delta);
+  transactions_free(txs, 4);
+}
+
 int main(int argc, char *argv[]) {
   UNITY_BEGIN();
   TEST_ASSERT(storage_init() == RC_OK);
@@ -201,6 +256,7 @@ int main(int argc, char *argv[]) {
   RUN_TEST(test_bundle_exceed_supply_neg_invalid);
   RUN_TEST(test_iota_consensus_bundle_validator_validate_size_4_value_wrong_sig_invalid);
   RUN_TEST(test_iota_consensus_bundle_validator_validate_size_4_value_valid);
+  RUN_TEST(test_iota_consensus_bundle_validator_validate_delta_cached);
 
   TEST_ASSERT(storage_destroy() == RC_OK);
   return UNITY_END();
@@ -144,6 +144,8 @@ retcode_t iota_consensus_conf_init(iota_consensus_conf_t *const conf) {
   strcpy(conf->snapshot_file, DEFAULT_SNAPSHOT_FILE);
   strcpy(conf->snapshot_signature_file, DEFAULT_SNAPSHOT_SIG_FILE);
   conf->snapshot_signature_skip_validation = DEFAULT_SNAPSHOT_SIGNATURE_SKIP_VALIDATION;
+  conf->tip_selection_batch_window_ms = DEFAULT_TIP_SELECTION_BATCH_WINDOW_MS;
+  conf->tip_selection_cw_incremental = DEFAULT_TIP_SELECTION_CW_INCREMENTAL;
 
   ret = iota_snapshot_conf_init(conf);
 
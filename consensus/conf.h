@@ -23,7 +23,9 @@
 #define DEFAULT_TIP_SELECTION_ALPHA 0.001
 #define DEFAULT_TIP_SELECTION_BELOW_MAX_DEPTH 20000
 #define DEFAULT_TIP_SELECTION_CW_CALC_IMPL DFS_FROM_ENTRY_POINT
+#define DEFAULT_TIP_SELECTION_CW_INCREMENTAL false
 #define DEFAULT_TIP_SELECTION_EP_RAND_IMPL EP_RANDOM_WALK
+#define DEFAULT_TIP_SELECTION_BATCH_WINDOW_MS 0
 #define DEFAULT_SNAPSHOT_CONF_FILE SNAPSHOT_CONF_FILE
 #define DEFAULT_SNAPSHOT_SIG_FILE SNAPSHOT_SIG_FILE
 #define DEFAULT_SNAPSHOT_FILE SNAPSHOT_FILE
@@ -82,6 +84,14 @@ typedef struct iota_consensus_conf_s {
   bool snapshot_signature_skip_validation;
   // Epoch time of the last snapshot
   uint64_t snapshot_timestamp_sec;
+  // Time during which concurrent tip selections of the same depth are coalesced
+  // into a single batch, 0 to select tips of each request separately
+  uint64_t tip_selection_batch_window_ms;
+  // Keep the cumulative weights of the subtangle above the deepest entry point
+  // across tip selections instead of computing them for each selection. An
+  // entry point outside of the kept subtangle forces a full rebuild, so
+  // selections alternating between such entry points rebuild every time
+  bool tip_selection_cw_incremental;
 } iota_consensus_conf_t;
 
 /**
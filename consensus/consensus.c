@@ -18,15 +18,23 @@ retcode_t iota_consensus_init(iota_consensus_t *const consensus, tangle_t *const
 
   logger_id = logger_helper_enable(CONSENSUS_LOGGER_ID, LOGGER_DEBUG, true);
 
+  log_info(logger_id, "Initializing ISS verifier\n");
+  if ((ret = iss_verifier_create(&consensus->iss_verifier, 0)) != RC_OK) {
+    log_critical(logger_id, "Initializing ISS verifier failed\n");
+    return ret;
+  }
+
   log_info(logger_id, "Initializing bundle validator\n");
-  if ((ret = iota_consensus_bundle_validator_init()) != RC_OK) {
+  if ((ret = iota_consensus_bundle_validator_init(consensus->iss_verifier)) != RC_OK) {
     log_critical(logger_id, "Initializing bundle validator failed\n");
     return ret;
   }
 
   log_info(logger_id, "Initializing cumulative weight rating calculator\n");
-  if ((ret = iota_consensus_cw_rating_init(&consensus->cw_rating_calculator, DEFAULT_TIP_SELECTION_CW_CALC_IMPL)) !=
-      RC_OK) {
+  if ((ret = iota_consensus_cw_rating_init(&consensus->cw_rating_calculator,
+                                           consensus->conf.tip_selection_cw_incremental
+                                               ? BACKWARD_WEIGHT_PROPAGATION
+                                               : DEFAULT_TIP_SELECTION_CW_CALC_IMPL)) != RC_OK) {
     log_critical(logger_id, "Initializing cumulative weight rating calculator failed\n");
     return ret;
   }
@@ -61,14 +69,16 @@ retcode_t iota_consensus_init(iota_consensus_t *const consensus, tangle_t *const
 
   log_info(logger_id, "Initializing transaction solidifier\n");
   if ((ret = iota_consensus_transaction_solidifier_init(&consensus->transaction_solidifier, &consensus->conf,
-                                                        transaction_requester, tips)) != RC_OK) {
+                                                        transaction_requester, tips,
+                                                        &consensus->cw_rating_calculator)) != RC_OK) {
     log_critical(logger_id, "Initializing transaction solidifier failed\n");
     return ret;
   }
 
   log_info(logger_id, "Initializing milestone tracker\n");
   if ((ret = iota_milestone_tracker_init(&consensus->milestone_tracker, &consensus->conf, &consensus->snapshot,
-                                         &consensus->ledger_validator, &consensus->transaction_solidifier)) != RC_OK) {
+                                         &consensus->ledger_validator, &consensus->transaction_solidifier,
+                                         consensus->iss_verifier)) != RC_OK) {
     log_critical(logger_id, "Initializing milestone tracker failed\n");
     return ret;
   }
@@ -191,6 +201,12 @@ retcode_t iota_consensus_destroy(iota_consensus_t *const consensus) {
     log_error(logger_id, "Destroying transaction validator failed\n");
   }
 
+  // Destroyed last, the milestone tracker threads are joined by now
+  log_info(logger_id, "Destroying ISS verifier\n");
+  if (consensus->iss_verifier && (ret = iss_verifier_destroy(&consensus->iss_verifier)) != RC_OK) {
+    log_error(logger_id, "Destroying ISS verifier failed\n");
+  }
+
   logger_helper_release(logger_id);
 
   return ret;
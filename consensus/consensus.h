@@ -24,6 +24,8 @@
 
 typedef struct iota_consensus_s {
   iota_consensus_conf_t conf;
+  // Computes the signature digests of the bundle validator and milestone tracker
+  iss_verifier_t *iss_verifier;
   cw_rating_calculator_t cw_rating_calculator;
   entry_point_selector_t entry_point_selector;
   ep_randomizer_t ep_randomizer;
@@ -7,6 +7,7 @@
 
 #include "common/errors.h"
 #include "consensus/cw_rating_calculator/cw_rating_dfs_impl.h"
+#include "consensus/cw_rating_calculator/cw_rating_incremental_impl.h"
 #include "utils/logger_helper.h"
 
 #define CW_RATING_CALCULATOR_LOGGER_ID "cw_rating_calculator"
@@ -15,14 +16,23 @@ static logger_id_t logger_id;
 
 retcode_t iota_consensus_cw_rating_init(cw_rating_calculator_t *const cw_calc, cw_calculation_implementation_t impl) {
   logger_id = logger_helper_enable(CW_RATING_CALCULATOR_LOGGER_ID, LOGGER_DEBUG, true);
+  cw_calc->engine = NULL;
   if (impl == DFS_FROM_ENTRY_POINT) {
     init_cw_calculator_dfs(&cw_calc->base);
     return RC_OK;
+  } else if (impl == DFS_FROM_ENTRY_POINT_PARALLEL) {
+    init_cw_calculator_dfs_parallel(&cw_calc->base);
+    return RC_OK;
+  } else if (impl == BACKWARD_WEIGHT_PROPAGATION) {
+    return init_cw_calculator_incremental(cw_calc);
   }
   return RC_OK;
 }
 
 retcode_t iota_consensus_cw_rating_destroy(cw_rating_calculator_t *cw_calc) {
+  if (cw_calc->base.vtable.cw_rating_destroy != NULL) {
+    cw_calc->base.vtable.cw_rating_destroy(cw_calc);
+  }
   logger_helper_release(logger_id);
   return RC_OK;
 }
@@ -36,7 +46,33 @@ retcode_t iota_consensus_cw_rating_calculate(cw_rating_calculator_t const *const
   return calculator->base.vtable.cw_rating_calculate(calculator, tangle, entry_point, out);
 }
 
+void iota_consensus_cw_rating_release(cw_rating_calculator_t const *const calculator, cw_calc_result *const result) {
+  if (calculator->base.vtable.cw_rating_release == NULL) {
+    cw_calc_result_destroy(result);
+    return;
+  }
+  calculator->base.vtable.cw_rating_release(calculator, result);
+}
+
+retcode_t iota_consensus_cw_rating_add_solid_transactions(cw_rating_calculator_t const *const calculator,
+                                                          tangle_t *const tangle,
+                                                          hash243_set_t const solid_transactions) {
+  if (calculator->base.vtable.cw_rating_add_solid_transactions == NULL) {
+    return RC_OK;
+  }
+  return calculator->base.vtable.cw_rating_add_solid_transactions(calculator, tangle, solid_transactions);
+}
+
+retcode_t iota_consensus_cw_rating_set_deepest_entry_point(cw_rating_calculator_t const *const calculator,
+                                                           flex_trit_t const *const entry_point) {
+  if (calculator->base.vtable.cw_rating_set_deepest_entry_point == NULL) {
+    return RC_OK;
+  }
+  return calculator->base.vtable.cw_rating_set_deepest_entry_point(calculator, entry_point);
+}
+
 void cw_calc_result_destroy(cw_calc_result *const calc_result) {
   hash_to_indexed_hash_set_map_free(&calc_result->tx_to_approvers);
   hash_to_int64_t_map_free(&calc_result->cw_ratings);
+  subtangle_graph_free(&calc_result->graph);
 }
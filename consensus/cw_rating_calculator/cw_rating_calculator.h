@@ -15,7 +15,9 @@
 
 #include "common/errors.h"
 #include "common/trinary/flex_trit.h"
+#include "consensus/cw_rating_calculator/subtangle_graph.h"
 #include "consensus/tangle/tangle.h"
+#include "utils/containers/hash/hash243_set.h"
 #include "utils/containers/hash/hash_int64_t_map.h"
 #include "utils/hash_indexed_map.h"
 
@@ -26,26 +28,42 @@ extern "C" {
 // Forward declarations
 typedef struct cw_rating_calculator_base cw_rating_calculator_base_t;
 typedef struct cw_rating_calculator_t cw_rating_calculator_t;
+typedef struct cw_rating_engine_s cw_rating_engine_t;
 
 typedef enum cw_calculation_implementation_e {
   CW_NO_IMPLEMENTATION,
   /// time - O(n^2), place - O(n^2)
   DFS_FROM_ENTRY_POINT,
-  /// time - O(n), place - O(n^2) implementation with the cost of
-  /// Performing propogation on each incoming transaction
+  /// time - O(n) when the entry point is not in the subtangle, O(1)
+  /// otherwise, place - O(n) implementation with the cost of performing
+  /// propagation on each incoming solid transaction
   BACKWARD_WEIGHT_PROPAGATION,
+  /// DFS_FROM_ENTRY_POINT with the future cones computed by one thread per
+  /// core, started for each calculation
+  DFS_FROM_ENTRY_POINT_PARALLEL,
 } cw_calculation_implementation_t;
 
 typedef struct cw_calc_result {
   hash_to_int64_t_map_t cw_ratings;
+  // The idx of an entry is the id of the transaction in the graph
   hash_to_indexed_hash_set_map_t tx_to_approvers;
+  subtangle_graph_t graph;
 } cw_calc_result;
 
 typedef struct {
   // find_transactions_request
   retcode_t (*cw_rating_calculate)(cw_rating_calculator_t const *const, tangle_t *const tangle,
                                    flex_trit_t *entry_point, cw_calc_result *result);
-
+  // Gives a result back, NULL if results are owned by the caller
+  void (*cw_rating_release)(cw_rating_calculator_t const *const, cw_calc_result *const result);
+  // Adds newly solid transactions, NULL if the implementation keeps no state
+  retcode_t (*cw_rating_add_solid_transactions)(cw_rating_calculator_t const *const, tangle_t *const tangle,
+                                                hash243_set_t const solid_transactions);
+  // Drops the state below the deepest possible entry point, NULL if the implementation keeps no state
+  retcode_t (*cw_rating_set_deepest_entry_point)(cw_rating_calculator_t const *const,
+                                                 flex_trit_t const *const entry_point);
+  // Destroys the state of the implementation, NULL if it keeps no state
+  void (*cw_rating_destroy)(cw_rating_calculator_t *const);
 } cw_calculator_vtable;
 
 struct cw_rating_calculator_base {
@@ -54,6 +72,8 @@ struct cw_rating_calculator_base {
 
 struct cw_rating_calculator_t {
   cw_rating_calculator_base_t base;
+  // State kept across calculations, NULL for stateless implementations
+  cw_rating_engine_t *engine;
 };
 
 extern retcode_t iota_consensus_cw_rating_init(cw_rating_calculator_t *const cw_calc,
@@ -64,6 +84,43 @@ extern retcode_t iota_consensus_cw_rating_destroy(cw_rating_calculator_t *cw_cal
 extern retcode_t iota_consensus_cw_rating_calculate(cw_rating_calculator_t const *const cw_calc, tangle_t *const tangle,
                                                     flex_trit_t const *entry_point, cw_calc_result *out);
 
+/**
+ * Gives back a result obtained from iota_consensus_cw_rating_calculate
+ * Results of stateless implementations are destroyed, results of stateful ones
+ * are shared and must not be modified nor destroyed by the caller
+ *
+ * @param cw_calc The calculator
+ * @param result The result
+ */
+extern void iota_consensus_cw_rating_release(cw_rating_calculator_t const *const cw_calc, cw_calc_result *const result);
+
+/**
+ * Feeds newly solid transactions to a stateful calculator, no-op otherwise
+ *
+ * @param cw_calc The calculator
+ * @param tangle A tangle
+ * @param solid_transactions The hashes of the transactions that became solid
+ *
+ * @return a status code
+ */
+extern retcode_t iota_consensus_cw_rating_add_solid_transactions(cw_rating_calculator_t const *const cw_calc,
+                                                                 tangle_t *const tangle,
+                                                                 hash243_set_t const solid_transactions);
+
+/**
+ * Tells a stateful calculator the deepest entry point of the next calculations
+ * so that it can drop the transactions below it, no-op otherwise
+ * A later calculation from a deeper entry point is still served, at a higher
+ * cost
+ *
+ * @param cw_calc The calculator
+ * @param entry_point The deepest entry point
+ *
+ * @return a status code
+ */
+extern retcode_t iota_consensus_cw_rating_set_deepest_entry_point(cw_rating_calculator_t const *const cw_calc,
+                                                                  flex_trit_t const *const entry_point);
+
 extern void cw_calc_result_destroy(cw_calc_result *const calc_result);
 
 #ifdef __cplusplus
@@ -6,12 +6,13 @@
  */
 
 #include <inttypes.h>
+#include <unistd.h>
 
 #include "common/storage/pack.h"
 #include "consensus/cw_rating_calculator/cw_rating_dfs_impl.h"
-#include "utils/containers/bitset.h"
 #include "utils/containers/hash/hash243_stack.h"
 #include "utils/logger_helper.h"
+#include "utils/macros.h"
 
 #define CW_RATING_CALCULATOR_LOGGER_ID "cw_rating_calculator"
 
@@ -19,69 +20,99 @@ static logger_id_t logger_id;
 
 static retcode_t cw_rating_dfs_do_dfs_from_db(cw_rating_calculator_t const *const cw_calc, tangle_t *const tangle,
                                               flex_trit_t *entry_point, hash_to_indexed_hash_set_map_t *tx_to_approvers,
-                                              uint64_t *subtangle_size, int64_t subtangle_before_timestamp);
+                                              uint64_t *subtangle_size, int64_t subtangle_before_timestamp,
+                                              bool solid_only);
 
-static retcode_t cw_rating_dfs_do_dfs_light(hash_to_indexed_hash_set_map_t tx_to_approvers, flex_trit_t *ep,
-                                            bitset_t *visited_bitset, uint64_t *subtangle_size);
+static retcode_t cw_rating_dfs_calculate(cw_rating_calculator_t const *const cw_calc, tangle_t *const tangle,
+                                         flex_trit_t *entry_point, cw_calc_result *out, size_t num_workers,
+                                         bool solid_only);
 
 void init_cw_calculator_dfs(cw_rating_calculator_base_t *calculator) {
   logger_id = logger_helper_enable(CW_RATING_CALCULATOR_LOGGER_ID, LOGGER_DEBUG, true);
   calculator->vtable = cw_topological_vtable;
 }
 
+void init_cw_calculator_dfs_parallel(cw_rating_calculator_base_t *calculator) {
+  logger_id = logger_helper_enable(CW_RATING_CALCULATOR_LOGGER_ID, LOGGER_DEBUG, true);
+  calculator->vtable = cw_topological_parallel_vtable;
+}
+
+size_t cw_rating_dfs_num_workers() {
+  long num_cores = 1;
+
+#ifdef _SC_NPROCESSORS_ONLN
+  num_cores = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+  return MIN(CW_RATING_DFS_MAX_WORKERS, (size_t)MAX(1, num_cores));
+}
+
 retcode_t cw_rating_calculate_dfs(cw_rating_calculator_t const *const cw_calc, tangle_t *const tangle,
                                   flex_trit_t *entry_point, cw_calc_result *out) {
+  return cw_rating_dfs_calculate(cw_calc, tangle, entry_point, out, 1, false);
+}
+
+retcode_t cw_rating_calculate_dfs_parallel(cw_rating_calculator_t const *const cw_calc, tangle_t *const tangle,
+                                           flex_trit_t *entry_point, cw_calc_result *out) {
+  return cw_rating_dfs_calculate(cw_calc, tangle, entry_point, out, cw_rating_dfs_num_workers(), false);
+}
+
+retcode_t cw_rating_calculate_dfs_solid_parallel(cw_rating_calculator_t const *const cw_calc, tangle_t *const tangle,
+                                                 flex_trit_t *entry_point, cw_calc_result *out) {
+  return cw_rating_dfs_calculate(cw_calc, tangle, entry_point, out, cw_rating_dfs_num_workers(), true);
+}
+
+static retcode_t cw_rating_dfs_calculate(cw_rating_calculator_t const *const cw_calc, tangle_t *const tangle,
+                                         flex_trit_t *entry_point, cw_calc_result *out, size_t num_workers,
+                                         bool solid_only) {
   retcode_t res;
 
   out->tx_to_approvers = NULL;
   out->cw_ratings = NULL;
+  memset(&out->graph, 0, sizeof(subtangle_graph_t));
   hash_to_indexed_hash_set_entry_t *curr_hash_to_approvers_entry = NULL;
   hash_to_indexed_hash_set_entry_t *tmp_hash_to_approvers_entry = NULL;
-  uint64_t sub_tangle_size;
+  hash_to_indexed_hash_set_entry_t *approver_entry = NULL;
+  hash243_set_entry_t *curr_approver = NULL;
+  hash243_set_entry_t *tmp_approver = NULL;
   uint64_t max_subtangle_size;
-  uint64_t bitset_size;
+  uint32_t id;
 
   if (!entry_point) {
     return RC_NULL_PARAM;
   }
 
   if ((res = cw_rating_dfs_do_dfs_from_db(cw_calc, tangle, entry_point, &out->tx_to_approvers, &max_subtangle_size,
-                                          0)) != RC_OK) {
+                                          0, solid_only)) != RC_OK) {
     log_error(logger_id, "Failed in DFS from DB, error code is: %" PRIu64 "\n", res);
     return RC_CONSENSUS_CW_FAILED_IN_DFS_FROM_DB;
   }
 
-  // Insert first "ratings" entry
-  if ((res = hash_to_int64_t_map_add(&out->cw_ratings, entry_point, max_subtangle_size))) {
-    log_error(logger_id, "Failed adding entrypoint into map\n");
-    return res;
-  }
-
-  if (max_subtangle_size <= 1) {
-    return RC_OK;
+  // Entry point first, ids are given in discovery order
+  HASH_ITER(hh, out->tx_to_approvers, curr_hash_to_approvers_entry, tmp_hash_to_approvers_entry) {
+    if ((res = subtangle_graph_add_vertex(&out->graph, curr_hash_to_approvers_entry->hash, &id)) != RC_OK) {
+      return res;
+    }
+    curr_hash_to_approvers_entry->idx = id;
   }
-
-  bitset_size = bistset_required_size(max_subtangle_size);
-  uint64_t visited_raw_bits[bitset_size];
-  bitset_t visited_txs_bitset = {
-      .raw_bits = visited_raw_bits, .bitset_integer_index = 0, .bitset_relative_index = 0, .size = bitset_size};
-
-  flex_trit_t curr_hash[FLEX_TRIT_SIZE_243];
   HASH_ITER(hh, out->tx_to_approvers, curr_hash_to_approvers_entry, tmp_hash_to_approvers_entry) {
-    if (curr_hash_to_approvers_entry->idx == 0) {
-      continue;
+    HASH_ITER(hh, curr_hash_to_approvers_entry->approvers, curr_approver, tmp_approver) {
+      HASH_FIND(hh, out->tx_to_approvers, curr_approver->hash, FLEX_TRIT_SIZE_243, approver_entry);
+      if (approver_entry != NULL && (res = subtangle_graph_add_approver(&out->graph, curr_hash_to_approvers_entry->idx,
+                                                                        approver_entry->idx)) != RC_OK) {
+        return res;
+      }
     }
+  }
 
-    bitset_reset(&visited_txs_bitset);
-    memcpy(curr_hash, curr_hash_to_approvers_entry->hash, FLEX_TRIT_SIZE_243);
-    if ((res = cw_rating_dfs_do_dfs_light(out->tx_to_approvers, curr_hash, &visited_txs_bitset, &sub_tangle_size)) !=
-        RC_OK) {
-      log_error(logger_id, "Failed in light DFS, error code is: %" PRIu64 "\n", res);
-      return RC_CONSENSUS_CW_FAILED_IN_LIGHT_DFS;
-    }
+  if ((res = subtangle_graph_compute_cw_ratings_parallel(&out->graph, num_workers)) != RC_OK) {
+    log_error(logger_id, "Failed computing future cones, error code is: %" PRIu64 "\n", res);
+    return res;
+  }
 
-    if ((res = hash_to_int64_t_map_add(&out->cw_ratings, curr_hash, sub_tangle_size))) {
-      log_error(logger_id, "Failed in light DFS, error code is: %" PRIu64 "\n", res);
+  HASH_ITER(hh, out->tx_to_approvers, curr_hash_to_approvers_entry, tmp_hash_to_approvers_entry) {
+    if ((res = hash_to_int64_t_map_add(&out->cw_ratings, curr_hash_to_approvers_entry->hash,
+                                       out->graph.cw_ratings[curr_hash_to_approvers_entry->idx]))) {
+      log_error(logger_id, "Failed adding rating into map\n");
       return res;
     }
   }
@@ -91,11 +122,13 @@ retcode_t cw_rating_calculate_dfs(cw_rating_calculator_t const *const cw_calc, t
 
 static retcode_t cw_rating_dfs_do_dfs_from_db(cw_rating_calculator_t const *const cw_calc, tangle_t *const tangle,
                                               flex_trit_t *entry_point, hash_to_indexed_hash_set_map_t *tx_to_approvers,
-                                              uint64_t *subtangle_size, int64_t subtangle_before_timestamp) {
+                                              uint64_t *subtangle_size, int64_t subtangle_before_timestamp,
+                                              bool solid_only) {
   hash_to_indexed_hash_set_entry_t *curr_tx = NULL;
   size_t curr_approver_index;
   retcode_t res = RC_OK;
   iota_stor_pack_t pack;
+  DECLARE_PACK_SINGLE_TX(approver_s, approver, approver_pack);
   *subtangle_size = 0;
 
   if ((res = hash_pack_init(&pack, 10)) != RC_OK) {
@@ -126,6 +159,16 @@ static retcode_t cw_rating_dfs_do_dfs_from_db(cw_rating_calculator_t const *cons
       hash243_stack_pop(&stack);
       while (pack.num_loaded > 0) {
         curr_approver_index = --pack.num_loaded;
+        if (solid_only) {
+          approver_pack.num_loaded = 0;
+          if ((res = iota_tangle_transaction_load_partial(tangle, (flex_trit_t *)pack.models[curr_approver_index],
+                                                          &approver_pack, PARTIAL_TX_MODEL_METADATA)) != RC_OK) {
+            return res;
+          }
+          if (approver_pack.num_loaded == 0 || !transaction_solid(approver)) {
+            continue;
+          }
+        }
         // Add each found approver to the currently traversed tx
         if ((res = hash243_stack_push(&stack, ((flex_trit_t *)pack.models[curr_approver_index])))) {
           return res;
@@ -144,43 +187,3 @@ static retcode_t cw_rating_dfs_do_dfs_from_db(cw_rating_calculator_t const *cons
 
   return res;
 }
-
-static retcode_t cw_rating_dfs_do_dfs_light(hash_to_indexed_hash_set_map_t tx_to_approvers, flex_trit_t *ep,
-                                            bitset_t *visited_bitset, uint64_t *subtangle_size) {
-  *subtangle_size = 0;
-  flex_trit_t *curr_hash = NULL;
-  hash_to_indexed_hash_set_entry_t *curr_tx_entry = NULL;
-  retcode_t ret;
-
-  hash243_stack_t stack = NULL;
-  if ((ret = hash243_stack_push(&stack, ep))) {
-    return ret;
-  }
-
-  while (!hash243_stack_empty(stack)) {
-    curr_hash = hash243_stack_peek(stack);
-
-    HASH_FIND(hh, tx_to_approvers, curr_hash, FLEX_TRIT_SIZE_243, curr_tx_entry);
-
-    hash243_stack_pop(&stack);
-
-    if (!curr_tx_entry) {
-      continue;
-    }
-
-    if (bitset_is_set(visited_bitset, curr_tx_entry->idx)) {
-      continue;
-    }
-    ++(*subtangle_size);
-
-    bitset_set_true(visited_bitset, curr_tx_entry->idx);
-
-    if ((ret =
-             hash243_set_for_each(&curr_tx_entry->approvers, (hash243_on_container_func)hash243_stack_push, &stack))) {
-      return ret;
-    }
-  }
-
-  hash243_stack_free(&stack);
-  return RC_OK;
-}
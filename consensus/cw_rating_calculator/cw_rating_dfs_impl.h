@@ -17,7 +17,20 @@
 extern "C" {
 #endif
 
+// Maximum number of worker threads of the parallel implementation
+#ifndef CW_RATING_DFS_MAX_WORKERS
+#define CW_RATING_DFS_MAX_WORKERS 16
+#endif
+
 void init_cw_calculator_dfs(cw_rating_calculator_base_t *calculator);
+void init_cw_calculator_dfs_parallel(cw_rating_calculator_base_t *calculator);
+
+/**
+ * @return the number of worker threads of the parallel implementation, the
+ * number of online cores bounded by CW_RATING_DFS_MAX_WORKERS
+ */
+size_t cw_rating_dfs_num_workers();
+
 /**
  *
  * @param cw_calc - the calculator
@@ -27,11 +40,12 @@ void init_cw_calculator_dfs(cw_rating_calculator_base_t *calculator);
  * @return retcode_t
  *
  * This implementation does a DFS from entry point to discover all transactions
- * this first DFS is done using storage to load each transaction approvers, and
+ * this DFS is done using storage to load each transaction approvers, and
  * we use this DFS to store transactions loaded from storage in a map (in
- * memory) then, for each transaction, another DFS is performed to discover it's
- * approvers using the map we got from initial DFS Complexity: DFS + (num
- * vertices)*DFS = (E+V) + V*(E+V) ~ V*(E+V)~O(V^2)
+ * memory) then the transactions are given dense ids in a graph where the future
+ * cone of each transaction is computed as a bitset, ORing the bitsets of its
+ * approvers 64 transactions at a time
+ * Complexity: DFS + (E+V)*V/64 ~ O(V^2/64)
  *
  * (E ~ 2*V - because each transaction has two outcoming edges)
  */
@@ -39,10 +53,33 @@ void init_cw_calculator_dfs(cw_rating_calculator_base_t *calculator);
 extern retcode_t cw_rating_calculate_dfs(cw_rating_calculator_t const *const cw_calc, tangle_t *const tangle,
                                          flex_trit_t *entry_point, cw_calc_result *out);
 
+/**
+ * Same as cw_rating_calculate_dfs, the future cones being computed by
+ * cw_rating_dfs_num_workers() threads started for the calculation, each one
+ * for its own range of ids and with its own SUBTANGLE_GRAPH_CONES_MAX_WORDS
+ * words of cones
+ * Complexity: DFS + (E+V)*V/(64*workers)
+ */
+extern retcode_t cw_rating_calculate_dfs_parallel(cw_rating_calculator_t const *const cw_calc, tangle_t *const tangle,
+                                                  flex_trit_t *entry_point, cw_calc_result *out);
+
+/**
+ * Same as cw_rating_calculate_dfs_parallel, the approvers that are not solid
+ * being left out of the subtangle
+ * Complexity: DFS + E loads of metadata + (E+V)*V/(64*workers)
+ */
+extern retcode_t cw_rating_calculate_dfs_solid_parallel(cw_rating_calculator_t const *const cw_calc,
+                                                        tangle_t *const tangle, flex_trit_t *entry_point,
+                                                        cw_calc_result *out);
+
 static cw_calculator_vtable cw_topological_vtable = {
     .cw_rating_calculate = cw_rating_calculate_dfs,
 };
 
+static cw_calculator_vtable cw_topological_parallel_vtable = {
+    .cw_rating_calculate = cw_rating_calculate_dfs_parallel,
+};
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,430 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/storage/pack.h"
+#include "consensus/cw_rating_calculator/cw_rating_dfs_impl.h"
+#include "consensus/cw_rating_calculator/cw_rating_incremental_impl.h"
+#include "utils/handles/lock.h"
+#include "utils/handles/rw_lock.h"
+#include "utils/logger_helper.h"
+#include "utils/macros.h"
+
+#define CW_RATING_CALCULATOR_LOGGER_ID "cw_rating_calculator"
+
+static logger_id_t logger_id;
+
+// The transactions of the subtangle approved by a transaction of the subtangle
+typedef struct cw_engine_approvees_s {
+  uint32_t ids[2];
+  uint32_t size;
+} cw_engine_approvees_t;
+
+typedef struct cw_engine_candidate_s {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  flex_trit_t trunk[FLEX_TRIT_SIZE_243];
+  flex_trit_t branch[FLEX_TRIT_SIZE_243];
+  uint8_t state;
+  UT_hash_handle hh;
+} cw_engine_candidate_t;
+
+struct cw_rating_engine_s {
+  // Held for reading by the callers of the shared result
+  rw_lock_handle_t lock;
+  // Held by writers while they wait for the lock, readers pass through it so that they can't starve a writer
+  lock_handle_t turnstile;
+  bool rooted;
+  // The entry point the subtangle was built from, the deepest one it can serve
+  flex_trit_t root[FLEX_TRIT_SIZE_243];
+  // The subtangle above the root and its cumulative weights
+  cw_calc_result result;
+  // Indexed by the ids of the graph of the result
+  cw_engine_approvees_t *approvees;
+  hash_to_int64_t_map_entry_t **ratings;
+  uint32_t *visits;
+  uint32_t *stack;
+  uint32_t capacity;
+  // Marks the vertices visited by the current propagation
+  uint32_t propagation;
+};
+
+static void cw_engine_read_lock(cw_rating_engine_t *const engine) {
+  lock_handle_lock(&engine->turnstile);
+  lock_handle_unlock(&engine->turnstile);
+  rw_lock_handle_rdlock(&engine->lock);
+}
+
+static void cw_engine_write_lock(cw_rating_engine_t *const engine) {
+  lock_handle_lock(&engine->turnstile);
+  rw_lock_handle_wrlock(&engine->lock);
+  lock_handle_unlock(&engine->turnstile);
+}
+
+static void cw_engine_clear(cw_rating_engine_t *const engine) {
+  cw_calc_result_destroy(&engine->result);
+  engine->rooted = false;
+}
+
+static retcode_t cw_engine_reserve(cw_rating_engine_t *const engine, uint32_t const size) {
+  uint32_t capacity = MAX(64, engine->capacity);
+  void *tmp = NULL;
+
+  if (size <= engine->capacity) {
+    return RC_OK;
+  }
+  while (capacity < size) {
+    capacity *= 2;
+  }
+  if ((tmp = realloc(engine->approvees, capacity * sizeof(*engine->approvees))) == NULL) {
+    return RC_CONSENSUS_OOM;
+  }
+  engine->approvees = tmp;
+  if ((tmp = realloc(engine->ratings, capacity * sizeof(*engine->ratings))) == NULL) {
+    return RC_CONSENSUS_OOM;
+  }
+  engine->ratings = tmp;
+  if ((tmp = realloc(engine->visits, capacity * sizeof(*engine->visits))) == NULL) {
+    return RC_CONSENSUS_OOM;
+  }
+  engine->visits = tmp;
+  if ((tmp = realloc(engine->stack, capacity * sizeof(*engine->stack))) == NULL) {
+    return RC_CONSENSUS_OOM;
+  }
+  engine->stack = tmp;
+  engine->capacity = capacity;
+  return RC_OK;
+}
+
+static retcode_t cw_engine_rebuild(cw_rating_calculator_t const *const cw_calc, tangle_t *const tangle,
+                                   flex_trit_t *const entry_point) {
+  cw_rating_engine_t *engine = cw_calc->engine;
+  subtangle_graph_t *graph = &engine->result.graph;
+  uint32_t id, i, approver;
+  retcode_t ret = RC_OK;
+
+  cw_engine_clear(engine);
+  // Newly solid transactions are the only ones added afterwards, the others are left out
+  if ((ret = cw_rating_calculate_dfs_solid_parallel(cw_calc, tangle, entry_point, &engine->result)) != RC_OK ||
+      (ret = cw_engine_reserve(engine, graph->num_vertices)) != RC_OK) {
+    goto done;
+  }
+
+  for (id = 0; id < graph->num_vertices; id++) {
+    engine->approvees[id].size = 0;
+    engine->visits[id] = 0;
+    HASH_FIND(hh, engine->result.cw_ratings, graph->hashes[id], FLEX_TRIT_SIZE_243, engine->ratings[id]);
+  }
+  for (id = 0; id < graph->num_vertices; id++) {
+    for (i = 0; i < graph->approvers[id].size; i++) {
+      approver = graph->approvers[id].ids[i];
+      if (engine->approvees[approver].size < 2) {
+        engine->approvees[approver].ids[engine->approvees[approver].size++] = id;
+      }
+    }
+  }
+  engine->propagation = 0;
+  memcpy(engine->root, entry_point, FLEX_TRIT_SIZE_243);
+  engine->rooted = true;
+
+done:
+  if (ret != RC_OK) {
+    cw_engine_clear(engine);
+  }
+  return ret;
+}
+
+// Drops the transactions that are not approving the new root
+static retcode_t cw_engine_reroot(cw_rating_engine_t *const engine, flex_trit_t const *const entry_point) {
+  subtangle_graph_t *graph = &engine->result.graph;
+  hash_to_indexed_hash_set_entry_t *ep_entry = NULL;
+  hash_to_indexed_hash_set_entry_t *curr_entry = NULL;
+  hash_to_indexed_hash_set_entry_t *tmp_entry = NULL;
+  size_t words = bistset_required_size(graph->num_vertices);
+  uint64_t *kept_raw_bits = NULL;
+  uint32_t *new_ids = NULL;
+  uint32_t num_vertices = graph->num_vertices;
+  uint32_t id, new_id, i, j;
+  retcode_t ret = RC_OK;
+
+  HASH_FIND(hh, engine->result.tx_to_approvers, entry_point, FLEX_TRIT_SIZE_243, ep_entry);
+  if ((kept_raw_bits = (uint64_t *)calloc(words, sizeof(uint64_t))) == NULL ||
+      (new_ids = (uint32_t *)malloc(num_vertices * sizeof(uint32_t))) == NULL) {
+    ret = RC_CONSENSUS_OOM;
+    goto done;
+  }
+  bitset_t kept = {.raw_bits = kept_raw_bits, .bitset_integer_index = 0, .bitset_relative_index = 0, .size = words};
+  if ((ret = subtangle_graph_future_cone(graph, ep_entry->idx, &kept)) != RC_OK) {
+    goto done;
+  }
+  subtangle_graph_keep(graph, &kept, new_ids);
+
+  HASH_ITER(hh, engine->result.tx_to_approvers, curr_entry, tmp_entry) {
+    if ((new_id = new_ids[curr_entry->idx]) != SUBTANGLE_GRAPH_NO_VERTEX) {
+      curr_entry->idx = new_id;
+      continue;
+    }
+    HASH_DEL(engine->result.cw_ratings, engine->ratings[curr_entry->idx]);
+    free(engine->ratings[curr_entry->idx]);
+    HASH_DEL(engine->result.tx_to_approvers, curr_entry);
+    hash243_set_free(&curr_entry->approvers);
+    free(curr_entry);
+  }
+
+  for (id = 0; id < num_vertices; id++) {
+    if ((new_id = new_ids[id]) == SUBTANGLE_GRAPH_NO_VERTEX) {
+      continue;
+    }
+    // Approvees below the new entry point are dropped as well
+    for (i = 0, j = 0; i < engine->approvees[id].size; i++) {
+      if (new_ids[engine->approvees[id].ids[i]] != SUBTANGLE_GRAPH_NO_VERTEX) {
+        engine->approvees[new_id].ids[j++] = new_ids[engine->approvees[id].ids[i]];
+      }
+    }
+    engine->approvees[new_id].size = j;
+    engine->ratings[new_id] = engine->ratings[id];
+    engine->visits[new_id] = engine->visits[id];
+  }
+  memcpy(engine->root, entry_point, FLEX_TRIT_SIZE_243);
+
+done:
+  free(new_ids);
+  free(kept_raw_bits);
+  return ret;
+}
+
+// Adds a transaction approving the subtangle and propagates its weight backward
+static retcode_t cw_engine_insert(cw_rating_engine_t *const engine, cw_engine_candidate_t const *const candidate) {
+  subtangle_graph_t *graph = &engine->result.graph;
+  hash_to_indexed_hash_set_entry_t *new_entry = NULL;
+  hash_to_indexed_hash_set_entry_t *approvee_entry = NULL;
+  flex_trit_t const *parents[2] = {candidate->trunk, candidate->branch};
+  cw_engine_approvees_t *approvees = NULL;
+  size_t stack_size = 0;
+  uint32_t id, vertex, i;
+  retcode_t ret = RC_OK;
+
+  if ((ret = cw_engine_reserve(engine, graph->num_vertices + 1)) != RC_OK ||
+      (ret = hash_to_indexed_hash_set_map_add_new_set(&engine->result.tx_to_approvers, candidate->hash, &new_entry,
+                                                      graph->num_vertices)) != RC_OK ||
+      (ret = subtangle_graph_add_vertex(graph, candidate->hash, &id)) != RC_OK ||
+      (ret = hash_to_int64_t_map_add(&engine->result.cw_ratings, candidate->hash, 1)) != RC_OK) {
+    return ret;
+  }
+  HASH_FIND(hh, engine->result.cw_ratings, candidate->hash, FLEX_TRIT_SIZE_243, engine->ratings[id]);
+  approvees = &engine->approvees[id];
+  approvees->size = 0;
+  engine->visits[id] = 0;
+
+  for (i = 0; i < 2; i++) {
+    HASH_FIND(hh, engine->result.tx_to_approvers, parents[i], FLEX_TRIT_SIZE_243, approvee_entry);
+    if (approvee_entry == NULL || approvee_entry == new_entry ||
+        (approvees->size == 1 && approvees->ids[0] == approvee_entry->idx)) {
+      continue;
+    }
+    if ((ret = hash243_set_add(&approvee_entry->approvers, candidate->hash)) != RC_OK ||
+        (ret = subtangle_graph_add_approver(graph, approvee_entry->idx, id)) != RC_OK) {
+      return ret;
+    }
+    approvees->ids[approvees->size++] = approvee_entry->idx;
+  }
+
+  if (++engine->propagation == 0) {
+    memset(engine->visits, 0, graph->num_vertices * sizeof(uint32_t));
+    engine->propagation = 1;
+  }
+  engine->visits[id] = engine->propagation;
+  engine->stack[stack_size++] = id;
+  while (stack_size > 0) {
+    vertex = engine->stack[--stack_size];
+    for (i = 0; i < engine->approvees[vertex].size; i++) {
+      id = engine->approvees[vertex].ids[i];
+      if (engine->visits[id] != engine->propagation) {
+        engine->visits[id] = engine->propagation;
+        graph->cw_ratings[id]++;
+        engine->ratings[id]->value++;
+        engine->stack[stack_size++] = id;
+      }
+    }
+  }
+
+  return RC_OK;
+}
+
+retcode_t init_cw_calculator_incremental(cw_rating_calculator_t *const calculator) {
+  logger_id = logger_helper_enable(CW_RATING_CALCULATOR_LOGGER_ID, LOGGER_DEBUG, true);
+  calculator->base.vtable = cw_incremental_vtable;
+  if ((calculator->engine = (cw_rating_engine_t *)calloc(1, sizeof(cw_rating_engine_t))) == NULL) {
+    return RC_CONSENSUS_OOM;
+  }
+  rw_lock_handle_init(&calculator->engine->lock);
+  lock_handle_init(&calculator->engine->turnstile);
+  return RC_OK;
+}
+
+retcode_t cw_rating_calculate_incremental(cw_rating_calculator_t const *const cw_calc, tangle_t *const tangle,
+                                          flex_trit_t *entry_point, cw_calc_result *out) {
+  cw_rating_engine_t *engine = cw_calc->engine;
+  retcode_t ret = RC_OK;
+
+  memset(out, 0, sizeof(cw_calc_result));
+
+  if (!entry_point) {
+    return RC_NULL_PARAM;
+  }
+
+  cw_engine_read_lock(engine);
+  // Cumulative weights don't depend on the root: any entry point of the subtangle is served as is, the subtangle is
+  // only rebuilt under the write lock when the entry point is missing
+  while (!engine->rooted || !hash_to_indexed_hash_set_map_contains(&engine->result.tx_to_approvers, entry_point)) {
+    rw_lock_handle_unlock(&engine->lock);
+    cw_engine_write_lock(engine);
+    if (!engine->rooted || !hash_to_indexed_hash_set_map_contains(&engine->result.tx_to_approvers, entry_point)) {
+      if ((ret = cw_engine_rebuild(cw_calc, tangle, entry_point)) != RC_OK) {
+        log_error(logger_id, "Failed rebuilding the subtangle, error code is: %" PRIu64 "\n", ret);
+        rw_lock_handle_unlock(&engine->lock);
+        return ret;
+      }
+    }
+    rw_lock_handle_unlock(&engine->lock);
+    cw_engine_read_lock(engine);
+  }
+
+  *out = engine->result;
+  return RC_OK;
+}
+
+void cw_rating_release_incremental(cw_rating_calculator_t const *const cw_calc, cw_calc_result *const result) {
+  if (result->tx_to_approvers == NULL) {
+    return;
+  }
+  memset(result, 0, sizeof(cw_calc_result));
+  rw_lock_handle_unlock(&cw_calc->engine->lock);
+}
+
+retcode_t cw_rating_add_solid_transactions_incremental(cw_rating_calculator_t const *const cw_calc,
+                                                       tangle_t *const tangle,
+                                                       hash243_set_t const solid_transactions) {
+  cw_rating_engine_t *engine = cw_calc->engine;
+  hash243_set_entry_t *curr_entry = NULL;
+  hash243_set_entry_t *tmp_entry = NULL;
+  cw_engine_candidate_t *candidates = NULL;
+  cw_engine_candidate_t *candidates_index = NULL;
+  cw_engine_candidate_t *parent = NULL;
+  cw_engine_candidate_t **stack = NULL;
+  size_t num_candidates = 0;
+  size_t stack_size = 0;
+  size_t i = 0;
+  retcode_t ret = RC_OK;
+  DECLARE_PACK_SINGLE_TX(tx_s, tx, pack);
+
+  cw_engine_write_lock(engine);
+
+  if (!engine->rooted || solid_transactions == NULL) {
+    goto done;
+  }
+
+  num_candidates = hash243_set_size(&solid_transactions);
+  if ((candidates = (cw_engine_candidate_t *)malloc(num_candidates * sizeof(cw_engine_candidate_t))) == NULL ||
+      (stack = (cw_engine_candidate_t **)malloc(num_candidates * sizeof(cw_engine_candidate_t *))) == NULL) {
+    ret = RC_CONSENSUS_OOM;
+    goto done;
+  }
+  num_candidates = 0;
+  HASH_ITER(hh, solid_transactions, curr_entry, tmp_entry) {
+    if (hash_to_indexed_hash_set_map_contains(&engine->result.tx_to_approvers, curr_entry->hash)) {
+      continue;
+    }
+    pack.num_loaded = 0;
+    if ((ret = iota_tangle_transaction_load_partial(tangle, curr_entry->hash, &pack,
+                                                    PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA)) != RC_OK) {
+      goto done;
+    }
+    if (pack.num_loaded == 0) {
+      continue;
+    }
+    memcpy(candidates[num_candidates].hash, curr_entry->hash, FLEX_TRIT_SIZE_243);
+    memcpy(candidates[num_candidates].trunk, transaction_trunk(tx), FLEX_TRIT_SIZE_243);
+    memcpy(candidates[num_candidates].branch, transaction_branch(tx), FLEX_TRIT_SIZE_243);
+    candidates[num_candidates].state = 0;
+    HASH_ADD(hh, candidates_index, hash, FLEX_TRIT_SIZE_243, &candidates[num_candidates]);
+    num_candidates++;
+  }
+
+  // Transactions of the set may approve each other: they are inserted after their approvees of the set
+  for (i = 0; i < num_candidates; i++) {
+    if (candidates[i].state != 0) {
+      continue;
+    }
+    candidates[i].state = 1;
+    stack[stack_size++] = &candidates[i];
+    while (stack_size > 0) {
+      HASH_FIND(hh, candidates_index, stack[stack_size - 1]->trunk, FLEX_TRIT_SIZE_243, parent);
+      if (parent == NULL || parent->state != 0) {
+        HASH_FIND(hh, candidates_index, stack[stack_size - 1]->branch, FLEX_TRIT_SIZE_243, parent);
+      }
+      if (parent != NULL && parent->state == 0) {
+        parent->state = 1;
+        stack[stack_size++] = parent;
+        continue;
+      }
+      parent = stack[--stack_size];
+      parent->state = 2;
+      if ((hash_to_indexed_hash_set_map_contains(&engine->result.tx_to_approvers, parent->trunk) ||
+           hash_to_indexed_hash_set_map_contains(&engine->result.tx_to_approvers, parent->branch)) &&
+          (ret = cw_engine_insert(engine, parent)) != RC_OK) {
+        goto done;
+      }
+    }
+  }
+
+done:
+  if (ret != RC_OK) {
+    log_error(logger_id, "Failed adding solid transactions, error code is: %" PRIu64 "\n", ret);
+    // The subtangle will be rebuilt by the next calculation
+    cw_engine_clear(engine);
+  }
+  rw_lock_handle_unlock(&engine->lock);
+  HASH_CLEAR(hh, candidates_index);
+  free(stack);
+  free(candidates);
+  return ret;
+}
+
+retcode_t cw_rating_set_deepest_entry_point_incremental(cw_rating_calculator_t const *const cw_calc,
+                                                        flex_trit_t const *const entry_point) {
+  cw_rating_engine_t *engine = cw_calc->engine;
+  retcode_t ret = RC_OK;
+
+  cw_engine_write_lock(engine);
+  // A subtangle not holding the entry point is rooted above it and is left to the next calculation
+  if (engine->rooted && memcmp(engine->root, entry_point, FLEX_TRIT_SIZE_243) != 0 &&
+      hash_to_indexed_hash_set_map_contains(&engine->result.tx_to_approvers, entry_point) &&
+      (ret = cw_engine_reroot(engine, entry_point)) != RC_OK) {
+    log_warning(logger_id, "Failed re-rooting the subtangle, error code is: %" PRIu64 "\n", ret);
+    cw_engine_clear(engine);
+  }
+  rw_lock_handle_unlock(&engine->lock);
+  return ret;
+}
+
+void cw_rating_destroy_incremental(cw_rating_calculator_t *const cw_calc) {
+  if (cw_calc->engine == NULL) {
+    return;
+  }
+  cw_engine_clear(cw_calc->engine);
+  rw_lock_handle_destroy(&cw_calc->engine->lock);
+  lock_handle_destroy(&cw_calc->engine->turnstile);
+  free(cw_calc->engine->stack);
+  free(cw_calc->engine->visits);
+  free(cw_calc->engine->ratings);
+  free(cw_calc->engine->approvees);
+  free(cw_calc->engine);
+  cw_calc->engine = NULL;
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __CONSENSUS_CW_RATING_CALCULATOR_CW_RATING_INCREMENTAL_IMPL_H__
+#define __CONSENSUS_CW_RATING_CALCULATOR_CW_RATING_INCREMENTAL_IMPL_H__
+
+#include "consensus/cw_rating_calculator/cw_rating_calculator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes a calculator keeping the subtangle above the deepest entry point
+ * in memory across calculations
+ *
+ * @param calculator The calculator
+ *
+ * @return a status code
+ */
+retcode_t init_cw_calculator_incremental(cw_rating_calculator_t *const calculator);
+
+/**
+ * @param cw_calc - the calculator
+ * @param entry_point  - where should the rating calculation start from
+ * @param out - a struct containing the ratings and mapping between txs and
+ *              their approvers - both are shared and must be given back with
+ *              iota_consensus_cw_rating_release!!!
+ * @return retcode_t
+ *
+ * The ratings are kept up to date by propagating the weight of each newly
+ * solid transaction backward to the transactions of the subtangle it approves.
+ * Only solid transactions are counted, unlike DFS_FROM_ENTRY_POINT which also
+ * counts stored approvers that are not solid yet.
+ * A cumulative weight does not depend on the entry point: any entry point of
+ * the subtangle is served as is, with the transactions below it, and the
+ * subtangle is only rebuilt from storage as
+ * cw_rating_calculate_dfs_solid_parallel does when the entry point is missing.
+ * The rebuilt subtangle replaces the kept one, so calculations alternating
+ * between entry points that are not in each other's subtangle rebuild every
+ * time and cost more than DFS_FROM_ENTRY_POINT.
+ * Complexity: O(1) for an entry point of the subtangle, (E+V) otherwise and
+ * (E+V) per newly solid transaction
+ */
+extern retcode_t cw_rating_calculate_incremental(cw_rating_calculator_t const *const cw_calc, tangle_t *const tangle,
+                                                 flex_trit_t *entry_point, cw_calc_result *out);
+
+extern void cw_rating_release_incremental(cw_rating_calculator_t const *const cw_calc, cw_calc_result *const result);
+
+extern retcode_t cw_rating_add_solid_transactions_incremental(cw_rating_calculator_t const *const cw_calc,
+                                                              tangle_t *const tangle,
+                                                              hash243_set_t const solid_transactions);
+
+/**
+ * Drops the transactions that are not approving the deepest entry point of the
+ * next calculations, the cumulative weights of the others being unchanged
+ * Complexity: (E+V)
+ */
+extern retcode_t cw_rating_set_deepest_entry_point_incremental(cw_rating_calculator_t const *const cw_calc,
+                                                               flex_trit_t const *const entry_point);
+
+extern void cw_rating_destroy_incremental(cw_rating_calculator_t *const cw_calc);
+
+static cw_calculator_vtable cw_incremental_vtable = {
+    .cw_rating_calculate = cw_rating_calculate_incremental,
+    .cw_rating_release = cw_rating_release_incremental,
+    .cw_rating_add_solid_transactions = cw_rating_add_solid_transactions_incremental,
+    .cw_rating_set_deepest_entry_point = cw_rating_set_deepest_entry_point_incremental,
+    .cw_rating_destroy = cw_rating_destroy_incremental,
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  //__CONSENSUS_CW_RATING_CALCULATOR_CW_RATING_INCREMENTAL_IMPL_H__
@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "consensus/cw_rating_calculator/subtangle_graph.h"
+#include "utils/handles/thread.h"
+#include "utils/macros.h"
+
+static atomic_uint_fast64_t last_generation = 0;
+
+static void subtangle_graph_touch(subtangle_graph_t *const graph) {
+  graph->generation = atomic_fetch_add_explicit(&last_generation, 1, memory_order_relaxed) + 1;
+}
+
+static retcode_t subtangle_graph_reserve(subtangle_graph_t *const graph, uint32_t const capacity) {
+  void *tmp = NULL;
+
+  if (capacity <= graph->capacity) {
+    return RC_OK;
+  }
+  if ((tmp = realloc(graph->hashes, capacity * sizeof(*graph->hashes))) == NULL) {
+    return RC_CONSENSUS_OOM;
+  }
+  graph->hashes = tmp;
+  if ((tmp = realloc(graph->cw_ratings, capacity * sizeof(*graph->cw_ratings))) == NULL) {
+    return RC_CONSENSUS_OOM;
+  }
+  graph->cw_ratings = tmp;
+  if ((tmp = realloc(graph->approvers, capacity * sizeof(*graph->approvers))) == NULL) {
+    return RC_CONSENSUS_OOM;
+  }
+  graph->approvers = tmp;
+  memset(graph->approvers + graph->capacity, 0, (capacity - graph->capacity) * sizeof(*graph->approvers));
+  graph->capacity = capacity;
+  return RC_OK;
+}
+
+retcode_t subtangle_graph_add_vertex(subtangle_graph_t *const graph, flex_trit_t const *const hash,
+                                     uint32_t *const id) {
+  retcode_t ret = RC_OK;
+
+  if (graph->num_vertices == graph->capacity &&
+      (ret = subtangle_graph_reserve(graph, MAX(64, 2 * graph->capacity))) != RC_OK) {
+    return ret;
+  }
+  *id = graph->num_vertices++;
+  memcpy(graph->hashes[*id], hash, FLEX_TRIT_SIZE_243);
+  graph->cw_ratings[*id] = 1;
+  graph->approvers[*id].size = 0;
+  subtangle_graph_touch(graph);
+  return RC_OK;
+}
+
+retcode_t subtangle_graph_add_approver(subtangle_graph_t *const graph, uint32_t const id, uint32_t const approver) {
+  subtangle_graph_edges_t *edges = &graph->approvers[id];
+  uint32_t *tmp = NULL;
+
+  if (edges->size == edges->capacity) {
+    if ((tmp = (uint32_t *)realloc(edges->ids, MAX(2, 2 * edges->capacity) * sizeof(uint32_t))) == NULL) {
+      return RC_CONSENSUS_OOM;
+    }
+    edges->ids = tmp;
+    edges->capacity = MAX(2, 2 * edges->capacity);
+  }
+  edges->ids[edges->size++] = approver;
+  subtangle_graph_touch(graph);
+  return RC_OK;
+}
+
+retcode_t subtangle_graph_post_order(subtangle_graph_t const *const graph, uint32_t const from, uint32_t *const order,
+                                     uint32_t *const num_ordered) {
+  size_t words = bistset_required_size(graph->num_vertices);
+  uint64_t *visited_raw_bits = NULL;
+  uint32_t *stack = NULL;
+  uint32_t *cursors = NULL;
+  size_t stack_size = 0;
+  uint32_t root, top, approver;
+  retcode_t ret = RC_OK;
+
+  *num_ordered = 0;
+  if ((visited_raw_bits = (uint64_t *)calloc(words, sizeof(uint64_t))) == NULL ||
+      (stack = (uint32_t *)malloc(MAX(1, graph->num_vertices) * sizeof(uint32_t))) == NULL ||
+      (cursors = (uint32_t *)malloc(MAX(1, graph->num_vertices) * sizeof(uint32_t))) == NULL) {
+    ret = RC_CONSENSUS_OOM;
+    goto done;
+  }
+  bitset_t visited = {
+      .raw_bits = visited_raw_bits, .bitset_integer_index = 0, .bitset_relative_index = 0, .size = words};
+
+  for (root = (from == SUBTANGLE_GRAPH_NO_VERTEX ? 0 : from); root < graph->num_vertices; root++) {
+    if (bitset_is_set(&visited, root)) {
+      continue;
+    }
+    bitset_set_true(&visited, root);
+    stack[stack_size] = root;
+    cursors[stack_size++] = 0;
+    while (stack_size > 0) {
+      top = stack[stack_size - 1];
+      if (cursors[stack_size - 1] < graph->approvers[top].size) {
+        approver = graph->approvers[top].ids[cursors[stack_size - 1]++];
+        if (!bitset_is_set(&visited, approver)) {
+          bitset_set_true(&visited, approver);
+          stack[stack_size] = approver;
+          cursors[stack_size++] = 0;
+        }
+        continue;
+      }
+      order[(*num_ordered)++] = top;
+      stack_size--;
+    }
+    if (from != SUBTANGLE_GRAPH_NO_VERTEX) {
+      break;
+    }
+  }
+
+done:
+  free(cursors);
+  free(stack);
+  free(visited_raw_bits);
+  return ret;
+}
+
+typedef struct subtangle_graph_cones_worker_s {
+  subtangle_graph_t const *graph;
+  uint32_t const *order;
+  size_t first_word;
+  size_t last_word;
+  size_t block_words;
+  int64_t *cw_ratings;
+  retcode_t ret;
+} subtangle_graph_cones_worker_t;
+
+/**
+ * Adds to each cumulative weight the size of the intersection of the future
+ * cone with the ids of words [first_word, last_word)
+ */
+static retcode_t subtangle_graph_count_cones(subtangle_graph_t const *const graph, uint32_t const *const order,
+                                             size_t const first_word, size_t const last_word,
+                                             size_t const block_words, int64_t *const cw_ratings) {
+  uint64_t *cones = NULL;
+  size_t block_first_word, size, base, i;
+  uint32_t k, vertex;
+
+  if (first_word >= last_word) {
+    return RC_OK;
+  }
+  if ((cones = (uint64_t *)malloc(graph->num_vertices * block_words * sizeof(uint64_t))) == NULL) {
+    return RC_CONSENSUS_OOM;
+  }
+
+  // Each block holds the intersection of the future cones with a range of ids
+  for (block_first_word = first_word; block_first_word < last_word; block_first_word += block_words) {
+    size = MIN(block_words, last_word - block_first_word);
+    base = block_first_word * 64;
+    memset(cones, 0, graph->num_vertices * size * sizeof(uint64_t));
+    for (k = 0; k < graph->num_vertices; k++) {
+      vertex = order[k];
+      bitset_t cone = {.raw_bits = cones + vertex * size, .bitset_integer_index = 0, .bitset_relative_index = 0,
+                       .size = size};
+      if (vertex >= base && vertex < base + size * 64) {
+        bitset_set_true(&cone, vertex - base);
+      }
+      for (i = 0; i < graph->approvers[vertex].size; i++) {
+        bitset_t approver_cone = {.raw_bits = cones + graph->approvers[vertex].ids[i] * size,
+                                  .bitset_integer_index = 0,
+                                  .bitset_relative_index = 0,
+                                  .size = size};
+        bitset_or(&cone, &approver_cone);
+      }
+      cw_ratings[vertex] += bitset_count(&cone);
+    }
+  }
+
+  free(cones);
+  return RC_OK;
+}
+
+static void *subtangle_graph_cones_worker(void *arg) {
+  subtangle_graph_cones_worker_t *worker = (subtangle_graph_cones_worker_t *)arg;
+
+  worker->ret = subtangle_graph_count_cones(worker->graph, worker->order, worker->first_word, worker->last_word,
+                                            worker->block_words, worker->cw_ratings);
+  return NULL;
+}
+
+retcode_t subtangle_graph_compute_cw_ratings(subtangle_graph_t *const graph) {
+  return subtangle_graph_compute_cw_ratings_parallel(graph, 1);
+}
+
+retcode_t subtangle_graph_compute_cw_ratings_parallel(subtangle_graph_t *const graph, size_t num_workers) {
+  size_t words = bistset_required_size(graph->num_vertices);
+  size_t words_per_worker, block_words, w;
+  uint32_t *order = NULL;
+  int64_t *workers_cw_ratings = NULL;
+  uint32_t num_ordered = 0;
+  uint32_t vertex;
+  retcode_t ret = RC_OK;
+
+  if (graph->num_vertices == 0) {
+    return RC_OK;
+  }
+
+  num_workers = MAX(1, MIN(num_workers, words));
+  words_per_worker = (words + num_workers - 1) / num_workers;
+  num_workers = (words + words_per_worker - 1) / words_per_worker;
+  block_words = MIN(words_per_worker, MAX(1, SUBTANGLE_GRAPH_CONES_MAX_WORDS / graph->num_vertices));
+  subtangle_graph_cones_worker_t workers[num_workers];
+  thread_handle_t threads[num_workers];
+  bool started[num_workers];
+
+  if ((order = (uint32_t *)malloc(graph->num_vertices * sizeof(uint32_t))) == NULL ||
+      (num_workers > 1 && (workers_cw_ratings = (int64_t *)calloc((num_workers - 1) * graph->num_vertices,
+                                                                   sizeof(int64_t))) == NULL)) {
+    ret = RC_CONSENSUS_OOM;
+    goto done;
+  }
+  if ((ret = subtangle_graph_post_order(graph, SUBTANGLE_GRAPH_NO_VERTEX, order, &num_ordered)) != RC_OK) {
+    goto done;
+  }
+  memset(graph->cw_ratings, 0, graph->num_vertices * sizeof(int64_t));
+
+  // Workers count disjoint ranges of ids, the first one in the calling thread
+  for (w = 0; w < num_workers; w++) {
+    workers[w] = (subtangle_graph_cones_worker_t){
+        .graph = graph,
+        .order = order,
+        .first_word = w * words_per_worker,
+        .last_word = MIN(words, (w + 1) * words_per_worker),
+        .block_words = block_words,
+        .cw_ratings = w == 0 ? graph->cw_ratings : workers_cw_ratings + (w - 1) * graph->num_vertices,
+        .ret = RC_OK,
+    };
+    started[w] = w > 0 && thread_handle_create(&threads[w], subtangle_graph_cones_worker, &workers[w]) == 0;
+  }
+  for (w = 0; w < num_workers; w++) {
+    if (!started[w]) {
+      subtangle_graph_cones_worker(&workers[w]);
+    }
+  }
+  for (w = 0; w < num_workers; w++) {
+    if (started[w]) {
+      thread_handle_join(threads[w], NULL);
+    }
+    if (workers[w].ret != RC_OK) {
+      ret = workers[w].ret;
+    }
+  }
+  if (ret != RC_OK) {
+    goto done;
+  }
+
+  for (w = 1; w < num_workers; w++) {
+    for (vertex = 0; vertex < graph->num_vertices; vertex++) {
+      graph->cw_ratings[vertex] += workers_cw_ratings[(w - 1) * graph->num_vertices + vertex];
+    }
+  }
+
+done:
+  subtangle_graph_touch(graph);
+  free(workers_cw_ratings);
+  free(order);
+  return ret;
+}
+
+retcode_t subtangle_graph_future_cone(subtangle_graph_t const *const graph, uint32_t const id,
+                                      bitset_t *const reached) {
+  uint32_t *stack = NULL;
+  size_t stack_size = 0;
+  uint32_t top, i;
+
+  if ((stack = (uint32_t *)malloc(graph->num_vertices * sizeof(uint32_t))) == NULL) {
+    return RC_CONSENSUS_OOM;
+  }
+  if (!bitset_is_set(reached, id)) {
+    bitset_set_true(reached, id);
+    stack[stack_size++] = id;
+  }
+  while (stack_size > 0) {
+    top = stack[--stack_size];
+    for (i = 0; i < graph->approvers[top].size; i++) {
+      if (!bitset_is_set(reached, graph->approvers[top].ids[i])) {
+        bitset_set_true(reached, graph->approvers[top].ids[i]);
+        stack[stack_size++] = graph->approvers[top].ids[i];
+      }
+    }
+  }
+  free(stack);
+  return RC_OK;
+}
+
+void subtangle_graph_keep(subtangle_graph_t *const graph, bitset_t *const kept, uint32_t *const new_ids) {
+  uint32_t num_kept = 0;
+  uint32_t id, new_id, i, j;
+
+  for (id = 0; id < graph->num_vertices; id++) {
+    new_ids[id] = bitset_is_set(kept, id) ? num_kept++ : SUBTANGLE_GRAPH_NO_VERTEX;
+  }
+  for (id = 0; id < graph->num_vertices; id++) {
+    if ((new_id = new_ids[id]) == SUBTANGLE_GRAPH_NO_VERTEX) {
+      free(graph->approvers[id].ids);
+      continue;
+    }
+    for (i = 0, j = 0; i < graph->approvers[id].size; i++) {
+      if (new_ids[graph->approvers[id].ids[i]] != SUBTANGLE_GRAPH_NO_VERTEX) {
+        graph->approvers[id].ids[j++] = new_ids[graph->approvers[id].ids[i]];
+      }
+    }
+    graph->approvers[id].size = j;
+    if (new_id != id) {
+      memcpy(graph->hashes[new_id], graph->hashes[id], FLEX_TRIT_SIZE_243);
+      graph->cw_ratings[new_id] = graph->cw_ratings[id];
+      graph->approvers[new_id] = graph->approvers[id];
+    }
+  }
+  memset(graph->approvers + num_kept, 0, (graph->num_vertices - num_kept) * sizeof(*graph->approvers));
+  graph->num_vertices = num_kept;
+  subtangle_graph_touch(graph);
+}
+
+void subtangle_graph_free(subtangle_graph_t *const graph) {
+  uint32_t id;
+
+  for (id = 0; id < graph->capacity; id++) {
+    free(graph->approvers[id].ids);
+  }
+  free(graph->approvers);
+  free(graph->cw_ratings);
+  free(graph->hashes);
+  memset(graph, 0, sizeof(subtangle_graph_t));
+}
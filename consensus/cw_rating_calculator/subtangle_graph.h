@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __CONSENSUS_CW_RATING_CALCULATOR_SUBTANGLE_GRAPH_H__
+#define __CONSENSUS_CW_RATING_CALCULATOR_SUBTANGLE_GRAPH_H__
+
+#include <stdint.h>
+
+#include "common/errors.h"
+#include "common/trinary/flex_trit.h"
+#include "utils/containers/bitset.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SUBTANGLE_GRAPH_NO_VERTEX UINT32_MAX
+
+// Maximum number of 64 bits words of future cones held by each thread computing cumulative weights: 16 MB per thread,
+// up to 256 MB with CW_RATING_DFS_MAX_WORKERS threads of 16
+#ifndef SUBTANGLE_GRAPH_CONES_MAX_WORDS
+#define SUBTANGLE_GRAPH_CONES_MAX_WORDS (1 << 21)
+#endif
+
+typedef struct subtangle_graph_edges_s {
+  uint32_t *ids;
+  uint32_t size;
+  uint32_t capacity;
+} subtangle_graph_edges_t;
+
+/**
+ * Transactions of a subtangle identified by dense ids, from 0 to num_vertices - 1,
+ * with the ids of their approvers in adjacency arrays
+ * A zeroed graph is an empty graph
+ */
+typedef struct subtangle_graph_s {
+  uint32_t num_vertices;
+  uint32_t capacity;
+  // Hash of each vertex
+  flex_trit_t (*hashes)[FLEX_TRIT_SIZE_243];
+  // Cumulative weight of each vertex
+  int64_t *cw_ratings;
+  // Approvers of each vertex
+  subtangle_graph_edges_t *approvers;
+  // Changes, to a value no other graph ever had, whenever vertices, approvers
+  // or cumulative weights change so that data derived from them can be cached
+  uint64_t generation;
+} subtangle_graph_t;
+
+/**
+ * Adds a vertex without approvers and with a cumulative weight of 1
+ *
+ * @param graph The graph
+ * @param hash The hash of the transaction
+ * @param id The id of the vertex
+ *
+ * @return a status code
+ */
+retcode_t subtangle_graph_add_vertex(subtangle_graph_t *const graph, flex_trit_t const *const hash,
+                                     uint32_t *const id);
+
+/**
+ * Adds an approver to a vertex
+ *
+ * @param graph The graph
+ * @param id The approved vertex
+ * @param approver The approving vertex
+ *
+ * @return a status code
+ */
+retcode_t subtangle_graph_add_approver(subtangle_graph_t *const graph, uint32_t const id, uint32_t const approver);
+
+/**
+ * Orders vertices so that each one comes after all its approvers
+ *
+ * @param graph The graph
+ * @param from The vertex whose future cone is ordered, SUBTANGLE_GRAPH_NO_VERTEX for all vertices
+ * @param order The ordered vertices, at least num_vertices entries
+ * @param num_ordered The number of ordered vertices
+ *
+ * @return a status code
+ */
+retcode_t subtangle_graph_post_order(subtangle_graph_t const *const graph, uint32_t const from, uint32_t *const order,
+                                     uint32_t *const num_ordered);
+
+/**
+ * Computes the cumulative weight of every vertex, the size of its future cone
+ * Future cones are bitsets ORed from the approvers of each vertex, by blocks
+ * of at most SUBTANGLE_GRAPH_CONES_MAX_WORDS words
+ * Complexity: (E+V) * V / 64
+ *
+ * @param graph The graph
+ *
+ * @return a status code
+ */
+retcode_t subtangle_graph_compute_cw_ratings(subtangle_graph_t *const graph);
+
+/**
+ * Computes the cumulative weight of every vertex as
+ * subtangle_graph_compute_cw_ratings does, each worker thread computing the
+ * future cones restricted to its own range of ids
+ * The worker threads are started and joined by each call
+ * Each worker uses at most SUBTANGLE_GRAPH_CONES_MAX_WORDS words, i.e.
+ * num_workers * SUBTANGLE_GRAPH_CONES_MAX_WORDS * 8 bytes in total, so that
+ * workers do fewer passes over the graph as their number grows
+ *
+ * @param graph The graph
+ * @param num_workers The maximum number of worker threads, the calling thread
+ *                    included
+ *
+ * @return a status code
+ */
+retcode_t subtangle_graph_compute_cw_ratings_parallel(subtangle_graph_t *const graph, size_t num_workers);
+
+/**
+ * Sets the bits of the vertices approving a vertex, directly or indirectly,
+ * and of the vertex itself
+ *
+ * @param graph The graph
+ * @param id The vertex
+ * @param reached A bitset of at least num_vertices bits
+ *
+ * @return a status code
+ */
+retcode_t subtangle_graph_future_cone(subtangle_graph_t const *const graph, uint32_t const id,
+                                      bitset_t *const reached);
+
+/**
+ * Drops the vertices that are not kept and renumbers the others, keeping
+ * their order
+ * The approvers of a kept vertex must be kept
+ *
+ * @param graph The graph
+ * @param kept The vertices to keep
+ * @param new_ids The new id of each vertex, SUBTANGLE_GRAPH_NO_VERTEX for the
+ *                dropped ones, num_vertices entries
+ */
+void subtangle_graph_keep(subtangle_graph_t *const graph, bitset_t *const kept, uint32_t *const new_ids);
+
+void subtangle_graph_free(subtangle_graph_t *const graph);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __CONSENSUS_CW_RATING_CALCULATOR_SUBTANGLE_GRAPH_H__
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/*
+ * Measures the cumulative weight calculation over a synthetic tangle: every
+ * transaction approves two random transactions among the previous ones, at
+ * most a window away, the oldest one being the entry point.
+ * The full calculations of the sequential and parallel DFS implementations
+ * are reported first, storage loads included. Then the future cones pass
+ * alone is timed for a growing number of workers, each one being checked
+ * against the sequential cumulative weights.
+ *
+ * Usage: bench_cw_rating [-n transactions] [-w window] [-r repetitions]
+ * [-m max workers] (defaults to 10000 transactions, a window of 100, 5
+ * repetitions and cw_rating_dfs_num_workers() workers)
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "common/model/transaction.h"
+#include "common/storage/storage.h"
+#include "common/storage/tests/helpers/defs.h"
+#include "consensus/cw_rating_calculator/cw_rating_calculator.h"
+#include "consensus/cw_rating_calculator/cw_rating_dfs_impl.h"
+#include "consensus/test_utils/tangle.h"
+#include "utils/macros.h"
+#include "utils/time.h"
+
+#define BENCH_DEFAULT_NUM_TXS 10000
+#define BENCH_DEFAULT_WINDOW 100
+#define BENCH_DEFAULT_REPETITIONS 5
+
+static char *test_db_path = "consensus/cw_rating_calculator/tests/test.db";
+static char *ciri_db_path = "consensus/cw_rating_calculator/tests/ciri.db";
+
+static tangle_t tangle;
+static connection_config_t config;
+
+static int bench_calculate(char const *const name, cw_calculation_implementation_t const impl,
+                           flex_trit_t *const ep, size_t const repetitions) {
+  cw_rating_calculator_t calc;
+  cw_calc_result out;
+  uint64_t start, best = UINT64_MAX;
+
+  if (iota_consensus_cw_rating_init(&calc, impl) != RC_OK) {
+    return EXIT_FAILURE;
+  }
+  for (size_t r = 0; r < repetitions; r++) {
+    start = current_timestamp_us();
+    if (iota_consensus_cw_rating_calculate(&calc, &tangle, ep, &out) != RC_OK) {
+      fprintf(stderr, "Calculation of %s failed\n", name);
+      return EXIT_FAILURE;
+    }
+    best = MIN(best, current_timestamp_us() - start);
+    iota_consensus_cw_rating_release(&calc, &out);
+  }
+  iota_consensus_cw_rating_destroy(&calc);
+
+  printf("%-24s %10.2f ms\n", name, best / 1000.0);
+  return EXIT_SUCCESS;
+}
+
+static int bench_cones(flex_trit_t *const ep, size_t const repetitions, size_t const max_workers) {
+  cw_rating_calculator_t calc;
+  cw_calc_result out;
+  int64_t *expected = NULL;
+  uint64_t start, best, sequential = 0;
+  int ret = EXIT_SUCCESS;
+
+  if (iota_consensus_cw_rating_init(&calc, DFS_FROM_ENTRY_POINT) != RC_OK ||
+      iota_consensus_cw_rating_calculate(&calc, &tangle, ep, &out) != RC_OK) {
+    return EXIT_FAILURE;
+  }
+  if ((expected = (int64_t *)malloc(out.graph.num_vertices * sizeof(int64_t))) == NULL) {
+    ret = EXIT_FAILURE;
+    goto done;
+  }
+  memcpy(expected, out.graph.cw_ratings, out.graph.num_vertices * sizeof(int64_t));
+
+  printf("Future cones of %" PRIu32 " transactions\n", out.graph.num_vertices);
+  for (size_t workers = 1;; workers = MIN(2 * workers, max_workers)) {
+    best = UINT64_MAX;
+    for (size_t r = 0; r < repetitions; r++) {
+      start = current_timestamp_us();
+      if (subtangle_graph_compute_cw_ratings_parallel(&out.graph, workers) != RC_OK) {
+        ret = EXIT_FAILURE;
+        goto done;
+      }
+      best = MIN(best, current_timestamp_us() - start);
+    }
+    if (memcmp(expected, out.graph.cw_ratings, out.graph.num_vertices * sizeof(int64_t)) != 0) {
+      fprintf(stderr, "Cumulative weights of %zu workers differ from the sequential ones\n", workers);
+      ret = EXIT_FAILURE;
+      goto done;
+    }
+    if (workers == 1) {
+      sequential = best;
+    }
+    printf("%3zu workers %10.2f ms, speedup %5.2f\n", workers, best / 1000.0, (double)sequential / MAX(1, best));
+    if (workers == max_workers) {
+      break;
+    }
+  }
+
+done:
+  free(expected);
+  iota_consensus_cw_rating_release(&calc, &out);
+  iota_consensus_cw_rating_destroy(&calc);
+  return ret;
+}
+
+int main(int argc, char *argv[]) {
+  size_t num_txs = BENCH_DEFAULT_NUM_TXS;
+  size_t window = BENCH_DEFAULT_WINDOW;
+  size_t repetitions = BENCH_DEFAULT_REPETITIONS;
+  size_t max_workers = cw_rating_dfs_num_workers();
+  tryte_t const *tx_trytes[] = {TEST_TX_TRYTES};
+  iota_transaction_t *tx = NULL;
+  iota_transaction_t *txs = NULL;
+  int opt = 0, ret = EXIT_FAILURE;
+
+  while ((opt = getopt(argc, argv, "n:w:r:m:")) != -1) {
+    switch (opt) {
+      case 'n':
+        num_txs = MAX(1, strtoull(optarg, NULL, 10));
+        break;
+      case 'w':
+        window = MAX(1, strtoull(optarg, NULL, 10));
+        break;
+      case 'r':
+        repetitions = MAX(1, strtoull(optarg, NULL, 10));
+        break;
+      case 'm':
+        max_workers = MAX(1, strtoull(optarg, NULL, 10));
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-n transactions] [-w window] [-r repetitions] [-m max workers]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+  }
+
+  config.db_path = test_db_path;
+  if (storage_init() != RC_OK || tangle_setup(&tangle, &config, test_db_path, ciri_db_path) != RC_OK) {
+    fprintf(stderr, "Setting up the tangle failed\n");
+    return EXIT_FAILURE;
+  }
+  srand(42);
+  transactions_deserialize(tx_trytes, &tx, 1, true);
+  if (tx == NULL || (txs = (iota_transaction_t *)malloc(num_txs * sizeof(iota_transaction_t))) == NULL ||
+      build_random_tangle(&tangle, tx, txs, num_txs, window, false, 0) != RC_OK) {
+    fprintf(stderr, "Building the tangle failed\n");
+    goto done;
+  }
+
+  printf("Tangle of %zu transactions, window of %zu\n", num_txs, window);
+  if (bench_calculate("dfs", DFS_FROM_ENTRY_POINT, transaction_hash(&txs[0]), repetitions) != EXIT_SUCCESS ||
+      bench_calculate("dfs_parallel", DFS_FROM_ENTRY_POINT_PARALLEL, transaction_hash(&txs[0]), repetitions) !=
+          EXIT_SUCCESS ||
+      bench_cones(transaction_hash(&txs[0]), repetitions, max_workers) != EXIT_SUCCESS) {
+    goto done;
+  }
+  ret = EXIT_SUCCESS;
+
+done:
+  free(txs);
+  transaction_free(tx);
+  tangle_cleanup(&tangle, test_db_path);
+  storage_destroy();
+  return ret;
+}
@@ -7,6 +7,7 @@
 
 #include <inttypes.h>
 #include <math.h>
+#include <stdlib.h>
 
 #include "consensus/exit_probability_randomizer/exit_prob_map.h"
 #include "consensus/exit_probability_randomizer/global_calcs.h"
@@ -22,16 +23,6 @@ static logger_id_t logger_id;
  * Private functions
  */
 
-static void iota_consensus_exit_prob_map_add_exit_probs(hash_to_double_map_t **const hash_to_probs,
-                                                        flex_trit_t const *const hash, double value) {
-  hash_to_double_map_entry_t *curr_approver_entry = NULL;
-  if (hash_to_double_map_find(*hash_to_probs, hash, &curr_approver_entry)) {
-    curr_approver_entry->value += value;
-  } else {
-    hash_to_double_map_add(*hash_to_probs, hash, value);
-  }
-}
-
 static retcode_t iota_consensus_exit_prob_remove_invalid_tip_candidates(
     tangle_t *const tangle, cw_calc_result *const cw_result, exit_prob_transaction_validator_t *const ep_validator) {
   retcode_t ret = RC_OK;
@@ -87,23 +78,23 @@ retcode_t iota_consensus_exit_prob_map_randomize(ep_randomizer_t const *const ra
     }
   }
 
-  hash243_set_t tips = NULL;
-  iota_consensus_exit_prob_map_eps_extract_tips(cw_result, &tips);
+  subtangle_graph_t const *const graph = &cw_result->graph;
   // Randomizes uniformly a value between 0 to 1
   double rand_weight = rand_handle_probability();
-  hash243_set_entry_t *tip_entry = NULL;
-  hash243_set_entry_t *tip_tmp_entry = NULL;
   hash_to_double_map_entry_t *curr_ep = NULL;
+  uint32_t id;
 
-  HASH_ITER(hh, tips, tip_entry, tip_tmp_entry) {
-    hash_to_double_map_find(&prob_randomizer->exit_probs, tip_entry->hash, &curr_ep);
+  for (id = 0; id < graph->num_vertices; id++) {
+    if (graph->approvers[id].size > 0 || !hash_to_double_map_find(&prob_randomizer->exit_probs, graph->hashes[id],
+                                                                    &curr_ep)) {
+      continue;
+    }
     rand_weight -= curr_ep->value;
     if (rand_weight <= 0) {
-      memcpy(tip, tip_entry->hash, FLEX_TRIT_SIZE_243);
+      memcpy(tip, graph->hashes[id], FLEX_TRIT_SIZE_243);
       break;
     }
   }
-  hash243_set_free(&tips);
   return RC_OK;
 }
 
@@ -115,14 +106,13 @@ retcode_t iota_consensus_exit_prob_map_calculate_probs(ep_randomizer_t const *co
                                                        hash_to_double_map_t *const hash_to_trans_probs) {
   retcode_t ret;
   bool ep_is_valid = false;
-  hash243_queue_t queue = NULL;
-  hash_to_indexed_hash_set_entry_t *aps = NULL;
-  hash_to_double_map_entry_t *curr_tx_entry = NULL;
-  hash243_set_entry_t *approver_entry = NULL;
-  hash243_set_entry_t *tmp_entry = NULL;
+  subtangle_graph_t const *const graph = &cw_result->graph;
+  hash_to_indexed_hash_set_entry_t *ep_entry = NULL;
+  uint32_t *order = NULL;
+  double *probs = NULL;
+  uint32_t num_ordered = 0;
+  uint32_t k, id, i;
   size_t num_approvers;
-  size_t approver_idx;
-  flex_trit_t *curr_tx;
 
   if ((ret = iota_consensus_exit_prob_transaction_validator_is_valid(ep_validator, tangle, ep, &ep_is_valid)) !=
       RC_OK) {
@@ -137,50 +127,61 @@ retcode_t iota_consensus_exit_prob_map_calculate_probs(ep_randomizer_t const *co
     return ret;
   }
 
-  hash_to_double_map_add(hash_to_trans_probs, ep, 1);
-  hash_to_double_map_add(hash_to_exit_probs, ep, 1);
-  hash243_queue_push(&queue, ep);
+  HASH_FIND(hh, cw_result->tx_to_approvers, ep, FLEX_TRIT_SIZE_243, ep_entry);
+  if (ep_entry == NULL) {
+    hash_to_double_map_add(hash_to_trans_probs, ep, 1);
+    return hash_to_double_map_add(hash_to_exit_probs, ep, 1);
+  }
+
+  if ((order = (uint32_t *)malloc(MAX(1, graph->num_vertices) * sizeof(uint32_t))) == NULL ||
+      (probs = (double *)calloc(MAX(1, graph->num_vertices), sizeof(double))) == NULL) {
+    ret = RC_CONSENSUS_OOM;
+    goto done;
+  }
+  if ((ret = subtangle_graph_post_order(graph, ep_entry->idx, order, &num_ordered)) != RC_OK) {
+    goto done;
+  }
 
-  while (hash243_queue_count(queue)) {
-    curr_tx = hash243_queue_peek(queue);
-    hash_to_indexed_hash_set_map_find(&cw_result->tx_to_approvers, curr_tx, &aps);
-    hash_to_double_map_find(hash_to_exit_probs, curr_tx, &curr_tx_entry);
-    num_approvers = hash243_set_size(&aps->approvers);
+  // In reverse post-order every transaction has received the probabilities of all its approvees before giving its own
+  probs[ep_entry->idx] = 1;
+  for (k = num_ordered; k-- > 0;) {
+    id = order[k];
+    if ((num_approvers = graph->approvers[id].size) == 0) {
+      continue;
+    }
     double trans_probs_to_direct_approvers[num_approvers];
-    map_transition_probabilities(exit_probability_randomizer->conf->alpha, cw_result->cw_ratings, &aps->approvers,
-                                 trans_probs_to_direct_approvers);
-    approver_idx = 0;
-    HASH_ITER(hh, aps->approvers, approver_entry, tmp_entry) {
-      iota_consensus_exit_prob_map_add_exit_probs(
-          &hash_to_exit_probs, approver_entry->hash,
-          (trans_probs_to_direct_approvers[approver_idx] * curr_tx_entry->value));
-      iota_consensus_exit_prob_map_add_exit_probs(
-          &hash_to_trans_probs, approver_entry->hash,
-          (trans_probs_to_direct_approvers[approver_idx] * curr_tx_entry->value));
-      hash243_queue_push(&queue, approver_entry->hash);
-      approver_idx++;
+    map_transition_probabilities(exit_probability_randomizer->conf->alpha, graph, graph->approvers[id].ids,
+                                 num_approvers, trans_probs_to_direct_approvers);
+    for (i = 0; i < num_approvers; i++) {
+      probs[graph->approvers[id].ids[i]] += trans_probs_to_direct_approvers[i] * probs[id];
     }
+  }
 
-    if (!iota_consensus_is_tx_a_tip(&cw_result->tx_to_approvers, curr_tx)) {
-      curr_tx_entry->value = 0;
+  for (k = 0; k < num_ordered; k++) {
+    id = order[k];
+    if ((ret = hash_to_double_map_add(hash_to_trans_probs, graph->hashes[id], probs[id])) != RC_OK ||
+        (ret = hash_to_double_map_add(hash_to_exit_probs, graph->hashes[id],
+                                      graph->approvers[id].size == 0 ? probs[id] : 0)) != RC_OK) {
+      goto done;
     }
-
-    hash243_queue_pop(&queue);
   }
-  hash243_queue_free(&queue);
-  return RC_OK;
+
+done:
+  free(probs);
+  free(order);
+  return ret;
 }
 
 void iota_consensus_exit_prob_map_eps_extract_tips(cw_calc_result *const cw_result, hash243_set_t *const tips) {
-  hash_to_indexed_hash_set_entry_t *curr_hash_to_approvers_entry = NULL;
-  hash_to_indexed_hash_set_entry_t *tmp_hash_to_approvers_entry = NULL;
-  HASH_ITER(hh, cw_result->tx_to_approvers, curr_hash_to_approvers_entry, tmp_hash_to_approvers_entry) {
-    if (iota_consensus_is_tx_a_tip(&cw_result->tx_to_approvers, curr_hash_to_approvers_entry->hash)) {
-      hash243_set_add(tips, curr_hash_to_approvers_entry->hash);
+  subtangle_graph_t const *const graph = &cw_result->graph;
+  uint32_t id;
+
+  for (id = 0; id < graph->num_vertices; id++) {
+    if (graph->approvers[id].size == 0) {
+      hash243_set_add(tips, graph->hashes[id]);
     }
   }
 }
-
 double iota_consensus_exit_prob_map_sum_probs(hash_to_double_map_t *const hash_to_probs) {
   double sum = 0;
   hash_to_double_map_entry_t *exit_prob_entry = NULL;
@@ -20,10 +20,13 @@ retcode_t iota_consensus_ep_randomizer_init(ep_randomizer_t *const ep_randomizer
   logger_id = logger_helper_enable(EXIT_PROBABILITY_RANDOMIZER_LOGGER_ID, LOGGER_DEBUG, true);
   rand_handle_seed(time(NULL));
   ep_randomizer->conf = conf;
+  ep_randomizer->engine = NULL;
   if (impl == EP_RANDOM_WALK) {
     iota_consensus_random_walker_init(ep_randomizer);
   } else if (impl == EP_RANDOMIZE_MAP_AND_SAMPLE) {
     iota_consensus_exit_prob_map_init(ep_randomizer);
+  } else if (impl == EP_RANDOM_WALK_ALIAS) {
+    return iota_consensus_random_walker_alias_init(ep_randomizer);
   } else if (impl == EP_NO_IMPLEMENTATION) {
     return RC_CONSENSUS_NOT_IMPLEMENTED;
   }
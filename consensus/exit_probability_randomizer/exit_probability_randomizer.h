@@ -22,11 +22,15 @@ extern "C" {
 // Forward declarations
 typedef struct ep_randomizer_base_s ep_randomizer_base_t;
 typedef struct ep_randomizer_s ep_randomizer_t;
+typedef struct ep_randomizer_engine_s ep_randomizer_engine_t;
 
 typedef enum ep_randomizer_implementation_e {
   EP_NO_IMPLEMENTATION,
   EP_RANDOM_WALK,
   EP_RANDOMIZE_MAP_AND_SAMPLE,
+  /// EP_RANDOM_WALK sampling approvers in O(1) from alias tables built once
+  /// per cumulative weights
+  EP_RANDOM_WALK_ALIAS,
 } ep_randomizer_implementation_t;
 
 typedef struct {
@@ -46,6 +50,8 @@ struct ep_randomizer_base_s {
 struct ep_randomizer_s {
   ep_randomizer_base_t base;
   iota_consensus_conf_t *conf;
+  // State kept across randomizations, NULL for stateless implementations
+  ep_randomizer_engine_t *engine;
 };
 
 extern retcode_t iota_consensus_ep_randomizer_init(ep_randomizer_t *const ep_randomizer,
@@ -9,22 +9,16 @@
 #include <math.h>
 #include "utils/macros.h"
 
-retcode_t map_transition_probabilities(double alpha, hash_to_int64_t_map_t const cw_ratings,
-                                       hash243_set_t const *const approvers, double transition_probs[]) {
-  hash243_set_entry_t *curr_approver = NULL;
-  hash243_set_entry_t *tmp_approver = NULL;
-  hash_to_int64_t_map_entry_t const *curr_rating = NULL;
-  size_t num_approvers = hash243_set_size(approvers);
+retcode_t map_transition_probabilities(double alpha, subtangle_graph_t const *const graph,
+                                       uint32_t const *const approvers, size_t const num_approvers,
+                                       double transition_probs[]) {
   double sum_transition_probabilities = 0;
   double max_weight = 0;
   size_t idx = 0;
 
-  HASH_ITER(hh, *approvers, curr_approver, tmp_approver) {
-    if (!hash_to_int64_t_map_find(&cw_ratings, curr_approver->hash, &curr_rating)) {
-      return RC_CONSENSUS_EXIT_PROBABILITIES_MISSING_RATING;
-    }
-    transition_probs[idx++] = curr_rating->value;
-    max_weight = MAX(max_weight, curr_rating->value);
+  for (idx = 0; idx < num_approvers; ++idx) {
+    transition_probs[idx] = graph->cw_ratings[approvers[idx]];
+    max_weight = MAX(max_weight, transition_probs[idx]);
   }
   for (idx = 0; idx < num_approvers; ++idx) {
     transition_probs[idx] -= max_weight;
@@ -20,16 +20,17 @@ extern "C" {
  * Maps transition probabilities to direct approvers
  *
  * @param alpha The alpha param of the random walk
- * @param cw_ratings The cumulative weights data
- * @param approvers The set of direct approvers
- * @param transition_probs The result is in the order of iteration over
- * "approvers"
+ * @param graph The subtangle holding the cumulative weights
+ * @param approvers The ids of the direct approvers
+ * @param num_approvers The number of direct approvers
+ * @param transition_probs The result is in the order of "approvers"
  *
  * @return a status code
  */
 
-extern retcode_t map_transition_probabilities(double alpha, hash_to_int64_t_map_t const cw_ratings,
-                                              hash243_set_t const *const approvers, double transition_probs[]);
+extern retcode_t map_transition_probabilities(double alpha, subtangle_graph_t const *const graph,
+                                              uint32_t const *const approvers, size_t const num_approvers,
+                                              double transition_probs[]);
 
 static inline bool iota_consensus_is_tx_a_tip(hash_to_indexed_hash_set_map_t const *const tx_to_approvers,
                                               flex_trit_t const *const tx) {
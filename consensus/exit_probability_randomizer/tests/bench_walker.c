@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/*
+ * Measures the random walks over a synthetic tangle: every transaction
+ * approves two random transactions among the previous ones, at most a window
+ * away, the oldest one being the entry point.
+ * The same number of walks is timed for the walker recomputing the transition
+ * probabilities at each step and for the walker sampling approvers from alias
+ * tables, built for the vertices the walks visit. A new solid transaction is
+ * given to the BACKWARD_WEIGHT_PROPAGATION calculator every solid interval
+ * walks, so that the walks run on new cumulative weights as on a node. Only
+ * the walks are timed.
+ *
+ * Usage: bench_walker [-n transactions] [-w window] [-k walks] [-a alpha]
+ * [-s solid interval] (defaults to 10000 transactions, a window of 100, 1000
+ * walks, an alpha of 0.001 and a solid transaction every 10 walks, 0 for
+ * none and cumulative weights computed once by DFS_FROM_ENTRY_POINT)
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "common/model/transaction.h"
+#include "common/storage/storage.h"
+#include "common/storage/tests/helpers/defs.h"
+#include "consensus/cw_rating_calculator/cw_rating_calculator.h"
+#include "consensus/exit_probability_randomizer/exit_probability_randomizer.h"
+#include "consensus/exit_probability_randomizer/walker.h"
+#include "consensus/test_utils/tangle.h"
+#include "consensus/transaction_solidifier/transaction_solidifier.h"
+#include "utils/macros.h"
+#include "utils/time.h"
+
+#define BENCH_DEFAULT_NUM_TXS 10000
+#define BENCH_DEFAULT_WINDOW 100
+#define BENCH_DEFAULT_NUM_WALKS 1000
+#define BENCH_DEFAULT_ALPHA 0.001
+#define BENCH_DEFAULT_SOLID_INTERVAL 10
+
+static char *test_db_path = "consensus/exit_probability_randomizer/tests/test.db";
+static char *ciri_db_path = "consensus/exit_probability_randomizer/tests/ciri.db";
+static char *snapshot_path = "consensus/exit_probability_randomizer/tests/snapshot.txt";
+static char *snapshot_conf_path = "consensus/snapshot/tests/snapshot_conf.json";
+
+static uint32_t max_depth = 15;
+
+static tangle_t tangle;
+static connection_config_t config;
+static iota_consensus_conf_t conf;
+static exit_prob_transaction_validator_t epv;
+static snapshot_t snapshot;
+static milestone_tracker_t mt;
+static ledger_validator_t lv;
+static transaction_solidifier_t ts;
+
+static retcode_t bench_init_epv() {
+  retcode_t ret = RC_OK;
+
+  conf.max_depth = max_depth;
+  strcpy(conf.snapshot_file, snapshot_path);
+  strcpy(conf.snapshot_conf_file, snapshot_conf_path);
+  conf.snapshot_signature_skip_validation = true;
+  if ((ret = iota_snapshot_init(&snapshot, &conf)) != RC_OK ||
+      (ret = iota_consensus_transaction_solidifier_init(&ts, &conf, NULL, NULL, NULL)) != RC_OK ||
+      (ret = iota_milestone_tracker_init(&mt, &conf, &snapshot, &lv, &ts, NULL)) != RC_OK ||
+      (ret = iota_consensus_ledger_validator_init(&lv, &tangle, &conf, &mt)) != RC_OK) {
+    return ret;
+  }
+
+  // We want to avoid unnecessary validation
+  mt.latest_snapshot->index = 9999999;
+  mt.latest_solid_subtangle_milestone_index = max_depth;
+
+  return iota_consensus_exit_prob_transaction_validator_init(&conf, &mt, &lv, &epv);
+}
+
+static void bench_destroy_epv() {
+  iota_consensus_ledger_validator_destroy(&lv);
+  iota_snapshot_destroy(&snapshot);
+  iota_milestone_tracker_destroy(&mt);
+  iota_consensus_exit_prob_transaction_validator_destroy(&epv);
+  iota_consensus_transaction_solidifier_destroy(&ts);
+}
+
+// Stores a new solid transaction and gives it to the calculator, whose cumulative weights are given back meanwhile
+static retcode_t bench_add_solid_transaction(cw_rating_calculator_t *const calc, cw_calc_result *const out,
+                                             bool *const has_out, iota_transaction_t const *const tx,
+                                             iota_transaction_t *const txs, size_t *const num_txs,
+                                             size_t const window) {
+  hash243_set_t solid_transactions = NULL;
+  retcode_t ret = RC_OK;
+
+  iota_consensus_cw_rating_release(calc, out);
+  *has_out = false;
+  if ((ret = extend_random_tangle(&tangle, tx, txs, *num_txs, 1, window, true, max_depth)) == RC_OK &&
+      (ret = hash243_set_add(&solid_transactions, transaction_hash(&txs[*num_txs]))) == RC_OK &&
+      (ret = iota_consensus_cw_rating_add_solid_transactions(calc, &tangle, solid_transactions)) == RC_OK) {
+    (*num_txs)++;
+  }
+  hash243_set_free(&solid_transactions);
+  if (ret != RC_OK ||
+      (ret = iota_consensus_cw_rating_calculate(calc, &tangle, transaction_hash(&txs[0]), out)) != RC_OK) {
+    return ret;
+  }
+  *has_out = true;
+  return RC_OK;
+}
+
+static int bench_walks(char const *const name, ep_randomizer_implementation_t const impl,
+                       cw_rating_calculator_t *const calc, cw_calc_result *const out, bool *const has_out,
+                       iota_transaction_t const *const tx, iota_transaction_t *const txs, size_t *const num_txs,
+                       size_t const window, size_t const num_walks, size_t const solid_interval) {
+  ep_randomizer_t randomizer;
+  flex_trit_t tip[FLEX_TRIT_SIZE_243];
+  size_t num_steps = 0, total_steps = 0, num_added = 0;
+  uint64_t start, first_walk = 0, elapsed = 0;
+  int ret = EXIT_SUCCESS;
+
+  if (iota_consensus_ep_randomizer_init(&randomizer, &conf, impl) != RC_OK) {
+    return EXIT_FAILURE;
+  }
+  for (size_t w = 0; w < num_walks; w++) {
+    if (w > 0 && solid_interval > 0 && w % solid_interval == 0) {
+      if (bench_add_solid_transaction(calc, out, has_out, tx, txs, num_txs, window) != RC_OK) {
+        fprintf(stderr, "Adding a solid transaction failed\n");
+        ret = EXIT_FAILURE;
+        goto done;
+      }
+      num_added++;
+    }
+    start = current_timestamp_us();
+    if (iota_consensus_random_walker_walk(&randomizer, &tangle, &epv, out, transaction_hash(&txs[0]), tip,
+                                          &num_steps) != RC_OK) {
+      fprintf(stderr, "Walk of %s failed\n", name);
+      ret = EXIT_FAILURE;
+      goto done;
+    }
+    elapsed += current_timestamp_us() - start;
+    if (w == 0) {
+      first_walk = elapsed;
+    }
+    total_steps += num_steps;
+  }
+  elapsed = MAX(1, elapsed);
+
+  printf("%-12s %10zu steps %10.2f ms %12.0f steps/s, first walk %8.2f ms, %zu solid transactions added\n", name,
+         total_steps, elapsed / 1000.0, total_steps * 1000000.0 / elapsed, first_walk / 1000.0, num_added);
+
+done:
+  iota_consensus_ep_randomizer_destroy(&randomizer);
+  return ret;
+}
+
+int main(int argc, char *argv[]) {
+  size_t num_txs = BENCH_DEFAULT_NUM_TXS;
+  size_t window = BENCH_DEFAULT_WINDOW;
+  size_t num_walks = BENCH_DEFAULT_NUM_WALKS;
+  size_t max_txs = 0;
+  size_t solid_interval = BENCH_DEFAULT_SOLID_INTERVAL;
+  cw_rating_calculator_t calc;
+  cw_calc_result out;
+  bool has_out = false;
+  tryte_t const *tx_trytes[] = {TEST_TX_TRYTES};
+  iota_transaction_t *tx = NULL;
+  iota_transaction_t *txs = NULL;
+  int opt = 0, ret = EXIT_FAILURE;
+
+  iota_consensus_conf_init(&conf);
+  conf.alpha = BENCH_DEFAULT_ALPHA;
+  while ((opt = getopt(argc, argv, "n:w:k:a:s:")) != -1) {
+    switch (opt) {
+      case 'n':
+        num_txs = MAX(1, strtoull(optarg, NULL, 10));
+        break;
+      case 'w':
+        window = MAX(1, strtoull(optarg, NULL, 10));
+        break;
+      case 'k':
+        num_walks = MAX(1, strtoull(optarg, NULL, 10));
+        break;
+      case 'a':
+        conf.alpha = atof(optarg);
+        break;
+      case 's':
+        solid_interval = strtoull(optarg, NULL, 10);
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-n transactions] [-w window] [-k walks] [-a alpha] [-s solid interval]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+  }
+
+  config.db_path = test_db_path;
+  if (storage_init() != RC_OK || tangle_setup(&tangle, &config, test_db_path, ciri_db_path) != RC_OK) {
+    fprintf(stderr, "Setting up the tangle failed\n");
+    return EXIT_FAILURE;
+  }
+  if (bench_init_epv() != RC_OK) {
+    fprintf(stderr, "Initializing the validator failed\n");
+    goto cleanup;
+  }
+  srand(42);
+  transactions_deserialize(tx_trytes, &tx, 1, true);
+  // Both walkers add their own solid transactions
+  max_txs = num_txs + (solid_interval > 0 ? 2 * ((num_walks - 1) / solid_interval) : 0);
+  if (tx == NULL || (txs = (iota_transaction_t *)malloc(max_txs * sizeof(iota_transaction_t))) == NULL ||
+      build_random_tangle(&tangle, tx, txs, num_txs, window, true, max_depth) != RC_OK) {
+    fprintf(stderr, "Building the tangle failed\n");
+    goto done;
+  }
+  if (iota_consensus_cw_rating_init(&calc, solid_interval > 0 ? BACKWARD_WEIGHT_PROPAGATION : DFS_FROM_ENTRY_POINT) !=
+      RC_OK) {
+    goto done;
+  }
+  if (iota_consensus_cw_rating_calculate(&calc, &tangle, transaction_hash(&txs[0]), &out) != RC_OK) {
+    fprintf(stderr, "Calculating the cumulative weights failed\n");
+    iota_consensus_cw_rating_destroy(&calc);
+    goto done;
+  }
+  has_out = true;
+
+  printf("Tangle of %zu transactions, window of %zu, %zu walks, alpha of %g, a solid transaction every %zu walks\n",
+         num_txs, window, num_walks, conf.alpha, solid_interval);
+  if (bench_walks("walker", EP_RANDOM_WALK, &calc, &out, &has_out, tx, txs, &num_txs, window, num_walks,
+                  solid_interval) == EXIT_SUCCESS &&
+      bench_walks("walker_alias", EP_RANDOM_WALK_ALIAS, &calc, &out, &has_out, tx, txs, &num_txs, window, num_walks,
+                  solid_interval) == EXIT_SUCCESS) {
+    ret = EXIT_SUCCESS;
+  }
+
+  if (has_out) {
+    iota_consensus_cw_rating_release(&calc, &out);
+  }
+  iota_consensus_cw_rating_destroy(&calc);
+
+done:
+  free(txs);
+  transaction_free(tx);
+  bench_destroy_epv();
+
+cleanup:
+  tangle_cleanup(&tangle, test_db_path);
+  storage_destroy();
+  return ret;
+}
@@ -80,8 +80,8 @@ static void init_epv(exit_prob_transaction_validator_t *const epv) {
   strcpy(conf.snapshot_conf_file, snapshot_conf_path);
   conf.snapshot_signature_skip_validation = true;
   TEST_ASSERT(iota_snapshot_init(&snapshot, &conf) == RC_OK);
-  TEST_ASSERT(iota_consensus_transaction_solidifier_init(&ts, &conf, NULL, NULL) == RC_OK);
-  TEST_ASSERT(iota_milestone_tracker_init(&mt, &conf, &snapshot, &lv, &ts) == RC_OK);
+  TEST_ASSERT(iota_consensus_transaction_solidifier_init(&ts, &conf, NULL, NULL, NULL) == RC_OK);
+  TEST_ASSERT(iota_milestone_tracker_init(&mt, &conf, &snapshot, &lv, &ts, NULL) == RC_OK);
   TEST_ASSERT(iota_consensus_ledger_validator_init(&lv, &tangle, &conf, &mt) == RC_OK);
 
   // We want to avoid unnecessary validation
@@ -228,6 +228,12 @@ void test_single_tx_tangle_map(void) {
   TEST_ASSERT(iota_consensus_ep_randomizer_destroy(&ep_randomizer) == RC_OK);
 }
 
+void test_single_tx_tangle_alias(void) {
+  ep_randomizer_t ep_randomizer;
+  test_single_tx_tangle_base(EP_RANDOM_WALK_ALIAS, &ep_randomizer);
+  TEST_ASSERT(iota_consensus_ep_randomizer_destroy(&ep_randomizer) == RC_OK);
+}
+
 void test_single_tx_tangle_base(ep_randomizer_implementation_t ep_impl, ep_randomizer_t *const ep_randomizer) {
   TEST_ASSERT(iota_consensus_cw_rating_init(&calc, DFS_FROM_ENTRY_POINT) == RC_OK);
   init_epv(&epv);
@@ -287,6 +293,12 @@ void test_cw_topology_only_direct_approvers_map(void) {
   TEST_ASSERT(iota_consensus_ep_randomizer_destroy(&ep_randomizer) == RC_OK);
 }
 
+void test_cw_topology_only_direct_approvers_alias(void) {
+  ep_randomizer_t ep_randomizer;
+  test_cw_gen_topology(ONLY_DIRECT_APPROVERS, EP_RANDOM_WALK_ALIAS, &ep_randomizer);
+  TEST_ASSERT(iota_consensus_ep_randomizer_destroy(&ep_randomizer) == RC_OK);
+}
+
 void test_cw_topology_blockchain_walker(void) {
   ep_randomizer_t ep_randomizer;
   test_cw_gen_topology(BLOCKCHAIN, EP_RANDOM_WALK, &ep_randomizer);
@@ -298,6 +310,12 @@ void test_cw_topology_blockchain_map(void) {
   TEST_ASSERT(iota_consensus_ep_randomizer_destroy(&ep_randomizer) == RC_OK);
 }
 
+void test_cw_topology_blockchain_alias(void) {
+  ep_randomizer_t ep_randomizer;
+  test_cw_gen_topology(BLOCKCHAIN, EP_RANDOM_WALK_ALIAS, &ep_randomizer);
+  TEST_ASSERT(iota_consensus_ep_randomizer_destroy(&ep_randomizer) == RC_OK);
+}
+
 void test_cw_topology_four_transactions_diamond_walker(void) {
   ep_randomizer_t ep_randomizer;
   test_cw_topology_four_transactions_diamond(EP_RANDOM_WALK, &ep_randomizer);
@@ -310,6 +328,12 @@ void test_cw_topology_four_transactions_diamond_map(void) {
   TEST_ASSERT(iota_consensus_ep_randomizer_destroy(&ep_randomizer) == RC_OK);
 }
 
+void test_cw_topology_four_transactions_diamond_alias(void) {
+  ep_randomizer_t ep_randomizer;
+  test_cw_topology_four_transactions_diamond(EP_RANDOM_WALK_ALIAS, &ep_randomizer);
+  TEST_ASSERT(iota_consensus_ep_randomizer_destroy(&ep_randomizer) == RC_OK);
+}
+
 void test_cw_topology_four_transactions_diamond(ep_randomizer_implementation_t ep_impl,
                                                 ep_randomizer_t *const ep_randomizer) {
   hash_to_int64_t_map_entry_t *curr_cw_entry = NULL;
@@ -411,6 +435,12 @@ void test_cw_topology_five_transactions_diamond_and_a_tail_map(void) {
   TEST_ASSERT(iota_consensus_ep_randomizer_destroy(&ep_randomizer) == RC_OK);
 }
 
+void test_cw_topology_five_transactions_diamond_and_a_tail_alias(void) {
+  ep_randomizer_t ep_randomizer;
+  test_cw_topology_five_transactions_diamond_and_a_tail(EP_RANDOM_WALK_ALIAS, &ep_randomizer);
+  TEST_ASSERT(iota_consensus_ep_randomizer_destroy(&ep_randomizer) == RC_OK);
+}
+
 void test_cw_topology_five_transactions_diamond_and_a_tail(ep_randomizer_implementation_t ep_impl,
                                                            ep_randomizer_t *const ep_randomizer) {
   hash_to_int64_t_map_entry_t *curr_cw_entry = NULL;
@@ -513,6 +543,12 @@ void test_cw_topology_two_inequal_tips_map(void) {
   test_cw_topology_two_inequal_tips(EP_RANDOMIZE_MAP_AND_SAMPLE, &ep_randomizer);
   TEST_ASSERT(iota_consensus_ep_randomizer_destroy(&ep_randomizer) == RC_OK);
 }
+
+void test_cw_topology_two_inequal_tips_alias(void) {
+  ep_randomizer_t ep_randomizer;
+  test_cw_topology_two_inequal_tips(EP_RANDOM_WALK_ALIAS, &ep_randomizer);
+  TEST_ASSERT(iota_consensus_ep_randomizer_destroy(&ep_randomizer) == RC_OK);
+}
 void test_cw_topology_two_inequal_tips(ep_randomizer_implementation_t ep_impl, ep_randomizer_t *const ep_randomizer) {
   hash_to_int64_t_map_entry_t *curr_cw_entry = NULL;
   hash_to_int64_t_map_entry_t *tmp_cw_entry = NULL;
@@ -639,6 +675,12 @@ void test_1_bundle_map(void) {
   TEST_ASSERT(iota_consensus_ep_randomizer_destroy(&ep_randomizer) == RC_OK);
 }
 
+void test_1_bundle_alias(void) {
+  ep_randomizer_t ep_randomizer;
+  test_1_bundle(EP_RANDOM_WALK_ALIAS, &ep_randomizer);
+  TEST_ASSERT(iota_consensus_ep_randomizer_destroy(&ep_randomizer) == RC_OK);
+}
+
 void test_1_bundle(ep_randomizer_implementation_t ep_impl, ep_randomizer_t *const ep_randomizer) {
   hash_to_int64_t_map_entry_t *curr_cw_entry = NULL;
   hash_to_int64_t_map_entry_t *tmp_cw_entry = NULL;
@@ -736,6 +778,12 @@ void test_2_chained_bundles_map(void) {
   TEST_ASSERT(iota_consensus_ep_randomizer_destroy(&ep_randomizer) == RC_OK);
 }
 
+void test_2_chained_bundles_alias(void) {
+  ep_randomizer_t ep_randomizer;
+  test_2_chained_bundles(EP_RANDOM_WALK_ALIAS, &ep_randomizer);
+  TEST_ASSERT(iota_consensus_ep_randomizer_destroy(&ep_randomizer) == RC_OK);
+}
+
 void test_2_chained_bundles(ep_randomizer_implementation_t ep_impl, ep_randomizer_t *const ep_randomizer) {
   hash_to_int64_t_map_entry_t *curr_cw_entry = NULL;
   hash_to_int64_t_map_entry_t *tmp_cw_entry = NULL;
@@ -817,6 +865,176 @@ void test_2_chained_bundles(ep_randomizer_implementation_t ep_impl, ep_randomize
   destroy_epv(&epv);
 }
 
+void test_cw_incremental_blockchain(void) {
+  cw_rating_calculator_t incremental_calc;
+  hash_to_int64_t_map_entry_t *curr_cw_entry = NULL;
+  hash_to_int64_t_map_entry_t *tmp_cw_entry = NULL;
+  hash_to_int64_t_map_entry_t *cw_entry = NULL;
+  hash243_set_t solid_transactions = NULL;
+  cw_calc_result expected, out;
+  size_t num_approvers = 20;
+
+  flex_trit_t tx_trits[FLEX_TRIT_SIZE_8019];
+  flex_trits_from_trytes(tx_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES, NUM_TRITS_SERIALIZED_TRANSACTION,
+                         NUM_TRYTES_SERIALIZED_TRANSACTION);
+
+  iota_transaction_t *tx = transaction_deserialize(tx_trits, true);
+  TEST_ASSERT(iota_tangle_transaction_store(&tangle, tx) == RC_OK);
+  TEST_ASSERT(iota_tangle_transaction_update_solid_state(&tangle, transaction_hash(tx), true) == RC_OK);
+
+  iota_transaction_t txs[num_approvers];
+  for (size_t i = 0; i < num_approvers; i++) {
+    txs[i] = *tx;
+    txs[i].consensus.hash[i / 256] += (i + 1);
+    transaction_set_trunk(&txs[i], i == 0 ? transaction_hash(tx) : transaction_hash(&txs[i - 1]));
+    transaction_set_branch(&txs[i], i < 2 ? transaction_hash(tx) : transaction_hash(&txs[i - 2]));
+  }
+  for (size_t i = 0; i < num_approvers / 2; i++) {
+    TEST_ASSERT(iota_tangle_transaction_store(&tangle, &txs[i]) == RC_OK);
+    TEST_ASSERT(iota_tangle_transaction_update_solid_state(&tangle, transaction_hash(&txs[i]), true) == RC_OK);
+  }
+
+  TEST_ASSERT(iota_consensus_cw_rating_init(&calc, DFS_FROM_ENTRY_POINT) == RC_OK);
+  TEST_ASSERT(iota_consensus_cw_rating_init(&incremental_calc, BACKWARD_WEIGHT_PROPAGATION) == RC_OK);
+  TEST_ASSERT(iota_consensus_cw_rating_calculate(&incremental_calc, &tangle, transaction_hash(tx), &out) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(num_approvers / 2 + 1, HASH_COUNT(out.tx_to_approvers));
+  iota_consensus_cw_rating_release(&incremental_calc, &out);
+
+  // The second half arrives in reverse order
+  for (size_t i = num_approvers; i > num_approvers / 2; i--) {
+    TEST_ASSERT(iota_tangle_transaction_store(&tangle, &txs[i - 1]) == RC_OK);
+    TEST_ASSERT(iota_tangle_transaction_update_solid_state(&tangle, transaction_hash(&txs[i - 1]), true) == RC_OK);
+    TEST_ASSERT(hash243_set_add(&solid_transactions, transaction_hash(&txs[i - 1])) == RC_OK);
+  }
+  TEST_ASSERT(iota_consensus_cw_rating_add_solid_transactions(&incremental_calc, &tangle, solid_transactions) ==
+              RC_OK);
+
+  // Same entry point, a higher one served from the same subtangle, the higher one once the transactions below it are
+  // dropped, then the lower one rebuilt from storage
+  for (size_t ep_index = 0; ep_index < 4; ep_index++) {
+    flex_trit_t *ep = ep_index == 0 || ep_index == 3 ? transaction_hash(tx) : transaction_hash(&txs[num_approvers / 4]);
+
+    if (ep_index == 2) {
+      TEST_ASSERT(iota_consensus_cw_rating_set_deepest_entry_point(&incremental_calc, ep) == RC_OK);
+    }
+    TEST_ASSERT(iota_consensus_cw_rating_calculate(&calc, &tangle, ep, &expected) == RC_OK);
+    TEST_ASSERT(iota_consensus_cw_rating_calculate(&incremental_calc, &tangle, ep, &out) == RC_OK);
+    if (ep_index == 1) {
+      TEST_ASSERT_EQUAL_INT(num_approvers + 1, HASH_COUNT(out.tx_to_approvers));
+    } else {
+      TEST_ASSERT_EQUAL_INT(HASH_COUNT(expected.tx_to_approvers), HASH_COUNT(out.tx_to_approvers));
+      TEST_ASSERT_EQUAL_INT(HASH_COUNT(expected.cw_ratings), HASH_COUNT(out.cw_ratings));
+    }
+    HASH_ITER(hh, expected.cw_ratings, curr_cw_entry, tmp_cw_entry) {
+      TEST_ASSERT(hash_to_int64_t_map_find(&out.cw_ratings, curr_cw_entry->hash, &cw_entry));
+      TEST_ASSERT_EQUAL_INT64(curr_cw_entry->value, cw_entry->value);
+    }
+    iota_consensus_cw_rating_release(&incremental_calc, &out);
+    iota_consensus_cw_rating_release(&calc, &expected);
+  }
+
+  hash243_set_free(&solid_transactions);
+  TEST_ASSERT(iota_consensus_cw_rating_destroy(&incremental_calc) == RC_OK);
+  TEST_ASSERT(iota_consensus_cw_rating_destroy(&calc) == RC_OK);
+  transaction_free(tx);
+}
+
+void test_cw_incremental_non_solid_approvers(void) {
+  cw_rating_calculator_t incremental_calc;
+  hash_to_int64_t_map_entry_t *cw_entry = NULL;
+  hash243_set_t solid_transactions = NULL;
+  cw_calc_result out;
+
+  flex_trit_t tx_trits[FLEX_TRIT_SIZE_8019];
+  flex_trits_from_trytes(tx_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES, NUM_TRITS_SERIALIZED_TRANSACTION,
+                         NUM_TRYTES_SERIALIZED_TRANSACTION);
+
+  iota_transaction_t *tx = transaction_deserialize(tx_trits, true);
+  TEST_ASSERT(iota_tangle_transaction_store(&tangle, tx) == RC_OK);
+  TEST_ASSERT(iota_tangle_transaction_update_solid_state(&tangle, transaction_hash(tx), true) == RC_OK);
+
+  // A solid approver and a pending one approving it
+  iota_transaction_t txs[2];
+  for (size_t i = 0; i < 2; i++) {
+    txs[i] = *tx;
+    txs[i].consensus.hash[0] += (i + 1);
+    transaction_set_trunk(&txs[i], i == 0 ? transaction_hash(tx) : transaction_hash(&txs[0]));
+    transaction_set_branch(&txs[i], transaction_hash(tx));
+    TEST_ASSERT(iota_tangle_transaction_store(&tangle, &txs[i]) == RC_OK);
+  }
+  TEST_ASSERT(iota_tangle_transaction_update_solid_state(&tangle, transaction_hash(&txs[0]), true) == RC_OK);
+
+  // The rebuilt subtangle counts the solid transactions only, as the newly solid ones are added later
+  TEST_ASSERT(iota_consensus_cw_rating_init(&incremental_calc, BACKWARD_WEIGHT_PROPAGATION) == RC_OK);
+  TEST_ASSERT(iota_consensus_cw_rating_calculate(&incremental_calc, &tangle, transaction_hash(tx), &out) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(2, HASH_COUNT(out.cw_ratings));
+  TEST_ASSERT_FALSE(hash_to_int64_t_map_contains(&out.cw_ratings, transaction_hash(&txs[1])));
+  TEST_ASSERT(hash_to_int64_t_map_find(&out.cw_ratings, transaction_hash(tx), &cw_entry));
+  TEST_ASSERT_EQUAL_INT64(2, cw_entry->value);
+  iota_consensus_cw_rating_release(&incremental_calc, &out);
+
+  TEST_ASSERT(iota_tangle_transaction_update_solid_state(&tangle, transaction_hash(&txs[1]), true) == RC_OK);
+  TEST_ASSERT(hash243_set_add(&solid_transactions, transaction_hash(&txs[1])) == RC_OK);
+  TEST_ASSERT(iota_consensus_cw_rating_add_solid_transactions(&incremental_calc, &tangle, solid_transactions) ==
+              RC_OK);
+  TEST_ASSERT(iota_consensus_cw_rating_calculate(&incremental_calc, &tangle, transaction_hash(tx), &out) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(3, HASH_COUNT(out.cw_ratings));
+  TEST_ASSERT(hash_to_int64_t_map_find(&out.cw_ratings, transaction_hash(tx), &cw_entry));
+  TEST_ASSERT_EQUAL_INT64(3, cw_entry->value);
+  TEST_ASSERT(hash_to_int64_t_map_find(&out.cw_ratings, transaction_hash(&txs[0]), &cw_entry));
+  TEST_ASSERT_EQUAL_INT64(2, cw_entry->value);
+  iota_consensus_cw_rating_release(&incremental_calc, &out);
+
+  hash243_set_free(&solid_transactions);
+  TEST_ASSERT(iota_consensus_cw_rating_destroy(&incremental_calc) == RC_OK);
+  transaction_free(tx);
+}
+
+void test_cw_parallel_random_tangle(void) {
+  cw_rating_calculator_t parallel_calc;
+  hash_to_int64_t_map_entry_t *curr_cw_entry = NULL;
+  hash_to_int64_t_map_entry_t *tmp_cw_entry = NULL;
+  hash_to_int64_t_map_entry_t *cw_entry = NULL;
+  cw_calc_result expected, out;
+  size_t num_txs = 300;
+  iota_transaction_t txs[num_txs + 1];
+
+  flex_trit_t tx_trits[FLEX_TRIT_SIZE_8019];
+  flex_trits_from_trytes(tx_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES, NUM_TRITS_SERIALIZED_TRANSACTION,
+                         NUM_TRYTES_SERIALIZED_TRANSACTION);
+
+  iota_transaction_t *tx = transaction_deserialize(tx_trits, true);
+
+  // Each transaction approves two of the last 20 ones, the future cones span several words
+  TEST_ASSERT(build_random_tangle(&tangle, tx, txs, num_txs + 1, 20, false, 0) == RC_OK);
+  flex_trit_t *ep = transaction_hash(&txs[0]);
+
+  TEST_ASSERT(iota_consensus_cw_rating_init(&calc, DFS_FROM_ENTRY_POINT) == RC_OK);
+  TEST_ASSERT(iota_consensus_cw_rating_init(&parallel_calc, DFS_FROM_ENTRY_POINT_PARALLEL) == RC_OK);
+  TEST_ASSERT(iota_consensus_cw_rating_calculate(&calc, &tangle, ep, &expected) == RC_OK);
+  TEST_ASSERT(iota_consensus_cw_rating_calculate(&parallel_calc, &tangle, ep, &out) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(num_txs + 1, HASH_COUNT(out.cw_ratings));
+  TEST_ASSERT_EQUAL_INT(HASH_COUNT(expected.cw_ratings), HASH_COUNT(out.cw_ratings));
+  HASH_ITER(hh, expected.cw_ratings, curr_cw_entry, tmp_cw_entry) {
+    TEST_ASSERT(hash_to_int64_t_map_find(&out.cw_ratings, curr_cw_entry->hash, &cw_entry));
+    TEST_ASSERT_EQUAL_INT64(curr_cw_entry->value, cw_entry->value);
+  }
+  TEST_ASSERT(hash_to_int64_t_map_find(&out.cw_ratings, ep, &cw_entry));
+  TEST_ASSERT_EQUAL_INT64(num_txs + 1, cw_entry->value);
+
+  // Every worker count gives the same cumulative weights
+  for (size_t num_workers = 1; num_workers <= 8; num_workers++) {
+    TEST_ASSERT(subtangle_graph_compute_cw_ratings_parallel(&out.graph, num_workers) == RC_OK);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(expected.graph.cw_ratings, out.graph.cw_ratings, (num_txs + 1) * sizeof(int64_t)));
+  }
+
+  iota_consensus_cw_rating_release(&parallel_calc, &out);
+  iota_consensus_cw_rating_release(&calc, &expected);
+  TEST_ASSERT(iota_consensus_cw_rating_destroy(&parallel_calc) == RC_OK);
+  TEST_ASSERT(iota_consensus_cw_rating_destroy(&calc) == RC_OK);
+  transaction_free(tx);
+}
+
 void test_sum_probabilities_1_ep_mapping(ep_randomizer_t *const ep_randomizer, flex_trit_t const *const ep,
                                          cw_calc_result const *const out) {
   hash_to_double_map_t hash_to_exit_probs = NULL;
@@ -853,22 +1071,33 @@ int main(int argc, char *argv[]) {
 
   RUN_TEST(test_single_tx_tangle_walker);
   RUN_TEST(test_single_tx_tangle_map);
+  RUN_TEST(test_single_tx_tangle_alias);
   RUN_TEST(test_cw_topology_blockchain_walker);
   RUN_TEST(test_cw_topology_blockchain_map);
+  RUN_TEST(test_cw_topology_blockchain_alias);
   RUN_TEST(test_cw_topology_only_direct_approvers_walker);
   RUN_TEST(test_cw_topology_only_direct_approvers_map);
+  RUN_TEST(test_cw_topology_only_direct_approvers_alias);
   RUN_TEST(test_cw_topology_four_transactions_diamond_walker);
   RUN_TEST(test_cw_topology_four_transactions_diamond_map);
+  RUN_TEST(test_cw_topology_four_transactions_diamond_alias);
   RUN_TEST(test_cw_topology_two_inequal_tips_walker);
   RUN_TEST(test_cw_topology_two_inequal_tips_map);
+  RUN_TEST(test_cw_topology_two_inequal_tips_alias);
   RUN_TEST(test_cw_topology_five_transactions_diamond_and_a_tail_walker);
   RUN_TEST(test_cw_topology_five_transactions_diamond_and_a_tail_map);
+  RUN_TEST(test_cw_topology_five_transactions_diamond_and_a_tail_alias);
+  RUN_TEST(test_cw_incremental_blockchain);
+  RUN_TEST(test_cw_incremental_non_solid_approvers);
+  RUN_TEST(test_cw_parallel_random_tangle);
 
   // Bundles
   RUN_TEST(test_1_bundle_walker);
   RUN_TEST(test_1_bundle_map);
+  RUN_TEST(test_1_bundle_alias);
   RUN_TEST(test_2_chained_bundles_walker);
   RUN_TEST(test_2_chained_bundles_map);
+  RUN_TEST(test_2_chained_bundles_alias);
 
   TEST_ASSERT(storage_destroy() == RC_OK);
   return UNITY_END();
@@ -10,7 +10,9 @@
 
 #include "consensus/exit_probability_randomizer/global_calcs.h"
 #include "consensus/exit_probability_randomizer/walker.h"
+#include "utils/handles/lock.h"
 #include "utils/handles/rand.h"
+#include "utils/handles/rw_lock.h"
 #include "utils/logger_helper.h"
 #include "utils/macros.h"
 
@@ -18,23 +20,45 @@
 
 static logger_id_t logger_id;
 
+typedef struct alias_table_s {
+  // Epoch of the engine the table was built in, stale tables being rebuilt by the next walk visiting their vertex
+  uint64_t epoch;
+  uint32_t size;
+  uint32_t capacity;
+  double *transition_probs;
+  // Probability of keeping the approver of a slot rather than its alias
+  double *alias_probs;
+  uint32_t *aliases;
+} alias_table_t;
+
+struct ep_randomizer_engine_s {
+  rw_lock_handle_t lock;
+  // Serializes the building of tables by the walks holding the read lock
+  lock_handle_t build_lock;
+  // Changes, under the write lock, whenever the graph of the cumulative weights or alpha change
+  uint64_t epoch;
+  // Generation of the graph and alpha of the current epoch
+  uint64_t generation;
+  double alpha;
+  // Table of each vertex, in the order of the graph
+  alias_table_t *tables;
+  uint32_t tables_capacity;
+};
+
 /*
  * Private functions
  */
 
 static retcode_t select_approver(ep_randomizer_t const *const exit_probability_randomizer,
-                                 hash_to_int64_t_map_t const cw_ratings, hash243_set_t const *const approvers,
-                                 flex_trit_t *const approver) {
-  hash243_set_entry_t *curr_approver = NULL;
-  hash243_set_entry_t *tmp_approver = NULL;
-  size_t num_approvers = hash243_set_size(approvers);
+                                 subtangle_graph_t const *const graph, uint32_t const *const approvers,
+                                 size_t const num_approvers, size_t *const selected) {
   double transition_probs[num_approvers];
   double sum_transition_probs = 0;
   double target = 0;
   size_t idx = 0;
   retcode_t ret;
 
-  if ((ret = map_transition_probabilities(exit_probability_randomizer->conf->alpha, cw_ratings, approvers,
+  if ((ret = map_transition_probabilities(exit_probability_randomizer->conf->alpha, graph, approvers, num_approvers,
                                           transition_probs)) != RC_OK) {
     return ret;
   }
@@ -43,21 +67,19 @@ static retcode_t select_approver(ep_randomizer_t const *const exit_probability_r
     sum_transition_probs += transition_probs[idx];
   }
 
-  idx = 0;
   target = rand_handle_probability() * sum_transition_probs;
-  HASH_ITER(hh, *approvers, curr_approver, tmp_approver) {
-    if ((target = (target - transition_probs[idx++])) <= 0) {
-      memcpy(approver, curr_approver->hash, FLEX_TRIT_SIZE_243);
+  for (idx = 0; idx < num_approvers; ++idx) {
+    if ((target = (target - transition_probs[idx])) <= 0) {
       break;
     }
   }
+  *selected = MIN(idx, num_approvers - 1);
 
   return RC_OK;
 }
 
-static retcode_t find_tail_if_valid(ep_randomizer_t const *const exit_probability_randomizer, tangle_t *const tangle,
-                                    exit_prob_transaction_validator_t *const epv, flex_trit_t *const tx_hash,
-                                    bool *const has_valid_tail) {
+static retcode_t find_tail_if_valid(tangle_t *const tangle, exit_prob_transaction_validator_t *const epv,
+                                    flex_trit_t *const tx_hash, bool *const has_valid_tail) {
   retcode_t ret = RC_OK;
 
   *has_valid_tail = false;
@@ -79,36 +101,247 @@ static retcode_t find_tail_if_valid(ep_randomizer_t const *const exit_probabilit
 static retcode_t random_walker_select_approver_tail(ep_randomizer_t const *const exit_probability_randomizer,
                                                     tangle_t *const tangle,
                                                     exit_prob_transaction_validator_t *const epv,
-                                                    cw_calc_result *const cw_result,
-                                                    flex_trit_t const *const curr_tail_hash,
-                                                    flex_trit_t *const approver, bool *const has_approver_tail) {
+                                                    cw_calc_result *const cw_result, uint32_t const curr_tail_id,
+                                                    flex_trit_t *const approver, uint32_t *const approver_tail_id,
+                                                    bool *const has_approver_tail) {
   retcode_t ret = RC_OK;
-  hash_to_indexed_hash_set_entry_t *approvers_entry = NULL;
+  subtangle_graph_t const *const graph = &cw_result->graph;
+  hash_to_indexed_hash_set_entry_t *tail_entry = NULL;
+  size_t num_approvers = graph->approvers[curr_tail_id].size;
+  uint32_t approvers[MAX(1, num_approvers)];
+  size_t selected = 0;
+  flex_trit_t tail[FLEX_TRIT_SIZE_243];
 
   *has_approver_tail = false;
-  if (!hash_to_indexed_hash_set_map_find(&cw_result->tx_to_approvers, curr_tail_hash, &approvers_entry)) {
-    return RC_OK;
+  // The graph may be shared by other walks, invalid approvers are removed from a copy
+  if (num_approvers > 0) {
+    memcpy(approvers, graph->approvers[curr_tail_id].ids, num_approvers * sizeof(uint32_t));
   }
-
-  while (!(*has_approver_tail) && HASH_COUNT(approvers_entry->approvers) > 0) {
-    ret = select_approver(exit_probability_randomizer, cw_result->cw_ratings, &approvers_entry->approvers, approver);
-    if (ret != RC_OK) {
-      *has_approver_tail = false;
+  while (!(*has_approver_tail) && num_approvers > 0) {
+    if ((ret = select_approver(exit_probability_randomizer, graph, approvers, num_approvers, &selected)) != RC_OK) {
       return ret;
     }
+    memcpy(tail, graph->hashes[approvers[selected]], FLEX_TRIT_SIZE_243);
 
-    if ((ret = find_tail_if_valid(exit_probability_randomizer, tangle, epv, approver, has_approver_tail)) != RC_OK) {
+    if ((ret = find_tail_if_valid(tangle, epv, tail, has_approver_tail)) != RC_OK) {
       return ret;
     }
     if (!(*has_approver_tail)) {
-      // if next tail is not valid, re-select while removing it from
-      // approvers set
-      hash243_set_remove(&approvers_entry->approvers, approver);
+      approvers[selected] = approvers[--num_approvers];
+    }
+  }
+
+  if (*has_approver_tail) {
+    memcpy(approver, tail, FLEX_TRIT_SIZE_243);
+    if (memcmp(tail, graph->hashes[approvers[selected]], FLEX_TRIT_SIZE_243) == 0) {
+      *approver_tail_id = approvers[selected];
+    } else {
+      HASH_FIND(hh, cw_result->tx_to_approvers, tail, FLEX_TRIT_SIZE_243, tail_entry);
+      *approver_tail_id = tail_entry ? (uint32_t)tail_entry->idx : SUBTANGLE_GRAPH_NO_VERTEX;
+    }
+  }
+
+  return RC_OK;
+}
+
+/**
+ * Builds the alias table of a vertex with Vose's method: each slot keeps its
+ * approver with some probability or gives its alias, an approver whose
+ * probability exceeds the average
+ */
+static void alias_table_build(double const *const transition_probs, size_t const num_approvers,
+                              double *const alias_probs, uint32_t *const aliases, uint32_t *const small,
+                              uint32_t *const large) {
+  size_t num_small = 0, num_large = 0;
+  uint32_t s, l, idx;
+
+  for (idx = 0; idx < num_approvers; idx++) {
+    alias_probs[idx] = transition_probs[idx] * num_approvers;
+    aliases[idx] = idx;
+    if (alias_probs[idx] < 1) {
+      small[num_small++] = idx;
+    } else {
+      large[num_large++] = idx;
+    }
+  }
+  while (num_small > 0 && num_large > 0) {
+    s = small[--num_small];
+    l = large[--num_large];
+    aliases[s] = l;
+    alias_probs[l] -= 1 - alias_probs[s];
+    if (alias_probs[l] < 1) {
+      small[num_small++] = l;
+    } else {
+      large[num_large++] = l;
+    }
+  }
+  // Whatever is left is 1 up to rounding errors
+  while (num_large > 0) {
+    alias_probs[large[--num_large]] = 1;
+  }
+  while (num_small > 0) {
+    alias_probs[small[--num_small]] = 1;
+  }
+}
+
+// Starts a new epoch for a graph and alpha, dropping the tables of the previous one in O(1)
+static retcode_t alias_tables_reset(ep_randomizer_engine_t *const engine, double const alpha,
+                                    subtangle_graph_t const *const graph) {
+  alias_table_t *tables = NULL;
+
+  if (graph->num_vertices > engine->tables_capacity) {
+    if ((tables = (alias_table_t *)realloc(engine->tables, graph->num_vertices * sizeof(alias_table_t))) == NULL) {
+      return RC_CONSENSUS_OOM;
     }
+    memset(tables + engine->tables_capacity, 0,
+           (graph->num_vertices - engine->tables_capacity) * sizeof(alias_table_t));
+    engine->tables = tables;
+    engine->tables_capacity = graph->num_vertices;
   }
+  engine->epoch++;
+  engine->generation = graph->generation;
+  engine->alpha = alpha;
+
+  return RC_OK;
+}
+
+// Called with the read lock held, builds the table of a vertex the first time a walk of the epoch visits it
+static retcode_t alias_table_get(ep_randomizer_engine_t *const engine, subtangle_graph_t const *const graph,
+                                 uint32_t const id, alias_table_t const **const table) {
+  alias_table_t *const entry = &engine->tables[id];
+  uint32_t const num_approvers = graph->approvers[id].size;
+  void *tmp = NULL;
+  retcode_t ret = RC_OK;
+
+  *table = entry;
+  if (__atomic_load_n(&entry->epoch, __ATOMIC_ACQUIRE) == engine->epoch) {
+    return RC_OK;
+  }
+
+  lock_handle_lock(&engine->build_lock);
+  if (entry->epoch == engine->epoch) {
+    goto done;
+  }
+  if (num_approvers > entry->capacity) {
+    if ((tmp = realloc(entry->transition_probs, num_approvers * sizeof(double))) == NULL) {
+      ret = RC_CONSENSUS_OOM;
+      goto done;
+    }
+    entry->transition_probs = tmp;
+    if ((tmp = realloc(entry->alias_probs, num_approvers * sizeof(double))) == NULL) {
+      ret = RC_CONSENSUS_OOM;
+      goto done;
+    }
+    entry->alias_probs = tmp;
+    if ((tmp = realloc(entry->aliases, num_approvers * sizeof(uint32_t))) == NULL) {
+      ret = RC_CONSENSUS_OOM;
+      goto done;
+    }
+    entry->aliases = tmp;
+    entry->capacity = num_approvers;
+  }
+  entry->size = num_approvers;
+  if (num_approvers > 0) {
+    uint32_t scratch[2 * num_approvers];
+
+    if ((ret = map_transition_probabilities(engine->alpha, graph, graph->approvers[id].ids, num_approvers,
+                                            entry->transition_probs)) != RC_OK) {
+      goto done;
+    }
+    alias_table_build(entry->transition_probs, num_approvers, entry->alias_probs, entry->aliases, scratch,
+                      scratch + num_approvers);
+  }
+  __atomic_store_n(&entry->epoch, engine->epoch, __ATOMIC_RELEASE);
+
+done:
+  lock_handle_unlock(&engine->build_lock);
   return ret;
 }
 
+static size_t alias_table_sample(alias_table_t const *const table) {
+  double target = rand_handle_probability() * table->size;
+  size_t slot = MIN((size_t)target, table->size - 1);
+
+  return target - slot < table->alias_probs[slot] ? slot : table->aliases[slot];
+}
+
+static retcode_t alias_walker_select_approver_tail(ep_randomizer_engine_t *const engine, tangle_t *const tangle,
+                                                   exit_prob_transaction_validator_t *const epv,
+                                                   cw_calc_result *const cw_result, uint32_t const curr_tail_id,
+                                                   flex_trit_t *const approver, uint32_t *const approver_tail_id,
+                                                   bool *const has_approver_tail) {
+  retcode_t ret = RC_OK;
+  subtangle_graph_t const *const graph = &cw_result->graph;
+  uint32_t const *const approvers = graph->approvers[curr_tail_id].ids;
+  size_t const num_approvers = graph->approvers[curr_tail_id].size;
+  alias_table_t const *table = NULL;
+  double const *transition_probs = NULL;
+  hash_to_indexed_hash_set_entry_t *tail_entry = NULL;
+  bool rejected[MAX(1, num_approvers)];
+  size_t num_rejected = 0;
+  double rejected_prob = 0;
+  double sum_transition_probs = 0;
+  double target = 0;
+  size_t selected = 0;
+  size_t idx = 0;
+  flex_trit_t tail[FLEX_TRIT_SIZE_243];
+
+  *has_approver_tail = false;
+  if (num_approvers == 0) {
+    return RC_OK;
+  }
+  if ((ret = alias_table_get(engine, graph, curr_tail_id, &table)) != RC_OK) {
+    return ret;
+  }
+  transition_probs = table->transition_probs;
+  memset(rejected, 0, sizeof(rejected));
+  while (!(*has_approver_tail) && num_rejected < num_approvers) {
+    if (rejected_prob < RANDOM_WALKER_ALIAS_MAX_REJECTED_PROB) {
+      // Sampling the table again until an approver is not rejected keeps the probabilities of the others
+      if (rejected[selected = alias_table_sample(table)]) {
+        continue;
+      }
+    } else {
+      sum_transition_probs = 0;
+      for (idx = 0; idx < num_approvers; ++idx) {
+        sum_transition_probs += rejected[idx] ? 0 : transition_probs[idx];
+      }
+      target = rand_handle_probability() * sum_transition_probs;
+      for (idx = 0; idx < num_approvers; ++idx) {
+        if (rejected[idx]) {
+          continue;
+        }
+        selected = idx;
+        if ((target -= transition_probs[idx]) <= 0) {
+          break;
+        }
+      }
+    }
+    memcpy(tail, graph->hashes[approvers[selected]], FLEX_TRIT_SIZE_243);
+
+    if ((ret = find_tail_if_valid(tangle, epv, tail, has_approver_tail)) != RC_OK) {
+      return ret;
+    }
+    if (!(*has_approver_tail)) {
+      rejected[selected] = true;
+      num_rejected++;
+      rejected_prob += transition_probs[selected];
+    }
+  }
+
+  if (*has_approver_tail) {
+    memcpy(approver, tail, FLEX_TRIT_SIZE_243);
+    if (memcmp(tail, graph->hashes[approvers[selected]], FLEX_TRIT_SIZE_243) == 0) {
+      *approver_tail_id = approvers[selected];
+    } else {
+      HASH_FIND(hh, cw_result->tx_to_approvers, tail, FLEX_TRIT_SIZE_243, tail_entry);
+      *approver_tail_id = tail_entry ? (uint32_t)tail_entry->idx : SUBTANGLE_GRAPH_NO_VERTEX;
+    }
+  }
+
+  return RC_OK;
+}
+
 /*
  * Public functions
  */
@@ -116,6 +349,18 @@ static retcode_t random_walker_select_approver_tail(ep_randomizer_t const *const
 void iota_consensus_random_walker_init(ep_randomizer_t *const randomizer) {
   logger_id = logger_helper_enable(RANDOM_WALKER_LOGGER_ID, LOGGER_DEBUG, true);
   randomizer->base.vtable = random_walk_vtable;
+  randomizer->engine = NULL;
+}
+
+retcode_t iota_consensus_random_walker_alias_init(ep_randomizer_t *const randomizer) {
+  logger_id = logger_helper_enable(RANDOM_WALKER_LOGGER_ID, LOGGER_DEBUG, true);
+  randomizer->base.vtable = random_walk_alias_vtable;
+  if ((randomizer->engine = (ep_randomizer_engine_t *)calloc(1, sizeof(ep_randomizer_engine_t))) == NULL) {
+    return RC_CONSENSUS_OOM;
+  }
+  rw_lock_handle_init(&randomizer->engine->lock);
+  lock_handle_init(&randomizer->engine->build_lock);
+  return RC_OK;
 }
 
 retcode_t iota_consensus_random_walker_randomize(ep_randomizer_t const *const exit_probability_randomizer,
@@ -123,12 +368,41 @@ retcode_t iota_consensus_random_walker_randomize(ep_randomizer_t const *const ex
                                                  exit_prob_transaction_validator_t *const ep_validator,
                                                  cw_calc_result *const cw_result, flex_trit_t const *const ep,
                                                  flex_trit_t *tip) {
+  size_t num_steps = 0;
+
+  return iota_consensus_random_walker_walk(exit_probability_randomizer, tangle, ep_validator, cw_result, ep, tip,
+                                           &num_steps);
+}
+
+retcode_t iota_consensus_random_walker_alias_randomize(ep_randomizer_t const *const exit_probability_randomizer,
+                                                       tangle_t *const tangle,
+                                                       exit_prob_transaction_validator_t *const ep_validator,
+                                                       cw_calc_result *const cw_result, flex_trit_t const *const ep,
+                                                       flex_trit_t *tip) {
+  size_t num_steps = 0;
+
+  return iota_consensus_random_walker_walk(exit_probability_randomizer, tangle, ep_validator, cw_result, ep, tip,
+                                           &num_steps);
+}
+
+retcode_t iota_consensus_random_walker_walk(ep_randomizer_t const *const exit_probability_randomizer,
+                                           tangle_t *const tangle,
+                                           exit_prob_transaction_validator_t *const ep_validator,
+                                           cw_calc_result *const cw_result, flex_trit_t const *const ep,
+                                           flex_trit_t *const tip, size_t *const num_steps) {
   retcode_t ret = RC_OK;
+  ep_randomizer_engine_t *engine = exit_probability_randomizer->engine;
+  double const alpha = exit_probability_randomizer->conf->alpha;
+  subtangle_graph_t const *const graph = &cw_result->graph;
   bool ep_is_valid = false;
   bool has_approver_tail = false;
-  size_t num_traversed_tails = 1;
   flex_trit_t const *curr_tail_hash = ep;
   flex_trit_t approver_tail_hash[FLEX_TRIT_SIZE_243];
+  hash_to_indexed_hash_set_entry_t *ep_entry = NULL;
+  uint32_t curr_tail_id = SUBTANGLE_GRAPH_NO_VERTEX;
+
+  *num_steps = 0;
+
   if ((ret = iota_consensus_exit_prob_transaction_validator_is_valid(ep_validator, tangle, ep, &ep_is_valid)) !=
       RC_OK) {
     log_error(logger_id, "Entry point validation failed: %" PRIu64 "\n", ret);
@@ -138,19 +412,69 @@ retcode_t iota_consensus_random_walker_randomize(ep_randomizer_t const *const ex
     return RC_CONSENSUS_EXIT_PROBABILITIES_INVALID_ENTRYPOINT;
   }
 
-  do {
-    if ((ret = random_walker_select_approver_tail(exit_probability_randomizer, tangle, ep_validator, cw_result,
-                                                  curr_tail_hash, approver_tail_hash, &has_approver_tail)) != RC_OK) {
+  if (engine != NULL) {
+    // A new epoch is started under the write lock, then the tables are built and read under the read lock
+    rw_lock_handle_rdlock(&engine->lock);
+    while (engine->generation != graph->generation || engine->alpha != alpha) {
+      rw_lock_handle_unlock(&engine->lock);
+      rw_lock_handle_wrlock(&engine->lock);
+      if ((engine->generation != graph->generation || engine->alpha != alpha) &&
+          (ret = alias_tables_reset(engine, alpha, graph)) != RC_OK) {
+        log_error(logger_id, "Resetting alias tables failed: %" PRIu64 "\n", ret);
+        rw_lock_handle_unlock(&engine->lock);
+        return ret;
+      }
+      rw_lock_handle_unlock(&engine->lock);
+      rw_lock_handle_rdlock(&engine->lock);
+    }
+  }
+
+  HASH_FIND(hh, cw_result->tx_to_approvers, ep, FLEX_TRIT_SIZE_243, ep_entry);
+  curr_tail_id = ep_entry ? (uint32_t)ep_entry->idx : SUBTANGLE_GRAPH_NO_VERTEX;
+
+  while (curr_tail_id != SUBTANGLE_GRAPH_NO_VERTEX) {
+    if (engine != NULL) {
+      ret = alias_walker_select_approver_tail(engine, tangle, ep_validator, cw_result, curr_tail_id,
+                                              approver_tail_hash, &curr_tail_id, &has_approver_tail);
+    } else {
+      ret = random_walker_select_approver_tail(exit_probability_randomizer, tangle, ep_validator, cw_result,
+                                               curr_tail_id, approver_tail_hash, &curr_tail_id, &has_approver_tail);
+    }
+    if (ret != RC_OK) {
       log_error(logger_id, "Selecting approver tail failed: %" PRIu64 "\n", ret);
-      return ret;
-    } else if (has_approver_tail) {
-      curr_tail_hash = approver_tail_hash;
-      num_traversed_tails++;
+      goto done;
+    } else if (!has_approver_tail) {
+      break;
     }
-  } while (has_approver_tail);
+    curr_tail_hash = approver_tail_hash;
+    (*num_steps)++;
+  }
 
   memcpy(tip, curr_tail_hash, FLEX_TRIT_SIZE_243);
-  log_debug(logger_id, "Number of tails traversed to find tip: %" PRIu64 "\n", num_traversed_tails);
+  log_debug(logger_id, "Number of tails traversed to find tip: %" PRIu64 "\n", *num_steps + 1);
 
+done:
+  if (engine != NULL) {
+    rw_lock_handle_unlock(&engine->lock);
+  }
   return ret;
 }
+
+retcode_t iota_consensus_random_walker_alias_destroy(ep_randomizer_t *const exit_probability_randomizer) {
+  ep_randomizer_engine_t *engine = exit_probability_randomizer->engine;
+
+  if (engine == NULL) {
+    return RC_OK;
+  }
+  rw_lock_handle_destroy(&engine->lock);
+  lock_handle_destroy(&engine->build_lock);
+  for (uint32_t id = 0; id < engine->tables_capacity; id++) {
+    free(engine->tables[id].transition_probs);
+    free(engine->tables[id].alias_probs);
+    free(engine->tables[id].aliases);
+  }
+  free(engine->tables);
+  free(engine);
+  exit_probability_randomizer->engine = NULL;
+  return RC_OK;
+}
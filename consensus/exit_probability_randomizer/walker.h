@@ -18,6 +18,13 @@
 extern "C" {
 #endif
 
+// Once this share of the transition probabilities of a vertex belongs to
+// rejected approvers, the remaining ones are sampled linearly instead of from
+// the alias table
+#ifndef RANDOM_WALKER_ALIAS_MAX_REJECTED_PROB
+#define RANDOM_WALKER_ALIAS_MAX_REJECTED_PROB 0.5
+#endif
+
 void iota_consensus_random_walker_init(ep_randomizer_t *const randomizer);
 
 retcode_t iota_consensus_random_walker_randomize(ep_randomizer_t const *const exit_probability_randomizer,
@@ -26,11 +33,71 @@ retcode_t iota_consensus_random_walker_randomize(ep_randomizer_t const *const ex
                                                  cw_calc_result *const cw_result, flex_trit_t const *const ep,
                                                  flex_trit_t *tip);
 
+/**
+ * Initializes a walker keeping, for each vertex it visited on the last
+ * cumulative weights it walked on, the transition probabilities to its
+ * approvers and their Walker alias table
+ *
+ * @param randomizer The randomizer
+ *
+ * @return a status code
+ */
+retcode_t iota_consensus_random_walker_alias_init(ep_randomizer_t *const randomizer);
+
+/**
+ * Randomizes a tip as iota_consensus_random_walker_randomize does
+ * The alias tables are dropped in O(1), under a write lock, when the graph of
+ * the cumulative weights or alpha changed since the last walk, then the table
+ * of a vertex is built by the first walk visiting it and each step samples an
+ * approver in O(1). An approver without a valid tail is rejected by sampling
+ * again, without building the table again
+ *
+ * @param exit_probability_randomizer The randomizer
+ * @param tangle A tangle
+ * @param ep_validator The validator of the visited tails
+ * @param cw_result The cumulative weight data
+ * @param ep The entry point hash
+ * @param tip The selected tip hash
+ *
+ * @return a status code
+ */
+retcode_t iota_consensus_random_walker_alias_randomize(ep_randomizer_t const *const exit_probability_randomizer,
+                                                       tangle_t *const tangle,
+                                                       exit_prob_transaction_validator_t *const ep_validator,
+                                                       cw_calc_result *const cw_result, flex_trit_t const *const ep,
+                                                       flex_trit_t *tip);
+
+/**
+ * Walks from an entry point to a tip as the walker randomizers do
+ *
+ * @param exit_probability_randomizer A walker randomizer
+ * @param tangle A tangle
+ * @param ep_validator The validator of the visited tails
+ * @param cw_result The cumulative weight data
+ * @param ep The entry point hash
+ * @param tip The selected tip hash
+ * @param num_steps The number of approvers walked to
+ *
+ * @return a status code
+ */
+retcode_t iota_consensus_random_walker_walk(ep_randomizer_t const *const exit_probability_randomizer,
+                                           tangle_t *const tangle,
+                                           exit_prob_transaction_validator_t *const ep_validator,
+                                           cw_calc_result *const cw_result, flex_trit_t const *const ep,
+                                           flex_trit_t *const tip, size_t *const num_steps);
+
+retcode_t iota_consensus_random_walker_alias_destroy(ep_randomizer_t *const exit_probability_randomizer);
+
 static ep_randomizer_vtable random_walk_vtable = {
     .exit_probability_randomize = iota_consensus_random_walker_randomize,
     .exit_probability_destroy = NULL,
 };
 
+static ep_randomizer_vtable random_walk_alias_vtable = {
+    .exit_probability_randomize = iota_consensus_random_walker_alias_randomize,
+    .exit_probability_destroy = iota_consensus_random_walker_alias_destroy,
+};
+
 #ifdef __cplusplus
 }
 #endif
@@ -47,17 +47,15 @@ static retcode_t update_snapshot_milestone_do_func(flex_trit_t *const hash, iota
 }
 
 static retcode_t update_snapshot_milestone(ledger_validator_t const *const lv, tangle_t const *const tangle,
-                                           flex_trit_t *const hash, uint64_t index) {
+                                           flex_trit_t *const hash, uint64_t index,
+                                           hash243_set_t *const hashes_to_update) {
   retcode_t ret;
-  hash243_set_t hashes_to_update = NULL;
 
   if ((ret = tangle_traversal_dfs_to_genesis(tangle, update_snapshot_milestone_do_func, hash, lv->conf->genesis_hash,
-                                             NULL, &hashes_to_update)) != RC_OK) {
+                                             NULL, hashes_to_update)) != RC_OK) {
     return ret;
   }
-  ret = iota_tangle_transactions_update_snapshot_index(tangle, hashes_to_update, index);
-  hash243_set_free(&hashes_to_update);
-  return ret;
+  return iota_tangle_transactions_update_snapshot_index(tangle, *hashes_to_update, index);
 }
 
 static retcode_t build_snapshot(ledger_validator_t const *const lv, tangle_t const *const tangle,
@@ -122,8 +120,6 @@ static retcode_t get_latest_delta_do_func(flex_trit_t *hash, iota_stor_pack_t *p
                                           bool *should_stop) {
   retcode_t ret = RC_OK;
   bundle_status_t bundle_status = BUNDLE_NOT_INITIALIZED;
-  bundle_transactions_t *bundle = NULL;
-  iota_transaction_t *tx_bundle = NULL;
 
   *should_stop = false;
   *should_branch = false;
@@ -134,30 +130,19 @@ static retcode_t get_latest_delta_do_func(flex_trit_t *hash, iota_stor_pack_t *p
   if (transaction_snapshot_index(tx) == 0 || transaction_snapshot_index(tx) > params->latest_snapshot_index) {
     *should_branch = true;
     if (transaction_current_index(tx) == 0) {
-      bundle_transactions_new(&bundle);
-      if ((ret = iota_consensus_bundle_validator_validate(tangle, hash, bundle, &bundle_status)) != RC_OK) {
+      if ((ret = iota_consensus_bundle_validator_validate_delta(tangle, hash, params->state, &bundle_status)) !=
+          RC_OK) {
         goto done;
       }
-      if (bundle_status != BUNDLE_VALID || (tx_bundle = (iota_transaction_t *)utarray_eltptr(bundle, 0)) == NULL) {
+      if (bundle_status != BUNDLE_VALID) {
         params->valid_delta = false;
         *should_stop = true;
         goto done;
       }
-      while (tx_bundle != NULL) {
-        if (transaction_value(tx_bundle) != 0) {
-          if ((ret = state_delta_add_or_sum(params->state, transaction_address(tx_bundle),
-                                            transaction_value(tx_bundle))) != RC_OK) {
-            goto done;
-          }
-        }
-        tx_bundle = (iota_transaction_t *)utarray_next(bundle, tx_bundle);
-      }
-      bundle_transactions_free(&bundle);
     }
   }
 
 done:
-  bundle_transactions_free(&bundle);
   if (ret != RC_OK) {
     *should_stop = true;
     params->valid_delta = false;
@@ -217,6 +202,7 @@ retcode_t iota_consensus_ledger_validator_update_snapshot(ledger_validator_t con
   bool valid_delta = true;
   state_delta_t delta = NULL;
   state_delta_t patch = NULL;
+  hash243_set_t confirmed_hashes = NULL;
   DECLARE_PACK_SINGLE_TX(tx, tx_ptr, pack);
   *has_snapshot = false;
 
@@ -247,7 +233,8 @@ retcode_t iota_consensus_ledger_validator_update_snapshot(ledger_validator_t con
       goto done;
     }
     if ((*has_snapshot = state_delta_is_consistent(&patch))) {
-      if ((ret = update_snapshot_milestone(lv, tangle, milestone->hash, milestone->index)) != RC_OK) {
+      if ((ret = update_snapshot_milestone(lv, tangle, milestone->hash, milestone->index, &confirmed_hashes)) !=
+          RC_OK) {
         log_error(logger_id, "Updating snapshot milestone failed\n");
         goto done;
       }
@@ -261,12 +248,15 @@ retcode_t iota_consensus_ledger_validator_update_snapshot(ledger_validator_t con
         log_error(logger_id, "Applying patch failed\n");
         goto done;
       }
+      // Bundles confirmed by the milestone are not walked through anymore
+      iota_consensus_bundle_validator_evict(confirmed_hashes);
     }
   }
 
 done:
   state_delta_destroy(&delta);
   state_delta_destroy(&patch);
+  hash243_set_free(&confirmed_hashes);
   return ret;
 }
 
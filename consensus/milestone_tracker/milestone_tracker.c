@@ -10,6 +10,7 @@
 
 #include "common/crypto/iss/normalize.h"
 #include "common/crypto/iss/v1/iss.h"
+#include "common/crypto/iss/v1/iss_verifier.h"
 #include "common/trinary/trit_long.h"
 #include "consensus/bundle_validator/bundle_validator.h"
 #include "consensus/ledger_validator/ledger_validator.h"
@@ -53,29 +54,42 @@ static bool is_milestone_bundle_structure_valid(bundle_transactions_t const* con
 // This function assumes the bundle is valid
 static retcode_t validate_coordinator(milestone_tracker_t* const mt, iota_milestone_t* const candidate,
                                       bundle_transactions_t const* const bundle, bool* valid) {
+  retcode_t ret = RC_OK;
   iota_transaction_t* tx = NULL;
-  trit_t signature_trits[NUM_TRITS_SIGNATURE];
+  size_t const security_level = mt->conf->coordinator_security_level;
+  trit_t signatures_trits[security_level * NUM_TRITS_SIGNATURE];
   trit_t siblings_trits[NUM_TRITS_SIGNATURE];
   trit_t signed_hash[HASH_LENGTH_TRIT];
-  trit_t digest[mt->conf->coordinator_security_level * HASH_LENGTH_TRIT];
+  trit_t digest[security_level * HASH_LENGTH_TRIT];
   trit_t root[HASH_LENGTH_TRIT];
   flex_trit_t coo[FLEX_TRIT_SIZE_243];
+  iss_verifier_job_t jobs[security_level];
   sponge_t sponge;
 
   *valid = false;
-  tx = (iota_transaction_t*)utarray_eltptr(bundle, mt->conf->coordinator_security_level);
+  tx = (iota_transaction_t*)utarray_eltptr(bundle, security_level);
   flex_trits_to_trits(siblings_trits, NUM_TRITS_SIGNATURE, transaction_signature(tx), NUM_TRITS_SIGNATURE,
                       NUM_TRITS_SIGNATURE);
-  sponge_init(&sponge, mt->conf->coordinator_signature_type);
   normalize_flex_hash_to_trits(transaction_hash(tx), signed_hash);
-  for (int i = 0; i < mt->conf->coordinator_security_level; i++) {
+  for (size_t i = 0; i < security_level; i++) {
     tx = (iota_transaction_t*)utarray_eltptr(bundle, i);
-    flex_trits_to_trits(signature_trits, NUM_TRITS_SIGNATURE, transaction_signature(tx), NUM_TRITS_SIGNATURE,
+    jobs[i].hash = signed_hash + i * ISS_CHUNK_LENGTH;
+    jobs[i].sig = signatures_trits + i * NUM_TRITS_SIGNATURE;
+    jobs[i].sig_len = NUM_TRITS_SIGNATURE;
+    jobs[i].digest = digest + i * HASH_LENGTH_TRIT;
+    flex_trits_to_trits(jobs[i].sig, NUM_TRITS_SIGNATURE, transaction_signature(tx), NUM_TRITS_SIGNATURE,
                         NUM_TRITS_SIGNATURE);
-    iss_sig_digest(&sponge, digest + i * HASH_LENGTH_TRIT, signed_hash + i * ISS_CHUNK_LENGTH, signature_trits,
-                   NUM_TRITS_SIGNATURE);
   }
-  iss_address(&sponge, digest, root, mt->conf->coordinator_security_level * HASH_LENGTH_TRIT);
+  // The fragments of all signatures are hashed concurrently
+  if ((ret = iss_verifier_sig_digests(mt->iss_verifier, mt->conf->coordinator_signature_type, jobs,
+                                      security_level)) != RC_OK) {
+    return ret;
+  }
+
+  if ((ret = sponge_init(&sponge, mt->conf->coordinator_signature_type)) != RC_OK) {
+    return ret;
+  }
+  iss_address(&sponge, digest, root, security_level * HASH_LENGTH_TRIT);
   iss_merkle_root(&sponge, root, siblings_trits, mt->conf->coordinator_num_keys_in_milestone, candidate->index);
   flex_trits_from_trits(coo, HASH_LENGTH_TRIT, root, HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
   if (memcmp(coo, mt->conf->coordinator_address, FLEX_TRIT_SIZE_243) == 0) {
@@ -317,7 +331,7 @@ static void* milestone_solidifier(void* arg) {
 
 retcode_t iota_milestone_tracker_init(milestone_tracker_t* const mt, iota_consensus_conf_t* const conf,
                                       snapshot_t* const snapshot, ledger_validator_t* const lv,
-                                      transaction_solidifier_t* const ts) {
+                                      transaction_solidifier_t* const ts, iss_verifier_t* const iss_verifier) {
   if (mt == NULL) {
     return RC_CONSENSUS_MT_NULL_SELF;
   }
@@ -329,6 +343,7 @@ retcode_t iota_milestone_tracker_init(milestone_tracker_t* const mt, iota_consen
   mt->latest_snapshot = snapshot;
   mt->ledger_validator = lv;
   mt->transaction_solidifier = ts;
+  mt->iss_verifier = iss_verifier;
   mt->candidates = NULL;
   rw_lock_handle_init(&mt->candidates_lock);
   mt->milestone_start_index = conf->last_milestone;
@@ -10,6 +10,7 @@
 
 #include <stdbool.h>
 
+#include "common/crypto/iss/v1/iss_verifier.h"
 #include "common/crypto/sponge/sponge.h"
 #include "common/errors.h"
 #include "common/model/milestone.h"
@@ -54,6 +55,8 @@ typedef struct milestone_tracker_s {
   transaction_solidifier_t* transaction_solidifier;
   hash243_queue_t candidates;
   rw_lock_handle_t candidates_lock;
+  // Computes the digests of the coordinator signatures, NULL to compute them in the validating thread
+  iss_verifier_t* iss_verifier;
   // bool accept_any_testnet_coo;
 } milestone_tracker_t;
 
@@ -64,12 +67,14 @@ typedef struct milestone_tracker_s {
  * @param conf Consensus configuration
  * @param snapshot An initial snapshot
  * @param lv A ledger validator
+ * @param ts A transaction solidifier
+ * @param iss_verifier The verifier computing signature digests, may be NULL
  *
  * @return a status code
  */
 retcode_t iota_milestone_tracker_init(milestone_tracker_t* const mt, iota_consensus_conf_t* const conf,
                                       snapshot_t* const snapshot, ledger_validator_t* const lv,
-                                      transaction_solidifier_t* ts);
+                                      transaction_solidifier_t* ts, iss_verifier_t* const iss_verifier);
 
 /**
  * Starts a milestone tracker
@@ -34,7 +34,7 @@ void milestone_validation_curl_p_27_sec_lvl_1(void) {
   conf.coordinator_max_milestone_index = 1 << conf.coordinator_num_keys_in_milestone;
   conf.coordinator_security_level = 1;
   conf.coordinator_signature_type = SPONGE_CURLP27;
-  TEST_ASSERT(iota_milestone_tracker_init(&mt, &conf, NULL, NULL, NULL) == RC_OK);
+  TEST_ASSERT(iota_milestone_tracker_init(&mt, &conf, NULL, NULL, NULL, NULL) == RC_OK);
 
   iota_transaction_t *txs[2];
   tryte_t const *const trytes[2] = {(tryte_t*)
@@ -114,7 +114,7 @@ void milestone_validation_kerl_sec_lvl_1(void) {
   conf.coordinator_max_milestone_index = 1 << conf.coordinator_num_keys_in_milestone;
   conf.coordinator_security_level = 1;
   conf.coordinator_signature_type = SPONGE_KERL;
-  TEST_ASSERT(iota_milestone_tracker_init(&mt, &conf, NULL, NULL, NULL) == RC_OK);
+  TEST_ASSERT(iota_milestone_tracker_init(&mt, &conf, NULL, NULL, NULL, NULL) == RC_OK);
 
   iota_transaction_t *txs[2];
   tryte_t const *const trytes[2] = {(tryte_t*)
@@ -194,7 +194,7 @@ void milestone_validation_curl_p_27_sec_lvl_3(void) {
   conf.coordinator_max_milestone_index = 1 << conf.coordinator_num_keys_in_milestone;
   conf.coordinator_security_level = 3;
   conf.coordinator_signature_type = SPONGE_CURLP27;
-  TEST_ASSERT(iota_milestone_tracker_init(&mt, &conf, NULL, NULL, NULL) == RC_OK);
+  TEST_ASSERT(iota_milestone_tracker_init(&mt, &conf, NULL, NULL, NULL, NULL) == RC_OK);
 
   iota_transaction_t *txs[4];
   tryte_t const *const trytes[4] = { (tryte_t*)
@@ -324,7 +324,7 @@ void milestone_validation_kerl_sec_lvl_3(void) {
   conf.coordinator_max_milestone_index = 1 << conf.coordinator_num_keys_in_milestone;
   conf.coordinator_security_level = 3;
   conf.coordinator_signature_type = SPONGE_KERL;
-  TEST_ASSERT(iota_milestone_tracker_init(&mt, &conf, NULL, NULL, NULL) == RC_OK);
+  TEST_ASSERT(iota_milestone_tracker_init(&mt, &conf, NULL, NULL, NULL, NULL) == RC_OK);
 
   iota_transaction_t *txs[4];
   tryte_t const *const trytes[4] = { (tryte_t*)
@@ -14,16 +14,102 @@
 
 static logger_id_t logger_id;
 
+static field_mask_t const TRANSACTION_MASK_FULL = {.essence = MASK_ESSENCE_ALL,
+                                                   .attachment = MASK_ATTACHMENT_ALL,
+                                                   .consensus = MASK_CONSENSUS_ALL,
+                                                   .data = MASK_DATA_ALL,
+                                                   .metadata = 0};
+
+static field_mask_t const PARTIAL_TX_MODEL_MASKS[] = {
+    [PARTIAL_TX_MODEL_METADATA] = {.metadata = MASK_METADATA_ALL},
+    [PARTIAL_TX_MODEL_ESSENCE_METADATA] = {.essence = MASK_ESSENCE_ALL, .metadata = MASK_METADATA_ALL},
+    [PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA] = {.essence = MASK_ESSENCE_ALL,
+                                                      .attachment = MASK_ATTACHMENT_ALL,
+                                                      .metadata = MASK_METADATA_ALL},
+    [PARTIAL_TX_MODEL_ESSENCE_CONSENSUS] = {.essence = MASK_ESSENCE_ALL, .consensus = MASK_CONSENSUS_ALL},
+};
+
+typedef retcode_t (*transaction_loader_t)(storage_connection_t const *const connection,
+                                          flex_trit_t const *const hash, iota_stor_pack_t *const pack);
+
 retcode_t iota_tangle_init(tangle_t *const tangle, connection_config_t const *const conf) {
+  retcode_t ret = RC_OK;
+
   logger_id = logger_helper_enable(TANGLE_LOGGER_ID, LOGGER_DEBUG, true);
-  return connection_init(&tangle->connection, conf);
+  tangle->cache = NULL;
+
+  if ((ret = connection_init(&tangle->connection, conf)) != RC_OK) {
+    return ret;
+  }
+
+  return transaction_cache_acquire(conf->db_path, &tangle->cache);
 }
 
 retcode_t iota_tangle_destroy(tangle_t *const tangle) {
   logger_helper_release(logger_id);
+  if (tangle->cache) {
+    transaction_cache_release(tangle->cache);
+    tangle->cache = NULL;
+  }
   return connection_destroy(&tangle->connection);
 }
 
+/*
+ * Transaction cache
+ */
+
+static retcode_t transaction_load_by_hash(storage_connection_t const *const connection,
+                                          flex_trit_t const *const hash, iota_stor_pack_t *const pack) {
+  return iota_stor_transaction_load(connection, TRANSACTION_FIELD_HASH, hash, pack);
+}
+
+// Serves a load from the transaction cache, falling back to the storage and filling the cache on a miss
+static retcode_t transaction_load_cached(tangle_t const *const tangle, flex_trit_t const *const hash,
+                                         field_mask_t const *const mask, transaction_loader_t const loader,
+                                         iota_stor_pack_t *const pack) {
+  retcode_t ret = RC_OK;
+  iota_transaction_t *tx = NULL;
+  uint64_t ticket = 0;
+
+  if (tangle->cache == NULL || pack->num_loaded == pack->capacity) {
+    return loader(&tangle->connection, hash, pack);
+  }
+
+  tx = (iota_transaction_t *)pack->models[pack->num_loaded];
+  if (transaction_cache_load(tangle->cache, hash, mask, tx, &ticket)) {
+    pack->num_loaded++;
+    return RC_OK;
+  }
+
+  if ((ret = loader(&tangle->connection, hash, pack)) == RC_OK && pack->num_loaded > 0 &&
+      pack->models[pack->num_loaded - 1] == tx) {
+    // Caching is best effort, a failure only costs a future storage load
+    transaction_cache_store(tangle->cache, hash, tx, mask, ticket);
+  }
+
+  return ret;
+}
+
+// Entries are invalidated after the storage update so that a concurrent miss can not cache the old values
+
+static retcode_t transaction_cache_invalidate_do_func(transaction_cache_t *const cache,
+                                                      flex_trit_t const *const hash) {
+  transaction_cache_invalidate(cache, hash);
+  return RC_OK;
+}
+
+static void transactions_cache_invalidate(tangle_t const *const tangle, hash243_set_t const hashes) {
+  if (tangle->cache) {
+    hash243_set_for_each(&hashes, (hash243_on_container_func)transaction_cache_invalidate_do_func, tangle->cache);
+  }
+}
+
+static void transaction_cache_invalidate_one(tangle_t const *const tangle, flex_trit_t const *const hash) {
+  if (tangle->cache) {
+    transaction_cache_invalidate(tangle->cache, hash);
+  }
+}
+
 /*
  * Transaction operations
  */
@@ -36,19 +122,33 @@ retcode_t iota_tangle_transaction_store(tangle_t const *const tangle, iota_trans
   return iota_stor_transaction_store(&tangle->connection, tx);
 }
 
+retcode_t iota_tangle_transactions_store_batch(tangle_t const *const tangle, iota_transaction_t const *const *const txs,
+                                               size_t const count, bool *const stored) {
+  return iota_stor_transactions_store_batch(&tangle->connection, txs, count, stored);
+}
+
 retcode_t iota_tangle_transaction_load(tangle_t const *const tangle, transaction_field_t const field,
                                        flex_trit_t const *const key, iota_stor_pack_t *const tx) {
+  if (field == TRANSACTION_FIELD_HASH) {
+    return transaction_load_cached(tangle, key, &TRANSACTION_MASK_FULL, transaction_load_by_hash, tx);
+  }
   return iota_stor_transaction_load(&tangle->connection, field, key, tx);
 }
 
 retcode_t iota_tangle_transaction_update_solid_state(tangle_t const *const tangle, flex_trit_t const *const hash,
                                                      bool const state) {
-  return iota_stor_transaction_update_solid_state(&tangle->connection, hash, state);
+  retcode_t ret = iota_stor_transaction_update_solid_state(&tangle->connection, hash, state);
+
+  transaction_cache_invalidate_one(tangle, hash);
+  return ret;
 }
 
 retcode_t iota_tangle_transactions_update_solid_state(tangle_t const *const tangle, hash243_set_t const hashes,
                                                       bool const is_solid) {
-  return iota_stor_transactions_update_solid_state(&tangle->connection, hashes, is_solid);
+  retcode_t ret = iota_stor_transactions_update_solid_state(&tangle->connection, hashes, is_solid);
+
+  transactions_cache_invalidate(tangle, hashes);
+  return ret;
 }
 
 retcode_t iota_tangle_transaction_load_hashes_of_approvers(tangle_t const *const tangle,
@@ -75,17 +175,21 @@ retcode_t iota_tangle_transaction_load_hashes_of_approvers(tangle_t const *const
 
 retcode_t iota_tangle_transaction_load_partial(tangle_t const *const tangle, flex_trit_t const *const hash,
                                                iota_stor_pack_t *const pack, partial_transaction_model_e models_mask) {
+  transaction_loader_t loader = NULL;
+
   if (models_mask == PARTIAL_TX_MODEL_METADATA) {
-    return iota_stor_transaction_load_metadata(&tangle->connection, hash, pack);
+    loader = iota_stor_transaction_load_metadata;
   } else if (models_mask == PARTIAL_TX_MODEL_ESSENCE_METADATA) {
-    return iota_stor_transaction_load_essence_and_metadata(&tangle->connection, hash, pack);
+    loader = iota_stor_transaction_load_essence_and_metadata;
   } else if (models_mask == PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA) {
-    return iota_stor_transaction_load_essence_attachment_and_metadata(&tangle->connection, hash, pack);
+    loader = iota_stor_transaction_load_essence_attachment_and_metadata;
   } else if (models_mask == PARTIAL_TX_MODEL_ESSENCE_CONSENSUS) {
-    return iota_stor_transaction_load_essence_and_consensus(&tangle->connection, hash, pack);
+    loader = iota_stor_transaction_load_essence_and_consensus;
   } else {
     return RC_CONSENSUS_NOT_IMPLEMENTED;
   }
+
+  return transaction_load_cached(tangle, hash, &PARTIAL_TX_MODEL_MASKS[models_mask], loader, pack);
 }
 
 retcode_t iota_tangle_transaction_load_hashes_of_requests(tangle_t const *const tangle, iota_stor_pack_t *const pack,
@@ -154,12 +258,18 @@ retcode_t iota_tangle_transaction_load_hashes_of_milestone_candidates(tangle_t c
 
 retcode_t iota_tangle_transaction_update_snapshot_index(tangle_t const *const tangle, flex_trit_t const *const hash,
                                                         uint64_t const snapshot_index) {
-  return iota_stor_transaction_update_snapshot_index(&tangle->connection, hash, snapshot_index);
+  retcode_t ret = iota_stor_transaction_update_snapshot_index(&tangle->connection, hash, snapshot_index);
+
+  transaction_cache_invalidate_one(tangle, hash);
+  return ret;
 }
 
 retcode_t iota_tangle_transactions_update_snapshot_index(tangle_t const *const tangle, hash243_set_t const hashes,
                                                          uint64_t const snapshot_index) {
-  return iota_stor_transactions_update_snapshot_index(&tangle->connection, hashes, snapshot_index);
+  retcode_t ret = iota_stor_transactions_update_snapshot_index(&tangle->connection, hashes, snapshot_index);
+
+  transactions_cache_invalidate(tangle, hashes);
+  return ret;
 }
 
 retcode_t iota_tangle_transaction_exist(tangle_t const *const tangle, transaction_field_t const field,
@@ -212,6 +322,14 @@ retcode_t iota_tangle_milestone_exist(tangle_t const *const tangle, flex_trit_t
  * Utilities
  */
 
+retcode_t iota_tangle_cache_stats(tangle_t const *const tangle, transaction_cache_stats_t *const stats) {
+  if (tangle->cache == NULL) {
+    return RC_NULL_PARAM;
+  }
+  transaction_cache_stats(tangle->cache, stats);
+  return RC_OK;
+}
+
 retcode_t iota_tangle_find_tail(tangle_t const *const tangle, flex_trit_t const *const tx_hash, flex_trit_t *const tail,
                                 bool *const found_tail) {
   retcode_t res = RC_OK;
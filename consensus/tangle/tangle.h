@@ -16,6 +16,7 @@
 #include "common/storage/connection.h"
 #include "common/storage/defs.h"
 #include "common/storage/storage.h"
+#include "common/storage/transaction_cache.h"
 #include "common/trinary/flex_trit.h"
 #include "consensus/snapshot/state_delta.h"
 #include "utils/containers/hash/hash243_queue.h"
@@ -28,6 +29,8 @@ extern "C" {
 
 typedef struct tangle_s {
   storage_connection_t connection;
+  // Shared by all tangles opened on the same database
+  transaction_cache_t *cache;
 } tangle_t;
 
 typedef enum _partial_transaction_model {
@@ -50,6 +53,20 @@ retcode_t iota_tangle_transaction_count(tangle_t const *const tangle, size_t *co
 
 retcode_t iota_tangle_transaction_store(tangle_t const *const tangle, iota_transaction_t const *const tx);
 
+/**
+ * Stores a batch of transactions in a single storage transaction
+ * Transactions already persisted, or appearing twice in the batch, are skipped
+ *
+ * @param tangle The tangle
+ * @param txs The transactions
+ * @param count The number of transactions
+ * @param stored Filled with, for each transaction, whether it was newly stored
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_transactions_store_batch(tangle_t const *const tangle, iota_transaction_t const *const *const txs,
+                                               size_t const count, bool *const stored);
+
 retcode_t iota_tangle_transaction_load(tangle_t const *const tangle, transaction_field_t const field,
                                        flex_trit_t const *const key, iota_stor_pack_t *const tx);
 
@@ -174,6 +191,16 @@ retcode_t iota_tangle_state_delta_load(tangle_t const *const tangle, uint64_t co
  * Utilities
  */
 
+/**
+ * Gets the counters of the transaction cache of the tangle
+ *
+ * @param tangle The tangle
+ * @param stats The counters
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_cache_stats(tangle_t const *const tangle, transaction_cache_stats_t *const stats);
+
 retcode_t iota_tangle_find_tail(tangle_t const *const tangle, flex_trit_t const *const tx_hash, flex_trit_t *const tail,
                                 bool *const found_tail);
 
@@ -5,6 +5,7 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "consensus/tangle/tangle.h"
@@ -62,3 +63,40 @@ retcode_t build_tangle(tangle_t *const tangle, iota_transaction_t **txs, size_t
 
   return RC_OK;
 }
+
+retcode_t extend_random_tangle(tangle_t *const tangle, iota_transaction_t const *const tx,
+                               iota_transaction_t *const txs, size_t const first, size_t const num_transactions,
+                               size_t const window, bool const solid, uint64_t const snapshot_index) {
+  retcode_t ret = RC_OK;
+  size_t lowest;
+  uint32_t id;
+
+  for (size_t i = first; i < first + num_transactions; i++) {
+    txs[i] = *tx;
+    // Different hash for each tx, we don't worry about it not being valid encoding
+    id = (uint32_t)i + 1;
+    memcpy(txs[i].consensus.hash, &id, sizeof(id));
+    if (i > 0) {
+      lowest = i > window ? i - window : 0;
+      transaction_set_trunk(&txs[i], transaction_hash(&txs[lowest + rand() % (i - lowest)]));
+      transaction_set_branch(&txs[i], transaction_hash(&txs[lowest + rand() % (i - lowest)]));
+    }
+    if ((ret = iota_tangle_transaction_store(tangle, &txs[i])) != RC_OK) {
+      return ret;
+    }
+    if (solid &&
+        ((ret = iota_tangle_transaction_update_solid_state(tangle, transaction_hash(&txs[i]), true)) != RC_OK ||
+         (ret = iota_tangle_transaction_update_snapshot_index(tangle, transaction_hash(&txs[i]), snapshot_index)) !=
+             RC_OK)) {
+      return ret;
+    }
+  }
+
+  return ret;
+}
+
+retcode_t build_random_tangle(tangle_t *const tangle, iota_transaction_t const *const tx, iota_transaction_t *const txs,
+                              size_t const num_transactions, size_t const window, bool const solid,
+                              uint64_t const snapshot_index) {
+  return extend_random_tangle(tangle, tx, txs, 0, num_transactions, window, solid, snapshot_index);
+}
@@ -26,7 +26,16 @@ void transactions_deserialize(tryte_t const *const *const transactions_trytes, i
 
 retcode_t build_tangle(tangle_t *const tangle, iota_transaction_t **txs, size_t num_transactions);
 
-void transactions_free(iota_transaction_t **txs, size_t num_transactions);
+// Stores copies of a transaction as txs[first] to txs[first + num_transactions - 1], each one approving two random
+// transactions among the previous ones, at most a window away, and marked solid with a snapshot index if solid is true
+retcode_t extend_random_tangle(tangle_t *const tangle, iota_transaction_t const *const tx,
+                               iota_transaction_t *const txs, size_t const first, size_t const num_transactions,
+                               size_t const window, bool const solid, uint64_t const snapshot_index);
+
+// Stores a random tangle of num_transactions transactions as extend_random_tangle does, txs[0] being the entry point
+retcode_t build_random_tangle(tangle_t *const tangle, iota_transaction_t const *const tx, iota_transaction_t *const txs,
+                              size_t const num_transactions, size_t const window, bool const solid,
+                              uint64_t const snapshot_index);
 
 #ifdef __cplusplus
 }
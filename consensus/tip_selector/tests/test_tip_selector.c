@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+#include <unity/unity.h>
+
+#include "common/model/transaction.h"
+#include "common/storage/storage.h"
+#include "common/storage/tests/helpers/defs.h"
+#include "consensus/test_utils/tangle.h"
+#include "consensus/tip_selector/tip_selector.h"
+#include "consensus/transaction_solidifier/transaction_solidifier.h"
+#include "utils/handles/thread.h"
+#include "utils/time.h"
+
+#define NUM_TXS 20
+#define NUM_PAIRS 8
+#define BATCH_WINDOW_MS 2000
+
+static char *test_db_path = "consensus/tip_selector/tests/test.db";
+static char *ciri_db_path = "consensus/tip_selector/tests/ciri.db";
+static char *snapshot_path = "consensus/snapshot/tests/snapshot.txt";
+static char *snapshot_conf_path = "consensus/snapshot/tests/snapshot_conf.json";
+
+static uint32_t max_depth = 15;
+
+static tangle_t tangle;
+static connection_config_t config;
+static iota_consensus_conf_t conf;
+static snapshot_t snapshot;
+static transaction_solidifier_t ts;
+static milestone_tracker_t mt;
+static ledger_validator_t lv;
+static exit_prob_transaction_validator_t epv;
+static cw_rating_calculator_t calc;
+static entry_point_selector_t eps;
+static ep_randomizer_t randomizer;
+static tip_selector_t tip_selector;
+static iota_transaction_t txs[NUM_TXS];
+
+typedef struct request_s {
+  size_t depth;
+  tips_pair_t tips;
+  retcode_t ret;
+} request_t;
+
+void setUp() { TEST_ASSERT(tangle_setup(&tangle, &config, test_db_path, ciri_db_path) == RC_OK); }
+
+void tearDown() { TEST_ASSERT(tangle_cleanup(&tangle, test_db_path) == RC_OK); }
+
+// Builds a blockchain of solid transactions, the first one being the entry point and the last one the only tip
+static void init_tip_selector() {
+  flex_trit_t tx_trits[FLEX_TRIT_SIZE_8019];
+  iota_transaction_t *tx = NULL;
+
+  flex_trits_from_trytes(tx_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES, NUM_TRITS_SERIALIZED_TRANSACTION,
+                         NUM_TRYTES_SERIALIZED_TRANSACTION);
+  TEST_ASSERT_NOT_NULL(tx = transaction_deserialize(tx_trits, true));
+  for (size_t i = 0; i < NUM_TXS; i++) {
+    txs[i] = *tx;
+    // Different hash for each tx, we don't worry about it not being valid encoding
+    txs[i].consensus.hash[0] += i;
+    if (i > 0) {
+      transaction_set_branch(&txs[i], transaction_hash(&txs[i - 1]));
+    }
+    TEST_ASSERT(iota_tangle_transaction_store(&tangle, &txs[i]) == RC_OK);
+    TEST_ASSERT(iota_tangle_transaction_update_solid_state(&tangle, transaction_hash(&txs[i]), true) == RC_OK);
+    TEST_ASSERT(iota_tangle_transaction_update_snapshot_index(&tangle, transaction_hash(&txs[i]), max_depth) == RC_OK);
+  }
+  transaction_free(tx);
+
+  TEST_ASSERT(iota_snapshot_init(&snapshot, &conf) == RC_OK);
+  TEST_ASSERT(iota_consensus_transaction_solidifier_init(&ts, &conf, NULL, NULL, NULL) == RC_OK);
+  TEST_ASSERT(iota_milestone_tracker_init(&mt, &conf, &snapshot, &lv, &ts, NULL) == RC_OK);
+  TEST_ASSERT(iota_consensus_ledger_validator_init(&lv, &tangle, &conf, &mt) == RC_OK);
+
+  // We want to avoid unnecessary validation
+  mt.latest_snapshot->index = 9999999;
+  mt.latest_solid_subtangle_milestone_index = max_depth;
+  // Without milestones in the tangle, the latest solid one is the entry point of any depth
+  memcpy(mt.latest_solid_subtangle_milestone, transaction_hash(&txs[0]), FLEX_TRIT_SIZE_243);
+
+  TEST_ASSERT(iota_consensus_exit_prob_transaction_validator_init(&conf, &mt, &lv, &epv) == RC_OK);
+  TEST_ASSERT(iota_consensus_cw_rating_init(&calc, DFS_FROM_ENTRY_POINT) == RC_OK);
+  TEST_ASSERT(iota_consensus_entry_point_selector_init(&eps, &mt) == RC_OK);
+  TEST_ASSERT(iota_consensus_ep_randomizer_init(&randomizer, &conf, EP_RANDOM_WALK) == RC_OK);
+  TEST_ASSERT(iota_consensus_tip_selector_init(&tip_selector, &conf, &calc, &eps, &randomizer, &epv, &lv, &mt) ==
+              RC_OK);
+}
+
+static void destroy_tip_selector() {
+  TEST_ASSERT(iota_consensus_tip_selector_destroy(&tip_selector) == RC_OK);
+  TEST_ASSERT(iota_consensus_ep_randomizer_destroy(&randomizer) == RC_OK);
+  TEST_ASSERT(iota_consensus_entry_point_selector_destroy(&eps) == RC_OK);
+  TEST_ASSERT(iota_consensus_cw_rating_destroy(&calc) == RC_OK);
+  iota_consensus_exit_prob_transaction_validator_destroy(&epv);
+  iota_consensus_ledger_validator_destroy(&lv);
+  iota_milestone_tracker_destroy(&mt);
+  iota_consensus_transaction_solidifier_destroy(&ts);
+  iota_snapshot_destroy(&snapshot);
+}
+
+static void assert_tips(tips_pair_t const *const tips) {
+  TEST_ASSERT_EQUAL_MEMORY(transaction_hash(&txs[NUM_TXS - 1]), tips->trunk, FLEX_TRIT_SIZE_243);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_hash(&txs[NUM_TXS - 1]), tips->branch, FLEX_TRIT_SIZE_243);
+}
+
+static void *request(void *arg) {
+  request_t *req = (request_t *)arg;
+
+  req->ret = iota_consensus_tip_selector_get_transactions_to_approve(&tip_selector, &tangle, req->depth, NULL,
+                                                                     &req->tips);
+  return NULL;
+}
+
+// Waits until the pending batch holds a number of requests
+static void wait_pending_batch(size_t const num_requests) {
+  bool pending = false;
+
+  while (!pending) {
+    lock_handle_lock(&tip_selector.batch_lock);
+    pending = tip_selector.pending_batch != NULL && tip_selector.pending_batch->num_requests == num_requests;
+    lock_handle_unlock(&tip_selector.batch_lock);
+    if (!pending) {
+      sleep_ms(1);
+    }
+  }
+}
+
+void test_batch(void) {
+  tips_pair_t tips[NUM_PAIRS];
+  retcode_t rets[NUM_PAIRS];
+
+  init_tip_selector();
+
+  TEST_ASSERT(iota_consensus_tip_selector_get_transactions_to_approve_batch(&tip_selector, &tangle, max_depth, NULL,
+                                                                            tips, rets, NUM_PAIRS) == RC_OK);
+  for (size_t i = 0; i < NUM_PAIRS; i++) {
+    TEST_ASSERT(rets[i] == RC_OK);
+    assert_tips(&tips[i]);
+  }
+
+  // The walker threads keep their connections for the next batches
+  TEST_ASSERT(iota_consensus_tip_selector_get_transactions_to_approve_batch(&tip_selector, &tangle, max_depth, NULL,
+                                                                            tips, rets, NUM_PAIRS) == RC_OK);
+  for (size_t i = 0; i < NUM_PAIRS; i++) {
+    TEST_ASSERT(rets[i] == RC_OK);
+    assert_tips(&tips[i]);
+  }
+
+  destroy_tip_selector();
+}
+
+void test_batch_references(void) {
+  flex_trit_t const *references[NUM_PAIRS];
+  tips_pair_t tips[NUM_PAIRS];
+  retcode_t rets[NUM_PAIRS];
+
+  init_tip_selector();
+
+  // Every other pair references a transaction out of the subtangle of the entry point
+  for (size_t i = 0; i < NUM_PAIRS; i++) {
+    references[i] = i % 2 ? transaction_trunk(&txs[0]) : transaction_hash(&txs[i + 1]);
+  }
+  TEST_ASSERT(iota_consensus_tip_selector_get_transactions_to_approve_batch(
+                  &tip_selector, &tangle, max_depth, references, tips, rets, NUM_PAIRS) == RC_OK);
+  for (size_t i = 0; i < NUM_PAIRS; i++) {
+    if (i % 2) {
+      TEST_ASSERT(rets[i] == RC_TIP_SELECTOR_REFERENCE_TOO_OLD);
+    } else {
+      TEST_ASSERT(rets[i] == RC_OK);
+      assert_tips(&tips[i]);
+    }
+  }
+
+  destroy_tip_selector();
+}
+
+void test_coalescing(void) {
+  thread_handle_t threads[2];
+  request_t requests[2] = {{.depth = max_depth}, {.depth = max_depth}};
+  request_t other_depth = {.depth = max_depth - 1};
+
+  conf.tip_selection_batch_window_ms = BATCH_WINDOW_MS;
+  init_tip_selector();
+
+  // The second request of the same depth joins the batch opened by the first one
+  TEST_ASSERT(thread_handle_create(&threads[0], request, &requests[0]) == 0);
+  wait_pending_batch(1);
+  TEST_ASSERT(thread_handle_create(&threads[1], request, &requests[1]) == 0);
+  wait_pending_batch(2);
+
+  // A request of another depth doesn't wait for the pending batch
+  request(&other_depth);
+  TEST_ASSERT(other_depth.ret == RC_OK);
+  assert_tips(&other_depth.tips);
+  lock_handle_lock(&tip_selector.batch_lock);
+  TEST_ASSERT(tip_selector.pending_batch != NULL);
+  TEST_ASSERT_EQUAL_INT(2, tip_selector.pending_batch->num_requests);
+  lock_handle_unlock(&tip_selector.batch_lock);
+
+  for (size_t i = 0; i < 2; i++) {
+    thread_handle_join(threads[i], NULL);
+    TEST_ASSERT(requests[i].ret == RC_OK);
+    assert_tips(&requests[i].tips);
+  }
+
+  destroy_tip_selector();
+  conf.tip_selection_batch_window_ms = 0;
+}
+
+void test_coalescing_full_batch(void) {
+  thread_handle_t threads[TIP_SELECTOR_BATCH_MAX_REQUESTS];
+  request_t requests[TIP_SELECTOR_BATCH_MAX_REQUESTS];
+  uint64_t start;
+
+  // A full batch is computed without waiting for the window to elapse
+  conf.tip_selection_batch_window_ms = 60 * BATCH_WINDOW_MS;
+  init_tip_selector();
+
+  start = current_timestamp_ms();
+  for (size_t i = 0; i < TIP_SELECTOR_BATCH_MAX_REQUESTS; i++) {
+    requests[i].depth = max_depth;
+    TEST_ASSERT(thread_handle_create(&threads[i], request, &requests[i]) == 0);
+  }
+  for (size_t i = 0; i < TIP_SELECTOR_BATCH_MAX_REQUESTS; i++) {
+    thread_handle_join(threads[i], NULL);
+    TEST_ASSERT(requests[i].ret == RC_OK);
+    assert_tips(&requests[i].tips);
+  }
+  TEST_ASSERT(current_timestamp_ms() - start < conf.tip_selection_batch_window_ms);
+
+  destroy_tip_selector();
+  conf.tip_selection_batch_window_ms = 0;
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  TEST_ASSERT(storage_init() == RC_OK);
+
+  config.db_path = test_db_path;
+  iota_consensus_conf_init(&conf);
+  conf.max_depth = max_depth;
+  conf.alpha = 0;
+  strcpy(conf.db_path, test_db_path);
+  strcpy(conf.snapshot_file, snapshot_path);
+  strcpy(conf.snapshot_conf_file, snapshot_conf_path);
+  conf.snapshot_signature_skip_validation = true;
+
+  RUN_TEST(test_batch);
+  RUN_TEST(test_batch_references);
+  RUN_TEST(test_coalescing);
+  RUN_TEST(test_coalescing_full_batch);
+
+  TEST_ASSERT(storage_destroy() == RC_OK);
+  return UNITY_END();
+}
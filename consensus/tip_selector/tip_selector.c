@@ -6,6 +6,9 @@
  */
 
 #include <inttypes.h>
+#include <stdlib.h>
+
+#include "utlist.h"
 
 #include "consensus/cw_rating_calculator/cw_rating_calculator.h"
 #include "consensus/entry_point_selector/entry_point_selector.h"
@@ -13,12 +16,19 @@
 #include "consensus/exit_probability_validator/exit_probability_validator.h"
 #include "consensus/snapshot/snapshot.h"
 #include "consensus/tip_selector/tip_selector.h"
+#include "utils/handles/thread.h"
 #include "utils/logger_helper.h"
+#include "utils/macros.h"
+#include "utils/system.h"
+#include "utils/time.h"
 
 #define TIP_SELECTOR_LOGGER_ID "tip_selector"
 
 static logger_id_t logger_id;
 
+static size_t tip_selector_num_walkers();
+static void *tip_selector_walker(void *arg);
+
 retcode_t iota_consensus_tip_selector_init(tip_selector_t *const tip_selector, iota_consensus_conf_t *const conf,
                                            cw_rating_calculator_t *const cw_rating_calculator,
                                            entry_point_selector_t *const entry_point_selector,
@@ -34,37 +44,126 @@ retcode_t iota_consensus_tip_selector_init(tip_selector_t *const tip_selector, i
   tip_selector->walker_validator = walker_validator;
   tip_selector->ledger_validator = ledger_validator;
   tip_selector->milestone_tracker = milestone_tracker;
+  tip_selector->deepest_milestone_index = 0;
+  tip_selector->pending_batch = NULL;
+  lock_handle_init(&tip_selector->batch_lock);
+  cond_handle_init(&tip_selector->batch_cond);
+  tip_selector->running = true;
+  tip_selector->walks = NULL;
+  tip_selector->num_walkers = 0;
+  lock_handle_init(&tip_selector->walks_lock);
+  cond_handle_init(&tip_selector->walks_cond);
+  cond_handle_init(&tip_selector->walks_done_cond);
+
+  // The calling thread being a walker, one fewer thread is started
+  if ((tip_selector->walkers = (thread_handle_t *)calloc(tip_selector_num_walkers(), sizeof(thread_handle_t))) ==
+      NULL) {
+    return RC_CONSENSUS_OOM;
+  }
+  for (size_t i = 1; i < tip_selector_num_walkers(); i++) {
+    if (thread_handle_create(&tip_selector->walkers[tip_selector->num_walkers], tip_selector_walker, tip_selector) !=
+        0) {
+      log_warning(logger_id, "Starting walker thread failed\n");
+      break;
+    }
+    tip_selector->num_walkers++;
+  }
   return RC_OK;
 }
 
-retcode_t iota_consensus_tip_selector_get_transactions_to_approve(tip_selector_t *const tip_selector,
-                                                                  tangle_t *const tangle, size_t const depth,
-                                                                  flex_trit_t const *const reference,
-                                                                  tips_pair_t *const tips) {
-  retcode_t ret = RC_OK;
-  flex_trit_t ep_trits[FLEX_TRIT_SIZE_243];
-  flex_trit_t *ep_p = ep_trits;
-  cw_calc_result rating_results = {.cw_ratings = NULL, .tx_to_approvers = NULL};
-  bool consistent = false;
-  hash243_stack_t tips_stack = NULL;
+/*
+ * Private functions
+ */
 
-  rw_lock_handle_rdlock(&tip_selector->milestone_tracker->latest_snapshot->rw_lock);
+struct tip_selector_request_s {
+  flex_trit_t const *reference;
+  tips_pair_t *tips;
+  retcode_t ret;
+  bool done;
+  tip_selector_request_t *next;
+};
 
-  if ((ret = iota_consensus_entry_point_selector_get_entry_point(tip_selector->entry_point_selector, tangle, depth,
-                                                                 ep_p)) != RC_OK) {
-    log_error(logger_id, "Getting entry point failed with error %" PRIu64 "\n", ret);
-    goto done;
+struct tip_selector_walk_s {
+  cw_calc_result *rating_results;
+  flex_trit_t const *ep;
+  flex_trit_t const *const *references;
+  tips_pair_t *tips;
+  retcode_t *rets;
+  size_t num_pairs;
+  // Guarded by the walks lock
+  size_t next_pair;
+  size_t num_walked;
+  tip_selector_walk_t *prev;
+  tip_selector_walk_t *next;
+};
+
+static size_t tip_selector_num_walkers() {
+  return MIN(TIP_SELECTOR_BATCH_MAX_WALKERS, MAX(1, system_cpu_available()));
+}
+
+// Stateful calculators may serve a subtangle holding transactions below the entry point
+static retcode_t tip_selector_approves_entry_point(cw_calc_result const *const rating_results,
+                                                   flex_trit_t const *const ep, flex_trit_t const *const hash,
+                                                   bool *const approves) {
+  subtangle_graph_t const *const graph = &rating_results->graph;
+  hash_to_indexed_hash_set_entry_t *ep_entry = NULL;
+  hash_to_indexed_hash_set_entry_t *entry = NULL;
+  size_t words = bistset_required_size(graph->num_vertices);
+  uint64_t *reached_raw_bits = NULL;
+  retcode_t ret = RC_OK;
+
+  *approves = false;
+  HASH_FIND(hh, rating_results->tx_to_approvers, ep, FLEX_TRIT_SIZE_243, ep_entry);
+  HASH_FIND(hh, rating_results->tx_to_approvers, hash, FLEX_TRIT_SIZE_243, entry);
+  if (ep_entry == NULL || entry == NULL) {
+    return RC_OK;
+  }
+  if ((reached_raw_bits = (uint64_t *)calloc(words, sizeof(uint64_t))) == NULL) {
+    return RC_CONSENSUS_OOM;
+  }
+  bitset_t reached = {
+      .raw_bits = reached_raw_bits, .bitset_integer_index = 0, .bitset_relative_index = 0, .size = words};
+  if ((ret = subtangle_graph_future_cone(graph, ep_entry->idx, &reached)) == RC_OK) {
+    *approves = bitset_is_set(&reached, entry->idx);
   }
+  free(reached_raw_bits);
+  return ret;
+}
 
-  if ((ret = iota_consensus_cw_rating_calculate(tip_selector->cw_rating_calculator, tangle, ep_p, &rating_results)) !=
-      RC_OK) {
-    log_error(logger_id, "Calculating CW ratings failed with error %" PRIu64 "\n", ret);
-    goto done;
+// Gives the calculator the deepest entry point once per latest solid milestone so that it drops the older transactions
+// The milestone index is only remembered once the calculator took the entry point, so that a failure is retried
+static void tip_selector_set_deepest_entry_point(tip_selector_t *const tip_selector, tangle_t *const tangle) {
+  uint64_t index = tip_selector->milestone_tracker->latest_solid_subtangle_milestone_index;
+  flex_trit_t deepest_ep[FLEX_TRIT_SIZE_243];
+  retcode_t ret = RC_OK;
+
+  if (__atomic_load_n(&tip_selector->deepest_milestone_index, __ATOMIC_RELAXED) == index) {
+    return;
   }
+  if ((ret = iota_consensus_entry_point_selector_get_entry_point(tip_selector->entry_point_selector, tangle,
+                                                                 tip_selector->conf->max_depth, deepest_ep)) != RC_OK ||
+      (ret = iota_consensus_cw_rating_set_deepest_entry_point(tip_selector->cw_rating_calculator, deepest_ep)) !=
+          RC_OK) {
+    log_warning(logger_id, "Setting deepest entry point failed with error %" PRIu64 "\n", ret);
+    return;
+  }
+  __atomic_store_n(&tip_selector->deepest_milestone_index, index, __ATOMIC_RELAXED);
+}
 
-  if ((ret = iota_consensus_exit_probability_randomize(
-           tip_selector->ep_randomizer, tangle, tip_selector->walker_validator, &rating_results, ep_p, tips->trunk)) !=
-      RC_OK) {
+static retcode_t tip_selector_select_pair(tip_selector_t *const tip_selector, tangle_t *const tangle,
+                                          exit_prob_transaction_validator_t *const walker_validator,
+                                          cw_calc_result *const rating_results, flex_trit_t const *const ep,
+                                          flex_trit_t const *const reference, tips_pair_t *const tips,
+                                          bool const has_trunk) {
+  retcode_t ret = RC_OK;
+  flex_trit_t const *branch_ep = ep;
+  bool consistent = false;
+  bool approves = false;
+  hash243_stack_t tips_stack = NULL;
+
+  if (!has_trunk && (ret = iota_consensus_exit_probability_randomize(tip_selector->ep_randomizer, tangle,
+                                                                     walker_validator, rating_results, ep,
+                                                                     tips->trunk)) != RC_OK) {
     log_error(logger_id, "Getting trunk tip failed with error %" PRIu64 "\n", ret);
     goto done;
   }
@@ -73,17 +172,19 @@ retcode_t iota_consensus_tip_selector_get_transactions_to_approve(tip_selector_t
   }
 
   if (reference != NULL) {
-    if (!hash_to_int64_t_map_contains(&rating_results.cw_ratings, reference)) {
+    if ((ret = tip_selector_approves_entry_point(rating_results, ep, reference, &approves)) != RC_OK) {
+      goto done;
+    }
+    if (!approves) {
       log_warning(logger_id, "Reference is too old\n");
       ret = RC_TIP_SELECTOR_REFERENCE_TOO_OLD;
       goto done;
     }
-    ep_p = reference;
+    branch_ep = reference;
   }
 
-  if ((ret = iota_consensus_exit_probability_randomize(
-           tip_selector->ep_randomizer, tangle, tip_selector->walker_validator, &rating_results, ep_p, tips->branch)) !=
-      RC_OK) {
+  if ((ret = iota_consensus_exit_probability_randomize(tip_selector->ep_randomizer, tangle, walker_validator,
+                                                       rating_results, branch_ep, tips->branch)) != RC_OK) {
     log_error(logger_id, "Getting branch tip failed with error %" PRIu64 "\n", ret);
     goto done;
   }
@@ -103,19 +204,259 @@ retcode_t iota_consensus_tip_selector_get_transactions_to_approve(tip_selector_t
   }
 
 done:
-  rw_lock_handle_unlock(&tip_selector->milestone_tracker->latest_snapshot->rw_lock);
-  cw_calc_result_destroy(&rating_results);
   hash243_stack_free(&tips_stack);
   return ret;
 }
 
+// Called with the walks lock held, walks the pairs of a batch until none is left to take
+static void tip_selector_walk_pairs(tip_selector_t *const tip_selector, tip_selector_walk_t *const walk,
+                                    tangle_t *const tangle,
+                                    exit_prob_transaction_validator_t *const walker_validator) {
+  size_t i;
+
+  while (walk->next_pair < walk->num_pairs) {
+    if ((i = walk->next_pair++) == walk->num_pairs - 1) {
+      DL_DELETE(tip_selector->walks, walk);
+    }
+    lock_handle_unlock(&tip_selector->walks_lock);
+    // The trunk of the first pair has already been selected by the calling thread
+    walk->rets[i] =
+        tip_selector_select_pair(tip_selector, tangle, walker_validator, walk->rating_results, walk->ep,
+                                 walk->references ? walk->references[i] : NULL, &walk->tips[i], i == 0);
+    lock_handle_lock(&tip_selector->walks_lock);
+    if (++walk->num_walked == walk->num_pairs) {
+      cond_handle_broadcast(&tip_selector->walks_done_cond);
+    }
+  }
+}
+
+static void *tip_selector_walker(void *arg) {
+  tip_selector_t *tip_selector = (tip_selector_t *)arg;
+  connection_config_t db_conf = {.db_path = tip_selector->conf->db_path};
+  tangle_t tangle;
+  exit_prob_transaction_validator_t walker_validator;
+  bool has_tangle = false;
+  bool has_walker_validator = false;
+
+  lock_handle_lock(&tip_selector->walks_lock);
+  while (true) {
+    while (tip_selector->running && tip_selector->walks == NULL) {
+      cond_handle_wait(&tip_selector->walks_cond, &tip_selector->walks_lock);
+    }
+    if (!tip_selector->running) {
+      break;
+    }
+    // The connection and the validator are opened by the first walk and kept for the next ones, validators memoize the
+    // transactions they analyzed and can't be shared by threads
+    if (!has_tangle || !has_walker_validator) {
+      lock_handle_unlock(&tip_selector->walks_lock);
+      if (!has_tangle) {
+        if (iota_tangle_init(&tangle, &db_conf) == RC_OK) {
+          has_tangle = true;
+        } else {
+          log_critical(logger_id, "Initializing tangle connection failed\n");
+        }
+      }
+      if (has_tangle && !has_walker_validator) {
+        if (iota_consensus_exit_prob_transaction_validator_init(tip_selector->conf, tip_selector->milestone_tracker,
+                                                                tip_selector->ledger_validator,
+                                                                &walker_validator) == RC_OK) {
+          has_walker_validator = true;
+        } else {
+          log_critical(logger_id, "Initializing walker validator failed\n");
+        }
+      }
+      lock_handle_lock(&tip_selector->walks_lock);
+      // The pairs are left to the calling threads and the other walkers
+      if (!has_tangle || !has_walker_validator) {
+        break;
+      }
+      continue;
+    }
+    tip_selector_walk_pairs(tip_selector, tip_selector->walks, &tangle, &walker_validator);
+  }
+  lock_handle_unlock(&tip_selector->walks_lock);
+
+  if (has_walker_validator) {
+    iota_consensus_exit_prob_transaction_validator_destroy(&walker_validator);
+  }
+  if (has_tangle && iota_tangle_destroy(&tangle) != RC_OK) {
+    log_critical(logger_id, "Destroying tangle connection failed\n");
+  }
+  return NULL;
+}
+
+static retcode_t tip_selector_get_transactions_to_approve_coalesced(tip_selector_t *const tip_selector,
+                                                                    tangle_t *const tangle, size_t const depth,
+                                                                    flex_trit_t const *const reference,
+                                                                    tips_pair_t *const tips) {
+  tip_selector_request_t request = {.reference = reference, .tips = tips, .ret = RC_OK, .done = false, .next = NULL};
+  tip_selector_request_t *iter = NULL;
+  tip_selector_batch_t batch = {.depth = depth, .requests = &request, .num_requests = 1};
+  uint64_t deadline = 0, now = 0;
+  size_t i = 0;
+
+  lock_handle_lock(&tip_selector->batch_lock);
+  if (tip_selector->pending_batch != NULL) {
+    if (tip_selector->pending_batch->depth != depth ||
+        tip_selector->pending_batch->num_requests == TIP_SELECTOR_BATCH_MAX_REQUESTS) {
+      lock_handle_unlock(&tip_selector->batch_lock);
+      iota_consensus_tip_selector_get_transactions_to_approve_batch(tip_selector, tangle, depth, &reference, tips,
+                                                                    &request.ret, 1);
+      return request.ret;
+    }
+    // The request is served by the thread that opened the batch
+    LL_APPEND(tip_selector->pending_batch->requests, &request);
+    // Wakes up the thread that opened the batch when it can't take more requests
+    if (++tip_selector->pending_batch->num_requests == TIP_SELECTOR_BATCH_MAX_REQUESTS) {
+      cond_handle_broadcast(&tip_selector->batch_cond);
+    }
+    while (!request.done) {
+      cond_handle_wait(&tip_selector->batch_cond, &tip_selector->batch_lock);
+    }
+    lock_handle_unlock(&tip_selector->batch_lock);
+    return request.ret;
+  }
+  tip_selector->pending_batch = &batch;
+  deadline = current_timestamp_ms() + tip_selector->conf->tip_selection_batch_window_ms;
+  while (batch.num_requests < TIP_SELECTOR_BATCH_MAX_REQUESTS && (now = current_timestamp_ms()) < deadline) {
+    cond_handle_timedwait(&tip_selector->batch_cond, &tip_selector->batch_lock, deadline - now);
+  }
+  tip_selector->pending_batch = NULL;
+  lock_handle_unlock(&tip_selector->batch_lock);
+
+  flex_trit_t const *references[batch.num_requests];
+  tips_pair_t batch_tips[batch.num_requests];
+  retcode_t rets[batch.num_requests];
+
+  LL_FOREACH(batch.requests, iter) { references[i++] = iter->reference; }
+  iota_consensus_tip_selector_get_transactions_to_approve_batch(tip_selector, tangle, depth, references, batch_tips,
+                                                                rets, batch.num_requests);
+
+  lock_handle_lock(&tip_selector->batch_lock);
+  i = 0;
+  LL_FOREACH(batch.requests, iter) {
+    memcpy(iter->tips, &batch_tips[i], sizeof(tips_pair_t));
+    iter->ret = rets[i++];
+    iter->done = true;
+  }
+  cond_handle_broadcast(&tip_selector->batch_cond);
+  lock_handle_unlock(&tip_selector->batch_lock);
+
+  return request.ret;
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t iota_consensus_tip_selector_get_transactions_to_approve(tip_selector_t *const tip_selector,
+                                                                  tangle_t *const tangle, size_t const depth,
+                                                                  flex_trit_t const *const reference,
+                                                                  tips_pair_t *const tips) {
+  retcode_t ret = RC_OK;
+
+  if (tip_selector->conf->tip_selection_batch_window_ms > 0) {
+    return tip_selector_get_transactions_to_approve_coalesced(tip_selector, tangle, depth, reference, tips);
+  }
+  // The return value of a batch is also the one of each pair when it fails
+  iota_consensus_tip_selector_get_transactions_to_approve_batch(tip_selector, tangle, depth, &reference, tips, &ret,
+                                                                1);
+  return ret;
+}
+
+retcode_t iota_consensus_tip_selector_get_transactions_to_approve_batch(
+    tip_selector_t *const tip_selector, tangle_t *const tangle, size_t const depth,
+    flex_trit_t const *const *const references, tips_pair_t *const tips, retcode_t *const rets,
+    size_t const num_pairs) {
+  retcode_t ret = RC_OK;
+  flex_trit_t ep[FLEX_TRIT_SIZE_243];
+  cw_calc_result rating_results = {.cw_ratings = NULL, .tx_to_approvers = NULL};
+  tip_selector_walk_t walk = {.rating_results = &rating_results,
+                              .ep = ep,
+                              .references = references,
+                              .tips = tips,
+                              .rets = rets,
+                              .num_pairs = num_pairs,
+                              .next_pair = 0,
+                              .num_walked = 0,
+                              .prev = NULL,
+                              .next = NULL};
+  size_t i;
+
+  if (num_pairs == 0) {
+    return RC_OK;
+  }
+
+  rw_lock_handle_rdlock(&tip_selector->milestone_tracker->latest_snapshot->rw_lock);
+
+  if ((ret = iota_consensus_entry_point_selector_get_entry_point(tip_selector->entry_point_selector, tangle, depth,
+                                                                 ep)) != RC_OK) {
+    log_error(logger_id, "Getting entry point failed with error %" PRIu64 "\n", ret);
+    goto done;
+  }
+
+  tip_selector_set_deepest_entry_point(tip_selector, tangle);
+  if ((ret = iota_consensus_cw_rating_calculate(tip_selector->cw_rating_calculator, tangle, ep, &rating_results)) !=
+      RC_OK) {
+    log_error(logger_id, "Calculating CW ratings failed with error %" PRIu64 "\n", ret);
+    goto done;
+  }
+
+  // The first walk also resets the state a randomizer may lazily build from the cumulative weights before the other
+  // walks share it
+  if ((ret = iota_consensus_exit_probability_randomize(tip_selector->ep_randomizer, tangle,
+                                                       tip_selector->walker_validator, &rating_results, ep,
+                                                       tips[0].trunk)) != RC_OK) {
+    log_error(logger_id, "Getting trunk tip failed with error %" PRIu64 "\n", ret);
+    goto done;
+  }
+
+  // The calling thread walks the pairs along with the walker threads
+  lock_handle_lock(&tip_selector->walks_lock);
+  DL_APPEND(tip_selector->walks, &walk);
+  if (num_pairs > 1) {
+    cond_handle_broadcast(&tip_selector->walks_cond);
+  }
+  tip_selector_walk_pairs(tip_selector, &walk, tangle, tip_selector->walker_validator);
+  while (walk.num_walked < walk.num_pairs) {
+    cond_handle_wait(&tip_selector->walks_done_cond, &tip_selector->walks_lock);
+  }
+  lock_handle_unlock(&tip_selector->walks_lock);
+
+done:
+  rw_lock_handle_unlock(&tip_selector->milestone_tracker->latest_snapshot->rw_lock);
+  iota_consensus_cw_rating_release(tip_selector->cw_rating_calculator, &rating_results);
+  if (ret != RC_OK) {
+    for (i = 0; i < num_pairs; i++) {
+      rets[i] = ret;
+    }
+  }
+  return ret;
+}
+
 retcode_t iota_consensus_tip_selector_destroy(tip_selector_t *const tip_selector) {
+  lock_handle_lock(&tip_selector->walks_lock);
+  tip_selector->running = false;
+  cond_handle_broadcast(&tip_selector->walks_cond);
+  lock_handle_unlock(&tip_selector->walks_lock);
+  for (size_t i = 0; i < tip_selector->num_walkers; i++) {
+    thread_handle_join(tip_selector->walkers[i], NULL);
+  }
+  free(tip_selector->walkers);
+  tip_selector->walkers = NULL;
+  tip_selector->num_walkers = 0;
   tip_selector->cw_rating_calculator = NULL;
   tip_selector->entry_point_selector = NULL;
   tip_selector->ep_randomizer = NULL;
   tip_selector->walker_validator = NULL;
   tip_selector->ledger_validator = NULL;
   tip_selector->milestone_tracker = NULL;
+  lock_handle_destroy(&tip_selector->batch_lock);
+  cond_handle_destroy(&tip_selector->batch_cond);
+  lock_handle_destroy(&tip_selector->walks_lock);
+  cond_handle_destroy(&tip_selector->walks_cond);
+  cond_handle_destroy(&tip_selector->walks_done_cond);
   logger_helper_release(logger_id);
   return RC_OK;
 }
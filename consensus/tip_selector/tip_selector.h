@@ -22,11 +22,34 @@
 #include "consensus/milestone_tracker/milestone_tracker.h"
 #include "consensus/model.h"
 #include "consensus/tangle/tangle.h"
+#include "utils/handles/cond.h"
+#include "utils/handles/lock.h"
+#include "utils/handles/thread.h"
+
+// Maximum number of threads running the walks of a batch, the calling thread included
+#ifndef TIP_SELECTOR_BATCH_MAX_WALKERS
+#define TIP_SELECTOR_BATCH_MAX_WALKERS 16
+#endif
+
+// Maximum number of requests coalesced into a batch
+#ifndef TIP_SELECTOR_BATCH_MAX_REQUESTS
+#define TIP_SELECTOR_BATCH_MAX_REQUESTS 64
+#endif
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+typedef struct tip_selector_request_s tip_selector_request_t;
+typedef struct tip_selector_walk_s tip_selector_walk_t;
+
+// Requests waiting for the same entry point and cumulative weights
+typedef struct tip_selector_batch_s {
+  size_t depth;
+  tip_selector_request_t *requests;
+  size_t num_requests;
+} tip_selector_batch_t;
+
 typedef struct tip_selector_s {
   iota_consensus_conf_t *conf;
   cw_rating_calculator_t *cw_rating_calculator;
@@ -35,6 +58,22 @@ typedef struct tip_selector_s {
   exit_prob_transaction_validator_t *walker_validator;
   ledger_validator_t *ledger_validator;
   milestone_tracker_t *milestone_tracker;
+  // The latest solid milestone index the deepest entry point was given to the calculator for
+  uint64_t deepest_milestone_index;
+  // The batch still accepting requests, NULL if none
+  tip_selector_batch_t *pending_batch;
+  lock_handle_t batch_lock;
+  cond_handle_t batch_cond;
+  // Threads helping the calling threads to walk the pairs of batches, each one opening its own connection to the
+  // database and validator once and keeping them until the tip selector is destroyed
+  bool running;
+  thread_handle_t *walkers;
+  size_t num_walkers;
+  // Batches having pairs left to walk
+  tip_selector_walk_t *walks;
+  lock_handle_t walks_lock;
+  cond_handle_t walks_cond;
+  cond_handle_t walks_done_cond;
 } tip_selector_t;
 
 retcode_t iota_consensus_tip_selector_init(tip_selector_t *const tip_selector, iota_consensus_conf_t *const conf,
@@ -45,11 +84,51 @@ retcode_t iota_consensus_tip_selector_init(tip_selector_t *const tip_selector, i
                                            ledger_validator_t *const ledger_validator,
                                            milestone_tracker_t *const milestone_tracker);
 
+/**
+ * Selects a pair of tips to approve
+ *
+ * When conf->tip_selection_batch_window_ms is not 0, requests of the same depth
+ * arriving within this window are coalesced into a single call to
+ * iota_consensus_tip_selector_get_transactions_to_approve_batch, made as soon as
+ * the window elapses or TIP_SELECTOR_BATCH_MAX_REQUESTS requests are coalesced
+ *
+ * @param tip_selector The tip selector
+ * @param tangle A tangle
+ * @param depth The depth of the entry point
+ * @param reference A transaction the branch walk starts from, NULL for none
+ * @param tips The selected tips
+ *
+ * @return a status code
+ */
 retcode_t iota_consensus_tip_selector_get_transactions_to_approve(tip_selector_t *const tip_selector,
                                                                   tangle_t *const tangle, size_t const depth,
                                                                   flex_trit_t const *const reference,
                                                                   tips_pair_t *const tips);
 
+/**
+ * Selects pairs of tips to approve, the entry point and the cumulative weights
+ * being computed once for all pairs
+ * The walks are run in parallel over the shared cumulative weights by the
+ * calling thread and the walker threads of the tip selector, which have their
+ * own connection to the database
+ *
+ * @param tip_selector The tip selector
+ * @param tangle A tangle
+ * @param depth The depth of the entry point
+ * @param references The reference of each pair, NULL for none - NULL if no
+ *                   pair has a reference
+ * @param tips The selected tips
+ * @param rets The status code of each pair
+ * @param num_pairs The number of pairs
+ *
+ * @return a status code, the selection of a pair failing is only reported in
+ * its status code
+ */
+retcode_t iota_consensus_tip_selector_get_transactions_to_approve_batch(
+    tip_selector_t *const tip_selector, tangle_t *const tangle, size_t const depth,
+    flex_trit_t const *const *const references, tips_pair_t *const tips, retcode_t *const rets,
+    size_t const num_pairs);
+
 retcode_t iota_consensus_tip_selector_destroy(tip_selector_t *const tip_selector);
 
 #ifdef __cplusplus
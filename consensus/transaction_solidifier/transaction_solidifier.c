@@ -54,6 +54,12 @@ static retcode_t propagate_solid_transactions(transaction_solidifier_t *const ts
   ts->newly_set_solid_transactions = NULL;
   lock_handle_unlock(&ts->lock);
 
+  if (ts->cw_rating_calculator != NULL &&
+      iota_consensus_cw_rating_add_solid_transactions(ts->cw_rating_calculator, tangle, transactions_to_propagate) !=
+          RC_OK) {
+    log_warning(logger_id, "Adding solid transactions to cumulative weights failed\n");
+  }
+
   if ((ret = hash_pack_init(&hash_pack, 32)) != RC_OK) {
     goto done;
   }
@@ -132,12 +138,14 @@ static void *spawn_solid_transactions_propagation(void *arg) {
 retcode_t iota_consensus_transaction_solidifier_init(transaction_solidifier_t *const ts,
                                                      iota_consensus_conf_t *const conf,
                                                      transaction_requester_t *const transaction_requester,
-                                                     tips_cache_t *const tips) {
+                                                     tips_cache_t *const tips,
+                                                     cw_rating_calculator_t *const cw_rating_calculator) {
   ts->conf = conf;
   ts->transaction_requester = transaction_requester;
   ts->running = false;
   ts->newly_set_solid_transactions = NULL;
   ts->tips = tips;
+  ts->cw_rating_calculator = cw_rating_calculator;
   lock_handle_init(&ts->lock);
   cond_handle_init(&ts->cond);
   logger_id = logger_helper_enable(TRANSACTION_SOLIDIFIER_LOGGER_ID, LOGGER_DEBUG, true);
@@ -15,6 +15,7 @@
 #include "common/model/transaction.h"
 #include "common/storage/connection.h"
 #include "consensus/conf.h"
+#include "consensus/cw_rating_calculator/cw_rating_calculator.h"
 #include "consensus/tangle/tangle.h"
 #include "gossip/components/transaction_requester.h"
 #include "gossip/tips_cache.h"
@@ -36,13 +37,16 @@ typedef struct transaction_solidifier_s {
   lock_handle_t lock;
   hash243_set_t newly_set_solid_transactions;
   tips_cache_t *tips;
+  // Fed with the newly solid transactions, may be NULL
+  cw_rating_calculator_t *cw_rating_calculator;
   cond_handle_t cond;
 } transaction_solidifier_t;
 
 retcode_t iota_consensus_transaction_solidifier_init(transaction_solidifier_t *const ts,
                                                      iota_consensus_conf_t *const conf,
                                                      transaction_requester_t *const transaction_requester,
-                                                     tips_cache_t *const tips);
+                                                     tips_cache_t *const tips,
+                                                     cw_rating_calculator_t *const cw_rating_calculator);
 
 retcode_t iota_consensus_transaction_solidifier_start(transaction_solidifier_t *const ts);
 
@@ -156,6 +156,39 @@ void transaction_is_valid() {
   transaction_free(tx1);
 }
 
+void transaction_fields_invalidity() {
+  flex_trit_t transaction_1_trits[FLEX_TRIT_SIZE_8019];
+
+  flex_trits_from_trytes(transaction_1_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TX_1_OF_4_VALUE_BUNDLE_TRYTES,
+                         NUM_TRYTES_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+
+  iota_transaction_t *tx1 = transaction_deserialize(transaction_1_trits, true);
+  transaction_validator_t tv;
+  transaction_validation_fields_t fields;
+  conf.snapshot_timestamp_sec = transaction_attachment_timestamp(tx1) / 1000;
+  TEST_ASSERT(iota_consensus_transaction_validator_init(&tv, &conf) == RC_OK);
+
+  fields.hash = transaction_hash(tx1);
+  fields.weight_magnitude = transaction_weight_magnitude(tx1);
+  fields.timestamp = transaction_timestamp(tx1);
+  fields.attachment_timestamp = transaction_attachment_timestamp(tx1);
+  fields.value = transaction_value(tx1);
+  fields.address_trit = 0;
+  TEST_ASSERT_EQUAL_INT(TRANSACTION_VALID, iota_consensus_transaction_validate_fields(&tv, &fields));
+
+  fields.address_trit = 1;
+  TEST_ASSERT_EQUAL_INT(TRANSACTION_INVALID_ADDRESS, iota_consensus_transaction_validate_fields(&tv, &fields));
+  fields.value = IOTA_SUPPLY + 1;
+  TEST_ASSERT_EQUAL_INT(TRANSACTION_INVALID_VALUE, iota_consensus_transaction_validate_fields(&tv, &fields));
+  fields.attachment_timestamp = current_timestamp_ms() + 99 * 60 * 60 * 1000;
+  TEST_ASSERT_EQUAL_INT(TRANSACTION_INVALID_TIMESTAMP, iota_consensus_transaction_validate_fields(&tv, &fields));
+  fields.weight_magnitude = conf.mwm - 1;
+  TEST_ASSERT_EQUAL_INT(TRANSACTION_INVALID_WEIGHT, iota_consensus_transaction_validate_fields(&tv, &fields));
+
+  TEST_ASSERT(iota_consensus_transaction_validator_destroy(&tv) == RC_OK);
+  transaction_free(tx1);
+}
+
 int main(int argc, char *argv[]) {
   UNITY_BEGIN();
 
@@ -170,6 +203,7 @@ int main(int argc, char *argv[]) {
   RUN_TEST(transaction_invalid_value_tx_wrong_address);
   RUN_TEST(transaction_invalid_timestamp_too_futuristic);
   RUN_TEST(transaction_invalid_timestamp_too_old);
+  RUN_TEST(transaction_fields_invalidity);
 
   return UNITY_END();
 }
@@ -29,15 +29,13 @@ static uint64_t MAX_TIMESTAMP_FUTURE_MS = 2 * 60 * 60 * 1000;
  * Genesis transaction will always be valid.
  *
  * @param tv Transaction validator
- * @param transaction Transaction under test
+ * @param fields Fields of the transaction under test
  *
  * @returns true if timestamp is invalid, false otherwise
  */
 static bool has_invalid_timestamp(transaction_validator_t const* const tv,
-                                  iota_transaction_t const* const transaction) {
-  uint64_t timestamp_ms = transaction_attachment_timestamp(transaction) == 0
-                              ? transaction_timestamp(transaction) * 1000UL
-                              : transaction_attachment_timestamp(transaction);
+                                  transaction_validation_fields_t const* const fields) {
+  uint64_t timestamp_ms = fields->attachment_timestamp == 0 ? fields->timestamp * 1000UL : fields->attachment_timestamp;
   bool is_too_futuristic = timestamp_ms > (current_timestamp_ms() + MAX_TIMESTAMP_FUTURE_MS);
   bool is_below_snapshot = timestamp_ms < tv->conf->snapshot_timestamp_sec * 1000UL;
 
@@ -46,7 +44,7 @@ static bool has_invalid_timestamp(transaction_validator_t const* const tv,
   }
 
   if (is_below_snapshot) {
-    return memcmp(transaction_hash(transaction), tv->conf->genesis_hash, FLEX_TRIT_SIZE_243) != 0;
+    return memcmp(fields->hash, tv->conf->genesis_hash, FLEX_TRIT_SIZE_243) != 0;
   }
 
   return false;
@@ -73,26 +71,39 @@ retcode_t iota_consensus_transaction_validator_destroy(transaction_validator_t*
 
 bool iota_consensus_transaction_validate(transaction_validator_t const* const tv,
                                          iota_transaction_t const* const transaction) {
-  if (transaction_weight_magnitude(transaction) < tv->conf->mwm) {
+  transaction_validation_fields_t fields;
+
+  fields.hash = transaction_hash(transaction);
+  fields.weight_magnitude = transaction_weight_magnitude(transaction);
+  fields.timestamp = transaction_timestamp(transaction);
+  fields.attachment_timestamp = transaction_attachment_timestamp(transaction);
+  fields.value = transaction_value(transaction);
+  fields.address_trit = flex_trits_at(transaction_address(transaction), NUM_TRITS_ADDRESS, NUM_TRITS_ADDRESS - 1);
+
+  return iota_consensus_transaction_validate_fields(tv, &fields) == TRANSACTION_VALID;
+}
+
+transaction_validity_t iota_consensus_transaction_validate_fields(transaction_validator_t const* const tv,
+                                                                  transaction_validation_fields_t const* const fields) {
+  if (fields->weight_magnitude < tv->conf->mwm) {
     log_debug(logger_id, "Validation failed: insufficient transaction weight\n");
-    return false;
+    return TRANSACTION_INVALID_WEIGHT;
   }
 
-  if (has_invalid_timestamp(tv, transaction)) {
+  if (has_invalid_timestamp(tv, fields)) {
     log_debug(logger_id, "Validation failed: invalid timestamp\n");
-    return false;
+    return TRANSACTION_INVALID_TIMESTAMP;
   }
 
-  if (llabs(transaction_value(transaction)) > IOTA_SUPPLY) {
+  if (llabs(fields->value) > IOTA_SUPPLY) {
     log_debug(logger_id, "Validation failed: invalid value\n");
-    return false;
+    return TRANSACTION_INVALID_VALUE;
   }
 
-  if (transaction_value(transaction) != 0 &&
-      flex_trits_at(transaction_address(transaction), NUM_TRITS_ADDRESS, NUM_TRITS_ADDRESS - 1) != 0) {
+  if (fields->value != 0 && fields->address_trit != 0) {
     log_debug(logger_id, "Validation failed: invalid address for value transaction\n");
-    return false;
+    return TRANSACTION_INVALID_ADDRESS;
   }
 
-  return true;
+  return TRANSACTION_VALID;
 }
@@ -25,6 +25,32 @@ typedef struct transaction_validator_s {
   iota_consensus_conf_t *conf;
 } transaction_validator_t;
 
+/**
+ * Outcome of the validation checks, either valid or the first failing check
+ */
+typedef enum transaction_validity_e {
+  TRANSACTION_VALID = 0,
+  TRANSACTION_INVALID_WEIGHT,
+  TRANSACTION_INVALID_TIMESTAMP,
+  TRANSACTION_INVALID_VALUE,
+  TRANSACTION_INVALID_ADDRESS,
+  TRANSACTION_VALIDITY_COUNT
+} transaction_validity_t;
+
+/**
+ * The transaction fields the validation checks depend on, so that they can be
+ * checked before a transaction is deserialized
+ */
+typedef struct transaction_validation_fields_s {
+  flex_trit_t const *hash;
+  uint8_t weight_magnitude;
+  uint64_t timestamp;
+  uint64_t attachment_timestamp;
+  int64_t value;
+  // Last trit of the address
+  trit_t address_trit;
+} transaction_validation_fields_t;
+
 /**
  * Initializes a transaction validator
  *
@@ -61,6 +87,18 @@ retcode_t iota_consensus_transaction_validator_destroy(transaction_validator_t *
 bool iota_consensus_transaction_validate(transaction_validator_t const *const tv,
                                          iota_transaction_t const *const transaction);
 
+/**
+ * Runs the validation checks of iota_consensus_transaction_validate on the
+ * fields of a transaction
+ *
+ * @param tv The transaction validator
+ * @param fields The fields of a transaction under test
+ *
+ * @return TRANSACTION_VALID if valid, the failing check otherwise
+ */
+transaction_validity_t iota_consensus_transaction_validate_fields(transaction_validator_t const *const tv,
+                                                                  transaction_validation_fields_t const *const fields);
+
 #ifdef __cplusplus
 }
 #endif
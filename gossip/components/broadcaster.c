@@ -10,10 +10,15 @@
 #include "consensus/tangle/tangle.h"
 #include "gossip/components/broadcaster.h"
 #include "gossip/node.h"
+#include "utils/handles/lock.h"
 #include "utils/logger_helper.h"
 
 #define BROADCASTER_LOGGER_ID "broadcaster"
 #define BROADCASTER_TIMEOUT_MS 5000ULL
+// Maximum number of transactions waiting to be broadcast
+#ifndef BROADCASTER_QUEUE_SIZE
+#define BROADCASTER_QUEUE_SIZE 1024
+#endif
 
 static logger_id_t logger_id;
 
@@ -23,7 +28,6 @@ static logger_id_t logger_id;
 
 static void *broadcaster_routine(broadcaster_t *const broadcaster) {
   neighbor_t *iter = NULL;
-  flex_trit_t *transaction_flex_trits_ptr = NULL;
   flex_trit_t transaction_flex_trits[FLEX_TRIT_SIZE_8019];
   connection_config_t db_conf = {.db_path = broadcaster->node->conf.db_path};
   tangle_t tangle;
@@ -46,15 +50,9 @@ static void *broadcaster_routine(broadcaster_t *const broadcaster) {
       cond_handle_timedwait(&broadcaster->cond, &lock_cond, BROADCASTER_TIMEOUT_MS);
     }
 
-    rw_lock_handle_wrlock(&broadcaster->lock);
-    transaction_flex_trits_ptr = hash8019_queue_peek(broadcaster->queue);
-    if (transaction_flex_trits_ptr == NULL) {
-      rw_lock_handle_unlock(&broadcaster->lock);
+    if (mpsc_ring_pop(broadcaster->queue, transaction_flex_trits) != RC_OK) {
       continue;
     }
-    memcpy(transaction_flex_trits, transaction_flex_trits_ptr, FLEX_TRIT_SIZE_8019);
-    hash8019_queue_pop(&broadcaster->queue);
-    rw_lock_handle_unlock(&broadcaster->lock);
 
     log_debug(logger_id, "Broadcasting transaction\n");
     rw_lock_handle_rdlock(&broadcaster->node->neighbors_lock);
@@ -81,6 +79,8 @@ static void *broadcaster_routine(broadcaster_t *const broadcaster) {
  */
 
 retcode_t broadcaster_init(broadcaster_t *const broadcaster, node_t *const node) {
+  retcode_t ret = RC_OK;
+
   if (broadcaster == NULL || node == NULL) {
     return RC_NULL_PARAM;
   }
@@ -89,8 +89,10 @@ retcode_t broadcaster_init(broadcaster_t *const broadcaster, node_t *const node)
   memset(broadcaster, 0, sizeof(broadcaster_t));
   broadcaster->running = false;
   broadcaster->node = node;
-  broadcaster->queue = NULL;
-  rw_lock_handle_init(&broadcaster->lock);
+  if ((ret = mpsc_ring_create(&broadcaster->queue, BROADCASTER_QUEUE_SIZE, FLEX_TRIT_SIZE_8019)) != RC_OK) {
+    log_critical(logger_id, "Initializing broadcaster queue failed\n");
+    return ret;
+  }
   cond_handle_init(&broadcaster->cond);
 
   return RC_OK;
@@ -104,8 +106,7 @@ retcode_t broadcaster_destroy(broadcaster_t *const broadcaster) {
   }
 
   broadcaster->node = NULL;
-  hash8019_queue_free(&broadcaster->queue);
-  rw_lock_handle_destroy(&broadcaster->lock);
+  mpsc_ring_destroy(&broadcaster->queue);
   cond_handle_destroy(&broadcaster->cond);
   logger_helper_release(logger_id);
 
@@ -133,32 +134,23 @@ retcode_t broadcaster_on_next(broadcaster_t *const broadcaster, flex_trit_t cons
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_wrlock(&broadcaster->lock);
-  ret = hash8019_queue_push(&broadcaster->queue, transaction_flex_trits);
-  rw_lock_handle_unlock(&broadcaster->lock);
+  ret = mpsc_ring_push(broadcaster->queue, transaction_flex_trits);
+  cond_handle_signal(&broadcaster->cond);
 
   if (ret != RC_OK) {
     log_warning(logger_id, "Pushing transaction flex trits to broadcaster queue failed\n");
     return RC_BROADCASTER_FAILED_PUSH_QUEUE;
-  } else {
-    cond_handle_signal(&broadcaster->cond);
   }
 
   return RC_OK;
 }
 
 size_t broadcaster_size(broadcaster_t *const broadcaster) {
-  size_t size = 0;
-
   if (broadcaster == NULL) {
     return 0;
   }
 
-  rw_lock_handle_rdlock(&broadcaster->lock);
-  size = hash8019_queue_count(broadcaster->queue);
-  rw_lock_handle_unlock(&broadcaster->lock);
-
-  return size;
+  return mpsc_ring_size(broadcaster->queue);
 }
 
 retcode_t broadcaster_stop(broadcaster_t *const broadcaster) {
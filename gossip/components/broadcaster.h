@@ -11,9 +11,9 @@
 #include <stdbool.h>
 
 #include "common/errors.h"
-#include "utils/containers/hash/hash8019_queue.h"
+#include "common/trinary/flex_trit.h"
+#include "utils/containers/queues/mpsc_ring.h"
 #include "utils/handles/cond.h"
-#include "utils/handles/rw_lock.h"
 #include "utils/handles/thread.h"
 
 // Forward declarations
@@ -23,8 +23,8 @@ typedef struct broadcaster_s {
   thread_handle_t thread;
   bool running;
   node_t *node;
-  hash8019_queue_t queue;
-  rw_lock_handle_t lock;
+  // Transaction flex trits filled by the processor workers and the API
+  mpsc_ring_t *queue;
   cond_handle_t cond;
 } broadcaster_t;
 
@@ -95,7 +95,9 @@ retcode_t broadcaster_stop(broadcaster_t *const broadcaster);
  *
  * @return true if empty, false otherwise
  */
-static inline bool broadcaster_is_empty(broadcaster_t *const broadcaster) { return broadcaster->queue == NULL; }
+static inline bool broadcaster_is_empty(broadcaster_t *const broadcaster) {
+  return mpsc_ring_is_empty(broadcaster->queue);
+}
 
 #ifdef __cplusplus
 }
@@ -5,19 +5,55 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <stdatomic.h>
 #include <string.h>
 
 #include "common/crypto/curl-p/ptrit.h"
+#include "common/trinary/trit_byte.h"
+#include "common/trinary/trit_long.h"
 #include "common/trinary/trit_ptrit.h"
 #include "consensus/milestone_tracker/milestone_tracker.h"
 #include "consensus/transaction_solidifier/transaction_solidifier.h"
 #include "gossip/components/processor.h"
 #include "gossip/neighbor.h"
 #include "gossip/node.h"
+#include "utils/fnv.h"
+#include "utils/handles/lock.h"
 #include "utils/logger_helper.h"
+#include "utils/macros.h"
+#include "utils/system.h"
+#include "utils/time.h"
 
 #define PROCESSOR_LOGGER_ID "processor"
 #define PROCESSOR_TIMEOUT_MS 1000ULL
+// Number of transactions hashed at once by a ptrit Curl
+#define PROCESSOR_BATCH_LANES 64
+// Matches the number of transactions hashed at once by the widest batch of ptrit Curls
+#define PROCESSOR_BATCH_SIZE (PROCESSOR_BATCH_LANES * PTRIT_BATCH_MAX)
+// Maximum number of packets waiting for a worker
+#ifndef PROCESSOR_WORKER_QUEUE_SIZE
+#define PROCESSOR_WORKER_QUEUE_SIZE 1024
+#endif
+// Default number of workers: each one stores through its own connection but the database has a single writer, so
+// more workers only contend for the write lock
+#ifndef PROCESSOR_DEFAULT_MAX_WORKERS
+#define PROCESSOR_DEFAULT_MAX_WORKERS 4
+#endif
+// Attempts to store a batch before giving up on it, spaced by a growing delay
+#ifndef PROCESSOR_STORE_ATTEMPTS
+#define PROCESSOR_STORE_ATTEMPTS 3
+#endif
+#ifndef PROCESSOR_STORE_RETRY_DELAY_MS
+#define PROCESSOR_STORE_RETRY_DELAY_MS 10
+#endif
+// Number of trailing transaction bytes, covering the attachment timestamps and the nonce, mixed to pick a worker
+#define PROCESSOR_PARTITION_KEY_BYTES 32
+// Offsets of the serialized transaction fields read by the pre-validation
+#define PROCESSOR_VALUE_OFFSET (NUM_TRITS_SIGNATURE + NUM_TRITS_ADDRESS)
+#define PROCESSOR_TIMESTAMP_OFFSET (PROCESSOR_VALUE_OFFSET + NUM_TRITS_VALUE + NUM_TRITS_OBSOLETE_TAG)
+#define PROCESSOR_ATTACHMENT_TIMESTAMP_OFFSET                                                             \
+  (PROCESSOR_TIMESTAMP_OFFSET + NUM_TRITS_TIMESTAMP + NUM_TRITS_CURRENT_INDEX + NUM_TRITS_LAST_INDEX + \
+   NUM_TRITS_BUNDLE + NUM_TRITS_TRUNK + NUM_TRITS_BRANCH + NUM_TRITS_TAG)
 
 static logger_id_t logger_id;
 
@@ -26,31 +62,141 @@ static logger_id_t logger_id;
  */
 
 /**
- * Converts transaction bytes from a packet to a transaction, validates it and
- * updates its status.
- * If valid and new: stores and broadcasts it.
+ * Transactions a worker rejected, indexed by the failing validation check,
+ * valid packets it could not hand over to the broadcaster or responder
+ * and valid transactions it could not store
+ */
+struct processor_worker_rejections_s {
+  atomic_uint_fast64_t counts[TRANSACTION_VALIDITY_COUNT];
+  atomic_uint_fast64_t forward_drops;
+  atomic_uint_fast64_t store_drops;
+};
+
+/**
+ * A batch of packets dequeued together and processed in lockstep
+ */
+typedef struct processor_batch_s {
+  size_t count;
+  iota_packet_t packets[PROCESSOR_BATCH_SIZE];
+  flex_trit_t hashes[PROCESSOR_BATCH_SIZE][FLEX_TRIT_SIZE_243];
+  // Number of trailing zero trits of the hashes
+  uint8_t weights[PROCESSOR_BATCH_SIZE];
+  neighbor_t *neighbors[PROCESSOR_BATCH_SIZE];
+  iota_transaction_t transactions[PROCESSOR_BATCH_SIZE];
+  flex_trit_t transactions_flex_trits[PROCESSOR_BATCH_SIZE][FLEX_TRIT_SIZE_8019];
+  bool valid[PROCESSOR_BATCH_SIZE];
+} processor_batch_t;
+
+/**
+ * Counts the trailing zero trits of the hashes squeezed out of a ptrit Curl
+ *
+ * @param hash The hashes, one per lane
+ * @param weights The weight magnitudes of the count first lanes
+ * @param count The number of lanes
+ */
+static void ptrit_hash_weights(ptrit_t const *const hash, uint8_t *const weights, size_t const count) {
+  // A zero trit has both its low and high bits set
+  uint64_t zeros = ~0ULL;
+
+  memset(weights, 0, count);
+  for (size_t i = HASH_LENGTH_TRIT; i-- > 0 && (zeros &= hash[i].low & hash[i].high) != 0;) {
+    for (size_t lane = 0; lane < count; lane++) {
+      weights[lane] += (zeros >> lane) & 1;
+    }
+  }
+}
+
+/**
+ * Decodes trits of the transaction of a packet straight from its bytes
+ *
+ * @param packet The packet
+ * @param offset The offset of the first trit in the serialized transaction
+ * @param length The number of trits, at most NUM_TRITS_VALUE
+ * @param trits The trits
+ */
+static void packet_transaction_trits(iota_packet_t const *const packet, size_t const offset, size_t const length,
+                                     trit_t *const trits) {
+  trit_t buffer[NUM_TRITS_VALUE + NUMBER_OF_TRITS_IN_A_BYTE];
+  size_t const skipped = offset % NUMBER_OF_TRITS_IN_A_BYTE;
+
+  bytes_to_trits(packet->content + offset / NUMBER_OF_TRITS_IN_A_BYTE, MIN_BYTES(skipped + length), buffer,
+                 skipped + length);
+  memcpy(trits, buffer + skipped, length);
+}
+
+/**
+ * Reads the fields checked by the transaction validator from a packet, without converting the whole transaction
+ *
+ * @param packet The packet
+ * @param hash The CurlP81 hash of the transaction
+ * @param weight_magnitude The number of trailing zero trits of the hash
+ * @param fields The fields to fill
+ */
+static void packet_validation_fields(iota_packet_t const *const packet, flex_trit_t const *const hash,
+                                     uint8_t const weight_magnitude, transaction_validation_fields_t *const fields) {
+  trit_t trits[NUM_TRITS_VALUE];
+
+  fields->hash = hash;
+  fields->weight_magnitude = weight_magnitude;
+  packet_transaction_trits(packet, PROCESSOR_VALUE_OFFSET - 1, 1, trits);
+  fields->address_trit = trits[0];
+  packet_transaction_trits(packet, PROCESSOR_VALUE_OFFSET, NUM_TRITS_VALUE, trits);
+  fields->value = trits_to_long(trits, NUM_TRITS_VALUE);
+  packet_transaction_trits(packet, PROCESSOR_TIMESTAMP_OFFSET, NUM_TRITS_TIMESTAMP, trits);
+  fields->timestamp = trits_to_long(trits, NUM_TRITS_TIMESTAMP);
+  packet_transaction_trits(packet, PROCESSOR_ATTACHMENT_TIMESTAMP_OFFSET, NUM_TRITS_ATTACHMENT_TIMESTAMP, trits);
+  fields->attachment_timestamp = trits_to_long(trits, NUM_TRITS_ATTACHMENT_TIMESTAMP);
+}
+
+/**
+ * Converts transaction bytes from a packet to a transaction and validates it.
+ * The validation checks run on fields read straight from the packet, so that invalid transactions are discarded
+ * before being converted.
  *
  * @param processor The processor state
- * @param tangle A tangle
+ * @param worker The worker processing the packet
  * @param neighbor The neighbor that sent the packet
  * @param packet The packet from which to process transaction bytes
  * @param curl_hash The CurlP81 hash of the transaction
+ * @param weight_magnitude The number of trailing zero trits of the hash
+ * @param transaction The transaction to fill
+ * @param transaction_flex_trits The transaction trits to fill
+ * @param valid Whether the transaction is valid
  *
  * @return a status code
  */
-static retcode_t process_transaction_bytes(processor_t const *const processor, tangle_t *const tangle,
+static retcode_t process_transaction_bytes(processor_t *const processor, processor_worker_t *const worker,
                                            neighbor_t *const neighbor, iota_packet_t const *const packet,
-                                           flex_trit_t const *const curl_hash) {
+                                           flex_trit_t const *const curl_hash, uint8_t const weight_magnitude,
+                                           iota_transaction_t *const transaction,
+                                           flex_trit_t *const transaction_flex_trits, bool *const valid) {
   retcode_t ret = RC_OK;
-  bool exists = false;
-  iota_transaction_t transaction = {.metadata.snapshot_index = 0, .metadata.solid = 0, .loaded_columns_mask = 0};
-  flex_trit_t transaction_flex_trits[FLEX_TRIT_SIZE_8019];
+  transaction_validation_fields_t fields;
+  transaction_validity_t validity;
 
-  if (processor == NULL || neighbor == NULL || packet == NULL || curl_hash == NULL) {
+  if (processor == NULL || worker == NULL || neighbor == NULL || packet == NULL || curl_hash == NULL ||
+      transaction == NULL || transaction_flex_trits == NULL || valid == NULL) {
     return RC_NULL_PARAM;
   }
 
-  // TODO Check if transaction hash is cached
+  *valid = false;
+
+  // Discards the transaction if it has recently been received, it is then either stored or being stored
+  if (recent_hashes_contains(&processor->recent_hashes, curl_hash)) {
+    NEIGHBOR_COUNTER_INCREMENT(neighbor->nbr_seen_tx);
+    return RC_OK;
+  }
+
+  // Validates the transaction before converting it
+  packet_validation_fields(packet, curl_hash, weight_magnitude, &fields);
+  if ((validity = iota_consensus_transaction_validate_fields(processor->transaction_validator, &fields)) !=
+      TRANSACTION_VALID) {
+    log_debug(logger_id, "Invalid transaction\n");
+    atomic_fetch_add_explicit(&worker->rejections->counts[validity], 1, memory_order_relaxed);
+    goto failure;
+  }
+
+  memset(transaction, 0, sizeof(iota_transaction_t));
 
   // Retreives the transaction from the packet
   if (flex_trits_from_bytes(transaction_flex_trits, NUM_TRITS_SERIALIZED_TRANSACTION, packet->content,
@@ -62,64 +208,63 @@ static retcode_t process_transaction_bytes(processor_t const *const processor, t
   }
 
   // Deserializes the transaction
-  if (transaction_deserialize_from_trits(&transaction, transaction_flex_trits, false) !=
+  if (transaction_deserialize_from_trits(transaction, transaction_flex_trits, false) !=
       NUM_TRITS_SERIALIZED_TRANSACTION) {
     log_warning(logger_id, "Deserializing transaction failed\n");
     ret = RC_PROCESSOR_INVALID_TRANSACTION;
     goto failure;
   }
-  transaction_set_hash(&transaction, curl_hash);
-
-  // Validates the transaction
-  if (!iota_consensus_transaction_validate(processor->transaction_validator, &transaction)) {
-    log_debug(logger_id, "Invalid transaction\n");
-    goto failure;
-  }
-
-  // TODO Add transaction hash to cache
+  transaction_set_hash(transaction, curl_hash);
 
-  // Checks if the transaction is already persisted
-  if ((ret = iota_tangle_transaction_exist(tangle, TRANSACTION_FIELD_HASH, curl_hash, &exists)) != RC_OK) {
-    log_warning(logger_id, "Checking if transaction exists failed\n");
-    goto failure;
-  }
+  *valid = true;
+  return ret;
 
-  if (!exists) {
-    // Stores the new transaction
-    log_debug(logger_id, "Storing new transaction\n");
-    if ((ret = iota_tangle_transaction_store(tangle, &transaction)) != RC_OK) {
-      log_warning(logger_id, "Storing new transaction failed\n");
-      goto failure;
-    }
+failure:
+  NEIGHBOR_COUNTER_INCREMENT(neighbor->nbr_invalid_tx);
+  return ret;
+}
 
-    // Updates transaction status
-    if ((ret = iota_consensus_transaction_solidifier_update_status(processor->transaction_solidifier, tangle,
-                                                                   &transaction)) != RC_OK) {
-      log_warning(logger_id, "Updating transaction status failed\n");
-      return ret;
-    }
+/**
+ * Updates the status of a newly stored transaction and broadcasts it.
+ *
+ * @param processor The processor state
+ * @param worker The worker processing the transaction
+ * @param tangle A tangle
+ * @param neighbor The neighbor that sent the transaction
+ * @param transaction The transaction
+ * @param transaction_flex_trits The transaction trits
+ *
+ * @return a status code
+ */
+static retcode_t process_new_transaction(processor_t const *const processor, processor_worker_t *const worker,
+                                         tangle_t *const tangle, neighbor_t *const neighbor,
+                                         iota_transaction_t *const transaction,
+                                         flex_trit_t const *const transaction_flex_trits) {
+  retcode_t ret = RC_OK;
 
-    // TODO Store transaction metadata
+  // Updates transaction status
+  if ((ret = iota_consensus_transaction_solidifier_update_status(processor->transaction_solidifier, tangle,
+                                                                 transaction)) != RC_OK) {
+    log_warning(logger_id, "Updating transaction status failed\n");
+    return ret;
+  }
 
-    // Broadcast the new transaction
-    if ((ret = broadcaster_on_next(&processor->node->broadcaster, transaction_flex_trits)) != RC_OK) {
-      log_warning(logger_id, "Propagating packet to broadcaster failed\n");
-      goto failure;
-    }
+  // TODO Store transaction metadata
 
-    if (transaction_current_index(&transaction) == 0 &&
-        memcmp(transaction_address(&transaction), processor->milestone_tracker->conf->coordinator_address,
-               FLEX_TRIT_SIZE_243) == 0) {
-      ret = iota_milestone_tracker_add_candidate(processor->milestone_tracker, transaction_hash(&transaction));
-    }
+  // Broadcast the new transaction, the transaction is stored and valid even if the broadcaster queue is full
+  if (broadcaster_on_next(&processor->node->broadcaster, transaction_flex_trits) != RC_OK) {
+    log_warning(logger_id, "Propagating packet to broadcaster failed\n");
+    atomic_fetch_add_explicit(&worker->rejections->forward_drops, 1, memory_order_relaxed);
+  }
 
-    neighbor->nbr_new_tx++;
+  if (transaction_current_index(transaction) == 0 &&
+      memcmp(transaction_address(transaction), processor->milestone_tracker->conf->coordinator_address,
+             FLEX_TRIT_SIZE_243) == 0) {
+    ret = iota_milestone_tracker_add_candidate(processor->milestone_tracker, transaction_hash(transaction));
   }
 
-  return ret;
+  NEIGHBOR_COUNTER_INCREMENT(neighbor->nbr_new_tx);
 
-failure:
-  neighbor->nbr_invalid_tx++;
   return ret;
 }
 
@@ -128,14 +273,16 @@ failure:
  * queue.
  *
  * @param processor The processor state
+ * @param worker The worker processing the packet
  * @param neighbor The neighbor that sent the packet
  * @param packet The packet from which to process request bytes
  * @param hash Transaction bytes hash
  *
  * @return a status code
  */
-static retcode_t process_request_bytes(processor_t const *const processor, neighbor_t *const neighbor,
-                                       iota_packet_t const *const packet, flex_trit_t const *const hash) {
+static retcode_t process_request_bytes(processor_t const *const processor, processor_worker_t *const worker,
+                                       neighbor_t *const neighbor, iota_packet_t const *const packet,
+                                       flex_trit_t const *const hash) {
   retcode_t ret = RC_OK;
   flex_trit_t request_hash[FLEX_TRIT_SIZE_243];
 
@@ -161,6 +308,7 @@ static retcode_t process_request_bytes(processor_t const *const processor, neigh
   // Adds request to the responder queue
   if ((ret = responder_on_next(&processor->node->responder, neighbor, request_hash)) != RC_OK) {
     log_warning(logger_id, "Propagating request to responder failed\n");
+    atomic_fetch_add_explicit(&worker->rejections->forward_drops, 1, memory_order_relaxed);
     return ret;
   }
 
@@ -168,135 +316,229 @@ static retcode_t process_request_bytes(processor_t const *const processor, neigh
 }
 
 /**
- * Processes a packet
+ * Stores the valid transactions of a batch, retrying a failed store since a storage error says nothing about the
+ * transactions themselves
+ *
+ * @param tangle A tangle
+ * @param transactions The valid transactions
+ * @param count The number of valid transactions
+ * @param stored Whether each transaction was new and got stored
+ *
+ * @return a status code
+ */
+static retcode_t process_batch_store(tangle_t *const tangle, iota_transaction_t const **const transactions,
+                                     size_t const count, bool *const stored) {
+  retcode_t ret = RC_OK;
+
+  for (size_t attempt = 1; attempt <= PROCESSOR_STORE_ATTEMPTS; attempt++) {
+    if ((ret = iota_tangle_transactions_store_batch(tangle, transactions, count, stored)) == RC_OK) {
+      break;
+    }
+    log_warning(logger_id, "Storing new transactions failed, attempt %zu/%d\n", attempt, PROCESSOR_STORE_ATTEMPTS);
+    if (attempt < PROCESSOR_STORE_ATTEMPTS) {
+      sleep_ms(attempt * PROCESSOR_STORE_RETRY_DELAY_MS);
+    }
+  }
+
+  return ret;
+}
+
+/**
+ * Processes a batch of packets
+ * Valid transactions of the batch are checked for existence and stored all at once, their hashes are then remembered
+ * so that copies received from other neighbors are discarded before being deserialized.
+ * Transactions that could not be stored are neither blamed on their neighbors nor remembered, so that a copy received
+ * later gets another chance to be stored.
  *
  * @param processor The processor state
+ * @param worker The worker processing the batch
  * @param tangle A tangle
- * @param packet The packet
+ * @param batch The batch
  *
  * @return a status code
  */
-static retcode_t process_packet(processor_t const *const processor, tangle_t *const tangle,
-                                iota_packet_t const *const packet, flex_trit_t const *const hash) {
+static retcode_t process_batch(processor_t *const processor, processor_worker_t *const worker, tangle_t *const tangle,
+                               processor_batch_t *const batch) {
   retcode_t ret = RC_OK;
   neighbor_t *neighbor = NULL;
+  iota_packet_t const *packet = NULL;
   char *protocol = NULL;
+  iota_transaction_t const *valid_transactions[PROCESSOR_BATCH_SIZE];
+  size_t valid_indexes[PROCESSOR_BATCH_SIZE];
+  bool stored[PROCESSOR_BATCH_SIZE];
+  size_t valid_count = 0;
+  size_t j;
 
-  if (processor == NULL || packet == NULL) {
+  if (processor == NULL || worker == NULL || tangle == NULL || batch == NULL) {
     return RC_NULL_PARAM;
   }
 
   rw_lock_handle_rdlock(&processor->node->neighbors_lock);
 
-  neighbor = neighbors_find_by_endpoint(processor->node->neighbors, &packet->source);
-  protocol = packet->source.protocol == PROTOCOL_TCP ? "tcp" : "udp";
+  for (j = 0; j < batch->count; j++) {
+    packet = &batch->packets[j];
+    batch->valid[j] = false;
+    neighbor = neighbors_find_by_endpoint(processor->node->neighbors, &packet->source);
+    protocol = packet->source.protocol == PROTOCOL_TCP ? "tcp" : "udp";
+    batch->neighbors[j] = neighbor;
+
+    if (neighbor) {
+      log_debug(logger_id, "Processing packet from tethered node %s://%s:%d\n", protocol, neighbor->endpoint.host,
+                neighbor->endpoint.port);
+      NEIGHBOR_COUNTER_INCREMENT(neighbor->nbr_all_tx);
+
+      log_debug(logger_id, "Processing transaction bytes\n");
+      if (process_transaction_bytes(processor, worker, neighbor, packet, batch->hashes[j], batch->weights[j],
+                                    &batch->transactions[j], batch->transactions_flex_trits[j],
+                                    &batch->valid[j]) != RC_OK) {
+        log_warning(logger_id, "Processing transaction bytes failed\n");
+        batch->neighbors[j] = NULL;
+        continue;
+      }
+      if (batch->valid[j]) {
+        valid_transactions[valid_count] = &batch->transactions[j];
+        valid_indexes[valid_count++] = j;
+      }
+    } else {
+      log_debug(logger_id, "Discarding packet from non-tethered node %s://%s:%d\n", protocol, packet->source.ip,
+                packet->source.port);
+      // TODO Testnet add non-tethered neighbor
+    }
+  }
 
-  if (neighbor) {
-    log_debug(logger_id, "Processing packet from tethered node %s://%s:%d\n", protocol, neighbor->endpoint.host,
-              neighbor->endpoint.port);
-    neighbor->nbr_all_tx++;
+  // Stores the new transactions
+  if (valid_count > 0 && (ret = process_batch_store(tangle, valid_transactions, valid_count, stored)) != RC_OK) {
+    log_warning(logger_id, "Dropping %zu new transactions that could not be stored\n", valid_count);
+    atomic_fetch_add_explicit(&worker->rejections->store_drops, valid_count, memory_order_relaxed);
+    valid_count = 0;
+  }
 
-    log_debug(logger_id, "Processing transaction bytes\n");
-    if ((ret = process_transaction_bytes(processor, tangle, neighbor, packet, hash)) != RC_OK) {
-      log_warning(logger_id, "Processing transaction bytes failed\n");
-      goto done;
+  for (j = 0; j < valid_count; j++) {
+    if (recent_hashes_add(&processor->recent_hashes, batch->hashes[valid_indexes[j]]) != RC_OK) {
+      log_warning(logger_id, "Adding hash to recent hashes failed\n");
     }
+    if (stored[j] &&
+        process_new_transaction(processor, worker, tangle, batch->neighbors[valid_indexes[j]],
+                                &batch->transactions[valid_indexes[j]],
+                                batch->transactions_flex_trits[valid_indexes[j]]) != RC_OK) {
+      log_warning(logger_id, "Processing new transaction failed\n");
+    }
+  }
 
+  for (j = 0; j < batch->count; j++) {
+    if (batch->neighbors[j] == NULL) {
+      continue;
+    }
     log_debug(logger_id, "Processing request bytes\n");
-    if ((ret = process_request_bytes(processor, neighbor, packet, hash)) != RC_OK) {
+    if (process_request_bytes(processor, worker, batch->neighbors[j], &batch->packets[j], batch->hashes[j]) !=
+        RC_OK) {
       log_warning(logger_id, "Processing request bytes failed\n");
-      goto done;
     }
-  } else {
-    log_debug(logger_id, "Discarding packet from non-tethered node %s://%s:%d\n", protocol, packet->source.ip,
-              packet->source.port);
-    // TODO Testnet add non-tethered neighbor
   }
 
-done:
   rw_lock_handle_unlock(&processor->node->neighbors_lock);
   return ret;
 }
 
 /**
- * Continuously looks for a packet from a processor packet queue and process it.
+ * Picks the worker of a packet from the trailing bytes of its transaction,
+ * which differ between any two attached transactions
  *
  * @param processor The processor state
+ * @param packet The packet
+ *
+ * @return the worker
+ */
+static processor_worker_t *processor_partition(processor_t *const processor, iota_packet_t const *const packet) {
+  uint64_t key =
+      fnv1a_64(packet->content + PACKET_TX_SIZE - PROCESSOR_PARTITION_KEY_BYTES, PROCESSOR_PARTITION_KEY_BYTES);
+
+  return &processor->workers[key % processor->workers_count];
+}
+
+/**
+ * Continuously looks for packets from a worker packet queue and process them.
+ * Each worker has its own tangle connection and hashing buffers.
+ *
+ * @param worker The worker state
  */
-static void *processor_routine(processor_t *const processor) {
-  connection_config_t db_conf = {.db_path = processor->node->conf.db_path};
+static void *processor_routine(processor_worker_t *const worker) {
+  processor_t *processor = NULL;
+  connection_config_t db_conf;
   tangle_t tangle;
-  size_t j;
+  size_t j, curls_count;
+  // Full batches keep all the lanes of the vector registers busy
+  size_t const batch_size = PROCESSOR_BATCH_LANES * ptrit_batch_width();
 
-  if (processor == NULL) {
+  if (worker == NULL) {
     return NULL;
   }
 
+  processor = worker->processor;
+  db_conf.db_path = processor->node->conf.db_path;
+
   if (iota_tangle_init(&tangle, &db_conf) != RC_OK) {
     log_critical(logger_id, "Initializing tangle connection failed\n");
     return NULL;
   }
 
-  const size_t PACKET_MAX = 64;
-  size_t packet_cnt = 0;
-  iota_packet_t *packet_ptr = NULL;
-  iota_packet_t *packets = (iota_packet_t *)calloc(PACKET_MAX, sizeof(iota_packet_t));
+  processor_batch_t *batch = (processor_batch_t *)calloc(1, sizeof(processor_batch_t));
 
   trit_t *tx = (trit_t *)calloc(NUM_TRITS_SERIALIZED_TRANSACTION, sizeof(trit_t));
   trit_t *hash = (trit_t *)calloc(HASH_LENGTH_TRIT, sizeof(trit_t));
 
-  PCurl *curl = (PCurl *)calloc(1, sizeof(PCurl));
-  curl->type = 81;
-
-  ptrit_t *txs_acc = (ptrit_t *)calloc(NUM_TRITS_SERIALIZED_TRANSACTION, sizeof(ptrit_t));
+  PCurl *curls = (PCurl *)calloc(PTRIT_BATCH_MAX, sizeof(PCurl));
 
-  flex_trit_t flex_hash[FLEX_TRIT_SIZE_243];
+  ptrit_t *txs_acc = (ptrit_t *)calloc(PTRIT_BATCH_MAX * NUM_TRITS_SERIALIZED_TRANSACTION, sizeof(ptrit_t));
 
   lock_handle_t lock_cond;
   lock_handle_init(&lock_cond);
   lock_handle_lock(&lock_cond);
 
   while (processor->running) {
-    if (processor_is_empty(processor)) {
-      cond_handle_timedwait(&processor->cond, &lock_cond, PROCESSOR_TIMEOUT_MS);
+    if (mpsc_ring_is_empty(worker->queue)) {
+      cond_handle_timedwait(&worker->cond, &lock_cond, PROCESSOR_TIMEOUT_MS);
     }
 
-    rw_lock_handle_wrlock(&processor->lock);
-    for (packet_cnt = 0; packet_cnt < PACKET_MAX; packet_cnt++) {
-      packet_ptr = iota_packet_queue_peek(processor->queue);
-      if (packet_ptr == NULL) {
-        goto process_packets;
+    for (batch->count = 0; batch->count < batch_size; batch->count++) {
+      if (mpsc_ring_pop(worker->queue, &batch->packets[batch->count]) != RC_OK) {
+        break;
       }
-      packets[packet_cnt] = *packet_ptr;
-      iota_packet_queue_pop(&processor->queue);
     }
 
-  process_packets:
-    rw_lock_handle_unlock(&processor->lock);
-
-    if (packet_cnt == 0) {
+    if (batch->count == 0) {
       continue;
     }
 
-    ptrit_curl_init(curl, CURL_P_81);
-    memset(txs_acc, 0, NUM_TRITS_SERIALIZED_TRANSACTION * sizeof(ptrit_t));
-    memset(flex_hash, FLEX_TRIT_NULL_VALUE, sizeof(flex_hash));
+    curls_count = (batch->count + PROCESSOR_BATCH_LANES - 1) / PROCESSOR_BATCH_LANES;
+    for (j = 0; j < curls_count; j++) {
+      ptrit_curl_init(&curls[j], CURL_P_81);
+    }
+    memset(txs_acc, 0, curls_count * NUM_TRITS_SERIALIZED_TRANSACTION * sizeof(ptrit_t));
+    memset(batch->hashes, FLEX_TRIT_NULL_VALUE, sizeof(batch->hashes));
 
-    for (j = 0; j < packet_cnt; j++) {
-      bytes_to_trits(packets[j].content, PACKET_TX_SIZE, tx, NUM_TRITS_SERIALIZED_TRANSACTION);
-      trits_to_ptrits(tx, txs_acc, j, NUM_TRITS_SERIALIZED_TRANSACTION);
+    for (j = 0; j < batch->count; j++) {
+      bytes_to_trits(batch->packets[j].content, PACKET_TX_SIZE, tx, NUM_TRITS_SERIALIZED_TRANSACTION);
+      trits_to_ptrits(tx, txs_acc + (j / PROCESSOR_BATCH_LANES) * NUM_TRITS_SERIALIZED_TRANSACTION,
+                      j % PROCESSOR_BATCH_LANES, NUM_TRITS_SERIALIZED_TRANSACTION);
     }
 
-    ptrit_curl_absorb(curl, txs_acc, NUM_TRITS_SERIALIZED_TRANSACTION);
-    ptrit_curl_squeeze(curl, txs_acc, HASH_LENGTH_TRIT);
+    ptrit_curl_absorb_batch(curls, curls_count, txs_acc, NUM_TRITS_SERIALIZED_TRANSACTION);
+    ptrit_curl_squeeze_batch(curls, curls_count, txs_acc, HASH_LENGTH_TRIT);
 
-    for (j = 0; j < packet_cnt; j++) {
-      ptrits_to_trits(txs_acc, hash, j, HASH_LENGTH_TRIT);
-      flex_trits_from_trits(flex_hash, HASH_LENGTH_TRIT, hash, HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
+    for (j = 0; j < batch->count; j += PROCESSOR_BATCH_LANES) {
+      ptrit_hash_weights(txs_acc + (j / PROCESSOR_BATCH_LANES) * HASH_LENGTH_TRIT, batch->weights + j,
+                         MIN(batch->count - j, PROCESSOR_BATCH_LANES));
+    }
 
-      if (process_packet(processor, &tangle, &packets[j], flex_hash) != RC_OK) {
-        log_warning(logger_id, "Processing packet failed\n");
-      }
+    for (j = 0; j < batch->count; j++) {
+      ptrits_to_trits(txs_acc + (j / PROCESSOR_BATCH_LANES) * HASH_LENGTH_TRIT, hash, j % PROCESSOR_BATCH_LANES,
+                      HASH_LENGTH_TRIT);
+      flex_trits_from_trits(batch->hashes[j], HASH_LENGTH_TRIT, hash, HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
+    }
+
+    if (process_batch(processor, worker, &tangle, batch) != RC_OK) {
+      log_warning(logger_id, "Processing packets failed\n");
     }
   }
 
@@ -307,8 +549,8 @@ static void *processor_routine(processor_t *const processor) {
     log_critical(logger_id, "Destroying tangle connection failed\n");
   }
 
-  free(curl);
-  free(packets);
+  free(curls);
+  free(batch);
   free(tx);
   free(hash);
   free(txs_acc);
@@ -316,6 +558,31 @@ static void *processor_routine(processor_t *const processor) {
   return NULL;
 }
 
+/**
+ * Stops and joins the first workers of a processor
+ *
+ * @param processor The processor state
+ * @param count The number of workers to join
+ *
+ * @return a status code
+ */
+static retcode_t processor_join_workers(processor_t *const processor, size_t const count) {
+  retcode_t ret = RC_OK;
+
+  processor->running = false;
+  for (size_t i = 0; i < count; i++) {
+    cond_handle_signal(&processor->workers[i].cond);
+  }
+  for (size_t i = 0; i < count; i++) {
+    if (thread_handle_join(processor->workers[i].thread, NULL) != 0) {
+      log_error(logger_id, "Shutting down processor thread %zu failed\n", i);
+      ret = RC_FAILED_THREAD_JOIN;
+    }
+  }
+
+  return ret;
+}
+
 /*
  * Public functions
  */
@@ -324,6 +591,9 @@ retcode_t processor_init(processor_t *const processor, node_t *const node,
                          transaction_validator_t *const transaction_validator,
                          transaction_solidifier_t *const transaction_solidifier,
                          milestone_tracker_t *const milestone_tracker) {
+  retcode_t ret = RC_OK;
+  processor_worker_t *worker = NULL;
+
   if (processor == NULL || node == NULL || transaction_validator == NULL || transaction_solidifier == NULL ||
       milestone_tracker == NULL) {
     return RC_NULL_PARAM;
@@ -332,13 +602,36 @@ retcode_t processor_init(processor_t *const processor, node_t *const node,
   logger_id = logger_helper_enable(PROCESSOR_LOGGER_ID, LOGGER_DEBUG, true);
 
   processor->running = false;
-  processor->queue = NULL;
-  rw_lock_handle_init(&processor->lock);
-  cond_handle_init(&processor->cond);
+  processor->workers_count = node->conf.processor_workers ? node->conf.processor_workers
+                                                          : MIN(system_cpu_available(), PROCESSOR_DEFAULT_MAX_WORKERS);
+  if (processor->workers_count == 0) {
+    processor->workers_count = 1;
+  }
+  if ((processor->workers = (processor_worker_t *)calloc(processor->workers_count, sizeof(processor_worker_t))) ==
+      NULL) {
+    return RC_OOM;
+  }
+  for (size_t i = 0; i < processor->workers_count; i++) {
+    worker = &processor->workers[i];
+    if ((ret = mpsc_ring_create(&worker->queue, PROCESSOR_WORKER_QUEUE_SIZE, sizeof(iota_packet_t))) != RC_OK) {
+      log_critical(logger_id, "Initializing processor queue failed\n");
+      return ret;
+    }
+    cond_handle_init(&worker->cond);
+    if ((worker->rejections =
+             (processor_worker_rejections_t *)calloc(1, sizeof(processor_worker_rejections_t))) == NULL) {
+      return RC_OOM;
+    }
+    worker->processor = processor;
+  }
   processor->node = node;
   processor->transaction_validator = transaction_validator;
   processor->transaction_solidifier = transaction_solidifier;
   processor->milestone_tracker = milestone_tracker;
+  if ((ret = recent_hashes_init(&processor->recent_hashes, node->conf.recent_hashes_size)) != RC_OK) {
+    log_critical(logger_id, "Initializing recent hashes filter failed\n");
+    return ret;
+  }
 
   return RC_OK;
 }
@@ -348,11 +641,15 @@ retcode_t processor_start(processor_t *const processor) {
     return RC_NULL_PARAM;
   }
 
-  log_info(logger_id, "Spawning processor thread\n");
+  log_info(logger_id, "Spawning %zu processor threads\n", processor->workers_count);
   processor->running = true;
-  if (thread_handle_create(&processor->thread, (thread_routine_t)processor_routine, processor) != 0) {
-    log_critical(logger_id, "Spawning processor thread failed\n");
-    return RC_FAILED_THREAD_SPAWN;
+  for (size_t i = 0; i < processor->workers_count; i++) {
+    if (thread_handle_create(&processor->workers[i].thread, (thread_routine_t)processor_routine,
+                             &processor->workers[i]) != 0) {
+      log_critical(logger_id, "Spawning processor thread %zu failed\n", i);
+      processor_join_workers(processor, i);
+      return RC_FAILED_THREAD_SPAWN;
+    }
   }
 
   return RC_OK;
@@ -365,27 +662,29 @@ retcode_t processor_stop(processor_t *const processor) {
     return RC_OK;
   }
 
-  log_info(logger_id, "Shutting down processor thread\n");
-  processor->running = false;
-  cond_handle_signal(&processor->cond);
-  if (thread_handle_join(processor->thread, NULL) != 0) {
-    log_error(logger_id, "Shutting down processor thread failed\n");
-    return RC_FAILED_THREAD_JOIN;
-  }
-
-  return RC_OK;
+  log_info(logger_id, "Shutting down processor threads\n");
+  return processor_join_workers(processor, processor->workers_count);
 }
 
 retcode_t processor_destroy(processor_t *const processor) {
+  processor_worker_t *worker = NULL;
+
   if (processor == NULL) {
     return RC_NULL_PARAM;
   } else if (processor->running) {
     return RC_STILL_RUNNING;
   }
 
-  iota_packet_queue_free(&processor->queue);
-  rw_lock_handle_destroy(&processor->lock);
-  cond_handle_destroy(&processor->cond);
+  for (size_t i = 0; i < processor->workers_count; i++) {
+    worker = &processor->workers[i];
+    mpsc_ring_destroy(&worker->queue);
+    cond_handle_destroy(&worker->cond);
+    free(worker->rejections);
+  }
+  free(processor->workers);
+  processor->workers = NULL;
+  processor->workers_count = 0;
+  recent_hashes_destroy(&processor->recent_hashes);
   processor->node = NULL;
   processor->transaction_validator = NULL;
   processor->transaction_solidifier = NULL;
@@ -398,23 +697,21 @@ retcode_t processor_destroy(processor_t *const processor) {
 
 retcode_t processor_on_next(processor_t *const processor, iota_packet_t const packet) {
   retcode_t ret = RC_OK;
+  processor_worker_t *worker = NULL;
 
   if (processor == NULL) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_wrlock(&processor->lock);
-  ret = iota_packet_queue_push(&processor->queue, &packet);
-  rw_lock_handle_unlock(&processor->lock);
+  worker = processor_partition(processor, &packet);
 
-  if (ret != RC_OK) {
-    log_warning(logger_id, "Pushing packet to processor queue failed\n");
-    return ret;
-  } else {
-    cond_handle_signal(&processor->cond);
+  // A full queue drops the packet, counted by the queue, rather than stalling the receivers
+  if ((ret = mpsc_ring_push(worker->queue, &packet)) != RC_OK) {
+    log_debug(logger_id, "Pushing packet to processor queue failed\n");
   }
+  cond_handle_signal(&worker->cond);
 
-  return RC_OK;
+  return ret;
 }
 
 size_t processor_size(processor_t *const processor) {
@@ -424,9 +721,35 @@ size_t processor_size(processor_t *const processor) {
     return 0;
   }
 
-  rw_lock_handle_rdlock(&processor->lock);
-  size = iota_packet_queue_count(processor->queue);
-  rw_lock_handle_unlock(&processor->lock);
+  for (size_t i = 0; i < processor->workers_count; i++) {
+    size += mpsc_ring_size(processor->workers[i].queue);
+  }
 
   return size;
 }
+
+retcode_t processor_worker_stats(processor_t *const processor, size_t const index,
+                                 processor_worker_stats_t *const stats) {
+  mpsc_ring_stats_t ring_stats;
+
+  if (processor == NULL || stats == NULL) {
+    return RC_NULL_PARAM;
+  } else if (index >= processor->workers_count) {
+    return RC_PROCESSOR_INVALID_WORKER;
+  }
+
+  mpsc_ring_stats(processor->workers[index].queue, &ring_stats);
+  stats->queue_size = ring_stats.size;
+  stats->peak_queue_size = ring_stats.peak_size;
+  stats->processed = ring_stats.popped;
+  stats->dropped = ring_stats.dropped;
+  stats->forward_dropped =
+      atomic_load_explicit(&processor->workers[index].rejections->forward_drops, memory_order_relaxed);
+  stats->store_dropped = atomic_load_explicit(&processor->workers[index].rejections->store_drops, memory_order_relaxed);
+  for (size_t i = 0; i < TRANSACTION_VALIDITY_COUNT; i++) {
+    stats->rejected[i] =
+        atomic_load_explicit(&processor->workers[index].rejections->counts[i], memory_order_relaxed);
+  }
+
+  return RC_OK;
+}
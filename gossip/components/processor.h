@@ -9,13 +9,14 @@
 #define __GOSSIP_COMPONENTS_PROCESSOR_H__
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "common/errors.h"
 #include "consensus/transaction_validator/transaction_validator.h"
 #include "gossip/iota_packet.h"
+#include "gossip/recent_hashes.h"
+#include "utils/containers/queues/mpsc_ring.h"
 #include "utils/handles/cond.h"
-#include "utils/handles/lock.h"
-#include "utils/handles/rw_lock.h"
 #include "utils/handles/thread.h"
 
 // Forward declarations
@@ -24,20 +25,51 @@ typedef struct tangle_s tangle_t;
 typedef struct transaction_solidifier_s transaction_solidifier_t;
 typedef struct milestone_tracker_s milestone_tracker_t;
 
+typedef struct processor_s processor_t;
+typedef struct processor_worker_rejections_s processor_worker_rejections_t;
+
 /**
- * A processor is responsible for analyzing packets sent by neighbors.
+ * A processor worker owns a queue of packets and the thread processing them
  */
-typedef struct processor_s {
+typedef struct processor_worker_s {
   thread_handle_t thread;
-  bool running;
-  iota_packet_queue_t queue;
-  rw_lock_handle_t lock;
+  // Filled by the receivers, emptied by the worker
+  mpsc_ring_t *queue;
   cond_handle_t cond;
+  processor_worker_rejections_t *rejections;
+  processor_t *processor;
+} processor_worker_t;
+
+typedef struct processor_worker_stats_s {
+  size_t queue_size;
+  size_t peak_queue_size;
+  uint64_t processed;
+  // Packets dropped because the worker queue was full
+  uint64_t dropped;
+  // Valid transactions and requests dropped because the broadcaster or responder queue was full
+  uint64_t forward_dropped;
+  // Valid transactions dropped because storing them kept failing
+  uint64_t store_dropped;
+  // Transactions rejected by the validation checks, indexed by the failing check
+  uint64_t rejected[TRANSACTION_VALIDITY_COUNT];
+} processor_worker_stats_t;
+
+/**
+ * A processor is responsible for analyzing packets sent by neighbors.
+ * Packets are partitioned between workers by the content of their transaction
+ * so that copies of a transaction received from different neighbors are always
+ * processed by the same worker.
+ */
+struct processor_s {
+  bool running;
+  size_t workers_count;
+  processor_worker_t *workers;
   node_t *node;
   transaction_validator_t *transaction_validator;
   transaction_solidifier_t *transaction_solidifier;
   milestone_tracker_t *milestone_tracker;
-} processor_t;
+  recent_hashes_t recent_hashes;
+};
 
 #ifdef __cplusplus
 extern "C" {
@@ -97,22 +129,34 @@ retcode_t processor_destroy(processor_t *const processor);
 retcode_t processor_on_next(processor_t *const processor, iota_packet_t const packet);
 
 /**
- * Gets the size of the processor queue
+ * Gets the size of the processor queues
  *
  * @param processor The processor
  *
- * @return a status code
+ * @return the number of packets waiting to be processed by all workers
  */
 size_t processor_size(processor_t *const processor);
 
 /**
- * Tells whether the processor queue is empty or not
+ * Gets the queue depth and rejection metrics of a processor worker
+ *
+ * @param processor The processor
+ * @param index The index of the worker, in [0, workers_count)
+ * @param stats The metrics
+ *
+ * @return a status code
+ */
+retcode_t processor_worker_stats(processor_t *const processor, size_t const index,
+                                 processor_worker_stats_t *const stats);
+
+/**
+ * Tells whether the processor queues are empty or not
  *
  * @param processor The processor
  *
  * @return true if empty, false otherwise
  */
-static inline bool processor_is_empty(processor_t *const processor) { return processor->queue == NULL; }
+static inline bool processor_is_empty(processor_t *const processor) { return processor_size(processor) == 0; }
 
 #ifdef __cplusplus
 }
@@ -5,15 +5,22 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <string.h>
+
 #include "gossip/components/responder.h"
 #include "consensus/tangle/tangle.h"
 #include "gossip/neighbor.h"
 #include "gossip/node.h"
+#include "utils/handles/lock.h"
 #include "utils/handles/rand.h"
 #include "utils/logger_helper.h"
 
 #define RESPONDER_LOGGER_ID "responder"
 #define RESPONDER_TIMEOUT_MS 1000ULL
+// Maximum number of transaction requests waiting for a reply
+#ifndef RESPONDER_QUEUE_SIZE
+#define RESPONDER_QUEUE_SIZE 4096
+#endif
 
 static logger_id_t logger_id;
 
@@ -50,7 +57,7 @@ static retcode_t get_transaction_for_request(responder_t const *const responder,
     log_debug(logger_id, "Responding to random tip request\n");
     if (rand_handle_probability() < responder->node->conf.p_reply_random_tip &&
         !requester_is_empty(&responder->node->transaction_requester)) {
-      neighbor->nbr_random_tx_req++;
+      NEIGHBOR_COUNTER_INCREMENT(neighbor->nbr_random_tx_req);
       if ((ret = tips_cache_random_tip(&responder->node->tips, tip)) != RC_OK) {
         return ret;
       }
@@ -127,7 +134,6 @@ static retcode_t respond_to_request(responder_t const *const responder, tangle_t
  * @param responder The responder state
  */
 static void *responder_routine(responder_t *const responder) {
-  transaction_request_t *request_ptr = NULL;
   transaction_request_t request;
   DECLARE_PACK_SINGLE_TX(tx, tx_ptr, pack);
   connection_config_t db_conf = {.db_path = responder->node->conf.db_path};
@@ -151,15 +157,9 @@ static void *responder_routine(responder_t *const responder) {
       cond_handle_timedwait(&responder->cond, &lock_cond, RESPONDER_TIMEOUT_MS);
     }
 
-    rw_lock_handle_wrlock(&responder->lock);
-    request_ptr = transaction_request_queue_peek(responder->queue);
-    if (request_ptr == NULL) {
-      rw_lock_handle_unlock(&responder->lock);
+    if (mpsc_ring_pop(responder->queue, &request) != RC_OK) {
       continue;
     }
-    request = *request_ptr;
-    transaction_request_queue_pop(&responder->queue);
-    rw_lock_handle_unlock(&responder->lock);
 
     log_debug(logger_id, "Responding to request\n");
     hash_pack_reset(&pack);
@@ -185,6 +185,8 @@ static void *responder_routine(responder_t *const responder) {
  */
 
 retcode_t responder_init(responder_t *const responder, node_t *const node) {
+  retcode_t ret = RC_OK;
+
   if (responder == NULL || node == NULL) {
     return RC_NULL_PARAM;
   }
@@ -192,8 +194,10 @@ retcode_t responder_init(responder_t *const responder, node_t *const node) {
   logger_id = logger_helper_enable(RESPONDER_LOGGER_ID, LOGGER_DEBUG, true);
 
   responder->running = false;
-  responder->queue = NULL;
-  rw_lock_handle_init(&responder->lock);
+  if ((ret = mpsc_ring_create(&responder->queue, RESPONDER_QUEUE_SIZE, sizeof(transaction_request_t))) != RC_OK) {
+    log_critical(logger_id, "Initializing responder queue failed\n");
+    return ret;
+  }
   cond_handle_init(&responder->cond);
   responder->node = node;
 
@@ -244,8 +248,7 @@ retcode_t responder_destroy(responder_t *const responder) {
     return RC_STILL_RUNNING;
   }
 
-  transaction_request_queue_free(&responder->queue);
-  rw_lock_handle_destroy(&responder->lock);
+  mpsc_ring_destroy(&responder->queue);
   cond_handle_destroy(&responder->cond);
   responder->node = NULL;
 
@@ -256,35 +259,30 @@ retcode_t responder_destroy(responder_t *const responder) {
 
 retcode_t responder_on_next(responder_t *const responder, neighbor_t *const neighbor, flex_trit_t const *const hash) {
   retcode_t ret = RC_OK;
+  transaction_request_t request;
 
   if (responder == NULL || neighbor == NULL || hash == NULL) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_wrlock(&responder->lock);
-  ret = transaction_request_queue_push(&responder->queue, neighbor, hash);
-  rw_lock_handle_unlock(&responder->lock);
+  request.neighbor = neighbor;
+  memcpy(request.hash, hash, FLEX_TRIT_SIZE_243);
+
+  ret = mpsc_ring_push(responder->queue, &request);
+  cond_handle_signal(&responder->cond);
 
   if (ret != RC_OK) {
     log_warning(logger_id, "Pushing transaction_request to responder queue failed\n");
     return ret;
-  } else {
-    cond_handle_signal(&responder->cond);
   }
 
   return RC_OK;
 }
 
 size_t responder_size(responder_t *const responder) {
-  size_t size = 0;
-
   if (responder == NULL) {
     return 0;
   }
 
-  rw_lock_handle_rdlock(&responder->lock);
-  size = transaction_request_queue_count(responder->queue);
-  rw_lock_handle_unlock(&responder->lock);
-
-  return size;
+  return mpsc_ring_size(responder->queue);
 }
@@ -13,9 +13,8 @@
 #include "common/errors.h"
 #include "common/trinary/flex_trit.h"
 #include "gossip/transaction_request.h"
+#include "utils/containers/queues/mpsc_ring.h"
 #include "utils/handles/cond.h"
-#include "utils/handles/lock.h"
-#include "utils/handles/rw_lock.h"
 #include "utils/handles/thread.h"
 
 // Forward declarations
@@ -29,8 +28,8 @@ typedef struct node_s node_t;
 typedef struct responder_s {
   thread_handle_t thread;
   bool running;
-  transaction_request_queue_t queue;
-  rw_lock_handle_t lock;
+  // Transaction requests filled by the processor workers
+  mpsc_ring_t *queue;
   cond_handle_t cond;
   node_t *node;
 } responder_t;
@@ -103,7 +102,7 @@ size_t responder_size(responder_t *const responder);
  *
  * @return true if empty, false otherwise
  */
-static inline bool responder_is_empty(responder_t *const responder) { return responder->queue == NULL; }
+static inline bool responder_is_empty(responder_t *const responder) { return mpsc_ring_is_empty(responder->queue); }
 
 #ifdef __cplusplus
 }
@@ -28,6 +28,8 @@
 #define DEFAULT_PROBABILITY_SEND_MILESTONE 0.02
 #define DEFAULT_TIPS_CACHE_SIZE 5000
 #define DEFAULT_REQUESTER_QUEUE_SIZE 10000
+#define DEFAULT_RECENT_HASHES_SIZE 65536
+#define DEFAULT_PROCESSOR_WORKERS 0
 #define DEFAULT_TIPS_SOLIDIFIER_ENABLED true
 
 #ifdef __cplusplus
@@ -68,6 +70,10 @@ typedef struct iota_gossip_conf_s {
   size_t tips_cache_size;
   // Size of the requester queue
   size_t requester_queue_size;
+  // Number of recently seen transaction hashes remembered to discard duplicates
+  size_t recent_hashes_size;
+  // Number of threads processing received packets, 0 for one per available core up to 4
+  size_t processor_workers;
   // Path of the DB file
   char db_path[128];
   // Scan the current tips and attempt to mark them as solid
@@ -74,7 +74,7 @@ retcode_t neighbor_send_packet(node_t *const node, neighbor_t *const neighbor, i
     return RC_NEIGHBOR_INVALID_PROTOCOL;
   }
 
-  neighbor->nbr_sent_tx++;
+  NEIGHBOR_COUNTER_INCREMENT(neighbor->nbr_sent_tx);
 
   return RC_OK;
 }
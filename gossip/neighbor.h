@@ -17,6 +17,14 @@
 #include "gossip/iota_packet.h"
 #include "utarray.h"
 
+/*
+ * The counters of a neighbor are updated concurrently, e.g. by the processor
+ * workers, so they are only accessed through these; the header being shared
+ * with C++ sources, the fields themselves can not be declared _Atomic
+ */
+#define NEIGHBOR_COUNTER_INCREMENT(counter) __atomic_fetch_add(&(counter), 1, __ATOMIC_RELAXED)
+#define NEIGHBOR_COUNTER_LOAD(counter) __atomic_load_n(&(counter), __ATOMIC_RELAXED)
+
 // Forward declarations
 typedef struct node_s node_t;
 typedef struct tangle_s tangle_t;
@@ -26,6 +34,8 @@ typedef struct neighbor_s {
   unsigned int nbr_all_tx;
   unsigned int nbr_new_tx;
   unsigned int nbr_invalid_tx;
+  // Transactions discarded by the recent hashes filter of the processor
+  unsigned int nbr_seen_tx;
   unsigned int nbr_sent_tx;
   unsigned int nbr_random_tx_req;
   struct neighbor_s *next;
@@ -149,6 +159,20 @@ neighbor_t *neighbors_find_by_endpoint(neighbor_t *const neighbors, endpoint_t c
 neighbor_t *neighbors_find_by_endpoint_values(neighbor_t *const neighbors, char const *const ip, uint16_t const port,
                                               protocol_type_t const protocol);
 
+/**
+ * Gives the ratio of transactions of a neighbor that were discarded as
+ * recently seen
+ *
+ * @param neighbor The neighbor
+ *
+ * @return the ratio, in [0,1]
+ */
+static inline double neighbor_seen_tx_ratio(neighbor_t const *const neighbor) {
+  unsigned int all_tx = NEIGHBOR_COUNTER_LOAD(neighbor->nbr_all_tx);
+
+  return all_tx == 0 ? 0.0 : (double)NEIGHBOR_COUNTER_LOAD(neighbor->nbr_seen_tx) / all_tx;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gossip/recent_hashes.h"
+#include "utils/fnv.h"
+
+// Empty slots hold a null fingerprint, which is thus never produced
+#define RECENT_HASHES_EMPTY 0
+
+#define RECENT_HASHES_CACHE_LINE 64
+
+typedef struct recent_hashes_bucket_s {
+  _Alignas(RECENT_HASHES_CACHE_LINE) _Atomic uint64_t fingerprints[RECENT_HASHES_BUCKET_SIZE];
+} recent_hashes_bucket_t;
+
+struct recent_hashes_table_s {
+  _Atomic uint32_t cursor;
+  recent_hashes_bucket_t buckets[];
+};
+
+/*
+ * Private functions
+ */
+
+// FNV-1a over the whole hash followed by a 64 bits finalizer, the bucket and the fingerprint being both taken from it
+static uint64_t recent_hashes_fingerprint(flex_trit_t const *const hash) {
+  uint64_t key = fnv1a_64(hash, FLEX_TRIT_SIZE_243);
+
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+
+  return key == RECENT_HASHES_EMPTY ? 1 : key;
+}
+
+static recent_hashes_bucket_t *recent_hashes_bucket(recent_hashes_t *const filter, uint64_t const fingerprint) {
+  return &filter->table->buckets[fingerprint & filter->mask];
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t recent_hashes_init(recent_hashes_t *const filter, size_t const capacity) {
+  size_t buckets = 1;
+  size_t size = 0;
+
+  if (filter == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  while (buckets * RECENT_HASHES_BUCKET_SIZE < capacity) {
+    buckets <<= 1;
+  }
+
+  // Buckets are aligned on cache lines so that a lookup touches a single line
+  size = sizeof(recent_hashes_table_t) + buckets * sizeof(recent_hashes_bucket_t);
+  if ((filter->table = (recent_hashes_table_t *)aligned_alloc(RECENT_HASHES_CACHE_LINE, size)) == NULL) {
+    return RC_OOM;
+  }
+  // Zeroed memory is a table of empty slots
+  memset(filter->table, 0, size);
+  filter->mask = buckets - 1;
+  atomic_init(&filter->table->cursor, 0);
+
+  return RC_OK;
+}
+
+retcode_t recent_hashes_destroy(recent_hashes_t *const filter) {
+  if (filter == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  free(filter->table);
+  filter->table = NULL;
+  filter->mask = 0;
+
+  return RC_OK;
+}
+
+bool recent_hashes_contains(recent_hashes_t *const filter, flex_trit_t const *const hash) {
+  uint64_t fingerprint = recent_hashes_fingerprint(hash);
+  recent_hashes_bucket_t *bucket = recent_hashes_bucket(filter, fingerprint);
+
+  for (size_t i = 0; i < RECENT_HASHES_BUCKET_SIZE; i++) {
+    if (atomic_load_explicit(&bucket->fingerprints[i], memory_order_relaxed) == fingerprint) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+retcode_t recent_hashes_add(recent_hashes_t *const filter, flex_trit_t const *const hash) {
+  uint64_t fingerprint = recent_hashes_fingerprint(hash);
+  recent_hashes_bucket_t *bucket = recent_hashes_bucket(filter, fingerprint);
+  uint64_t expected = RECENT_HASHES_EMPTY;
+  size_t i;
+
+  for (i = 0; i < RECENT_HASHES_BUCKET_SIZE; i++) {
+    expected = atomic_load_explicit(&bucket->fingerprints[i], memory_order_relaxed);
+    if (expected == fingerprint) {
+      return RC_OK;
+    }
+    if (expected == RECENT_HASHES_EMPTY &&
+        atomic_compare_exchange_strong_explicit(&bucket->fingerprints[i], &expected, fingerprint,
+                                                memory_order_relaxed, memory_order_relaxed)) {
+      return RC_OK;
+    }
+  }
+
+  // The bucket is full, a shared cursor spreads the overwritten slots; racing insertions may overwrite each other,
+  // which only makes the filter forget a hash
+  i = atomic_fetch_add_explicit(&filter->table->cursor, 1, memory_order_relaxed) % RECENT_HASHES_BUCKET_SIZE;
+  atomic_store_explicit(&bucket->fingerprints[i], fingerprint, memory_order_relaxed);
+
+  return RC_OK;
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __GOSSIP_RECENT_HASHES_H__
+#define __GOSSIP_RECENT_HASHES_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/errors.h"
+#include "common/trinary/flex_trit.h"
+
+// Number of fingerprints per bucket, a bucket fills a 64 bytes cache line
+#define RECENT_HASHES_BUCKET_SIZE 8
+
+// Defined in the source file, its atomic fields can not be exposed to C++ users of the header
+typedef struct recent_hashes_table_s recent_hashes_table_t;
+
+/**
+ * A fixed memory filter of recently seen transaction hashes
+ *
+ * Hashes are reduced to 64 bits fingerprints stored in a set-associative table:
+ * a hash can only live in one bucket, and a full bucket overwrites a slot picked
+ * by a rotating cursor, so that old hashes are eventually forgotten. Lookups and
+ * insertions are lock-free so that the filter can be shared by concurrent
+ * processors. A false positive requires a 64 bits fingerprint collision between
+ * two hashes of the same bucket and a false negative only costs a full
+ * processing of the transaction, which is then found in the tangle.
+ */
+typedef struct recent_hashes_s {
+  recent_hashes_table_t *table;
+  // Number of buckets minus one, the number of buckets being a power of two
+  size_t mask;
+} recent_hashes_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes a recent hashes filter
+ *
+ * @param filter The filter
+ * @param capacity The minimal number of hashes remembered, rounded up to fill whole buckets
+ *
+ * @return a status code
+ */
+retcode_t recent_hashes_init(recent_hashes_t *const filter, size_t const capacity);
+
+/**
+ * Destroys a recent hashes filter
+ *
+ * @param filter The filter
+ *
+ * @return a status code
+ */
+retcode_t recent_hashes_destroy(recent_hashes_t *const filter);
+
+/**
+ * Tells whether a hash has recently been added to a filter
+ *
+ * @param filter The filter
+ * @param hash The hash
+ *
+ * @return true if the hash has been seen, false otherwise
+ */
+bool recent_hashes_contains(recent_hashes_t *const filter, flex_trit_t const *const hash);
+
+/**
+ * Adds a hash to a filter, possibly forgetting an older one
+ *
+ * @param filter The filter
+ * @param hash The hash
+ *
+ * @return a status code
+ */
+retcode_t recent_hashes_add(recent_hashes_t *const filter, flex_trit_t const *const hash);
+
+/**
+ * Gives the number of hashes a filter can remember
+ *
+ * @param filter The filter
+ *
+ * @return the capacity of the filter
+ */
+static inline size_t recent_hashes_capacity(recent_hashes_t const *const filter) {
+  return (filter->mask + 1) * RECENT_HASHES_BUCKET_SIZE;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __GOSSIP_RECENT_HASHES_H__
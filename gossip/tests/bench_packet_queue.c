@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/*
+ * Compares the lock-free MPSC ring now used by the gossip components against
+ * the former rw-lock guarded packet list, with producers standing for the
+ * receivers and a single consumer for a processor worker.
+ *
+ * Usage: bench_packet_queue [producers] [packets per producer] (defaults to 4
+ * and 200000)
+ */
+
+#include <inttypes.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "gossip/iota_packet.h"
+#include "utils/containers/queues/mpsc_ring.h"
+#include "utils/handles/rw_lock.h"
+#include "utils/handles/thread.h"
+
+#define BENCH_MAX_PRODUCERS 64
+#define BENCH_RING_SIZE 1024
+
+typedef struct bench_s {
+  size_t packets_per_producer;
+  // List queue
+  iota_packet_queue_t list;
+  rw_lock_handle_t lock;
+  // Ring queue
+  mpsc_ring_t *ring;
+} bench_t;
+
+static uint64_t now_us() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000ULL;
+}
+
+static void *list_producer(bench_t *const bench) {
+  iota_packet_t packet;
+
+  memset(&packet, 0, sizeof(iota_packet_t));
+  for (size_t i = 0; i < bench->packets_per_producer; i++) {
+    packet.content[0] = (byte_t)i;
+    rw_lock_handle_wrlock(&bench->lock);
+    iota_packet_queue_push(&bench->list, &packet);
+    rw_lock_handle_unlock(&bench->lock);
+  }
+
+  return NULL;
+}
+
+static void list_consume(bench_t *const bench, size_t const total) {
+  iota_packet_t *packet_ptr = NULL;
+  iota_packet_t packet;
+
+  for (size_t consumed = 0; consumed < total;) {
+    rw_lock_handle_wrlock(&bench->lock);
+    if ((packet_ptr = iota_packet_queue_peek(bench->list)) != NULL) {
+      packet = *packet_ptr;
+      iota_packet_queue_pop(&bench->list);
+      consumed++;
+    }
+    rw_lock_handle_unlock(&bench->lock);
+    if (packet_ptr == NULL) {
+      sched_yield();
+    }
+  }
+  (void)packet;
+}
+
+static void *ring_producer(bench_t *const bench) {
+  iota_packet_t packet;
+
+  memset(&packet, 0, sizeof(iota_packet_t));
+  for (size_t i = 0; i < bench->packets_per_producer;) {
+    packet.content[0] = (byte_t)i;
+    // Retries instead of dropping so that both queues carry the same packets
+    if (mpsc_ring_push(bench->ring, &packet) == RC_OK) {
+      i++;
+    } else {
+      sched_yield();
+    }
+  }
+
+  return NULL;
+}
+
+static void ring_consume(bench_t *const bench, size_t const total) {
+  iota_packet_t packet;
+
+  for (size_t consumed = 0; consumed < total;) {
+    if (mpsc_ring_pop(bench->ring, &packet) == RC_OK) {
+      consumed++;
+    } else {
+      sched_yield();
+    }
+  }
+}
+
+static uint64_t run(bench_t *const bench, size_t const producers, thread_routine_t const producer,
+                    void (*consume)(bench_t *const, size_t const)) {
+  thread_handle_t threads[BENCH_MAX_PRODUCERS];
+  uint64_t start = now_us();
+
+  for (size_t i = 0; i < producers; i++) {
+    thread_handle_create(&threads[i], producer, bench);
+  }
+  consume(bench, producers * bench->packets_per_producer);
+  for (size_t i = 0; i < producers; i++) {
+    thread_handle_join(threads[i], NULL);
+  }
+
+  return now_us() - start;
+}
+
+int main(int argc, char *argv[]) {
+  bench_t bench;
+  mpsc_ring_stats_t stats;
+  size_t producers = 4;
+  size_t total = 0;
+  uint64_t list_us = 0;
+  uint64_t ring_us = 0;
+
+  memset(&bench, 0, sizeof(bench_t));
+  bench.packets_per_producer = 200000;
+  if (argc > 1) {
+    producers = strtoull(argv[1], NULL, 10);
+  }
+  if (argc > 2) {
+    bench.packets_per_producer = strtoull(argv[2], NULL, 10);
+  }
+  if (producers == 0 || producers > BENCH_MAX_PRODUCERS) {
+    fprintf(stderr, "Number of producers must be in [1, %d]\n", BENCH_MAX_PRODUCERS);
+    return EXIT_FAILURE;
+  }
+  total = producers * bench.packets_per_producer;
+
+  rw_lock_handle_init(&bench.lock);
+  if (mpsc_ring_create(&bench.ring, BENCH_RING_SIZE, sizeof(iota_packet_t)) != RC_OK) {
+    fprintf(stderr, "Creating ring failed\n");
+    return EXIT_FAILURE;
+  }
+
+  list_us = run(&bench, producers, (thread_routine_t)list_producer, list_consume);
+  ring_us = run(&bench, producers, (thread_routine_t)ring_producer, ring_consume);
+  mpsc_ring_stats(bench.ring, &stats);
+
+  printf("%zu producers, %zu packets of %zu bytes\n", producers, total, sizeof(iota_packet_t));
+  printf("  list: %10" PRIu64 " us (%8.3f Mpackets/s)\n", list_us, (double)total / (list_us ? list_us : 1));
+  printf("  ring: %10" PRIu64 " us (%8.3f Mpackets/s), %" PRIu64 " pushes found the ring full\n", ring_us,
+         (double)total / (ring_us ? ring_us : 1), stats.dropped);
+
+  iota_packet_queue_free(&bench.list);
+  rw_lock_handle_destroy(&bench.lock);
+  mpsc_ring_destroy(&bench.ring);
+
+  return EXIT_SUCCESS;
+}
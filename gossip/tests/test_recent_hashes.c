@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "gossip/recent_hashes.h"
+
+#define NUM_HASHES 1000
+
+static flex_trit_t hashes[NUM_HASHES][FLEX_TRIT_SIZE_243];
+
+static void hashes_init() {
+  tryte_t trytes[HASH_LENGTH_TRYTE + 1] =
+      "999999999999999999999999999999999999999999999999999999999999999999999999"
+      "999999999";
+  char const alphabet[] = "9ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+  for (size_t i = 0; i < NUM_HASHES; i++) {
+    trytes[0] = alphabet[i % 27];
+    trytes[1] = alphabet[(i / 27) % 27];
+    trytes[2] = alphabet[i / 729];
+    flex_trits_from_trytes(hashes[i], HASH_LENGTH_TRIT, trytes, HASH_LENGTH_TRYTE, HASH_LENGTH_TRYTE);
+  }
+}
+
+void test_recent_hashes_contains() {
+  recent_hashes_t filter;
+
+  TEST_ASSERT(recent_hashes_init(&filter, 4 * NUM_HASHES) == RC_OK);
+  TEST_ASSERT(recent_hashes_capacity(&filter) >= 4 * NUM_HASHES);
+
+  for (size_t i = 0; i < NUM_HASHES; i++) {
+    TEST_ASSERT_FALSE(recent_hashes_contains(&filter, hashes[i]));
+  }
+
+  for (size_t i = 0; i < NUM_HASHES / 2; i++) {
+    TEST_ASSERT(recent_hashes_add(&filter, hashes[i]) == RC_OK);
+    TEST_ASSERT(recent_hashes_add(&filter, hashes[i]) == RC_OK);
+  }
+
+  for (size_t i = 0; i < NUM_HASHES; i++) {
+    TEST_ASSERT_EQUAL_INT(i < NUM_HASHES / 2, recent_hashes_contains(&filter, hashes[i]));
+  }
+
+  TEST_ASSERT(recent_hashes_destroy(&filter) == RC_OK);
+}
+
+void test_recent_hashes_fixed_memory() {
+  recent_hashes_t filter;
+  size_t seen = 0;
+
+  TEST_ASSERT(recent_hashes_init(&filter, 100) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(128, recent_hashes_capacity(&filter));
+
+  for (size_t i = 0; i < NUM_HASHES; i++) {
+    TEST_ASSERT(recent_hashes_add(&filter, hashes[i]) == RC_OK);
+    // The latest hash is always remembered
+    TEST_ASSERT_TRUE(recent_hashes_contains(&filter, hashes[i]));
+  }
+
+  for (size_t i = 0; i < NUM_HASHES; i++) {
+    seen += recent_hashes_contains(&filter, hashes[i]);
+  }
+  TEST_ASSERT(seen <= recent_hashes_capacity(&filter));
+
+  TEST_ASSERT(recent_hashes_destroy(&filter) == RC_OK);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  hashes_init();
+
+  RUN_TEST(test_recent_hashes_contains);
+  RUN_TEST(test_recent_hashes_fixed_memory);
+
+  return UNITY_END();
+}
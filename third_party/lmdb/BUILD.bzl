@@ -0,0 +1,12 @@
+cc_library(
+    name = "lmdb",
+    srcs = [
+        "libraries/liblmdb/mdb.c",
+        "libraries/liblmdb/midl.c",
+        "libraries/liblmdb/midl.h",
+    ],
+    hdrs = ["libraries/liblmdb/lmdb.h"],
+    linkopts = ["-pthread"],
+    strip_include_prefix = "libraries/liblmdb",
+    visibility = ["//visibility:public"],
+)
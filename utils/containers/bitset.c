@@ -19,13 +19,39 @@ void bitset_reset(bitset_t* const bitset) {
 }
 
 bool bitset_is_set(bitset_t* const bitset, size_t pos) {
-  bitset->bitset_integer_index = pos / (sizeof(*bitset) * 8);
-  bitset->bitset_relative_index = pos % (sizeof(*bitset) * 8);
+  bitset->bitset_integer_index = pos / (sizeof(*(bitset->raw_bits)) * 8);
+  bitset->bitset_relative_index = pos % (sizeof(*(bitset->raw_bits)) * 8);
 
   return bitset->raw_bits[bitset->bitset_integer_index] & (1ULL << bitset->bitset_relative_index);
 }
 
 void bitset_set_true(bitset_t* const bitset, size_t pos) {
-  bitset->bitset_integer_index = pos / (sizeof(*bitset) * 8);
-  bitset->raw_bits[bitset->bitset_integer_index] |= (1ULL << pos);
+  bitset->bitset_integer_index = pos / (sizeof(*(bitset->raw_bits)) * 8);
+  bitset->bitset_relative_index = pos % (sizeof(*(bitset->raw_bits)) * 8);
+  bitset->raw_bits[bitset->bitset_integer_index] |= (1ULL << bitset->bitset_relative_index);
+}
+
+void bitset_or(bitset_t* const bitset, bitset_t const* const other) {
+  size_t i;
+
+  assert(bitset->size == other->size);
+  for (i = 0; i < bitset->size; i++) {
+    bitset->raw_bits[i] |= other->raw_bits[i];
+  }
+}
+
+size_t bitset_count(bitset_t const* const bitset) {
+  size_t count = 0;
+  size_t i;
+
+  for (i = 0; i < bitset->size; i++) {
+#if defined(__GNUC__) || defined(__clang__)
+    count += __builtin_popcountll(bitset->raw_bits[i]);
+#else
+    uint64_t word = bitset->raw_bits[i] - ((bitset->raw_bits[i] >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    count += (((word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL) * 0x0101010101010101ULL) >> 56;
+#endif
+  }
+  return count;
 }
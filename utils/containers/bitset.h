@@ -26,6 +26,10 @@ typedef struct bitset_s {
 void bitset_reset(bitset_t* const bitset);
 bool bitset_is_set(bitset_t* const bitset, size_t pos);
 void bitset_set_true(bitset_t* const bitset, size_t pos);
+// Sets the bits of a bitset of the same size that are set in another, a word at a time
+void bitset_or(bitset_t* const bitset, bitset_t const* const other);
+// Number of bits set
+size_t bitset_count(bitset_t const* const bitset);
 
 size_t bistset_required_size(size_t num_elements);
 
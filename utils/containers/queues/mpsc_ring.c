@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "utils/containers/queues/mpsc_ring.h"
+
+#define MPSC_RING_CACHE_LINE 64
+#define MPSC_RING_ROUND_UP(size) (((size) + MPSC_RING_CACHE_LINE - 1) & ~(size_t)(MPSC_RING_CACHE_LINE - 1))
+
+/**
+ * A slot is free for the producer claiming index i when its sequence is i, and
+ * filled for the consumer popping index i when its sequence is i + 1; popping
+ * sets it to i + capacity, the index of the next round.
+ */
+typedef struct mpsc_ring_slot_s {
+  _Atomic size_t sequence;
+  // Followed by the element, the slot being padded to a multiple of a cache line
+  max_align_t element[];
+} mpsc_ring_slot_t;
+
+struct mpsc_ring_s {
+  // Written by producers
+  _Alignas(MPSC_RING_CACHE_LINE) _Atomic size_t tail;
+  _Alignas(MPSC_RING_CACHE_LINE) _Atomic uint64_t dropped;
+  // Written by the consumer, atomic so that the size can be read from any thread
+  _Alignas(MPSC_RING_CACHE_LINE) _Atomic size_t head;
+  _Atomic size_t peak_size;
+  // Read-only
+  _Alignas(MPSC_RING_CACHE_LINE) size_t capacity;
+  size_t mask;
+  size_t element_size;
+  size_t slot_size;
+  char *slots;
+};
+
+/*
+ * Private functions
+ */
+
+static inline mpsc_ring_slot_t *mpsc_ring_slot(mpsc_ring_t const *const ring, size_t const index) {
+  return (mpsc_ring_slot_t *)(ring->slots + (index & ring->mask) * ring->slot_size);
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t mpsc_ring_create(mpsc_ring_t **const ring, size_t const capacity, size_t const element_size) {
+  mpsc_ring_t *new_ring = NULL;
+  size_t slots = 1;
+
+  if (ring == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  while (slots < capacity) {
+    slots <<= 1;
+  }
+
+  if ((new_ring = (mpsc_ring_t *)aligned_alloc(MPSC_RING_CACHE_LINE, MPSC_RING_ROUND_UP(sizeof(mpsc_ring_t)))) ==
+      NULL) {
+    return RC_UTILS_OOM;
+  }
+  new_ring->capacity = slots;
+  new_ring->mask = slots - 1;
+  new_ring->element_size = element_size;
+  new_ring->slot_size = MPSC_RING_ROUND_UP(sizeof(mpsc_ring_slot_t) + element_size);
+  if ((new_ring->slots = (char *)aligned_alloc(MPSC_RING_CACHE_LINE, slots * new_ring->slot_size)) == NULL) {
+    free(new_ring);
+    return RC_UTILS_OOM;
+  }
+
+  for (size_t i = 0; i < slots; i++) {
+    atomic_init(&mpsc_ring_slot(new_ring, i)->sequence, i);
+  }
+  atomic_init(&new_ring->tail, 0);
+  atomic_init(&new_ring->dropped, 0);
+  atomic_init(&new_ring->head, 0);
+  atomic_init(&new_ring->peak_size, 0);
+
+  *ring = new_ring;
+
+  return RC_OK;
+}
+
+retcode_t mpsc_ring_destroy(mpsc_ring_t **const ring) {
+  if (ring == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  if (*ring) {
+    free((*ring)->slots);
+    free(*ring);
+    *ring = NULL;
+  }
+
+  return RC_OK;
+}
+
+retcode_t mpsc_ring_push(mpsc_ring_t *const ring, void const *const element) {
+  mpsc_ring_slot_t *slot = NULL;
+  size_t index = 0;
+  size_t sequence = 0;
+  intptr_t diff = 0;
+
+  if (ring == NULL || element == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  index = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  while (true) {
+    slot = mpsc_ring_slot(ring, index);
+    sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+    diff = (intptr_t)sequence - (intptr_t)index;
+    if (diff == 0) {
+      // The slot is free, claims it unless another producer did first, index then being reloaded
+      if (atomic_compare_exchange_weak_explicit(&ring->tail, &index, index + 1, memory_order_relaxed,
+                                                memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // The slot still holds the element of the previous round
+      atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+      return RC_UTILS_RING_FULL;
+    } else {
+      // Another producer claimed the slot
+      index = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    }
+  }
+
+  memcpy(slot->element, element, ring->element_size);
+  atomic_store_explicit(&slot->sequence, index + 1, memory_order_release);
+
+  return RC_OK;
+}
+
+retcode_t mpsc_ring_pop(mpsc_ring_t *const ring, void *const element) {
+  mpsc_ring_slot_t *slot = NULL;
+  size_t index = 0;
+  size_t size = 0;
+
+  if (ring == NULL || element == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  index = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  slot = mpsc_ring_slot(ring, index);
+  if (atomic_load_explicit(&slot->sequence, memory_order_acquire) != index + 1) {
+    return RC_UTILS_RING_EMPTY;
+  }
+
+  size = atomic_load_explicit(&ring->tail, memory_order_relaxed) - index;
+  if (size > atomic_load_explicit(&ring->peak_size, memory_order_relaxed)) {
+    atomic_store_explicit(&ring->peak_size, size, memory_order_relaxed);
+  }
+
+  memcpy(element, slot->element, ring->element_size);
+  atomic_store_explicit(&slot->sequence, index + ring->capacity, memory_order_release);
+  atomic_store_explicit(&ring->head, index + 1, memory_order_relaxed);
+
+  return RC_OK;
+}
+
+size_t mpsc_ring_size(mpsc_ring_t *const ring) {
+  size_t head = 0;
+  size_t tail = 0;
+
+  if (ring == NULL) {
+    return 0;
+  }
+
+  head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+  // Both indexes are loaded separately, the head may have moved past the loaded tail
+  return tail > head ? tail - head : 0;
+}
+
+void mpsc_ring_stats(mpsc_ring_t *const ring, mpsc_ring_stats_t *const stats) {
+  stats->capacity = ring->capacity;
+  stats->popped = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  stats->pushed = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  stats->size = stats->pushed > stats->popped ? stats->pushed - stats->popped : 0;
+  stats->peak_size = atomic_load_explicit(&ring->peak_size, memory_order_relaxed);
+  stats->dropped = atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __UTILS_CONTAINERS_QUEUES_MPSC_RING_H__
+#define __UTILS_CONTAINERS_QUEUES_MPSC_RING_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "common/errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A bounded lock-free multi-producer/single-consumer ring of fixed size
+ * elements
+ *
+ * Slots are preallocated and carry a sequence number telling producers and the
+ * consumer whether they are free or filled, so that a push only contends with
+ * other producers on the tail index and a pop never contends at all. A push on
+ * a full ring fails instead of blocking and is counted as a drop, leaving the
+ * caller to decide whether to retry or discard the element.
+ * Producer and consumer indexes live on distinct cache lines, as do slots.
+ */
+typedef struct mpsc_ring_s mpsc_ring_t;
+
+typedef struct mpsc_ring_stats_s {
+  size_t capacity;
+  size_t size;
+  // Highest size seen by the consumer
+  size_t peak_size;
+  uint64_t pushed;
+  uint64_t popped;
+  // Pushes that failed because the ring was full
+  uint64_t dropped;
+} mpsc_ring_stats_t;
+
+/**
+ * Creates a ring
+ *
+ * @param ring The ring
+ * @param capacity The minimal number of elements, rounded up to a power of two
+ * @param element_size The size of an element
+ *
+ * @return a status code
+ */
+retcode_t mpsc_ring_create(mpsc_ring_t **const ring, size_t const capacity, size_t const element_size);
+
+/**
+ * Destroys a ring
+ * /!\ This function is not thread safe
+ *
+ * @param ring The ring
+ *
+ * @return a status code
+ */
+retcode_t mpsc_ring_destroy(mpsc_ring_t **const ring);
+
+/**
+ * Copies an element at the back of a ring
+ * Can be called concurrently by any number of producers
+ *
+ * @param ring The ring
+ * @param element The element
+ *
+ * @return RC_UTILS_RING_FULL if the ring is full, a status code otherwise
+ */
+retcode_t mpsc_ring_push(mpsc_ring_t *const ring, void const *const element);
+
+/**
+ * Copies and removes the element at the front of a ring
+ * Must only be called by the consumer
+ *
+ * @param ring The ring
+ * @param element The element
+ *
+ * @return RC_UTILS_RING_EMPTY if the ring is empty, a status code otherwise
+ */
+retcode_t mpsc_ring_pop(mpsc_ring_t *const ring, void *const element);
+
+/**
+ * Gives the number of elements of a ring, which may be outdated as soon as it
+ * is returned if producers or the consumer are running
+ *
+ * @param ring The ring
+ *
+ * @return the number of elements
+ */
+size_t mpsc_ring_size(mpsc_ring_t *const ring);
+
+/**
+ * Tells whether a ring is empty or not
+ *
+ * @param ring The ring
+ *
+ * @return true if empty, false otherwise
+ */
+static inline bool mpsc_ring_is_empty(mpsc_ring_t *const ring) { return mpsc_ring_size(ring) == 0; }
+
+/**
+ * Gets the counters of a ring
+ *
+ * @param ring The ring
+ * @param stats The counters
+ */
+void mpsc_ring_stats(mpsc_ring_t *const ring, mpsc_ring_stats_t *const stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __UTILS_CONTAINERS_QUEUES_MPSC_RING_H__
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+#include <unity/unity.h>
+
+#include "utils/containers/queues/mpsc_ring.h"
+#include "utils/handles/thread.h"
+
+#define NUM_PRODUCERS 4
+#define NUM_ELEMENTS_PER_PRODUCER 10000
+
+typedef struct element_s {
+  uint32_t producer;
+  uint32_t sequence;
+  // Makes elements span several words
+  char payload[52];
+} element_t;
+
+typedef struct producer_s {
+  mpsc_ring_t *ring;
+  uint32_t id;
+} producer_t;
+
+void test_mpsc_ring_bounds() {
+  mpsc_ring_t *ring = NULL;
+  mpsc_ring_stats_t stats;
+  element_t element;
+
+  TEST_ASSERT(mpsc_ring_create(&ring, 3, sizeof(element_t)) == RC_OK);
+  TEST_ASSERT_TRUE(mpsc_ring_is_empty(ring));
+  TEST_ASSERT(mpsc_ring_pop(ring, &element) == RC_UTILS_RING_EMPTY);
+
+  for (uint32_t i = 0; i < 4; i++) {
+    element.sequence = i;
+    TEST_ASSERT(mpsc_ring_push(ring, &element) == RC_OK);
+  }
+  TEST_ASSERT(mpsc_ring_push(ring, &element) == RC_UTILS_RING_FULL);
+  TEST_ASSERT_EQUAL_INT(4, mpsc_ring_size(ring));
+
+  // Wraps around several times
+  for (uint32_t i = 0; i < 20; i++) {
+    TEST_ASSERT(mpsc_ring_pop(ring, &element) == RC_OK);
+    TEST_ASSERT_EQUAL_INT(i, element.sequence);
+    element.sequence = i + 4;
+    TEST_ASSERT(mpsc_ring_push(ring, &element) == RC_OK);
+  }
+
+  mpsc_ring_stats(ring, &stats);
+  TEST_ASSERT_EQUAL_INT(4, stats.capacity);
+  TEST_ASSERT_EQUAL_INT(4, stats.size);
+  TEST_ASSERT_EQUAL_INT(4, stats.peak_size);
+  TEST_ASSERT_EQUAL_INT(24, stats.pushed);
+  TEST_ASSERT_EQUAL_INT(20, stats.popped);
+  TEST_ASSERT_EQUAL_INT(1, stats.dropped);
+
+  TEST_ASSERT(mpsc_ring_destroy(&ring) == RC_OK);
+  TEST_ASSERT_NULL(ring);
+}
+
+static void *producer_routine(producer_t *const producer) {
+  element_t element;
+
+  memset(&element, 0, sizeof(element_t));
+  element.producer = producer->id;
+  for (element.sequence = 0; element.sequence < NUM_ELEMENTS_PER_PRODUCER;) {
+    if (mpsc_ring_push(producer->ring, &element) == RC_OK) {
+      element.sequence++;
+    }
+  }
+
+  return NULL;
+}
+
+void test_mpsc_ring_producers() {
+  mpsc_ring_t *ring = NULL;
+  mpsc_ring_stats_t stats;
+  thread_handle_t threads[NUM_PRODUCERS];
+  producer_t producers[NUM_PRODUCERS];
+  uint32_t next_sequences[NUM_PRODUCERS] = {0};
+  element_t element;
+  size_t popped = 0;
+
+  TEST_ASSERT(mpsc_ring_create(&ring, 64, sizeof(element_t)) == RC_OK);
+
+  for (uint32_t i = 0; i < NUM_PRODUCERS; i++) {
+    producers[i].ring = ring;
+    producers[i].id = i;
+    TEST_ASSERT_EQUAL_INT(0, thread_handle_create(&threads[i], (thread_routine_t)producer_routine, &producers[i]));
+  }
+
+  // Elements of a producer are popped in the order they were pushed
+  while (popped < NUM_PRODUCERS * NUM_ELEMENTS_PER_PRODUCER) {
+    if (mpsc_ring_pop(ring, &element) == RC_OK) {
+      TEST_ASSERT(element.producer < NUM_PRODUCERS);
+      TEST_ASSERT_EQUAL_INT(next_sequences[element.producer], element.sequence);
+      next_sequences[element.producer]++;
+      popped++;
+    }
+  }
+
+  for (uint32_t i = 0; i < NUM_PRODUCERS; i++) {
+    TEST_ASSERT_EQUAL_INT(0, thread_handle_join(threads[i], NULL));
+  }
+
+  mpsc_ring_stats(ring, &stats);
+  TEST_ASSERT_EQUAL_INT(NUM_PRODUCERS * NUM_ELEMENTS_PER_PRODUCER, stats.pushed);
+  TEST_ASSERT_EQUAL_INT(NUM_PRODUCERS * NUM_ELEMENTS_PER_PRODUCER, stats.popped);
+  TEST_ASSERT_TRUE(mpsc_ring_is_empty(ring));
+
+  TEST_ASSERT(mpsc_ring_destroy(&ring) == RC_OK);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_mpsc_ring_bounds);
+  RUN_TEST(test_mpsc_ring_producers);
+
+  return UNITY_END();
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdbool.h>
+#include <unity/unity.h>
+#include "utils/containers/bitset.h"
+
+#define NUM_BITS 300
+
+void test_bitset_set_and_count() {
+  size_t size = bistset_required_size(NUM_BITS);
+  uint64_t raw_bits[size];
+  bitset_t bitset = {.raw_bits = raw_bits, .bitset_integer_index = 0, .bitset_relative_index = 0, .size = size};
+
+  bitset_reset(&bitset);
+  TEST_ASSERT_EQUAL_INT(bitset_count(&bitset), 0);
+
+  for (size_t i = 0; i < NUM_BITS; i += 3) {
+    bitset_set_true(&bitset, i);
+  }
+
+  for (size_t i = 0; i < NUM_BITS; ++i) {
+    TEST_ASSERT(bitset_is_set(&bitset, i) == (i % 3 == 0));
+  }
+  TEST_ASSERT_EQUAL_INT(bitset_count(&bitset), (NUM_BITS + 2) / 3);
+}
+
+void test_bitset_set_beyond_first_word() {
+  size_t size = bistset_required_size(NUM_BITS);
+  uint64_t raw_bits[size];
+  bitset_t bitset = {.raw_bits = raw_bits, .bitset_integer_index = 0, .bitset_relative_index = 0, .size = size};
+
+  // Each position sets a single bit of its own word
+  bitset_reset(&bitset);
+  bitset_set_true(&bitset, 70);
+  TEST_ASSERT_EQUAL_UINT64(0, raw_bits[0]);
+  TEST_ASSERT_EQUAL_UINT64(1ULL << 6, raw_bits[1]);
+  bitset_set_true(&bitset, 255);
+  TEST_ASSERT_EQUAL_UINT64(1ULL << 63, raw_bits[3]);
+  TEST_ASSERT_FALSE(bitset_is_set(&bitset, 6));
+  TEST_ASSERT_FALSE(bitset_is_set(&bitset, 134));
+  TEST_ASSERT_TRUE(bitset_is_set(&bitset, 70));
+  TEST_ASSERT_TRUE(bitset_is_set(&bitset, 255));
+  TEST_ASSERT_EQUAL_INT(2, bitset_count(&bitset));
+}
+
+void test_bitset_or() {
+  size_t size = bistset_required_size(NUM_BITS);
+  uint64_t raw_bits[size];
+  uint64_t other_raw_bits[size];
+  bitset_t bitset = {.raw_bits = raw_bits, .bitset_integer_index = 0, .bitset_relative_index = 0, .size = size};
+  bitset_t other = {.raw_bits = other_raw_bits, .bitset_integer_index = 0, .bitset_relative_index = 0, .size = size};
+
+  bitset_reset(&bitset);
+  bitset_reset(&other);
+  for (size_t i = 0; i < NUM_BITS; ++i) {
+    if (i % 2 == 0) {
+      bitset_set_true(&bitset, i);
+    }
+    if (i % 5 == 0) {
+      bitset_set_true(&other, i);
+    }
+  }
+
+  bitset_or(&bitset, &other);
+
+  for (size_t i = 0; i < NUM_BITS; ++i) {
+    TEST_ASSERT(bitset_is_set(&bitset, i) == (i % 2 == 0 || i % 5 == 0));
+  }
+  TEST_ASSERT_EQUAL_INT(bitset_count(&bitset), NUM_BITS / 2 + NUM_BITS / 5 - NUM_BITS / 10);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_bitset_set_and_count);
+  RUN_TEST(test_bitset_set_beyond_first_word);
+  RUN_TEST(test_bitset_or);
+
+  return UNITY_END();
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __UTILS_FNV_H__
+#define __UTILS_FNV_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FNV1A_64_OFFSET_BASIS 14695981039346656037ULL
+#define FNV1A_64_PRIME 1099511628211ULL
+
+/**
+ * Hashes bytes with 64 bits FNV-1a, cheap enough for sharding and filtering
+ * keys that are not uniformly distributed, e.g. flex trits
+ *
+ * @param data The bytes
+ * @param size The number of bytes
+ *
+ * @return the hash
+ */
+static inline uint64_t fnv1a_64(void const *const data, size_t const size) {
+  uint8_t const *bytes = (uint8_t const *)data;
+  uint64_t hash = FNV1A_64_OFFSET_BASIS;
+
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ bytes[i]) * FNV1A_64_PRIME;
+  }
+
+  return hash;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __UTILS_FNV_H__
@@ -15,6 +15,7 @@ extern "C" {
 #endif
 
 uint64_t current_timestamp_ms();
+uint64_t current_timestamp_us();
 void sleep_ms(uint64_t milliseconds);
 
 #ifdef __cplusplus